@@ -1,33 +1,239 @@
-#include "bus.hpp"
-#include "memory.hpp"
+#include "Bus.hpp"
+#include "Memory.hpp"
 #include "IODevice.hpp"
 #include <iostream>  
 #include <algorithm> 
+#include <iterator>
 #include <cstdlib> 
 
 
-// Constructor to initialize memory
+// Constructor to initialize memory, mapped as plain RAM
 Bus::Bus(Memory& mem) : memory(mem), ioDevice(nullptr) {
     uint8_t ioPorts[256] = {0}; 
-    
+    std::fill(std::begin(sinkPage), std::end(sinkPage), 0);
+    std::fill(std::begin(generations), std::end(generations), 1); // 0 never matches
+    std::fill(std::begin(readPages), std::end(readPages), nullptr);
+    std::fill(std::begin(writePages), std::end(writePages), nullptr);
+    for (Page& page : pages) {
+        page.data = nullptr;
+        page.writable = false;
+        page.flags = 0;
+        page.device = nullptr;
+    }
+    mapCounts.assign((memory.getSize() + PAGE_SIZE - 1) >> PAGE_SHIFT, 0);
+    unflatPages = PAGES;
+    mapMemory(0, 0x10000, 0, true);
 }
 
 void Bus::attachIODevice(IODevice* device) {
     ioDevice = device;
 }
 
+void Bus::mapMemory(uint16_t address, int length, int offset, bool writable) {
+    uint8_t* base = memory.getMemoryPointer();
+    bool aliasingChanged = false;
+    for (int page = address >> PAGE_SHIFT; page < PAGES && (page << PAGE_SHIFT) < address + length; ++page) {
+        int storage = offset + (page << PAGE_SHIFT) - (address & ~(PAGE_SIZE - 1));
+        if (storage < 0 || storage + PAGE_SIZE > memory.getSize()) {
+            throw std::runtime_error("Page mapped outside of memory");
+        }
+        Page& entry = pages[page];
+        if (entry.data == base + storage && entry.writable == writable) {
+            continue; // Paging ports are often written with what they already hold
+        }
+        if (entry.data != nullptr) {
+            aliasingChanged |= --mapCounts[(entry.data - base) >> PAGE_SHIFT] != 0;
+        }
+        aliasingChanged |= ++mapCounts[storage >> PAGE_SHIFT] > 1;
+        entry.data = base + storage;
+        entry.writable = writable;
+        writeGenerations[page] = writable ? &generations[page] : &sinkGeneration;
+        storageGenerations[page] = memory.getPageGenerationPointer(storage);
+        seenStorageGenerations[page] = *storageGenerations[page];
+        ++generations[page];
+        updatePage(page);
+    }
+    if (aliasingChanged) {
+        // Pages outside the range may have gained or lost their twin
+        for (int page = 0; page < PAGES; ++page) {
+            updatePage(page);
+        }
+    }
+}
+
+void Bus::setPageFlags(uint16_t address, int length, uint8_t flags, bool set, IODevice* device) {
+    for (int page = address >> PAGE_SHIFT; page < PAGES && (page << PAGE_SHIFT) < address + length; ++page) {
+        pages[page].flags = set ? pages[page].flags | flags : pages[page].flags & ~flags;
+        if (flags & PAGE_IO) {
+            pages[page].device = set ? device : nullptr;
+        }
+        updatePage(page);
+    }
+}
+
+// Fills in the fast path entries of a page from where it lives and its flags
+void Bus::updatePage(int page) {
+    const Page& entry = pages[page];
+    uint8_t* base = memory.getMemoryPointer();
+    bool wasFlat = readPages[page] == base + (page << PAGE_SHIFT);
+    bool aliased = entry.data != nullptr && mapCounts[(entry.data - base) >> PAGE_SHIFT] > 1;
+    if (entry.flags != 0) {
+        readPages[page] = writePages[page] = nullptr;
+    } else {
+        readPages[page] = entry.data;
+        writePages[page] = aliased ? nullptr : entry.writable ? entry.data : sinkPage;
+    }
+
+    bool flat = readPages[page] == base + (page << PAGE_SHIFT);
+    unflatPages += wasFlat - flat;
+    flatRead = unflatPages == 0 ? base : nullptr;
+}
+
+// Bumps the generation of every page that maps some of the count bytes of
+// Memory from offset on, after they were changed behind the map
+void Bus::touchStorage(int offset, int count) {
+    const uint8_t* base = memory.getMemoryPointer();
+    for (int page = 0; page < PAGES; ++page) {
+        int storage = static_cast<int>(pages[page].data - base);
+        if (storage + PAGE_SIZE > offset && storage < offset + count) {
+            ++generations[page];
+        }
+    }
+}
+
+uint8_t Bus::readSlow(uint16_t address) {
+    const Page& page = pages[address >> PAGE_SHIFT];
+    uint8_t value;
+    if (page.flags & PAGE_IO) {
+        ++portSideEffects;
+        value = page.device->read(address);
+    } else {
+        value = page.data[address & (PAGE_SIZE - 1)];
+    }
+    if (page.flags & PAGE_WATCH && watcher) {
+        watcher(address, value, false);
+    }
+    return value;
+}
+
+void Bus::writeSlow(uint16_t address, uint8_t value) {
+    const Page& page = pages[address >> PAGE_SHIFT];
+    if (page.flags & PAGE_WATCH && watcher) {
+        watcher(address, value, true);
+    }
+    if (page.flags & PAGE_IO) {
+        ++portSideEffects;
+        page.device->write(address, value);
+        ++generations[address >> PAGE_SHIFT]; // what was read from it may be stale
+    } else if (page.writable) {
+        uint8_t& byte = page.data[address & (PAGE_SIZE - 1)];
+        memoryChanges += byte != value;
+        byte = value;
+        // Every page mapping this one sees the write
+        touchStorage(static_cast<int>(page.data - memory.getMemoryPointer()), PAGE_SIZE);
+    }
+}
+
+// Whether the count bytes from address on, going up (step 1) or down (step -1),
+// all sit in plain pages mapped onto the storage at their own address, where
+// Memory can work on them directly
+bool Bus::isFlat(uint16_t address, int count, int step, bool writing) const {
+    int first = (step > 0 ? address : address - (count - 1)) + 0x10000;
+    for (int page = first >> PAGE_SHIFT; page <= (first + count - 1) >> PAGE_SHIFT; ++page) {
+        const uint8_t* data = memory.getMemoryPointer() + ((page % PAGES) << PAGE_SHIFT);
+        if (readPages[page % PAGES] != data || (writing && writePages[page % PAGES] != data)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Bus::copyMemory(uint16_t source, uint16_t destination, int count, int step) {
+    if (isFlat(source, count, step, false) && isFlat(destination, count, step, true)) {
+        memory.copy(source, destination, count, step);
+        int first = (step > 0 ? destination : destination - (count - 1)) + 0x10000;
+        for (int page = first >> PAGE_SHIFT; page <= (first + count - 1) >> PAGE_SHIFT; ++page) {
+            ++generations[page % PAGES];
+        }
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        write(destination, read(source));
+        source += step;
+        destination += step;
+    }
+}
+
+int Bus::findMemory(uint16_t address, int count, int step, uint8_t first, uint8_t second) {
+    if (isFlat(address, count, step, false)) {
+        return memory.find(address, count, step, first, second);
+    }
+    for (int i = 0; i < count; ++i) {
+        uint8_t value = read(address);
+        if (value == first || value == second) {
+            return i;
+        }
+        address += step;
+    }
+    return count;
+}
+
+uint64_t Bus::getMemoryChanges() const {
+    return memoryChanges + memory.getChanges();
+}
+
+const uint32_t* Bus::getPageGenerationPointer(uint16_t address) {
+    return &generations[address >> PAGE_SHIFT];
+}
 
-uint8_t Bus::read(uint16_t address) {
-    return memory.read(address);  
+void Bus::setModel(MachineModel newModel) {
+    if (newModel != MachineModel::Spectrum48K && memory.getSize() < BANKED_MEMORY_SIZE) {
+        throw std::runtime_error("The 128K models need " + std::to_string(BANKED_MEMORY_SIZE) + " bytes of memory");
+    }
+    model = newModel;
+    pagingRegister = plus2APagingRegister = 0;
+    applyPaging();
 }
 
+// Points the four 16K slots at the ROM and RAM banks the paging ports select
+void Bus::applyPaging() {
+    if (model == MachineModel::Spectrum48K) {
+        mapMemory(0x0000, BANK_SIZE, ROM_OFFSETS[0], false);
+        mapMemory(0x4000, 0xC000, 0x4000, true);
+        return;
+    }
 
-void Bus::write(uint16_t address, uint8_t value) {
-    memory.write(address, value); 
+    if (model == MachineModel::SpectrumPlus2A && (plus2APagingRegister & 0x01)) {
+        // Special paging, all RAM in one of four fixed arrangements
+        static constexpr uint8_t specialBanks[4][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {4, 5, 6, 3}, {4, 7, 6, 3}};
+        const uint8_t* banks = specialBanks[(plus2APagingRegister >> 1) & 0x03];
+        for (int slot = 0; slot < 4; ++slot) {
+            mapMemory(slot * BANK_SIZE, BANK_SIZE, BANK_OFFSETS[banks[slot]], true);
+        }
+        return;
+    }
+
+    int rom = (pagingRegister >> 4) & 0x01;
+    if (model == MachineModel::SpectrumPlus2A) {
+        rom |= (plus2APagingRegister >> 1) & 0x02;
+    }
+    mapMemory(0x0000, BANK_SIZE, ROM_OFFSETS[rom], false);
+    mapMemory(0x4000, BANK_SIZE, BANK_OFFSETS[5], true);
+    mapMemory(0x8000, BANK_SIZE, BANK_OFFSETS[2], true);
+    mapMemory(0xC000, BANK_SIZE, BANK_OFFSETS[pagingRegister & 0x07], true);
+}
+
+const uint8_t* Bus::getScreen() {
+    int bank = model != MachineModel::Spectrum48K && (pagingRegister & 0x08) ? 7 : 5;
+    return memory.getMemoryPointer() + BANK_OFFSETS[bank];
 }
 
 
 uint8_t Bus::readIO(uint16_t port) {
+    if (ioDevice != nullptr && ioDevice->handlesAddress(port)) {
+        ++portSideEffects;
+        return ioDevice->read(port);
+    }
     if ((port & 1) == 0) {
         uint8_t result = 0xFF; 
     uint8_t keyRow = (port & 0xFF00) >> 8;  
@@ -68,11 +274,70 @@ int Bus::readBorder(uint16_t port) {
 
 
 
+// Bit 5 of 0x7FFD locks both paging ports until reset. The 128K only decodes
+// A15 and A1 of 0x7FFD, the +2A also A14 and A12 for 0x1FFD.
+bool Bus::isPagingPort(uint16_t port) const {
+    if (model == MachineModel::Spectrum48K || (pagingRegister & 0x20)) {
+        return false;
+    }
+    if (model == MachineModel::SpectrumPlus2A) {
+        return (port & 0xC002) == 0x4000 || (port & 0xF002) == 0x1000;
+    }
+    return (port & 0x8002) == 0;
+}
+
 void Bus::writeIO(uint16_t port, uint8_t value) {
+    ++portSideEffects;
+    if (isPagingPort(port)) {
+        if (model == MachineModel::SpectrumPlus2A && (port & 0xF002) == 0x1000) {
+            plus2APagingRegister = value;
+        } else {
+            pagingRegister = value;
+        }
+        applyPaging();
+    }
+    if (ioDevice != nullptr && ioDevice->handlesAddress(port)) {
+        ioDevice->write(port, value);
+        return;
+    }
     uint8_t lowBytePort = port & 0xFF;  
     ioPorts[lowBytePort] = value; 
 }
 
+int Bus::ioBlockLength(uint16_t port, int count, bool writing) {
+    const bool toDevice = ioDevice != nullptr && ioDevice->handlesAddress(port);
+    for (int i = 0; i < count; ++i) {
+        uint16_t current = port - (i << 8);
+        if ((writing && isPagingPort(current)) ||
+            (i > 0 && (ioDevice != nullptr && ioDevice->handlesAddress(current)) != toDevice)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void Bus::readIOBlock(uint16_t port, uint8_t* data, int count, const uint64_t* timestamps) {
+    if (ioDevice != nullptr && ioDevice->handlesAddress(port) && ioBlockLength(port, count, false) == count) {
+        ++portSideEffects;
+        ioDevice->readBlock(port, data, count, timestamps);
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        data[i] = readIO(port - (i << 8));
+    }
+}
+
+void Bus::writeIOBlock(uint16_t port, const uint8_t* data, int count, const uint64_t* timestamps) {
+    if (ioDevice != nullptr && ioDevice->handlesAddress(port) && ioBlockLength(port, count, true) == count) {
+        ++portSideEffects;
+        ioDevice->writeBlock(port, data, count, timestamps);
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        writeIO(port - (i << 8), data[i]);
+    }
+}
+
 
 
 bool Bus::isIOPort(uint16_t address) {
@@ -100,9 +365,37 @@ std::vector<uint8_t> Bus::readAllBytes(const std::string& filePath) {
 }
 
 void Bus::loadROM(const std::string& filePath) {
-    std::vector<uint8_t> romData = readAllBytes(filePath);
-    for (size_t i = 0; i < romData.size(); ++i) {
-        memory.write(static_cast<uint16_t>(i), romData[i]);
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open ROM file: " + filePath);
     }
-}
+    size_t romSize = static_cast<size_t>(file.tellg());
+    file.close();
+
+    // Mapped from the file where the host allows, read in where it does not
+    std::vector<uint8_t> romData;
+    auto place = [&](int offset, int fileOffset, int count) {
+        if (!memory.mapFile(offset, filePath, fileOffset, count)) {
+            if (romData.empty()) {
+                romData = readAllBytes(filePath);
+            }
+            memory.load(offset, romData.data() + fileOffset, count);
+        }
+        touchStorage(offset, count);
+    };
 
+    if (model == MachineModel::Spectrum48K) {
+        int count = static_cast<int>(std::min<size_t>(romSize, 0x10000));
+        place(0, 0, count);
+        mapMemory(0, count, 0, false);
+        return;
+    }
+
+    if (romSize > sizeof(ROM_OFFSETS) / sizeof(ROM_OFFSETS[0]) * BANK_SIZE) {
+        throw std::runtime_error("Too many ROMs in " + filePath);
+    }
+    for (size_t rom = 0; rom * BANK_SIZE < romSize; ++rom) {
+        int count = static_cast<int>(std::min<size_t>(romSize - rom * BANK_SIZE, BANK_SIZE));
+        place(ROM_OFFSETS[rom], static_cast<int>(rom * BANK_SIZE), count);
+    }
+}
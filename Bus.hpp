@@ -6,22 +6,99 @@
 #include <stdexcept> 
 #include <vector> 
 #include <string> 
+#include <functional>
+#include "Scheduler.hpp"
 
 
 class Memory;
 class IODevice;
 
+// Memory paging of the machine on the bus. The 48K map is fixed, the 128K
+// pages RAM through port 0x7FFD and the +2A/+3 adds 0x1FFD.
+enum class MachineModel
+{
+  Spectrum48K,
+  Spectrum128K,
+  SpectrumPlus2A
+};
+
 class Bus {
-private:
+public:
+    // The address space is mapped in 256 byte pages
+    static constexpr int PAGE_SHIFT = 8;
+    static constexpr int PAGE_SIZE = 1 << PAGE_SHIFT;
+    static constexpr int PAGES = 0x10000 >> PAGE_SHIFT;
+
+    // Pages with any of these set take the slow path
+    static constexpr uint8_t PAGE_IO = 1 << 0;    // Accesses go to a memory mapped device
+    static constexpr uint8_t PAGE_WATCH = 1 << 1; // Accesses are reported to watcher
+
+    // Where the 16K RAM banks and ROMs of the 128K models live in Memory.
+    // ROM 0 and banks 5, 2 and 0 sit where the 48K map has its ROM and RAM,
+    // so the power-on map is the flat one. Banking only repoints pages.
+    static constexpr int BANK_SIZE = 0x4000;
+    static constexpr int BANK_OFFSETS[8] = {0xC000, 0x10000, 0x8000, 0x14000, 0x18000, 0x4000, 0x1C000, 0x20000};
+    static constexpr int ROM_OFFSETS[4] = {0x0000, 0x24000, 0x28000, 0x2C000};
+    static constexpr int BANKED_MEMORY_SIZE = 0x30000;
+
+protected:
+    // The bus policies in BusPolicies.hpp build on the map
     Memory& memory;     
     IODevice* ioDevice;  
     uint8_t ioPort; 
-    
-    
-    
+
+    // Memory map. Plain pages are read and written straight through these,
+    // ROM pages write into sinkPage and pages with flags are left null.
+    // While every page reads the storage at its own address, as the 48K map
+    // does, flatRead points at it and reads skip the table: a table load
+    // that depends on the address is the slow part of a paged read.
+    uint8_t* flatRead = nullptr;
+    uint8_t* readPages[PAGES];
+    uint8_t* writePages[PAGES];
+    uint32_t* writeGenerations[PAGES];
+    // Write generation of every page of the address space. Repointing a page
+    // bumps it too, so code cached from the old contents is never run again.
+    uint32_t generations[PAGES];
+    // Generation of the Memory page each page maps, and what it was when the
+    // page's own generation last took it in. Writes made straight to Memory
+    // show up there, not in generations.
+    const uint32_t* storageGenerations[PAGES];
+    uint32_t seenStorageGenerations[PAGES];
+    // Where each page lives, whatever its flags
+    struct Page {
+        uint8_t* data;
+        bool writable;
+        uint8_t flags;
+        IODevice* device;
+    };
+    Page pages[PAGES];
+    uint8_t sinkPage[PAGE_SIZE];
+    uint32_t sinkGeneration = 0;
+    // Writes through the map that changed what memory holds
+    uint64_t memoryChanges = 0;
+    // How many pages map each page of Memory. A write to a page that is
+    // mapped twice takes the slow path, which bumps the generation of both.
+    std::vector<uint8_t> mapCounts;
+    // Pages that do not read the storage at their own address
+    int unflatPages = 0;
+
+    MachineModel model = MachineModel::Spectrum48K;
+    uint8_t pagingRegister = 0;       // Last write to 0x7FFD
+    uint8_t plus2APagingRegister = 0; // Last write to 0x1FFD
+
+    void updatePage(int page);
+    void touchStorage(int offset, int count);
+    void applyPaging();
+    bool isFlat(uint16_t address, int count, int step, bool writing) const;
+    bool isPagingPort(uint16_t port) const;
+    uint8_t readSlow(uint16_t address);
+    void writeSlow(uint16_t address, uint8_t value);
 
 public:
+// The INT line, raised and dropped by the ULA events on scheduler
 bool interrupt = false;
+// Device timing, on the clock of the CPU running on this bus
+Scheduler scheduler;
 uint8_t KeyMatrix[8];
     
     Bus(Memory& mem);
@@ -29,12 +106,75 @@ uint8_t KeyMatrix[8];
   
     void attachIODevice(IODevice* device);
 
+    // Buses that time their accesses keep the counter of the CPU running on
+    // them, z80::reset() hands it over. Plain memory has no use for it.
+    void attachClock(uint64_t*) {}
+
+    // The CPU's next memory access happens at the T-state given. The CPU puts
+    // an instruction's base T-states on the clock before its handler runs,
+    // so a bus that times its accesses counts on from here instead.
+    void startAccesses(uint64_t) {}
+
+    // The CPU reads the opcode or prefix byte at address, which an engine
+    // decoded earlier with the bare read(). Buses that time or count their
+    // accesses charge it as a read; plain memory has nothing to do. Compiled
+    // blocks make no fetches, so the JIT only runs on buses without them.
+    void fetch(uint16_t) {}
+    static constexpr bool CHARGES_FETCHES = false;
+    // Whether accesses can put waits on the CPU's clock, so an instruction's
+    // T-states are only known once it has run
+    static constexpr bool ADDS_WAITS = false;
+
    
+    // One shift and one indexed load find the page, pages with flags call out
     uint8_t read(uint16_t address);
 
   
     void write(uint16_t address, uint8_t value);
 
+    // Maps the pages covering length bytes from address onto the Memory
+    // storage from offset on. Writes to pages that are not writable are dropped.
+    void mapMemory(uint16_t address, int length, int offset, bool writable);
+    // Sets or clears flags on the pages covering length bytes from address.
+    // PAGE_IO pages are handed to device.
+    void setPageFlags(uint16_t address, int length, uint8_t flags, bool set, IODevice* device = nullptr);
+    // Called on every access of a PAGE_WATCH page, before a write lands
+    std::function<void(uint16_t address, uint8_t value, bool write)> watcher;
+
+    // Switches the paging to that of model, with both paging ports cleared.
+    // The 128K models need a Memory of BANKED_MEMORY_SIZE.
+    void setModel(MachineModel model);
+    MachineModel getModel() const { return model; }
+    // T-states from one frame interrupt to the next
+    uint32_t getFrameLength() const { return model == MachineModel::Spectrum48K ? 69888 : 70908; }
+    // The 6912 bytes of bitmap and attributes the ULA shows, bank 5 or on
+    // the 128K models bank 7 when bit 3 of 0x7FFD selects it
+    const uint8_t* getScreen();
+
+    // count bytes copied one at a time like LDIR (step 1) or LDDR (step -1)
+    void copyMemory(uint16_t source, uint16_t destination, int count, int step);
+
+    // Offset of the first byte matching first or second that CPIR (step 1) or
+    // CPDR (step -1) would reach within count bytes, count if there is none
+    int findMemory(uint16_t address, int count, int step, uint8_t first, uint8_t second);
+
+    // Write generation of the 256 byte page holding address, with the writes
+    // made straight to the Memory page it maps folded in
+    uint32_t getPageGeneration(uint16_t address);
+    // Where that generation is counted, for code that checks it without
+    // calling in. Memory writes only reach it on the next getPageGeneration().
+    const uint32_t* getPageGenerationPointer(uint16_t address);
+    // Writes that changed what memory holds
+    uint64_t getMemoryChanges() const;
+
+    // Puts the ROM at the bottom of memory and maps it read-only. On the
+    // 128K models the file holds the ROMs one after the other, two for the
+    // 128K and four for the +2A. The file is mapped into Memory rather than
+    // copied where the host allows it, so every machine that loads the same
+    // ROM runs from the same physical pages. Those stay backed by the file:
+    // truncating it on disk while a machine runs from it raises SIGBUS on the
+    // next read of a page past its new end, so ROM files are replaced, never
+    // rewritten in place.
     void loadROM(const std::string& filePath);
 
     std::vector<uint8_t> readAllBytes(const std::string& filePath);
@@ -43,8 +183,54 @@ uint8_t KeyMatrix[8];
     uint8_t readIO(uint16_t port);     
     int readBorder(uint16_t port);  
     void writeIO(uint16_t port, uint8_t value);  
+
+    // count bytes through port for INIR/INDR (read) or OTIR/OTDR (write). The
+    // port's high byte is one lower for each byte and timestamps holds the
+    // T-state each byte moves at. An attached device that handles every port
+    // of the span takes it in one call, anything else goes a byte at a time.
+    void readIOBlock(uint16_t port, uint8_t* data, int count, const uint64_t* timestamps);
+    void writeIOBlock(uint16_t port, const uint8_t* data, int count, const uint64_t* timestamps);
+    // How many of those count ports, from the first, go the same way: all to
+    // the attached device or none of them. Writes also stop at a paging port,
+    // which remaps memory in the middle of the span.
+    int ioBlockLength(uint16_t port, int count, bool writing);
     uint8_t ioPorts[256] = {0}; 
+    // Port writes and device reads, anything a port access may have changed
+    uint64_t portSideEffects = 0;
 
 };
 
+inline uint8_t Bus::read(uint16_t address) {
+    if (flatRead != nullptr) {
+        return flatRead[address];
+    }
+    const uint8_t* page = readPages[address >> PAGE_SHIFT];
+    if (page == nullptr) {
+        return readSlow(address);
+    }
+    return page[address & (PAGE_SIZE - 1)];
+}
+
+inline uint32_t Bus::getPageGeneration(uint16_t address) {
+    const int page = address >> PAGE_SHIFT;
+    const uint32_t storage = *storageGenerations[page];
+    if (storage != seenStorageGenerations[page]) {
+        seenStorageGenerations[page] = storage;
+        ++generations[page];
+    }
+    return generations[page];
+}
+
+inline void Bus::write(uint16_t address, uint8_t value) {
+    uint8_t* page = writePages[address >> PAGE_SHIFT];
+    if (page == nullptr) {
+        writeSlow(address, value);
+        return;
+    }
+    uint8_t& byte = page[address & (PAGE_SIZE - 1)];
+    memoryChanges += byte != value;
+    byte = value;
+    ++*writeGenerations[address >> PAGE_SHIFT];
+}
+
 #endif 
@@ -0,0 +1,225 @@
+#ifndef BUS_POLICIES_H
+#define BUS_POLICIES_H
+
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include "Bus.hpp"
+#include "Memory.hpp"
+
+// Buses the CPU can be built over. z80 holds a CpuBus, which a build picks
+// with Z80_BUS the way it picks the engine with Z80_DEFAULT_ENGINE. Each one
+// hides the Bus accessors with its own inline ones rather than overriding
+// virtual ones, so the core calls the chosen bus directly and inlines it.
+
+// 64K of plain RAM with nothing mapped over it, as the FUSE suite and unit
+// tests expect. Reads and writes index the storage without the page table.
+class FlatBus : public Bus {
+public:
+    FlatBus(Memory& mem) : Bus(mem), ram(mem.getMemoryPointer()) {}
+
+    uint8_t read(uint16_t address) {
+        return ram[address];
+    }
+
+    void write(uint16_t address, uint8_t value) {
+        uint8_t& byte = ram[address];
+        memoryChanges += byte != value;
+        byte = value;
+        ++generations[address >> PAGE_SHIFT];
+    }
+
+private:
+    // The map stays the flat one the constructor set up
+    using Bus::mapMemory;
+    using Bus::setPageFlags;
+    using Bus::setModel;
+    using Bus::loadROM;
+
+    uint8_t* ram;
+};
+
+// Paged memory with the ULA's contention. While the ULA fetches the screen,
+// the first 128 T-states of each of the 192 display lines, an access to a
+// contended bank waits for it. The wait is added to the CPU's T-state counter
+// at the access, so it comes out of the runFor() budget like any other time.
+// Accesses are timed from the T-state the CPU last gave startAccesses(), 3
+// T-states apart plus their waits; the internal cycles some instructions
+// have between accesses are not modelled. Frames are taken to start at
+// multiples of the frame length, as runFrame() lines them up from reset.
+class ContendedBus : public Bus {
+public:
+    ContendedBus(Memory& mem) : Bus(mem) {
+        std::fill(std::begin(chunkBanks), std::end(chunkBanks), -1); // ROMs
+        for (int bank = 0; bank < 8; ++bank) {
+            chunkBanks[BANK_OFFSETS[bank] / BANK_SIZE] = bank;
+        }
+    }
+
+    void attachClock(uint64_t* tstates) {
+        clock = tstates;
+        accessTime = *tstates;
+    }
+
+    void startAccesses(uint64_t tstate) { accessTime = tstate; }
+
+    void fetch(uint16_t address) { contend(address); }
+    static constexpr bool CHARGES_FETCHES = true;
+    static constexpr bool ADDS_WAITS = true;
+
+    uint8_t read(uint16_t address) {
+        contend(address);
+        return Bus::read(address);
+    }
+
+    void write(uint16_t address, uint8_t value) {
+        contend(address);
+        Bus::write(address, value);
+    }
+
+    // Byte at a time, so every byte LDIR and CPIR move is timed. Each byte
+    // is an iteration of its own, the next one's accesses 21 T-states on.
+    void copyMemory(uint16_t source, uint16_t destination, int count, int step) {
+        for (int i = 0; i < count; ++i) {
+            write(destination, read(source));
+            accessTime += ITERATION - 6;
+            source += step;
+            destination += step;
+        }
+    }
+
+    int findMemory(uint16_t address, int count, int step, uint8_t first, uint8_t second) {
+        for (int i = 0; i < count; ++i, address += step) {
+            uint8_t value = read(address);
+            accessTime += ITERATION - 3;
+            if (value == first || value == second) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    // T-states lost to contention since the bus was made
+    uint64_t getContention() const { return contention; }
+
+private:
+    struct Timing {
+        uint32_t frame;
+        uint32_t line;
+        uint32_t firstFetch; // T-state of the first contended access of a frame
+        uint8_t delays[8];   // Wait by T-state within each 8 T-state fetch
+    };
+    static constexpr Timing TIMING_48K = {69888, 224, 14335, {6, 5, 4, 3, 2, 1, 0, 0}};
+    static constexpr Timing TIMING_128K = {70908, 228, 14361, {6, 5, 4, 3, 2, 1, 0, 0}};
+    static constexpr Timing TIMING_PLUS2A = {70908, 228, 14365, {1, 0, 7, 6, 5, 4, 3, 2}};
+
+    // T-states of a repeating LDIR or CPIR iteration
+    static constexpr uint32_t ITERATION = 21;
+
+    uint64_t* clock = nullptr;
+    uint64_t accessTime = 0; // T-state of the next access
+    uint64_t contention = 0;
+    // RAM bank held by each 16K of Memory, -1 for the ROMs
+    int chunkBanks[BANKED_MEMORY_SIZE / BANK_SIZE];
+
+    // The odd banks on the 48K and 128K, where the 48K only has bank 5 in
+    // its contended range, and banks 4 to 7 on the +2A
+    bool isContended(uint16_t address) const {
+        int chunk = static_cast<int>(pages[address >> PAGE_SHIFT].data - memory.getMemoryPointer()) / BANK_SIZE;
+        int bank = chunkBanks[chunk];
+        if (bank < 0) {
+            return false;
+        }
+        return getModel() == MachineModel::SpectrumPlus2A ? bank >= 4 : (bank & 1) != 0;
+    }
+
+    void contend(uint16_t address) {
+        if (clock == nullptr) {
+            return;
+        }
+        const Timing& timing = getModel() == MachineModel::Spectrum48K ? TIMING_48K
+                               : getModel() == MachineModel::Spectrum128K ? TIMING_128K
+                                                                          : TIMING_PLUS2A;
+        uint32_t frameTime = static_cast<uint32_t>(accessTime % timing.frame);
+        accessTime += 3;
+        if (frameTime < timing.firstFetch || frameTime >= timing.firstFetch + 192 * timing.line) {
+            return;
+        }
+        uint32_t lineTime = (frameTime - timing.firstFetch) % timing.line;
+        if (lineTime >= 128 || !isContended(address)) {
+            return;
+        }
+        uint8_t delay = timing.delays[lineTime & 7];
+        *clock += delay;
+        accessTime += delay;
+        contention += delay;
+    }
+};
+
+// Paged memory that counts every access by page, for profilers
+class InstrumentedBus : public Bus {
+public:
+    InstrumentedBus(Memory& mem) : Bus(mem) {}
+
+    uint64_t reads[PAGES] = {0};
+    uint64_t writes[PAGES] = {0};
+    uint64_t ioReads = 0;
+    uint64_t ioWrites = 0;
+
+    void clearCounts() {
+        std::fill(std::begin(reads), std::end(reads), 0);
+        std::fill(std::begin(writes), std::end(writes), 0);
+        ioReads = ioWrites = 0;
+    }
+
+    uint8_t read(uint16_t address) {
+        ++reads[address >> PAGE_SHIFT];
+        return Bus::read(address);
+    }
+
+    void fetch(uint16_t address) { ++reads[address >> PAGE_SHIFT]; }
+    static constexpr bool CHARGES_FETCHES = true;
+
+    void write(uint16_t address, uint8_t value) {
+        ++writes[address >> PAGE_SHIFT];
+        Bus::write(address, value);
+    }
+
+    void copyMemory(uint16_t source, uint16_t destination, int count, int step) {
+        for (int i = 0; i < count; ++i) {
+            ++reads[uint16_t(source + i * step) >> PAGE_SHIFT];
+            ++writes[uint16_t(destination + i * step) >> PAGE_SHIFT];
+        }
+        Bus::copyMemory(source, destination, count, step);
+    }
+
+    int findMemory(uint16_t address, int count, int step, uint8_t first, uint8_t second) {
+        int found = Bus::findMemory(address, count, step, first, second);
+        for (int i = 0; i < std::min(found + 1, count); ++i) {
+            ++reads[uint16_t(address + i * step) >> PAGE_SHIFT];
+        }
+        return found;
+    }
+
+    uint8_t readIO(uint16_t port) {
+        ++ioReads;
+        return Bus::readIO(port);
+    }
+
+    void writeIO(uint16_t port, uint8_t value) {
+        ++ioWrites;
+        Bus::writeIO(port, value);
+    }
+
+    void readIOBlock(uint16_t port, uint8_t* data, int count, const uint64_t* timestamps) {
+        ioReads += count;
+        Bus::readIOBlock(port, data, count, timestamps);
+    }
+
+    void writeIOBlock(uint16_t port, const uint8_t* data, int count, const uint64_t* timestamps) {
+        ioWrites += count;
+        Bus::writeIOBlock(port, data, count, timestamps);
+    }
+};
+
+#endif
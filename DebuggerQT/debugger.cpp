@@ -165,11 +165,11 @@ private slots:
             {
                 // Read the opcode and lookup in the DD instruction table
                 opcode = bus.read(cpu.PC + 1);
-                auto it = cpu.instructionTableDD.find(opcode);
-                if (it != cpu.instructionTableDD.end())
+                const Instruction &instruction = cpu.instructionTableDD[opcode];
+                if (instruction.hasOperation())
                 {
                     Mnemonic->setText(QString("Mnemonic: %1")
-                                          .arg(QString::fromStdString(it->second.getMnemonic())));
+                                          .arg(QString::fromStdString(instruction.getMnemonic())));
                 }
                 else
                 {
@@ -189,11 +189,11 @@ private slots:
             {
                 // Read the opcode and lookup in the DD instruction table
                 auto opcode = bus.read(cpu.PC + 1);
-                auto it = cpu.instructionTableFD.find(opcode);
-                if (it != cpu.instructionTableFD.end())
+                const Instruction &instruction = cpu.instructionTableFD[opcode];
+                if (instruction.hasOperation())
                 {
                     Mnemonic->setText(QString("Mnemonic: %1")
-                                          .arg(QString::fromStdString(it->second.getMnemonic())));
+                                          .arg(QString::fromStdString(instruction.getMnemonic())));
                 }
                 else
                 {
@@ -214,11 +214,11 @@ private slots:
             break;
         default:
             opcode = bus.read(cpu.PC);
-            auto it = cpu.instructionTable.find(opcode);
-            if (it != cpu.instructionTable.end())
+            const Instruction &instruction = cpu.instructionTable[opcode];
+            if (instruction.hasOperation())
             {
                 Mnemonic->setText(QString("Mnemonic: %1")
-                                      .arg(QString::fromStdString(it->second.getMnemonic())));
+                                      .arg(QString::fromStdString(instruction.getMnemonic())));
             }
             break;
         }
@@ -239,8 +239,8 @@ private slots:
             {
                 // Read the opcode and lookup in the DD instruction table
                 opcode = bus.read(cpu.PC + 1);
-                auto it = cpu.instructionTableDD.find(opcode);
-                if (it != cpu.instructionTableDD.end())
+                const Instruction &instruction = cpu.instructionTableDD[opcode];
+                if (instruction.hasOperation())
                 {
                     return cpu.instructionTableDD[opcode].getMnemonic();
                 }
@@ -261,8 +261,8 @@ private slots:
             {
                 // Read the opcode and lookup in the DD instruction table
                 auto opcode = bus.read(cpu.PC + 1);
-                auto it = cpu.instructionTableFD.find(opcode);
-                if (it != cpu.instructionTableFD.end())
+                const Instruction &instruction = cpu.instructionTableFD[opcode];
+                if (instruction.hasOperation())
                 {
                     return cpu.instructionTableFD[opcode].getMnemonic();
                 }
@@ -283,8 +283,8 @@ private slots:
             break;
         default:
             opcode = bus.read(cpu.PC);
-            auto it = cpu.instructionTable.find(opcode);
-            if (it != cpu.instructionTable.end())
+            const Instruction &instruction = cpu.instructionTable[opcode];
+            if (instruction.hasOperation())
             {
                 return "Empty";
             }
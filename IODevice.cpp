@@ -28,3 +28,15 @@ void IODevice::write(int address, uint8_t value) {
         std::cerr << "Attempted write to unmapped I/O address 0x" << std::hex << address << std::endl;
     }
 }
+
+void IODevice::readBlock(int address, uint8_t* data, int count, const uint64_t*) {
+    for (int i = 0; i < count; ++i) {
+        data[i] = read((address - (i << 8)) & 0xFFFF);
+    }
+}
+
+void IODevice::writeBlock(int address, const uint8_t* data, int count, const uint64_t*) {
+    for (int i = 0; i < count; ++i) {
+        write((address - (i << 8)) & 0xFFFF, data[i]);
+    }
+}
@@ -15,6 +15,13 @@ IODevice();
 
     // Write to the device
     virtual void write(int address, uint8_t value) = 0;
+
+    // Move count bytes in one call, for INIR/INDR (readBlock) and OTIR/OTDR
+    // (writeBlock). The address's high byte is one lower for each byte, as B
+    // counts down, and timestamps holds the CPU T-state each byte moves at.
+    // By default read or write is called once per byte.
+    virtual void readBlock(int address, uint8_t* data, int count, const uint64_t* timestamps);
+    virtual void writeBlock(int address, const uint8_t* data, int count, const uint64_t* timestamps);
 };
 
 #endif 
@@ -1,21 +1,12 @@
 #include "Instruction.hpp"
 #include "main.hpp"
 
-Instruction::Instruction(const std::string &mnemonic,
-                         std::function<void(z80 &, uint8_t)> operation, int cycles)
-    : mnemonic(mnemonic), operation(operation), cycles(cycles) {}
-
-void Instruction::execute(z80 &cpu, uint8_t opCode)
+void Instruction::execute(z80 &cpu, uint8_t opCode) const
 {
-    operation(cpu, opCode);
+    (cpu.*operation)(opCode);
 }
 
 std::string Instruction::getMnemonic() const
 {
     return mnemonic;
 }
-
-int Instruction::getCycles() const
-{
-    return cycles;
-}
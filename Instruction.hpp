@@ -1,8 +1,9 @@
 #ifndef INSTRUCTION_H
 #define INSTRUCTION_H
 
+#include <array>
 #include <string>
-#include <functional>
+#include <cstdint>
 class z80; // Forward declaration of z80 class
 
 enum class AddressingMode
@@ -17,24 +18,37 @@ enum class AddressingMode
 
 };
 
+// Plain pointer to a z80 handler. Dispatching through it is a single indirect
+// call, unlike std::function which adds a type-erased thunk on every opcode.
+using Operation = void (z80::*)(uint8_t);
+
 class Instruction
 {
 private:
-    std::string mnemonic;
-    std::function<void(z80 &, uint8_t)> operation;
+    const char *mnemonic;
+    Operation operation;
+    // T-states for the whole instruction, prefixes included. For conditional
+    // jumps, calls, returns and repeating block instructions this is the cost
+    // when the condition fails; the handler adds the extra cycles itself.
     int cycles;
 
 public:
-    Instruction()
+    constexpr Instruction()
         : mnemonic("NOP"), operation(nullptr), cycles(4) {}
 
-    Instruction(const std::string &mnemonic,
-                std::function<void(z80 &, uint8_t)> operation, int cycles);
+    constexpr Instruction(const char *mnemonic, Operation operation, int cycles)
+        : mnemonic(mnemonic), operation(operation), cycles(cycles) {}
+
+    void execute(z80 &cpu, uint8_t opCode) const;
 
-    void execute(z80 &cpu, uint8_t opCode);
+    // Empty slots in the 256 entry tables have no operation
+    constexpr bool hasOperation() const { return operation != nullptr; }
+    constexpr Operation getOperation() const { return operation; }
 
     std::string getMnemonic() const;
-    int getCycles() const;
+    constexpr int getCycles() const { return cycles; }
 };
 
+using InstructionTable = std::array<Instruction, 256>;
+
 #endif
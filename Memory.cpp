@@ -1,26 +1,175 @@
 #include "Memory.hpp"
 #include <iostream>  
+#include <cstring>
+#include <algorithm>
+#include <new>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef MEMORY_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Constructor to initialize memory with a given size
 Memory::Memory(int size) : memorySize(size) {
+#ifdef MEMORY_MMAP
+    // Page aligned, so files can be mapped over it, and zero until touched
+    void* storage = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (storage == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    memory = static_cast<uint8_t*>(storage);
+#else
     memory = new uint8_t[size];  // Dynamically allocate memory array
     std::fill(memory, memory + size, 0);  // Initialize all memory to zero
+#endif
+
+    // Generations start at 1 so that 0 never matches
+    int pages = (size + 0xFF) >> 8;
+    pageGenerations = new uint32_t[pages];
+    std::fill(pageGenerations, pageGenerations + pages, 1);
 }
 
 // Destructor to clean up the dynamically allocated memory array
 Memory::~Memory() {
+#ifdef MEMORY_MMAP
+    munmap(memory, memorySize);
+#else
     delete[] memory;  // Free the memory
+#endif
+    delete[] pageGenerations;
+}
+
+int Memory::wrap(int offset) const {
+    offset %= memorySize;
+    return offset < 0 ? offset + memorySize : offset;
+}
+
+void Memory::touch(int offset, int count) {
+    for (int page = offset >> 8; page <= (offset + count - 1) >> 8; ++page) {
+        ++pageGenerations[page];
+    }
 }
 
 // Read a byte from memory
-uint8_t Memory::read(int address) {
-    address = address & 0xFFFF;  // Wrap address to 16-bit
-    return memory[address];  // Return the value at the address
+uint8_t Memory::read(int offset) {
+    return memory[wrap(offset)];  // Return the value at the offset
 }
 
 // Write a byte to memory
-void Memory::write(int address, uint8_t value) {
-    address = address & 0xFFFF;  // Wrap address to 16-bit
-    memory[address] = value;  // Set the value at the address
+void Memory::write(int offset, uint8_t value) {
+    offset = wrap(offset);
+    changes += memory[offset] != value;
+    memory[offset] = value;  // Set the value at the offset
+    ++pageGenerations[offset >> 8];
+}
+
+void Memory::load(int offset, const uint8_t* data, int count) {
+#ifdef MEMORY_MMAP
+    // The range may still hold a file mapFile() left read-only
+    long pageSize = sysconf(_SC_PAGESIZE);
+    int first = static_cast<int>(offset / pageSize * pageSize);
+    mprotect(memory + first, offset + count - first, PROT_READ | PROT_WRITE);
+#endif
+    std::copy(data, data + count, memory + offset);
+    changes += count;
+    touch(offset, count);
+}
+
+bool Memory::mapFile(int offset, const std::string& filePath, int fileOffset, int count) {
+#ifdef MEMORY_MMAP
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (offset % pageSize != 0 || fileOffset % pageSize != 0 || count % pageSize != 0 || offset + count > memorySize) {
+        return false;
+    }
+    int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || fileOffset + count > info.st_size) {
+        close(file);
+        return false;
+    }
+    void* mapped = mmap(memory + offset, count, PROT_READ, MAP_PRIVATE | MAP_FIXED, file, fileOffset);
+    close(file);
+    if (mapped == MAP_FAILED) {
+        // A failed MAP_FIXED may have unmapped the range, put fresh pages back
+        mmap(memory + offset, count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        return false;
+    }
+    changes += count;
+    touch(offset, count);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Memory::copy(int source, int destination, int count, int step) {
+    source &= 0xFFFF;
+    destination &= 0xFFFF;
+
+    // Lowest address of each range, and how far the writes run ahead of the reads
+    int from = step > 0 ? source : source - (count - 1);
+    int to = step > 0 ? destination : destination - (count - 1);
+    int lead = (step > 0 ? destination - source : source - destination) & 0xFFFF;
+
+    if (from >= 0 && to >= 0 && from + count <= 0x10000 && to + count <= 0x10000 && (lead == 0 || lead >= count)) {
+        // No wrap, and no byte is read after the copy has written it
+        std::memmove(memory + to, memory + from, count);
+        changes += count;
+        touch(to, count);
+        return;
+    }
+
+    changes += count;
+    for (int i = 0; i < count; ++i) {
+        memory[destination] = memory[source];
+        ++pageGenerations[destination >> 8];
+        source = (source + step) & 0xFFFF;
+        destination = (destination + step) & 0xFFFF;
+    }
+}
+
+int Memory::find(int address, int count, int step, uint8_t first, uint8_t second) {
+    address &= 0xFFFF;
+    int offset = 0;
+    while (offset < count) {
+        // Up to the end of the address space, where the search wraps
+        int length = std::min(count - offset, step > 0 ? 0x10000 - address : address + 1);
+        int i = 0;
+#ifdef __SSE2__
+        // 16 bytes at a time, a bit per byte that matches either value
+        const __m128i firstVector = _mm_set1_epi8(static_cast<char>(first));
+        const __m128i secondVector = _mm_set1_epi8(static_cast<char>(second));
+        for (; i + 16 <= length; i += 16) {
+            const uint8_t* chunk = step > 0 ? memory + address + i : memory + address - i - 15;
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk));
+            int matches = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, firstVector),
+                                                         _mm_cmpeq_epi8(bytes, secondVector)));
+            if (matches != 0) {
+                // Going down, the highest address in the chunk comes first
+                return offset + i + (step > 0 ? __builtin_ctz(matches) : __builtin_clz(matches) - 16);
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            uint8_t value = memory[address + step * i];
+            if (value == first || value == second) {
+                return offset + i;
+            }
+        }
+        offset += length;
+        address = (address + step * length) & 0xFFFF;
+    }
+    return count;
+}
+
+uint8_t* Memory::getMemoryPointer() {
+    return memory;
 }
 
@@ -2,11 +2,25 @@
 #define MEMORY_H
 
 #include <cstdint>  
+#include <string>
+
+// Storage comes from mmap where there is one, so files can be mapped into it
+#if defined(__unix__) || defined(__APPLE__)
+#define MEMORY_MMAP
+#endif
 
 class Memory {
 private:
     uint8_t* memory;  // The memory array
     int memorySize;   // Total size of memory
+    uint32_t* pageGenerations;  // Write count of every 256 byte page
+    uint64_t changes = 0;       // Writes that changed a byte, or may have
+
+    // Bumps the generation of every page holding some of the count bytes from offset on
+    void touch(int offset, int count);
+
+    // Offset into the storage, wrapped at its size
+    int wrap(int offset) const;
 
 public:
     // Constructor to initialize memory with a given size
@@ -15,12 +29,53 @@ public:
     // Destructor to clean up the memory array
     ~Memory();
 
+    // Storage is addressed by its own offsets, which wrap at its size. On a
+    // 64K Memory they are the CPU's addresses; banked storage is paged in by
+    // the Bus, which is where code visible reads and writes go. Writing here
+    // bumps the storage's page generations, which the Bus folds into its own,
+    // so code the CPU has cached from those pages is decoded again.
+
     // Read a byte from memory
-    uint8_t read(int address);
+    uint8_t read(int offset);
 
     // Write a byte to memory
-    void write(int address, uint8_t value);
+    void write(int offset, uint8_t value);
+
+    // Copies count bytes in from offset on, past the 64K a CPU address reaches
+    void load(int offset, const uint8_t* data, int count);
+
+    // Maps count bytes of the file from fileOffset on over the storage from
+    // offset on, read-only: the pages are the file's own in the page cache,
+    // shared by every Memory that maps it, and writing them faults until
+    // load() copies something over them. The three have to be multiples of
+    // the host page size. Returns false where the file cannot be mapped, the
+    // caller then loads it instead.
+    bool mapFile(int offset, const std::string& filePath, int fileOffset, int count);
+
+    // copy() and find() work on the unbanked 64K view: the first 64K of the
+    // storage taken as the CPU's address space, addresses wrapping at 64K.
+    // The Bus only hands them ranges it maps there at their own address.
+
+    // Copies count bytes one at a time, the way LDIR (step 1) or LDDR (step -1)
+    // does, so overlapping ranges repeat their pattern.
+    void copy(int source, int destination, int count, int step);
+
+    // Offset of the first of count bytes from address on, going up (step 1) or
+    // down (step -1), that equals first or second, or count if none does, the
+    // way CPIR or CPDR would reach it.
+    int find(int address, int count, int step, uint8_t first, uint8_t second);
+
     uint8_t* getMemoryPointer();
+    int getSize() const { return memorySize; }
+
+    // Bumped on every write here to the 256 byte page of the storage holding
+    // offset. Writes the Bus makes through its map count in its own
+    // generations instead, so its fast path never touches these.
+    const uint32_t* getPageGenerationPointer(int offset) const { return &pageGenerations[offset >> 8]; }
+
+    // Bumped when a write changes what memory holds. Loops that write back
+    // what is already there leave it alone.
+    uint64_t getChanges() const { return changes; }
 };
 
 #endif 
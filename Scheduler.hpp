@@ -0,0 +1,92 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+// Events keyed on the CPU's T-state counter. runFor() only compares against
+// the earliest one, so timing follows the emulated clock and costs nothing
+// between events. A binary heap, as only a handful are ever pending: the
+// frame interrupt, the end of the INT window, scanline boundaries, beeper edges.
+class Scheduler {
+public:
+    // Called with the T-state the event was due at, which is at or before the
+    // current one since events only run between instructions
+    using Callback = std::function<void(uint64_t when)>;
+
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    // Runs callback once the T-state counter reaches when. Returns an id for cancel().
+    int schedule(uint64_t when, Callback callback) {
+        return add(when, 0, std::move(callback));
+    }
+
+    // Runs callback at when, when + period and so on until cancelled. Each
+    // time is a multiple of period after the first, however late it ran.
+    int scheduleEvery(uint64_t when, uint64_t period, Callback callback) {
+        return add(when, period, std::move(callback));
+    }
+
+    void cancel(int id) {
+        auto event = std::find_if(events.begin(), events.end(), [id](const Event& e) { return e.id == id; });
+        if (event != events.end()) {
+            events.erase(event);
+            std::make_heap(events.begin(), events.end(), later);
+        }
+    }
+
+    void clear() {
+        events.clear();
+    }
+
+    // T-state of the earliest event, NEVER if there is none
+    uint64_t next() const {
+        return events.empty() ? NEVER : events.front().when;
+    }
+
+    // Runs every event due at or before now, earliest first and those due at
+    // the same T-state in the order they were scheduled. Callbacks may
+    // schedule and cancel events, including ones that are due straight away.
+    void runDue(uint64_t now) {
+        while (!events.empty() && events.front().when <= now) {
+            std::pop_heap(events.begin(), events.end(), later);
+            Event event = std::move(events.back());
+            events.pop_back();
+            if (event.period != 0) {
+                // Back on the heap first, so the callback can cancel it
+                add(event.when + event.period, event.period, event.callback, event.id);
+            }
+            event.callback(event.when);
+        }
+    }
+
+private:
+    struct Event {
+        uint64_t when;
+        uint64_t order; // Ties run first come, first served
+        uint64_t period;
+        int id;
+        Callback callback;
+    };
+
+    static bool later(const Event& a, const Event& b) {
+        return a.when != b.when ? a.when > b.when : a.order > b.order;
+    }
+
+    int add(uint64_t when, uint64_t period, Callback callback, int id = -1) {
+        if (id < 0) {
+            id = nextId++;
+        }
+        events.push_back({when, nextOrder++, period, id, std::move(callback)});
+        std::push_heap(events.begin(), events.end(), later);
+        return id;
+    }
+
+    std::vector<Event> events;
+    uint64_t nextOrder = 0;
+    int nextId = 0;
+};
+
+#endif
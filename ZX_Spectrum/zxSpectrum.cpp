@@ -57,10 +57,12 @@ public:
     {
 
         uint16_t address = startAddress;
+        // Bank 5, or the shadow screen in bank 7 when the 128K pages it in
+        const uint8_t *screen = bus.getScreen();
 
         for (int character = 0x4000; character <= 0x57FF; ++character)
         {
-            uint8_t byte = bus.read(character);
+            uint8_t byte = screen[character - 0x4000];
             if (byte != 0)
             {
                 uninitialized = false;
@@ -76,7 +78,7 @@ public:
                 int pixelLine = (character >> 8) & 0x7;  // Vertical offset within the row
                 int y = blockRow * 64 + rowInBlock * 8 + pixelLine;
                 int attributeAddress = 0x5800 + ((y / 8) * 32 + (x / 8));
-                uint8_t color = bus.read(attributeAddress);
+                uint8_t color = screen[attributeAddress - 0x4000];
                 foreground = color & 0b00000111;
                 background = (color & 0b00111000) >> 3;
                 brightness = (color & 0b01000000) >> 6;
@@ -98,7 +100,6 @@ public:
             frameCounter = 0;
         }
         repaint();
-        bus.interrupt = true;
     }
 
     QRgb getColor(bool value, bool flash, int foreground, int background, int brightness, int &frameCounter)
@@ -466,7 +467,7 @@ int main(int argc, char *argv[])
     QApplication app(argc, argv);
 
     Memory memory(0x10000); // 64KB memory
-    Bus bus(memory);
+    CpuBus bus(memory);
     z80 cpu;
 
     bus.loadROM("C:\\Users\\eelip\\Downloads\\48.rom");
@@ -475,22 +476,13 @@ int main(int argc, char *argv[])
     ZXScreen screen(bus, cpu);
     screen.show();
 
-    QTimer *screenUpdateTimer = new QTimer(&screen);
-    QObject::connect(screenUpdateTimer, &QTimer::timeout, [&]()
+    // One emulated frame per tick, then draw it
+    QTimer *frameTimer = new QTimer(&screen);
+    QObject::connect(frameTimer, &QTimer::timeout, [&]()
                      {
-    
-    screen.updateScreenBuffer(); });
-    screenUpdateTimer->start(20); // 50hz 16 for 60
-
-    QTimer *cpuTimer = new QTimer(&screen);
-    QObject::connect(cpuTimer, &QTimer::timeout, [&]()
-                     {
-       
-        for (int i = 0; i < 1000; ++i) {
-            cpu.run(bus.read(cpu.PC));
-            bus.interrupt = false;
-        } });
-    cpuTimer->start(1); 
+        cpu.runFrame();
+        screen.updateScreenBuffer(); });
+    frameTimer->start(20); // 50hz
 
     return app.exec();
 }
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// ALU heavy workload: boots the 48K ROM and then keeps the ROM floating point
+// calculator busy with divisions and multiplications. Build with
+// Z80_LAZY_FLAGS to compare lazy against eager flag evaluation.
+// Usage: calculatorBenchmark [rom path] [frames]
+int main(int argc, char *argv[])
+{
+    std::string romPath = argc > 1 ? argv[1] : "48.rom";
+    uint64_t frames = argc > 2 ? std::stoull(argv[2]) : 2000;
+
+    Memory memory(0x10000);
+    Bus bus(memory);
+    z80 cpu;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        bus.KeyMatrix[i] = 0xFF; // No keys pressed
+    }
+    bus.loadROM(romPath);
+    cpu.reset(&bus);
+
+    // Let the ROM set up the system variables and the calculator stack
+    for (int i = 0; i < 200; ++i)
+    {
+        cpu.runFrame();
+    }
+
+    const uint8_t program[] = {
+        0xF3,             // DI
+        0x3E, 0x2A,       // loop: LD A, 42
+        0xCD, 0x28, 0x2D, // CALL STACK_A
+        0x3E, 0x07,       // LD A, 7
+        0xCD, 0x28, 0x2D, // CALL STACK_A
+        0xEF,             // RST 28h, start the calculator
+        0x05,             // division
+        0x31,             // duplicate
+        0x04,             // multiply
+        0x38,             // end-calc
+        0xCD, 0xD5, 0x2D, // CALL FP_TO_A
+        0x18, 0xEB,       // JR loop
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+    {
+        bus.write(0x8000 + i, program[i]);
+    }
+    cpu.PC = 0x8000;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < frames; ++i)
+    {
+        cpu.runFor(z80::TSTATES_PER_FRAME);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+#ifdef Z80_LAZY_FLAGS
+    std::cout << "lazy flags: ";
+#else
+    std::cout << "eager flags: ";
+#endif
+    std::cout << frames << " frames in " << seconds << " s, "
+              << frames * z80::TSTATES_PER_FRAME / seconds / 1e6 << " MHz"
+              << " (A=" << static_cast<int>(cpu.A) << " AF=0x" << std::hex << cpu.getAF() << std::dec
+              << " PC=0x" << std::hex << cpu.PC << std::dec << ")" << std::endl;
+
+    return 0;
+}
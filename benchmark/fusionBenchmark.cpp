@@ -0,0 +1,139 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// Superinstruction workloads on the block engine: the 48K ROM boot, the ROM
+// floating point calculator and the ROM screen clearing routine. Each one is
+// timed with and without fused pairs. With --profile the pair profile of all
+// three is printed instead, the most frequent pairs being the candidates for
+// z80::fusedPairs.
+// Usage: fusionBenchmark [rom path] [frames] [--profile]
+
+namespace
+{
+const uint8_t calculatorProgram[] = {
+    0xF3,             // DI
+    0x3E, 0x2A,       // loop: LD A, 42
+    0xCD, 0x28, 0x2D, // CALL STACK_A
+    0x3E, 0x07,       // LD A, 7
+    0xCD, 0x28, 0x2D, // CALL STACK_A
+    0xEF,             // RST 28h, start the calculator
+    0x05,             // division
+    0x31,             // duplicate
+    0x04,             // multiply
+    0x38,             // end-calc
+    0xCD, 0xD5, 0x2D, // CALL FP_TO_A
+    0x18, 0xEB,       // JR loop
+};
+
+const uint8_t clearScreenProgram[] = {
+    0xF3,             // DI
+    0xCD, 0x6B, 0x0D, // loop: CALL CLS
+    0x18, 0xFB,       // JR loop
+};
+
+struct Workload
+{
+    const char *name;
+    const uint8_t *program; // run at 0x8000 after the boot, none for the boot itself
+    size_t size;
+};
+
+// Boots the ROM, then runs the workload for frames frames
+double runWorkload(z80 &cpu, Bus &bus, const std::string &romPath, const Workload &workload, uint64_t frames)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        bus.KeyMatrix[i] = 0xFF; // No keys pressed
+    }
+    bus.loadROM(romPath);
+    cpu.reset(&bus);
+    cpu.engine = ExecutionEngine::Block;
+
+    if (workload.program != nullptr)
+    {
+        // Let the ROM set up the system variables and the calculator stack
+        for (int i = 0; i < 200; ++i)
+        {
+            cpu.runFrame();
+        }
+        for (size_t i = 0; i < workload.size; ++i)
+        {
+            bus.write(0x8000 + i, workload.program[i]);
+        }
+        cpu.PC = 0x8000;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < frames; ++i)
+    {
+        cpu.runFrame();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    std::string romPath = argc > 1 ? argv[1] : "48.rom";
+    uint64_t frames = argc > 2 ? std::stoull(argv[2]) : 2000;
+    bool profile = argc > 3 && std::string(argv[3]) == "--profile";
+
+    const Workload workloads[] = {
+        {"boot", nullptr, 0},
+        {"calculator", calculatorProgram, sizeof(calculatorProgram)},
+        {"cls", clearScreenProgram, sizeof(clearScreenProgram)},
+    };
+
+    if (profile)
+    {
+        std::unordered_map<std::string, uint64_t> counts;
+        uint64_t total = 0;
+        for (const Workload &workload : workloads)
+        {
+            Memory memory(0x10000);
+            Bus bus(memory);
+            z80 cpu;
+            cpu.enablePairProfile();
+            runWorkload(cpu, bus, romPath, workload, frames);
+            for (const auto &pair : cpu.topPairs(SIZE_MAX))
+            {
+                counts[pair.first] += pair.second;
+                total += pair.second;
+            }
+        }
+
+        std::vector<std::pair<std::string, uint64_t>> top(counts.begin(), counts.end());
+        std::sort(top.begin(), top.end(), [](const auto &a, const auto &b)
+                  { return a.second > b.second; });
+        for (size_t i = 0; i < top.size() && i < 20; ++i)
+        {
+            std::cout << top[i].first << ": " << top[i].second << " ("
+                      << 100.0 * top[i].second / total << "%)" << std::endl;
+        }
+        return 0;
+    }
+
+    for (const Workload &workload : workloads)
+    {
+        for (bool fuse : {false, true})
+        {
+            Memory memory(0x10000);
+            Bus bus(memory);
+            z80 cpu;
+            cpu.fuseInstructions = fuse;
+            double seconds = runWorkload(cpu, bus, romPath, workload, frames);
+            std::cout << workload.name << (fuse ? " fused: " : " unfused: ") << frames << " frames in "
+                      << seconds << " s, " << frames * z80::TSTATES_PER_FRAME / seconds / 1e6 << " MHz, "
+                      << cpu.fusedPairsRun << " fused pairs run" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// Register to register workload: a loop of LD r,r', INC r, ADD A,r and the CB
+// bit instructions, the handlers the decode tables hold one template
+// instantiation per opcode of. Reports the emulated speed of the table,
+// predecoded and block engines, and the jit engine when built with Z80_JIT,
+// best of a few runs.
+// Usage: registerBenchmark [T-states per run] [runs]
+
+namespace
+{
+const uint8_t registerProgram[] = {
+    0xF3,       // DI
+    0x41,       // loop: LD B, C
+    0x53,       // LD D, E
+    0x3C,       // INC A
+    0x80,       // ADD A, B
+    0xCB, 0x5A, // BIT 3, D
+    0xCB, 0xD3, // SET 2, E
+    0xCB, 0x93, // RES 2, E
+    0x65,       // LD H, L
+    0x6F,       // LD L, A
+    0x0C,       // INC C
+    0x78,       // LD A, B
+    0xCB, 0x7F, // BIT 7, A
+    0x47,       // LD B, A
+    0x14,       // INC D
+    0x82,       // ADD A, D
+    0xCB, 0xC4, // SET 0, H
+    0x18, 0xE9, // JR loop
+};
+
+double runProgram(ExecutionEngine engine, uint64_t tstates)
+{
+    Memory memory(0x10000);
+    CpuBus bus(memory);
+    for (int i = 0; i < 8; ++i)
+    {
+        bus.KeyMatrix[i] = 0xFF; // No keys pressed
+    }
+    for (size_t i = 0; i < sizeof(registerProgram); ++i)
+    {
+        bus.write(0x8000 + i, registerProgram[i]);
+    }
+
+    z80 cpu;
+    cpu.reset(&bus);
+    cpu.engine = engine;
+    cpu.PC = 0x8000;
+
+    auto start = std::chrono::steady_clock::now();
+    cpu.runFor(tstates);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t tstates = argc > 1 ? std::stoull(argv[1]) : 100000000;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    const std::pair<const char *, ExecutionEngine> engines[] = {
+        {"table", ExecutionEngine::Table},
+        {"predecoded", ExecutionEngine::Predecoded},
+        {"block", ExecutionEngine::Block},
+#ifdef Z80_JIT
+        {"jit", ExecutionEngine::Jit},
+#endif
+    };
+
+    for (const auto &engine : engines)
+    {
+        double best = 0;
+        for (int run = 0; run < runs; ++run)
+        {
+            double seconds = runProgram(engine.second, tstates);
+            best = run == 0 ? seconds : std::min(best, seconds);
+        }
+        std::cout << engine.first << ": " << tstates << " T-states in " << best << " s, "
+                  << tstates / best / 1e6 << " MHz" << std::endl;
+    }
+
+    return 0;
+}
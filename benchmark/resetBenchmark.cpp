@@ -0,0 +1,41 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// Constructs and resets a large number of CPUs the way test fixtures and the
+// fuse runner do, and reports the cost per CPU. Usage: resetBenchmark [count]
+int main(int argc, char *argv[])
+{
+    uint64_t cpuCount = argc > 1 ? std::stoull(argv[1]) : 100000;
+
+    Memory memory(0x10000);
+    Bus bus(memory);
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < cpuCount; ++i)
+    {
+        // Heap allocate so the optimiser cannot fold the whole loop away
+        std::unique_ptr<z80> cpu = std::make_unique<z80>();
+        cpu->reset(&bus);
+        cpu->PC = static_cast<uint16_t>(i);
+        checksum += cpu->PC + cpu->SP;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "sizeof(z80): " << sizeof(z80) << " bytes" << std::endl;
+    std::cout << "Constructed and reset " << cpuCount << " CPUs in "
+              << seconds << " s (" << (seconds * 1e9 / cpuCount) << " ns per CPU)" << std::endl;
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// Boots the 48K ROM headless and reports how fast the core runs with each
+// execution engine, once driven one instruction at a time through run() and
+// once in whole frames through runFrame(). For the predecoded engine the hit
+// rate of the decode cache is reported as well, for the block engine how many
+// blocks ran and how many of them were reached through a chained successor.
+// The jit engine only generates native code in the romBootBenchmarkJit build,
+// here it runs the same blocks as the block engine. In the romBootBenchmarkAot
+// build the block and jit engines run 48.rom from its ahead of time translation.
+// The block and jit engines also report the T-states their idle loop skipping
+// credited without running them, and the loops that took most of those.
+// Usage: romBootBenchmark [rom path] [instruction count]
+
+struct BootResult
+{
+    double seconds;
+    uint64_t tstates;
+    uint64_t decodeCacheHits;
+    uint64_t decodeCacheMisses;
+    uint64_t blocksExecuted;
+    uint64_t blocksTranslated;
+    uint64_t blocksChained;
+    uint64_t jitBlocksCompiled;
+    uint64_t jitBlocksRun;
+    uint64_t staticBlocksRun;
+    std::vector<std::pair<uint16_t, uint64_t>> idleLoops; // T-states skipped by loop address, most first
+};
+
+#ifdef Z80_STATIC_ROM
+extern const StaticTranslation rom48Translation;
+#endif
+
+BootResult bootRom(const std::string &romPath, uint64_t instructionCount, ExecutionEngine engine, bool byFrame)
+{
+    Memory memory(0x10000);
+    Bus bus(memory);
+    z80 cpu;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        bus.KeyMatrix[i] = 0xFF; // No keys pressed
+    }
+    bus.loadROM(romPath);
+    cpu.reset(&bus);
+    cpu.engine = engine;
+#ifdef Z80_STATIC_ROM
+    if (!cpu.attachStaticTranslation(rom48Translation))
+    {
+        std::cerr << romPath << " is not the ROM rom48Translation was generated from" << std::endl;
+    }
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (byFrame)
+    {
+        // Roughly the same amount of work as the per instruction loop
+        uint64_t frames = instructionCount / 20000;
+        for (uint64_t i = 0; i < frames; ++i)
+        {
+            cpu.runFrame();
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0; i < instructionCount; ++i)
+        {
+            // Roughly one 50 Hz frame worth of instructions between interrupts
+            if (i % 20000 == 0)
+            {
+                bus.interrupt = true;
+            }
+            cpu.run(bus.read(cpu.PC));
+            bus.interrupt = false;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    BootResult result = {std::chrono::duration<double>(end - start).count(), cpu.tstates,
+                         cpu.decodeCacheHits, cpu.decodeCacheMisses,
+                         cpu.blocksExecuted, cpu.blocksTranslated, cpu.blocksChained, 0, 0,
+                         cpu.staticBlocksRun, {cpu.idleLoops.begin(), cpu.idleLoops.end()}};
+    std::sort(result.idleLoops.begin(), result.idleLoops.end(), [](const auto &a, const auto &b)
+              { return a.second > b.second; });
+#ifdef Z80_JIT
+    result.jitBlocksCompiled = cpu.jitBlocksCompiled;
+    result.jitBlocksRun = cpu.jitBlocksRun;
+#endif
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string romPath = argc > 1 ? argv[1] : "48.rom";
+    uint64_t instructionCount = argc > 2 ? std::stoull(argv[2]) : 50000000;
+
+    const std::pair<const char *, ExecutionEngine> engines[] = {
+        {"table", ExecutionEngine::Table},
+        {"switch", ExecutionEngine::Switch},
+        {"predecoded", ExecutionEngine::Predecoded},
+        {"block", ExecutionEngine::Block},
+        {"jit", ExecutionEngine::Jit},
+    };
+
+    for (const auto &engine : engines)
+    {
+        BootResult result = bootRom(romPath, instructionCount, engine.second, false);
+        std::cout << engine.first << ": executed " << instructionCount << " instructions in "
+                  << result.seconds << " s, "
+                  << static_cast<uint64_t>(instructionCount / result.seconds) << " instructions per second, "
+                  << result.tstates / result.seconds / 1e6 << " MHz" << std::endl;
+
+        BootResult frames = bootRom(romPath, instructionCount, engine.second, true);
+        std::cout << engine.first << " runFrame: " << frames.tstates << " T-states in "
+                  << frames.seconds << " s, "
+                  << frames.tstates / frames.seconds / 1e6 << " MHz" << std::endl;
+
+        uint64_t lookups = frames.decodeCacheHits + frames.decodeCacheMisses;
+        if (lookups > 0)
+        {
+            std::cout << engine.first << " decode cache: " << frames.decodeCacheHits << " hits, "
+                      << frames.decodeCacheMisses << " misses, "
+                      << 100.0 * frames.decodeCacheHits / lookups << "% hit rate" << std::endl;
+        }
+        if (frames.blocksExecuted > 0)
+        {
+            std::cout << engine.first << " blocks: " << frames.blocksExecuted << " run, "
+                      << frames.blocksTranslated << " translated, "
+                      << 100.0 * frames.blocksChained / frames.blocksExecuted << "% chained, "
+                      << static_cast<double>(frames.tstates) / frames.blocksExecuted << " T-states per block"
+                      << std::endl;
+        }
+        if (frames.jitBlocksCompiled > 0)
+        {
+            std::cout << engine.first << " native: " << frames.jitBlocksCompiled << " blocks compiled, "
+                      << 100.0 * frames.jitBlocksRun / frames.blocksExecuted << "% of blocks run natively"
+                      << std::endl;
+        }
+        if (frames.staticBlocksRun > 0)
+        {
+            std::cout << engine.first << " static: "
+                      << 100.0 * frames.staticBlocksRun / frames.blocksExecuted << "% of blocks run from the translated ROM"
+                      << std::endl;
+        }
+        if (!frames.idleLoops.empty())
+        {
+            uint64_t skipped = 0;
+            for (const auto &loop : frames.idleLoops)
+            {
+                skipped += loop.second;
+            }
+            std::cout << engine.first << " idle: " << 100.0 * skipped / frames.tstates << "% of T-states skipped in "
+                      << frames.idleLoops.size() << " loops";
+            for (size_t i = 0; i < frames.idleLoops.size() && i < 5; ++i)
+            {
+                std::cout << (i == 0 ? ", " : "; ") << "0x" << std::hex << frames.idleLoops[i].first << std::dec
+                          << ": " << 100.0 * frames.idleLoops[i].second / frames.tstates << "%";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -117,7 +117,7 @@ std::vector<Test> parseTestsIn(const std::string &filename)
 
             std::istringstream iss(line);
 
-            iss >> std::hex >> currentTest.I >> currentTest.R >> currentTest.IFF1 >> currentTest.IFF2 >> currentTest.IM >> currentTest.halted >> currentTest.tstates;
+            iss >> std::hex >> currentTest.I >> currentTest.R >> currentTest.IFF1 >> currentTest.IFF2 >> currentTest.IM >> currentTest.halted >> std::dec >> currentTest.tstates; // tstates are decimal
             lineType++;
         }
      
@@ -245,7 +245,7 @@ std::vector<Expected> parseExpected(const std::string &filename)
             std::istringstream iss(line);
             uint8_t halted;
 
-            iss >> std::hex >> currentTestExpected.I >> currentTestExpected.R >> currentTestExpected.IFF1 >> currentTestExpected.IFF2 >> currentTestExpected.IM >> halted >> currentTestExpected.tstates;
+            iss >> std::hex >> currentTestExpected.I >> currentTestExpected.R >> currentTestExpected.IFF1 >> currentTestExpected.IFF2 >> currentTestExpected.IM >> halted >> std::dec >> currentTestExpected.tstates; // tstates are decimal
         }
       
         else if (currentTestExpected.memorySetup.empty())
@@ -311,12 +311,40 @@ std::vector<Expected> parseExpected(const std::string &filename)
     return expected;
 }
 
-int main()
+// Pass --switch, --predecoded, --block or --jit to run the suite on another
+// execution engine. The Block and Jit engines run each test through runFor(),
+// and --jit compiles every block the first time it runs.
+int main(int argc, char *argv[])
 {
     z80 cpu;
     Memory memory(0x10000);
-    Bus bus(memory);
+    CpuBus bus(memory);
     cpu.reset(&bus);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--switch")
+        {
+            cpu.engine = ExecutionEngine::Switch;
+        }
+        else if (std::string(argv[i]) == "--predecoded")
+        {
+            cpu.engine = ExecutionEngine::Predecoded;
+        }
+        else if (std::string(argv[i]) == "--block")
+        {
+            cpu.engine = ExecutionEngine::Block;
+        }
+        else if (std::string(argv[i]) == "--jit")
+        {
+#ifdef Z80_JIT
+            cpu.engine = ExecutionEngine::Jit;
+            cpu.jitThreshold = 1;
+#else
+            std::cerr << "--jit needs a build with Z80_JIT" << std::endl;
+            return 1;
+#endif
+        }
+    }
     int passed = 0;
     int failed = 0;
     int error = 0;
@@ -403,14 +431,24 @@ int main()
                 }
             }
 
-            uint16_t runToAddress = exp.PC;
-
             bool memoryOk = true;
 
-            do
+            // Like Fuse, run whole instructions until the requested number of
+            // T-states has elapsed
+            cpu.tstates = 0;
+            if (cpu.engine == ExecutionEngine::Block || cpu.engine == ExecutionEngine::Jit)
+            {
+                cpu.overshoot = 0;
+                cpu.runFor(test.tstates);
+            }
+            else
             {
-                cpu.execute(bus.read(cpu.PC));
-            } while (cpu.PC < runToAddress);
+                do
+                {
+                    cpu.execute(bus.read(cpu.PC));
+                } while (cpu.tstates < test.tstates);
+            }
+            cpu.resolveFlags(); // F is compared directly below
 
             if (exp.memorySetup.empty())
             {
@@ -461,6 +499,7 @@ int main()
                 cpu.getDE() == exp.DE &&
                 cpu.getHL() == exp.HL &&
                 cpu.MPTR == exp.MEMPTR &&
+                cpu.tstates == exp.tstates &&
 
                 memoryOk)
         
@@ -506,6 +545,8 @@ int main()
                     std::cout << "Mismatch in R: Expected " << std::hex << exp.R << ", Got " << std::hex << (int)cpu.R << std::endl;
                  if (cpu.MPTR != exp.MEMPTR)
                   std::cout << "Mismatch in MPTR: Expected " << std::hex << exp.R << ", Got " << std::hex << cpu.MPTR << std::endl;
+                if (cpu.tstates != exp.tstates)
+                    std::cout << "Mismatch in tstates: Expected " << std::dec << exp.tstates << ", Got " << std::dec << cpu.tstates << std::endl;
 
                 std::cout << "Memory setup during the test:" << std::endl;
                 for (const auto &[startAddress, bytes] : test.memorySetup)
@@ -1,12 +1,32 @@
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
 #include "main.hpp"
 #include "Instruction.hpp"
+#ifdef Z80_JIT_NATIVE
+#include <cstring>
+#include <sys/mman.h>
+#endif
 
 z80::z80()
 {
     reset(nullptr);
 }
 
+#ifdef Z80_JIT
+z80::~z80()
+{
+#ifdef Z80_JIT_NATIVE
+    if (jitCode != nullptr)
+    {
+        munmap(jitCode, JIT_CODE_SIZE);
+    }
+#endif
+}
+#endif
+
 void z80::run(uint8_t opCode)
 {
 
@@ -14,7 +34,134 @@ void z80::run(uint8_t opCode)
     {
         execute(opCode); 
     }
+    else
+    {
+        skipHalted(tstates + 1);
+    }
+    handleInterrupt(interruptMode);
+}
+
+// Runs whole instructions until the T-state budget is used up. Interrupts are
+// checked on entry and after the bus events that fall within the budget,
+// which the engines run up to one at a time, and while INT is held after
+// every instruction, so an EI inside the window still sees it. The
+// instruction that crosses the end of the budget is completed, and the
+// T-states it ran over are taken off the next call. Returns the number of
+// T-states executed.
+uint64_t z80::runFor(uint64_t budget)
+{
+    if (overshoot >= budget)
+    {
+        overshoot -= budget;
+        return 0;
+    }
+
+    const uint64_t start = tstates;
+    const uint64_t deadline = start + budget - overshoot;
+
+    runDueEvents();
+
+    while (tstates < deadline)
+    {
+        if (tstates >= bus->scheduler.next())
+        {
+            runDueEvents();
+        }
+        uint64_t until = std::min(deadline, bus->scheduler.next());
+        // A one T-state deadline runs a single instruction on every engine
+        const bool sampling = bus->interrupt;
+        if (sampling)
+        {
+            until = std::min(until, tstates + 1);
+        }
+        runDeadline = until;
+
+        if (halted)
+        {
+            // Nothing wakes the CPU before the next event
+            skipHalted(until);
+        }
+        else if (engine == ExecutionEngine::Block || engine == ExecutionEngine::Jit)
+        {
+            runBlocks(until);
+        }
+        else
+        {
+            while (tstates < until && !halted)
+            {
+                bus->startAccesses(tstates);
+                execute(bus->read(PC));
+            }
+        }
+
+        if (sampling)
+        {
+            sampleInterrupt();
+        }
+    }
+
+    overshoot = tstates - deadline;
+    runDeadline = 0;
+    resolveFlags();
+#ifdef Z80_JIT
+    if (jitShadow)
+    {
+        syncJitShadow();
+    }
+#endif
+    return tstates - start;
+}
+
+// A halted CPU keeps executing NOPs, 4 T-states and a refresh each. Runs all
+// of those that start before until in one go.
+void z80::skipHalted(uint64_t until)
+{
+    uint64_t nops = (until - tstates + 3) / 4;
+    tstates += 4 * nops;
+    IncrementRefreshRegister(static_cast<int>(nops & 0x7F)); // R counts in 7 bits
+}
+
+// Runs one frame of the model on the bus. The ULA raises INT at the start of
+// every frame and drops it INT_LENGTH T-states later, both scheduled on the
+// bus by the first call so the frames line up with its runFor() budgets. A
+// change of model starts frames of the new length from here.
+uint64_t z80::runFrame()
+{
+    const uint32_t frameLength = bus->getFrameLength();
+    if (frameEvent >= 0 && frameEventLength != frameLength)
+    {
+        bus->scheduler.cancel(frameEvent);
+        frameEvent = -1;
+    }
+    if (frameEvent < 0)
+    {
+        CpuBus *ula = bus;
+        frameEvent = bus->scheduler.scheduleEvery(tstates - overshoot, frameLength, [ula](uint64_t when)
+                                                  {
+            ula->interrupt = true;
+            ula->scheduler.schedule(when + INT_LENGTH, [ula](uint64_t)
+                                    { ula->interrupt = false; }); });
+        frameEventLength = frameLength;
+    }
+    return runFor(frameLength);
+}
+
+void z80::runDueEvents()
+{
+    bus->scheduler.runDue(tstates);
+    sampleInterrupt();
+}
+
+void z80::sampleInterrupt()
+{
     handleInterrupt(interruptMode);
+#ifdef Z80_JIT
+    if (jitShadow)
+    {
+        jitShadow->bus->interrupt = bus->interrupt;
+        jitShadow->handleInterrupt(jitShadow->interruptMode);
+    }
+#endif
 }
 
 void z80::handleInterrupt(InterruptMode interruptMode)
@@ -27,7 +174,7 @@ void z80::handleInterrupt(InterruptMode interruptMode)
         halted = false;
         PC++;
     }
-    if (IFF1)
+    if (IFF1 && tstates != eiEndedAt)
     {
          IFF1 = IFF2 = false;
         switch (interruptMode)
@@ -36,8 +183,10 @@ void z80::handleInterrupt(InterruptMode interruptMode)
             break;
         case InterruptMode::Mode1:
             PC--;
+            bus->startAccesses(tstates + 7); // PC is pushed after 7 T-states
             pushPC();
             PC = 0x0038;
+            tstates += 13;
             break;
         case InterruptMode::Mode2:
             break;
@@ -50,23 +199,75 @@ void z80::handleInterrupt(InterruptMode interruptMode)
 }
 
 // Reset registers to default values
-void z80::reset(Bus *bus)
-{
-    A = A1 = 0xFF;
-    F = F1 = 0xFF;
-    B = C = D = E = H = L = 0x00;
-    B1 = C1 = D1 = E1 = H1 = L1 = 0x00;
-    I = R = 0x00;
-    IX = IY = 0x00;
-    PC = 0x0000;
+void z80::reset(CpuBus *bus)
+{
+    std::fill(std::begin(regs16), std::end(regs16), 0);
+    AF = AF1 = 0xFFFF;
     SP = 0xFFFF;
     interruptMode = InterruptMode::Mode0;
     halted = false;
     IFF1 = IFF2 =  false;
-
+    tstates = 0;
+    overshoot = 0;
+    eiEndedAt = UINT64_MAX;
+    runDeadline = 0;
+    decodeCache.clear(); // the generations belong to the old bus
+    decodeCacheHits = decodeCacheMisses = 0;
+    blockCache.clear();
+    blocksExecuted = blocksTranslated = blocksChained = 0;
+    fusedPairsRun = 0;
+    pairCounts.clear();
+    idleLoops.clear();
+    refreshReads = 0;
+    staticBlocks.clear();
+    staticGenerations.clear();
+    staticCounters.clear();
+    staticBlocksRun = 0;
+#ifdef Z80_JIT
+    jitCodeUsed = 0; // nothing refers to the old code any more
+    jitBlocksCompiled = jitBlocksRun = jitMismatches = 0;
+#endif
+#ifdef Z80_LAZY_FLAGS
+    lazyOp = FlagOp::None;
+#endif
+
+    // The frame interrupts were timed on the clock that just restarted
+    if (frameEvent >= 0)
+    {
+        this->bus->scheduler.cancel(frameEvent);
+        frameEvent = -1;
+    }
     this->bus = bus;
+    if (bus != nullptr)
+    {
+        bus->attachClock(&tstates);
+    }
+}
+
+// The handler's memory accesses come after the opcode fetches, 4 T-states
+// each, which is where a bus that times its accesses is told they start
+inline void z80::addBaseCycles(uint32_t cycles, int fetches)
+{
+    bus->startAccesses(tstates + 4 * fetches);
+    tstates += cycles;
+}
 
-    initializeInstructionTable();
+// executeTable() reads the opcode and prefix bytes of every instruction
+// through the bus. The engines that decode ahead of time read them with the
+// bare Bus::read() and charge the same reads here, with PC on the
+// instruction, each time they run it. opcodeRead when the caller already
+// read the first byte through the bus, as runFor() does for execute().
+inline void z80::chargeFetches(const DecodedInstruction &decoded, bool opcodeRead)
+{
+    if (!opcodeRead)
+    {
+        bus->startAccesses(tstates);
+        bus->fetch(PC);
+    }
+    if (decoded.prefixFetches > 0)
+        bus->fetch(PC + 1);
+    if (decoded.prefixFetches > 1)
+        bus->fetch(PC + 3); // The opcode after DD CB d
 }
 
 void z80::IncrementRefreshRegister(int steps)
@@ -89,143 +290,364 @@ void z80::IncrementRefreshRegister(int steps)
 // Read from a specific register
 uint8_t z80::readFromRegister(uint8_t regIndex)
 {
-    switch (regIndex)
-    {
-    case 0:
-        return B;
-    case 1:
-        return C;
-    case 2:
-        return D;
-    case 3:
-        return E;
-    case 4:
-        return H;
-    case 5:
-        return L;
-    case 7:
-        return A;
-    default:
-        return 0x00;
-    }
+    return regs8[readRegisterOffset[regIndex & 0x07]];
 }
 
 // Write to a specific register
 void z80::writeToRegister(uint8_t regIndex, uint8_t value)
 {
-    switch (regIndex)
+    regs8[writeRegisterOffset[regIndex & 0x07]] = value;
+}
+
+// Flag lookup tables, built at compile time so every ALU handler sets its
+// flags with a single load instead of a chain of branches.
+//
+//   szxypTable[v]                     S, Z, X, U and even parity of v
+//   incFlagsTable[v], decFlagsTable[v] F after INC/DEC v, except C
+//   addFlagsTable[c << 16 | a << 8 | b] F after ADD/ADC a, b with carry in c
+//   subFlagsTable[c << 16 | a << 8 | b] F after SUB/SBC a, b with carry in c
+//   cpFlagsTable[a << 8 | b]          F after CP b with A = a
+//
+// Only the flags are stored, the result itself is a single add or subtract.
+namespace
+{
+using ByteFlagTable = std::array<uint8_t, 0x100>;
+using CpFlagTable = std::array<uint8_t, 0x10000>;
+using CarryFlagTable = std::array<uint8_t, 0x20000>;
+
+constexpr uint8_t szxyFlags(uint8_t value)
+{
+    return (value & (z80::S | z80::X | z80::U)) | (value == 0 ? z80::Z : 0);
+}
+
+constexpr ByteFlagTable buildSZXYPTable()
+{
+    ByteFlagTable table{};
+    for (int value = 0; value < 0x100; ++value)
     {
-    case 0:
-        B = value;
-        break;
-    case 1:
-        C = value;
-        break;
-    case 2:
-        D = value;
-        break;
-    case 3:
-        E = value;
-        break;
-    case 4:
-        H = value;
-        break;
-    case 5:
-        L = value;
-        break;
-    case 6:
-        F = value;
-        break;
-    case 7:
-        A = value;
-        break;
-    default:
-        throw std::invalid_argument("Invalid register index");
+        int bits = 0;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            bits += (value >> bit) & 1;
+        }
+        table[value] = szxyFlags(value) | ((bits & 1) == 0 ? z80::P : 0);
+    }
+    return table;
+}
+
+constexpr ByteFlagTable buildIncFlagsTable()
+{
+    ByteFlagTable table{};
+    for (int value = 0; value < 0x100; ++value)
+    {
+        uint8_t flags = szxyFlags(value + 1);
+        if ((value & 0x0F) == 0x0F)
+            flags |= z80::H_flag;
+        if (value == 0x7F)
+            flags |= z80::P;
+        table[value] = flags;
+    }
+    return table;
+}
+
+constexpr ByteFlagTable buildDecFlagsTable()
+{
+    ByteFlagTable table{};
+    for (int value = 0; value < 0x100; ++value)
+    {
+        uint8_t flags = szxyFlags(value - 1) | z80::N;
+        if ((value & 0x0F) == 0x00)
+            flags |= z80::H_flag;
+        if (value == 0x80)
+            flags |= z80::P;
+        table[value] = flags;
+    }
+    return table;
+}
+
+constexpr CarryFlagTable buildAddFlagsTable()
+{
+    CarryFlagTable table{};
+    for (int carry = 0; carry < 2; ++carry)
+    {
+        for (int a = 0; a < 0x100; ++a)
+        {
+            for (int b = 0; b < 0x100; ++b)
+            {
+                int sum = a + b + carry;
+                uint8_t result = sum & 0xFF;
+                uint8_t flags = szxyFlags(result);
+                if ((a & 0x0F) + (b & 0x0F) + carry > 0x0F)
+                    flags |= z80::H_flag;
+                if (sum > 0xFF)
+                    flags |= z80::C_flag;
+                if ((~(a ^ b) & (a ^ result) & 0x80) != 0)
+                    flags |= z80::P;
+                table[(carry << 16) | (a << 8) | b] = flags;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr CarryFlagTable buildSubFlagsTable()
+{
+    CarryFlagTable table{};
+    for (int carry = 0; carry < 2; ++carry)
+    {
+        for (int a = 0; a < 0x100; ++a)
+        {
+            for (int b = 0; b < 0x100; ++b)
+            {
+                int diff = a - b - carry;
+                uint8_t result = diff & 0xFF;
+                uint8_t flags = szxyFlags(result) | z80::N;
+                if ((a & 0x0F) - (b & 0x0F) - carry < 0)
+                    flags |= z80::H_flag;
+                if (diff < 0)
+                    flags |= z80::C_flag;
+                if (((a ^ b) & (a ^ result) & 0x80) != 0)
+                    flags |= z80::P;
+                table[(carry << 16) | (a << 8) | b] = flags;
+            }
+        }
     }
+    return table;
+}
+
+constexpr CpFlagTable buildCpFlagsTable()
+{
+    CpFlagTable table{};
+    for (int a = 0; a < 0x100; ++a)
+    {
+        for (int b = 0; b < 0x100; ++b)
+        {
+            uint8_t result = (a - b) & 0xFF;
+            // X and U come from the operand, not the result
+            uint8_t flags = (szxyFlags(result) & (z80::S | z80::Z)) | (b & (z80::X | z80::U)) | z80::N;
+            if ((a & 0x0F) < (b & 0x0F))
+                flags |= z80::H_flag;
+            if (a < b)
+                flags |= z80::C_flag;
+            if (((a ^ b) & (a ^ result) & 0x80) != 0)
+                flags |= z80::P;
+            table[(a << 8) | b] = flags;
+        }
+    }
+    return table;
+}
+
+constexpr ByteFlagTable szxypTable = buildSZXYPTable();
+constexpr ByteFlagTable incFlagsTable = buildIncFlagsTable();
+constexpr ByteFlagTable decFlagsTable = buildDecFlagsTable();
+constexpr CarryFlagTable addFlagsTable = buildAddFlagsTable();
+constexpr CarryFlagTable subFlagsTable = buildSubFlagsTable();
+constexpr CpFlagTable cpFlagsTable = buildCpFlagsTable();
 }
 
 // Set a flag in F
 void z80::setFlag(uint8_t flagMask)
 {
+    resolveFlags();
     F |= flagMask; // Set the specified flag(s)
 }
 
 // Clear (reset) a flag in F
 void z80::clearFlag(uint8_t flagMask)
 {
+    resolveFlags();
     F &= ~flagMask; // Clear the specified flag(s)
 }
 
 // Toggle a flag in F
 void z80::toggleFlag(uint8_t flagMask)
 {
+    resolveFlags();
     F ^= flagMask; // Toggle the specified flag(s)
 }
 
 bool z80::isFlagSet(uint8_t flagMask) const
 {
+#ifdef Z80_LAZY_FLAGS
+    if (lazyOp != FlagOp::None)
+    {
+        // Z and C are by far the most read flags and need no full rebuild
+        if (flagMask == Z)
+        {
+            return lazyResult == 0;
+        }
+        if (flagMask == C_flag)
+        {
+            switch (lazyOp)
+            {
+            case FlagOp::Add:
+                return lazyA + lazyB > 0xFF;
+            case FlagOp::Sub:
+            case FlagOp::Cp:
+                return lazyA < lazyB;
+            case FlagOp::And:
+            case FlagOp::Or:
+            case FlagOp::Xor:
+                return false;
+            case FlagOp::Inc:
+            case FlagOp::Dec:
+                return (F & C_flag) != 0;
+            default:
+                break;
+            }
+        }
+        return (computeFlags(lazyOp, lazyA, lazyB, lazyResult) & flagMask) != 0;
+    }
+#endif
     return (F & flagMask) != 0; // Check if the flag is set
 }
 
-// Initialize the instruction table
-void z80::initializeInstructionTable()
+// Writes the flags of the last deferred ALU operation to F
+void z80::resolveFlags()
+{
+#ifdef Z80_LAZY_FLAGS
+    if (lazyOp != FlagOp::None)
+    {
+        F = computeFlags(lazyOp, lazyA, lazyB, lazyResult);
+        lazyOp = FlagOp::None;
+    }
+#endif
+}
+
+uint8_t z80::getF()
+{
+    resolveFlags();
+    return F;
+}
+
+void z80::setF(uint8_t value)
+{
+#ifdef Z80_LAZY_FLAGS
+    lazyOp = FlagOp::None;
+#endif
+    F = value;
+}
+
+// Sets the flags of an 8-bit ALU operation. In lazy mode only the operands
+// are recorded and F is built when a flag is read.
+void z80::updateFlags(FlagOp op, uint8_t a, uint8_t b, uint8_t result)
+{
+#ifdef Z80_LAZY_FLAGS
+    if (op == FlagOp::Inc || op == FlagOp::Dec)
+    {
+        resolveFlags(); // INC and DEC keep the carry of the previous F
+    }
+    lazyOp = op;
+    lazyA = a;
+    lazyB = b;
+    lazyResult = result;
+#else
+    F = computeFlags(op, a, b, result);
+#endif
+}
+
+// F after an 8-bit ALU operation. For INC and DEC, a is the value before the
+// operation; the logic operations only use the result.
+uint8_t z80::computeFlags(FlagOp op, uint8_t a, uint8_t b, uint8_t result) const
+{
+    switch (op)
+    {
+    case FlagOp::Add:
+        return addFlagsTable[(a << 8) | b];
+    case FlagOp::Adc:
+        // The carry that went in is whatever the plain sum is missing
+        return addFlagsTable[(((result - a - b) & 1) << 16) | (a << 8) | b];
+    case FlagOp::Sub:
+        return subFlagsTable[(a << 8) | b];
+    case FlagOp::Sbc:
+        return subFlagsTable[(((a - b - result) & 1) << 16) | (a << 8) | b];
+    case FlagOp::Cp:
+        return cpFlagsTable[(a << 8) | b];
+    case FlagOp::And:
+        return szxypTable[result] | H_flag;
+    case FlagOp::Or:
+    case FlagOp::Xor:
+        return szxypTable[result];
+    case FlagOp::Inc:
+        return incFlagsTable[a] | (F & C_flag);
+    case FlagOp::Dec:
+        return decFlagsTable[a] | (F & C_flag);
+    default:
+        return F;
+    }
+}
+
+// Replaces every flag outside keepMask
+void z80::replaceFlags(uint8_t keepMask, uint8_t flags)
+{
+    resolveFlags();
+    F = (F & keepMask) | flags;
+}
+
+// The decode tables are built once at compile time and shared read-only by
+// every z80 instance, so constructing or resetting a CPU only touches registers.
+namespace
 {
+constexpr InstructionTable buildInstructionTable()
+{
+    InstructionTable instructionTable{};
+
     // Populate instructionTable for main opcodes
-    instructionTable[0x40] = Instruction("LD B, B", &z80::LD_R_R, 4);
-    instructionTable[0x41] = Instruction("LD B, C", &z80::LD_R_R, 4);
-    instructionTable[0x42] = Instruction("LD B, D", &z80::LD_R_R, 4);
-    instructionTable[0x43] = Instruction("LD B, E", &z80::LD_R_R, 4);
-    instructionTable[0x44] = Instruction("LD B, H", &z80::LD_R_R, 4);
-    instructionTable[0x45] = Instruction("LD B, L", &z80::LD_R_R, 4);
-    instructionTable[0x47] = Instruction("LD B, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x48] = Instruction("LD C, B", &z80::LD_R_R, 4);
-    instructionTable[0x49] = Instruction("LD C, C", &z80::LD_R_R, 4);
-    instructionTable[0x4A] = Instruction("LD C, D", &z80::LD_R_R, 4);
-    instructionTable[0x4B] = Instruction("LD C, E", &z80::LD_R_R, 4);
-    instructionTable[0x4C] = Instruction("LD C, H", &z80::LD_R_R, 4);
-    instructionTable[0x4D] = Instruction("LD C, L", &z80::LD_R_R, 4);
-    instructionTable[0x4F] = Instruction("LD C, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x78] = Instruction("LD A, B", &z80::LD_R_R, 4);
-    instructionTable[0x79] = Instruction("LD A, C", &z80::LD_R_R, 4);
-    instructionTable[0x7A] = Instruction("LD A, D", &z80::LD_R_R, 4);
-    instructionTable[0x7B] = Instruction("LD A, E", &z80::LD_R_R, 4);
-    instructionTable[0x7C] = Instruction("LD A, H", &z80::LD_R_R, 4);
-    instructionTable[0x7D] = Instruction("LD A, L", &z80::LD_R_R, 4);
-    instructionTable[0x7F] = Instruction("LD A, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x50] = Instruction("LD D, B", &z80::LD_R_R, 4);
-    instructionTable[0x51] = Instruction("LD D, C", &z80::LD_R_R, 4);
-    instructionTable[0x52] = Instruction("LD D, D", &z80::LD_R_R, 4);
-    instructionTable[0x53] = Instruction("LD D, E", &z80::LD_R_R, 4);
-    instructionTable[0x54] = Instruction("LD D, H", &z80::LD_R_R, 4);
-    instructionTable[0x55] = Instruction("LD D, L", &z80::LD_R_R, 4);
-    instructionTable[0x57] = Instruction("LD D, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x58] = Instruction("LD E, B", &z80::LD_R_R, 4);
-    instructionTable[0x59] = Instruction("LD E, C", &z80::LD_R_R, 4);
-    instructionTable[0x5A] = Instruction("LD E, D", &z80::LD_R_R, 4);
-    instructionTable[0x5B] = Instruction("LD E, E", &z80::LD_R_R, 4);
-    instructionTable[0x5C] = Instruction("LD E, H", &z80::LD_R_R, 4);
-    instructionTable[0x5D] = Instruction("LD E, L", &z80::LD_R_R, 4);
-    instructionTable[0x5F] = Instruction("LD E, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x60] = Instruction("LD H, B", &z80::LD_R_R, 4);
-    instructionTable[0x61] = Instruction("LD H, C", &z80::LD_R_R, 4);
-    instructionTable[0x62] = Instruction("LD H, D", &z80::LD_R_R, 4);
-    instructionTable[0x63] = Instruction("LD H, E", &z80::LD_R_R, 4);
-    instructionTable[0x64] = Instruction("LD H, H", &z80::LD_R_R, 4);
-    instructionTable[0x65] = Instruction("LD H, L", &z80::LD_R_R, 4);
-    instructionTable[0x67] = Instruction("LD H, A", &z80::LD_R_R, 4);
-
-    instructionTable[0x68] = Instruction("LD L, B", &z80::LD_R_R, 4);
-    instructionTable[0x69] = Instruction("LD L, C", &z80::LD_R_R, 4);
-    instructionTable[0x6A] = Instruction("LD L, D", &z80::LD_R_R, 4);
-    instructionTable[0x6B] = Instruction("LD L, E", &z80::LD_R_R, 4);
-    instructionTable[0x6C] = Instruction("LD L, H", &z80::LD_R_R, 4);
-    instructionTable[0x6D] = Instruction("LD L, L", &z80::LD_R_R, 4);
-    instructionTable[0x6F] = Instruction("LD L, A", &z80::LD_R_R, 4);
+    instructionTable[0x40] = Instruction("LD B, B", &z80::LD_R_R<0, 0>, 4);
+    instructionTable[0x41] = Instruction("LD B, C", &z80::LD_R_R<0, 1>, 4);
+    instructionTable[0x42] = Instruction("LD B, D", &z80::LD_R_R<0, 2>, 4);
+    instructionTable[0x43] = Instruction("LD B, E", &z80::LD_R_R<0, 3>, 4);
+    instructionTable[0x44] = Instruction("LD B, H", &z80::LD_R_R<0, 4>, 4);
+    instructionTable[0x45] = Instruction("LD B, L", &z80::LD_R_R<0, 5>, 4);
+    instructionTable[0x47] = Instruction("LD B, A", &z80::LD_R_R<0, 7>, 4);
+
+    instructionTable[0x48] = Instruction("LD C, B", &z80::LD_R_R<1, 0>, 4);
+    instructionTable[0x49] = Instruction("LD C, C", &z80::LD_R_R<1, 1>, 4);
+    instructionTable[0x4A] = Instruction("LD C, D", &z80::LD_R_R<1, 2>, 4);
+    instructionTable[0x4B] = Instruction("LD C, E", &z80::LD_R_R<1, 3>, 4);
+    instructionTable[0x4C] = Instruction("LD C, H", &z80::LD_R_R<1, 4>, 4);
+    instructionTable[0x4D] = Instruction("LD C, L", &z80::LD_R_R<1, 5>, 4);
+    instructionTable[0x4F] = Instruction("LD C, A", &z80::LD_R_R<1, 7>, 4);
+
+    instructionTable[0x78] = Instruction("LD A, B", &z80::LD_R_R<7, 0>, 4);
+    instructionTable[0x79] = Instruction("LD A, C", &z80::LD_R_R<7, 1>, 4);
+    instructionTable[0x7A] = Instruction("LD A, D", &z80::LD_R_R<7, 2>, 4);
+    instructionTable[0x7B] = Instruction("LD A, E", &z80::LD_R_R<7, 3>, 4);
+    instructionTable[0x7C] = Instruction("LD A, H", &z80::LD_R_R<7, 4>, 4);
+    instructionTable[0x7D] = Instruction("LD A, L", &z80::LD_R_R<7, 5>, 4);
+    instructionTable[0x7F] = Instruction("LD A, A", &z80::LD_R_R<7, 7>, 4);
+
+    instructionTable[0x50] = Instruction("LD D, B", &z80::LD_R_R<2, 0>, 4);
+    instructionTable[0x51] = Instruction("LD D, C", &z80::LD_R_R<2, 1>, 4);
+    instructionTable[0x52] = Instruction("LD D, D", &z80::LD_R_R<2, 2>, 4);
+    instructionTable[0x53] = Instruction("LD D, E", &z80::LD_R_R<2, 3>, 4);
+    instructionTable[0x54] = Instruction("LD D, H", &z80::LD_R_R<2, 4>, 4);
+    instructionTable[0x55] = Instruction("LD D, L", &z80::LD_R_R<2, 5>, 4);
+    instructionTable[0x57] = Instruction("LD D, A", &z80::LD_R_R<2, 7>, 4);
+
+    instructionTable[0x58] = Instruction("LD E, B", &z80::LD_R_R<3, 0>, 4);
+    instructionTable[0x59] = Instruction("LD E, C", &z80::LD_R_R<3, 1>, 4);
+    instructionTable[0x5A] = Instruction("LD E, D", &z80::LD_R_R<3, 2>, 4);
+    instructionTable[0x5B] = Instruction("LD E, E", &z80::LD_R_R<3, 3>, 4);
+    instructionTable[0x5C] = Instruction("LD E, H", &z80::LD_R_R<3, 4>, 4);
+    instructionTable[0x5D] = Instruction("LD E, L", &z80::LD_R_R<3, 5>, 4);
+    instructionTable[0x5F] = Instruction("LD E, A", &z80::LD_R_R<3, 7>, 4);
+
+    instructionTable[0x60] = Instruction("LD H, B", &z80::LD_R_R<4, 0>, 4);
+    instructionTable[0x61] = Instruction("LD H, C", &z80::LD_R_R<4, 1>, 4);
+    instructionTable[0x62] = Instruction("LD H, D", &z80::LD_R_R<4, 2>, 4);
+    instructionTable[0x63] = Instruction("LD H, E", &z80::LD_R_R<4, 3>, 4);
+    instructionTable[0x64] = Instruction("LD H, H", &z80::LD_R_R<4, 4>, 4);
+    instructionTable[0x65] = Instruction("LD H, L", &z80::LD_R_R<4, 5>, 4);
+    instructionTable[0x67] = Instruction("LD H, A", &z80::LD_R_R<4, 7>, 4);
+
+    instructionTable[0x68] = Instruction("LD L, B", &z80::LD_R_R<5, 0>, 4);
+    instructionTable[0x69] = Instruction("LD L, C", &z80::LD_R_R<5, 1>, 4);
+    instructionTable[0x6A] = Instruction("LD L, D", &z80::LD_R_R<5, 2>, 4);
+    instructionTable[0x6B] = Instruction("LD L, E", &z80::LD_R_R<5, 3>, 4);
+    instructionTable[0x6C] = Instruction("LD L, H", &z80::LD_R_R<5, 4>, 4);
+    instructionTable[0x6D] = Instruction("LD L, L", &z80::LD_R_R<5, 5>, 4);
+    instructionTable[0x6F] = Instruction("LD L, A", &z80::LD_R_R<5, 7>, 4);
     // Load immediate values into registers
     instructionTable[0x06] = Instruction("LD B, n", &z80::LD_R_N, 7);
     instructionTable[0x0E] = Instruction("LD C, n", &z80::LD_R_N, 7);
@@ -238,21 +660,21 @@ void z80::initializeInstructionTable()
     instructionTable[0x0A] = Instruction("LD A, BC", &z80::LD_A_BC, 7);
     instructionTable[0x1A] = Instruction("LD A, DE", &z80::LD_A_DE, 7);
     instructionTable[0x12] = Instruction("LD (DE), A", &z80::LD_DE_A, 7);
-    instructionTable[0x02] = Instruction("LD (BC), A", &z80::LD_BC_A, 4);
-    instructionTable[0x3A] = Instruction("LD A, (nn)", &z80::LD_A_NN, 7);
-    instructionTable[0x32] = Instruction("LD (nn), A", &z80::LD_NN_A, 7);
-
-    instructionTable[0x70] = Instruction("LD (HL), B", &z80::LD_HL_R, 4);
-    instructionTable[0x71] = Instruction("LD (HL), C", &z80::LD_HL_R, 4);
-    instructionTable[0x72] = Instruction("LD (HL), D", &z80::LD_HL_R, 4);
-    instructionTable[0x73] = Instruction("LD (HL), E", &z80::LD_HL_R, 4);
-    instructionTable[0x74] = Instruction("LD (HL), H", &z80::LD_HL_R, 4);
-    instructionTable[0x75] = Instruction("LD (HL), L", &z80::LD_HL_R, 4);
-    instructionTable[0x77] = Instruction("LD (HL), A", &z80::LD_HL_R, 4);
+    instructionTable[0x02] = Instruction("LD (BC), A", &z80::LD_BC_A, 7);
+    instructionTable[0x3A] = Instruction("LD A, (nn)", &z80::LD_A_NN, 13);
+    instructionTable[0x32] = Instruction("LD (nn), A", &z80::LD_NN_A, 13);
+
+    instructionTable[0x70] = Instruction("LD (HL), B", &z80::LD_HL_R, 7);
+    instructionTable[0x71] = Instruction("LD (HL), C", &z80::LD_HL_R, 7);
+    instructionTable[0x72] = Instruction("LD (HL), D", &z80::LD_HL_R, 7);
+    instructionTable[0x73] = Instruction("LD (HL), E", &z80::LD_HL_R, 7);
+    instructionTable[0x74] = Instruction("LD (HL), H", &z80::LD_HL_R, 7);
+    instructionTable[0x75] = Instruction("LD (HL), L", &z80::LD_HL_R, 7);
+    instructionTable[0x77] = Instruction("LD (HL), A", &z80::LD_HL_R, 7);
 
     instructionTable[0x21] = Instruction("LD HL, nn", &z80::LD_DD_NN, 10);
-    instructionTable[0x2A] = Instruction("LD HL, (nn)", &z80::LD_HL_NN, 10);
-    instructionTable[0x22] = Instruction("LD (nn), HL", &z80::LD_NN_HL, 10);
+    instructionTable[0x2A] = Instruction("LD HL, (nn)", &z80::LD_HL_NN, 16);
+    instructionTable[0x22] = Instruction("LD (nn), HL", &z80::LD_NN_HL, 16);
 
     instructionTable[0x01] = Instruction("LD BC, nn", &z80::LD_DD_NN, 10);
     instructionTable[0x11] = Instruction("LD DE, nn", &z80::LD_DD_NN, 10);
@@ -268,154 +690,154 @@ void z80::initializeInstructionTable()
 
     instructionTable[0x36] = Instruction("LD (HL), n", &z80::LD_HL_N, 10);
 
-    instructionTable[0xF9] = Instruction("LD SP, HL", &z80::LD_SP_HL, 10);
+    instructionTable[0xF9] = Instruction("LD SP, HL", &z80::LD_SP_HL, 6);
 
-    instructionTable[0xC5] = Instruction("PUSH BC", &z80::PUSH_QQ, 10);
-    instructionTable[0xD5] = Instruction("PUSH DE", &z80::PUSH_QQ, 10);
-    instructionTable[0xE5] = Instruction("PUSH HL", &z80::PUSH_QQ, 10);
-    instructionTable[0xF5] = Instruction("PUSH AF", &z80::PUSH_QQ, 10);
+    instructionTable[0xC5] = Instruction("PUSH BC", &z80::PUSH_QQ, 11);
+    instructionTable[0xD5] = Instruction("PUSH DE", &z80::PUSH_QQ, 11);
+    instructionTable[0xE5] = Instruction("PUSH HL", &z80::PUSH_QQ, 11);
+    instructionTable[0xF5] = Instruction("PUSH AF", &z80::PUSH_QQ, 11);
 
     instructionTable[0xC1] = Instruction("POP BC", &z80::POP_QQ, 10);
     instructionTable[0xD1] = Instruction("POP DE", &z80::POP_QQ, 10);
     instructionTable[0xE1] = Instruction("POP HL", &z80::POP_QQ, 10);
     instructionTable[0xF1] = Instruction("POP AF", &z80::POP_QQ, 10);
-    instructionTable[0xEB] = Instruction("EX DE ,HL", &z80::EX_DE_HL, 10);
-    instructionTable[0x08] = Instruction("EX AF ,AF' ", &z80::EX_AF_AF1, 10);
-    instructionTable[0xD9] = Instruction("EXX ", &z80::EXX, 10);
-    instructionTable[0xE3] = Instruction("EX_(SP), HL ", &z80::EX_SP_HL, 10);
-
-    instructionTable[0x80] = Instruction("ADD A ,B ", &z80::ADD_A_R, 10);
-    instructionTable[0x81] = Instruction("ADD A, C ", &z80::ADD_A_R, 10);
-    instructionTable[0x82] = Instruction("ADD A, D ", &z80::ADD_A_R, 10);
-    instructionTable[0x83] = Instruction("ADD A, E ", &z80::ADD_A_R, 10);
-    instructionTable[0x84] = Instruction("ADD A, H ", &z80::ADD_A_R, 10);
-    instructionTable[0x85] = Instruction("ADD A, L ", &z80::ADD_A_R, 10);
-    instructionTable[0x87] = Instruction("ADD A, A ", &z80::ADD_A_R, 10);
-
-    instructionTable[0xC6] = Instruction("ADD A, n ", &z80::ADD_A_N, 10);
-
-    instructionTable[0x86] = Instruction("ADD A, (HL) ", &z80::ADD_A_HL, 10);
-
-    instructionTable[0x88] = Instruction("ADC A ,B ", &z80::ADC_A_s, 10);
-    instructionTable[0x89] = Instruction("ADC A, C ", &z80::ADC_A_s, 10);
-    instructionTable[0x8A] = Instruction("ADC A, D ", &z80::ADC_A_s, 10);
-    instructionTable[0x8B] = Instruction("ADC A, E ", &z80::ADC_A_s, 10);
-    instructionTable[0x8C] = Instruction("ADC A, H ", &z80::ADC_A_s, 10);
-    instructionTable[0x8D] = Instruction("ADC A, L ", &z80::ADC_A_s, 10);
-    instructionTable[0x8F] = Instruction("ADC A, A ", &z80::ADC_A_s, 10);
-
-    instructionTable[0xCE] = Instruction("ADC A, n ", &z80::ADC_A_N, 10);
-    instructionTable[0x8E] = Instruction("ADC A, (HL) ", &z80::ADC_A_HL, 10);
-
-    instructionTable[0x90] = Instruction("SUB A ,B ", &z80::SUB_A_R, 10);
-    instructionTable[0x91] = Instruction("SUB A, C ", &z80::SUB_A_R, 10);
-    instructionTable[0x92] = Instruction("SUB A, D ", &z80::SUB_A_R, 10);
-    instructionTable[0x93] = Instruction("SUB A, E ", &z80::SUB_A_R, 10);
-    instructionTable[0x94] = Instruction("SUB A, H ", &z80::SUB_A_R, 10);
-    instructionTable[0x95] = Instruction("SUB A, L ", &z80::SUB_A_R, 10);
-    instructionTable[0x97] = Instruction("SUB A, A ", &z80::SUB_A_R, 10);
-
-    instructionTable[0x98] = Instruction("SBC A ,B ", &z80::SBC_A_S, 10);
-    instructionTable[0x99] = Instruction("SBC A, C ", &z80::SBC_A_S, 10);
-    instructionTable[0x9A] = Instruction("SBC A, D ", &z80::SBC_A_S, 10);
-    instructionTable[0x9B] = Instruction("SBC A, E ", &z80::SBC_A_S, 10);
-    instructionTable[0x9C] = Instruction("SBC A, H ", &z80::SBC_A_S, 10);
-    instructionTable[0x9D] = Instruction("SBC A, L ", &z80::SBC_A_S, 10);
-    instructionTable[0x9F] = Instruction("SBC A, A ", &z80::SBC_A_S, 10);
-
-    instructionTable[0xA0] = Instruction("AND A ,B ", &z80::AND_A_R, 10);
-    instructionTable[0xA1] = Instruction("AND A, C ", &z80::AND_A_R, 10);
-    instructionTable[0xA2] = Instruction("AND A, D ", &z80::AND_A_R, 10);
-    instructionTable[0xA3] = Instruction("AND A, E ", &z80::AND_A_R, 10);
-    instructionTable[0xA4] = Instruction("AND A, H ", &z80::AND_A_R, 10);
-    instructionTable[0xA5] = Instruction("AND A, L ", &z80::AND_A_R, 10);
-    instructionTable[0xA7] = Instruction("AND A, A ", &z80::AND_A_R, 10);
-
-    instructionTable[0xB0] = Instruction("OR A ,B ", &z80::OR_A_R, 10);
-    instructionTable[0xB1] = Instruction("OR A, C ", &z80::OR_A_R, 10);
-    instructionTable[0xB2] = Instruction("OR A, D ", &z80::OR_A_R, 10);
-    instructionTable[0xB3] = Instruction("OR A, E ", &z80::OR_A_R, 10);
-    instructionTable[0xB4] = Instruction("OR A, H ", &z80::OR_A_R, 10);
-    instructionTable[0xB5] = Instruction("OR A, L ", &z80::OR_A_R, 10);
-    instructionTable[0xB7] = Instruction("OR A, A ", &z80::OR_A_R, 10);
-
-    instructionTable[0xA8] = Instruction("XOR A ,B ", &z80::XOR_A_R, 10);
-    instructionTable[0xA9] = Instruction("XOR A, C ", &z80::XOR_A_R, 10);
-    instructionTable[0xAA] = Instruction("XOR A, D ", &z80::XOR_A_R, 10);
-    instructionTable[0xAB] = Instruction("XOR A, E ", &z80::XOR_A_R, 10);
-    instructionTable[0xAC] = Instruction("XOR A, H ", &z80::XOR_A_R, 10);
-    instructionTable[0xAD] = Instruction("XOR A, L ", &z80::XOR_A_R, 10);
-    instructionTable[0xAF] = Instruction("XOR A, A ", &z80::XOR_A_R, 10);
-
-    instructionTable[0xB8] = Instruction("CP ,B ", &z80::CP_R, 10);
-    instructionTable[0xB9] = Instruction("CP, C ", &z80::CP_R, 10);
-    instructionTable[0xBA] = Instruction("CP, D ", &z80::CP_R, 10);
-    instructionTable[0xBB] = Instruction("CP, E ", &z80::CP_R, 10);
-    instructionTable[0xBC] = Instruction("CP, H ", &z80::CP_R, 10);
-    instructionTable[0xBD] = Instruction("CP, L ", &z80::CP_R, 10);
-    instructionTable[0xBF] = Instruction("CP, A ", &z80::CP_R, 10);
-
-    instructionTable[0x04] = Instruction("INC ,B ", &z80::INC_R, 10);
-    instructionTable[0x0C] = Instruction("INC, C ", &z80::INC_R, 10);
-    instructionTable[0x14] = Instruction("INC, D ", &z80::INC_R, 10);
-    instructionTable[0x1C] = Instruction("INC, E ", &z80::INC_R, 10);
-    instructionTable[0x24] = Instruction("INC, H ", &z80::INC_R, 10);
-    instructionTable[0x2C] = Instruction("INC, L ", &z80::INC_R, 10);
-    instructionTable[0x3C] = Instruction("INC, A ", &z80::INC_R, 10);
-
-    instructionTable[0x05] = Instruction("DEC ,B ", &z80::DEC_R, 10);
-    instructionTable[0x0D] = Instruction("DEC, C ", &z80::DEC_R, 10);
-    instructionTable[0x15] = Instruction("DEC, D ", &z80::DEC_R, 10);
-    instructionTable[0x1D] = Instruction("DEC, E ", &z80::DEC_R, 10);
-    instructionTable[0x25] = Instruction("DEC, H ", &z80::DEC_R, 10);
-    instructionTable[0x2D] = Instruction("DEC, L ", &z80::DEC_R, 10);
-    instructionTable[0x3D] = Instruction("DEC, A ", &z80::DEC_R, 10);
-
-    instructionTable[0xD6] = Instruction("SUB A, n ", &z80::SUB_A_N, 10);
-    instructionTable[0xDE] = Instruction("SBC A, n ", &z80::SBC_A_N, 10);
-    instructionTable[0xE6] = Instruction("AND A, n ", &z80::AND_A_N, 10);
-    instructionTable[0xF6] = Instruction("OR A, n ", &z80::OR_A_N, 10);
-    instructionTable[0xEE] = Instruction("XOR A, n ", &z80::XOR_A_N, 10);
-    instructionTable[0xFE] = Instruction("CP, n ", &z80::CP_N, 10);
-
-    instructionTable[0x96] = Instruction("SUB A, (HL) ", &z80::SUB_A_HL, 10);
-    instructionTable[0x9E] = Instruction("SBC A, (HL) ", &z80::SBC_A_HL, 10);
-    instructionTable[0xA6] = Instruction("AND A, (HL) ", &z80::AND_A_HL, 10);
-    instructionTable[0xB6] = Instruction("OR A, (HL) ", &z80::OR_A_HL, 10);
-    instructionTable[0xAE] = Instruction("XOR A, (HL) ", &z80::XOR_A_HL, 10);
-    instructionTable[0xBE] = Instruction("CP, (HL) ", &z80::CP_HL, 10);
-
-    instructionTable[0x34] = Instruction("INC, (HL) ", &z80::INC_HL, 10);
-    instructionTable[0x35] = Instruction("DEC, (HL) ", &z80::DEC_HL, 10);
-    instructionTable[0x27] = Instruction("DAA ", &z80::DAA, 10);
-    instructionTable[0x2F] = Instruction("CPL ", &z80::CPL, 10);
-    instructionTable[0x3F] = Instruction("CCF", &z80::CCF, 10);
-    instructionTable[0x37] = Instruction("SCF", &z80::SCF, 10);
-    instructionTable[0x00] = Instruction("NOP", &z80::NOP, 10);
-
-    instructionTable[0x76] = Instruction("HALT", &z80::HALT, 10);
-    instructionTable[0xF3] = Instruction("DI", &z80::DI, 10);
-    instructionTable[0xFB] = Instruction("EI", &z80::EI, 10);
-
-    instructionTable[0x09] = Instruction("ADD HL, BC", &z80::ADD_HL_SS, 10);
-    instructionTable[0x19] = Instruction("ADD HL, DE", &z80::ADD_HL_SS, 10);
-    instructionTable[0x29] = Instruction("ADD HL, HL", &z80::ADD_HL_SS, 10);
-    instructionTable[0x39] = Instruction("ADD HL, SP", &z80::ADD_HL_SS, 10);
-
-    instructionTable[0x03] = Instruction("INC BC", &z80::INC_SS, 10);
-    instructionTable[0x13] = Instruction("INC DE", &z80::INC_SS, 10);
-    instructionTable[0x23] = Instruction("INC HL", &z80::INC_SS, 10);
-    instructionTable[0x33] = Instruction("INC SP", &z80::INC_SS, 10);
-
-    instructionTable[0x0B] = Instruction("DEC BC", &z80::DEC_SS, 10);
-    instructionTable[0x1B] = Instruction("DEC DE", &z80::DEC_SS, 10);
-    instructionTable[0x2B] = Instruction("DEC HL", &z80::DEC_SS, 10);
-    instructionTable[0x3B] = Instruction("DEC SP", &z80::DEC_SS, 10);
-
-    instructionTable[0x07] = Instruction("RLCA", &z80::RLCA, 10);
-    instructionTable[0x17] = Instruction("RLA", &z80::RLA, 10);
-    instructionTable[0x0F] = Instruction("RRCA", &z80::RRCA, 10);
-    instructionTable[0x1F] = Instruction("RRA", &z80::RRA, 10);
+    instructionTable[0xEB] = Instruction("EX DE ,HL", &z80::EX_DE_HL, 4);
+    instructionTable[0x08] = Instruction("EX AF ,AF' ", &z80::EX_AF_AF1, 4);
+    instructionTable[0xD9] = Instruction("EXX ", &z80::EXX, 4);
+    instructionTable[0xE3] = Instruction("EX_(SP), HL ", &z80::EX_SP_HL, 19);
+
+    instructionTable[0x80] = Instruction("ADD A ,B ", &z80::ADD_A_R<0>, 4);
+    instructionTable[0x81] = Instruction("ADD A, C ", &z80::ADD_A_R<1>, 4);
+    instructionTable[0x82] = Instruction("ADD A, D ", &z80::ADD_A_R<2>, 4);
+    instructionTable[0x83] = Instruction("ADD A, E ", &z80::ADD_A_R<3>, 4);
+    instructionTable[0x84] = Instruction("ADD A, H ", &z80::ADD_A_R<4>, 4);
+    instructionTable[0x85] = Instruction("ADD A, L ", &z80::ADD_A_R<5>, 4);
+    instructionTable[0x87] = Instruction("ADD A, A ", &z80::ADD_A_R<7>, 4);
+
+    instructionTable[0xC6] = Instruction("ADD A, n ", &z80::ADD_A_N, 7);
+
+    instructionTable[0x86] = Instruction("ADD A, (HL) ", &z80::ADD_A_HL, 7);
+
+    instructionTable[0x88] = Instruction("ADC A ,B ", &z80::ADC_A_s, 4);
+    instructionTable[0x89] = Instruction("ADC A, C ", &z80::ADC_A_s, 4);
+    instructionTable[0x8A] = Instruction("ADC A, D ", &z80::ADC_A_s, 4);
+    instructionTable[0x8B] = Instruction("ADC A, E ", &z80::ADC_A_s, 4);
+    instructionTable[0x8C] = Instruction("ADC A, H ", &z80::ADC_A_s, 4);
+    instructionTable[0x8D] = Instruction("ADC A, L ", &z80::ADC_A_s, 4);
+    instructionTable[0x8F] = Instruction("ADC A, A ", &z80::ADC_A_s, 4);
+
+    instructionTable[0xCE] = Instruction("ADC A, n ", &z80::ADC_A_N, 7);
+    instructionTable[0x8E] = Instruction("ADC A, (HL) ", &z80::ADC_A_HL, 7);
+
+    instructionTable[0x90] = Instruction("SUB A ,B ", &z80::SUB_A_R, 4);
+    instructionTable[0x91] = Instruction("SUB A, C ", &z80::SUB_A_R, 4);
+    instructionTable[0x92] = Instruction("SUB A, D ", &z80::SUB_A_R, 4);
+    instructionTable[0x93] = Instruction("SUB A, E ", &z80::SUB_A_R, 4);
+    instructionTable[0x94] = Instruction("SUB A, H ", &z80::SUB_A_R, 4);
+    instructionTable[0x95] = Instruction("SUB A, L ", &z80::SUB_A_R, 4);
+    instructionTable[0x97] = Instruction("SUB A, A ", &z80::SUB_A_R, 4);
+
+    instructionTable[0x98] = Instruction("SBC A ,B ", &z80::SBC_A_S, 4);
+    instructionTable[0x99] = Instruction("SBC A, C ", &z80::SBC_A_S, 4);
+    instructionTable[0x9A] = Instruction("SBC A, D ", &z80::SBC_A_S, 4);
+    instructionTable[0x9B] = Instruction("SBC A, E ", &z80::SBC_A_S, 4);
+    instructionTable[0x9C] = Instruction("SBC A, H ", &z80::SBC_A_S, 4);
+    instructionTable[0x9D] = Instruction("SBC A, L ", &z80::SBC_A_S, 4);
+    instructionTable[0x9F] = Instruction("SBC A, A ", &z80::SBC_A_S, 4);
+
+    instructionTable[0xA0] = Instruction("AND A ,B ", &z80::AND_A_R, 4);
+    instructionTable[0xA1] = Instruction("AND A, C ", &z80::AND_A_R, 4);
+    instructionTable[0xA2] = Instruction("AND A, D ", &z80::AND_A_R, 4);
+    instructionTable[0xA3] = Instruction("AND A, E ", &z80::AND_A_R, 4);
+    instructionTable[0xA4] = Instruction("AND A, H ", &z80::AND_A_R, 4);
+    instructionTable[0xA5] = Instruction("AND A, L ", &z80::AND_A_R, 4);
+    instructionTable[0xA7] = Instruction("AND A, A ", &z80::AND_A_R, 4);
+
+    instructionTable[0xB0] = Instruction("OR A ,B ", &z80::OR_A_R, 4);
+    instructionTable[0xB1] = Instruction("OR A, C ", &z80::OR_A_R, 4);
+    instructionTable[0xB2] = Instruction("OR A, D ", &z80::OR_A_R, 4);
+    instructionTable[0xB3] = Instruction("OR A, E ", &z80::OR_A_R, 4);
+    instructionTable[0xB4] = Instruction("OR A, H ", &z80::OR_A_R, 4);
+    instructionTable[0xB5] = Instruction("OR A, L ", &z80::OR_A_R, 4);
+    instructionTable[0xB7] = Instruction("OR A, A ", &z80::OR_A_R, 4);
+
+    instructionTable[0xA8] = Instruction("XOR A ,B ", &z80::XOR_A_R, 4);
+    instructionTable[0xA9] = Instruction("XOR A, C ", &z80::XOR_A_R, 4);
+    instructionTable[0xAA] = Instruction("XOR A, D ", &z80::XOR_A_R, 4);
+    instructionTable[0xAB] = Instruction("XOR A, E ", &z80::XOR_A_R, 4);
+    instructionTable[0xAC] = Instruction("XOR A, H ", &z80::XOR_A_R, 4);
+    instructionTable[0xAD] = Instruction("XOR A, L ", &z80::XOR_A_R, 4);
+    instructionTable[0xAF] = Instruction("XOR A, A ", &z80::XOR_A_R, 4);
+
+    instructionTable[0xB8] = Instruction("CP ,B ", &z80::CP_R, 4);
+    instructionTable[0xB9] = Instruction("CP, C ", &z80::CP_R, 4);
+    instructionTable[0xBA] = Instruction("CP, D ", &z80::CP_R, 4);
+    instructionTable[0xBB] = Instruction("CP, E ", &z80::CP_R, 4);
+    instructionTable[0xBC] = Instruction("CP, H ", &z80::CP_R, 4);
+    instructionTable[0xBD] = Instruction("CP, L ", &z80::CP_R, 4);
+    instructionTable[0xBF] = Instruction("CP, A ", &z80::CP_R, 4);
+
+    instructionTable[0x04] = Instruction("INC ,B ", &z80::INC_R<0>, 4);
+    instructionTable[0x0C] = Instruction("INC, C ", &z80::INC_R<1>, 4);
+    instructionTable[0x14] = Instruction("INC, D ", &z80::INC_R<2>, 4);
+    instructionTable[0x1C] = Instruction("INC, E ", &z80::INC_R<3>, 4);
+    instructionTable[0x24] = Instruction("INC, H ", &z80::INC_R<4>, 4);
+    instructionTable[0x2C] = Instruction("INC, L ", &z80::INC_R<5>, 4);
+    instructionTable[0x3C] = Instruction("INC, A ", &z80::INC_R<7>, 4);
+
+    instructionTable[0x05] = Instruction("DEC ,B ", &z80::DEC_R, 4);
+    instructionTable[0x0D] = Instruction("DEC, C ", &z80::DEC_R, 4);
+    instructionTable[0x15] = Instruction("DEC, D ", &z80::DEC_R, 4);
+    instructionTable[0x1D] = Instruction("DEC, E ", &z80::DEC_R, 4);
+    instructionTable[0x25] = Instruction("DEC, H ", &z80::DEC_R, 4);
+    instructionTable[0x2D] = Instruction("DEC, L ", &z80::DEC_R, 4);
+    instructionTable[0x3D] = Instruction("DEC, A ", &z80::DEC_R, 4);
+
+    instructionTable[0xD6] = Instruction("SUB A, n ", &z80::SUB_A_N, 7);
+    instructionTable[0xDE] = Instruction("SBC A, n ", &z80::SBC_A_N, 7);
+    instructionTable[0xE6] = Instruction("AND A, n ", &z80::AND_A_N, 7);
+    instructionTable[0xF6] = Instruction("OR A, n ", &z80::OR_A_N, 7);
+    instructionTable[0xEE] = Instruction("XOR A, n ", &z80::XOR_A_N, 7);
+    instructionTable[0xFE] = Instruction("CP, n ", &z80::CP_N, 7);
+
+    instructionTable[0x96] = Instruction("SUB A, (HL) ", &z80::SUB_A_HL, 7);
+    instructionTable[0x9E] = Instruction("SBC A, (HL) ", &z80::SBC_A_HL, 7);
+    instructionTable[0xA6] = Instruction("AND A, (HL) ", &z80::AND_A_HL, 7);
+    instructionTable[0xB6] = Instruction("OR A, (HL) ", &z80::OR_A_HL, 7);
+    instructionTable[0xAE] = Instruction("XOR A, (HL) ", &z80::XOR_A_HL, 7);
+    instructionTable[0xBE] = Instruction("CP, (HL) ", &z80::CP_HL, 7);
+
+    instructionTable[0x34] = Instruction("INC, (HL) ", &z80::INC_HL, 11);
+    instructionTable[0x35] = Instruction("DEC, (HL) ", &z80::DEC_HL, 11);
+    instructionTable[0x27] = Instruction("DAA ", &z80::DAA, 4);
+    instructionTable[0x2F] = Instruction("CPL ", &z80::CPL, 4);
+    instructionTable[0x3F] = Instruction("CCF", &z80::CCF, 4);
+    instructionTable[0x37] = Instruction("SCF", &z80::SCF, 4);
+    instructionTable[0x00] = Instruction("NOP", &z80::NOP, 4);
+
+    instructionTable[0x76] = Instruction("HALT", &z80::HALT, 4);
+    instructionTable[0xF3] = Instruction("DI", &z80::DI, 4);
+    instructionTable[0xFB] = Instruction("EI", &z80::EI, 4);
+
+    instructionTable[0x09] = Instruction("ADD HL, BC", &z80::ADD_HL_SS, 11);
+    instructionTable[0x19] = Instruction("ADD HL, DE", &z80::ADD_HL_SS, 11);
+    instructionTable[0x29] = Instruction("ADD HL, HL", &z80::ADD_HL_SS, 11);
+    instructionTable[0x39] = Instruction("ADD HL, SP", &z80::ADD_HL_SS, 11);
+
+    instructionTable[0x03] = Instruction("INC BC", &z80::INC_SS, 6);
+    instructionTable[0x13] = Instruction("INC DE", &z80::INC_SS, 6);
+    instructionTable[0x23] = Instruction("INC HL", &z80::INC_SS, 6);
+    instructionTable[0x33] = Instruction("INC SP", &z80::INC_SS, 6);
+
+    instructionTable[0x0B] = Instruction("DEC BC", &z80::DEC_SS, 6);
+    instructionTable[0x1B] = Instruction("DEC DE", &z80::DEC_SS, 6);
+    instructionTable[0x2B] = Instruction("DEC HL", &z80::DEC_SS, 6);
+    instructionTable[0x3B] = Instruction("DEC SP", &z80::DEC_SS, 6);
+
+    instructionTable[0x07] = Instruction("RLCA", &z80::RLCA, 4);
+    instructionTable[0x17] = Instruction("RLA", &z80::RLA, 4);
+    instructionTable[0x0F] = Instruction("RRCA", &z80::RRCA, 4);
+    instructionTable[0x1F] = Instruction("RRA", &z80::RRA, 4);
 
     instructionTable[0xC3] = Instruction("JP, nn", &z80::JP_NN, 10);
 
@@ -428,17 +850,17 @@ void z80::initializeInstructionTable()
     instructionTable[0xF2] = Instruction("JP P, nn", &z80::JP_CC_NN, 10);
     instructionTable[0xFA] = Instruction("JP M, nn", &z80::JP_CC_NN, 10);
 
-    instructionTable[0x18] = Instruction("JR, e", &z80::JR_E, 10);
-    instructionTable[0x38] = Instruction("JR C, e", &z80::JR_C_E, 10);
-    instructionTable[0x30] = Instruction("JR NC, e", &z80::JR_NC_E, 10);
-    instructionTable[0x28] = Instruction("JR Z, e", &z80::JR_Z_E, 10);
-    instructionTable[0x20] = Instruction("JR NZ, e", &z80::JR_NZ_E, 10);
+    instructionTable[0x18] = Instruction("JR, e", &z80::JR_E, 12);
+    instructionTable[0x38] = Instruction("JR C, e", &z80::JR_C_E, 7);
+    instructionTable[0x30] = Instruction("JR NC, e", &z80::JR_NC_E, 7);
+    instructionTable[0x28] = Instruction("JR Z, e", &z80::JR_Z_E, 7);
+    instructionTable[0x20] = Instruction("JR NZ, e", &z80::JR_NZ_E, 7);
 
-    instructionTable[0xE9] = Instruction("JP (HL)", &z80::JP_HL, 10);
+    instructionTable[0xE9] = Instruction("JP (HL)", &z80::JP_HL, 4);
 
-    instructionTable[0x10] = Instruction("DJNZ, e", &z80::DJNZ_E, 10);
+    instructionTable[0x10] = Instruction("DJNZ, e", &z80::DJNZ_E, 8);
 
-    instructionTable[0xCD] = Instruction("CALL, nn", &z80::CALL_NN, 10);
+    instructionTable[0xCD] = Instruction("CALL, nn", &z80::CALL_NN, 17);
 
     instructionTable[0xC4] = Instruction("CALL NZ, nn", &z80::CALL_CC_NN, 10);
     instructionTable[0xCC] = Instruction("CALL Z, nn", &z80::CALL_CC_NN, 10);
@@ -450,248 +872,156 @@ void z80::initializeInstructionTable()
     instructionTable[0xFC] = Instruction("CALL M, nn", &z80::CALL_CC_NN, 10);
 
     instructionTable[0xC9] = Instruction("RET", &z80::RET, 10);
-    instructionTable[0xC0] = Instruction("RET, NZ", &z80::RET_CC, 10);
-    instructionTable[0xC8] = Instruction("RET, Z", &z80::RET_CC, 10);
-    instructionTable[0xD0] = Instruction("RET, NC", &z80::RET_CC, 10);
-    instructionTable[0xD8] = Instruction("RET, Z", &z80::RET_CC, 10);
-    instructionTable[0xE0] = Instruction("RET, PO", &z80::RET_CC, 10);
-    instructionTable[0xE8] = Instruction("RET, PE", &z80::RET_CC, 10);
-    instructionTable[0xF0] = Instruction("RET, P", &z80::RET_CC, 10);
-    instructionTable[0xF8] = Instruction("RET, M", &z80::RET_CC, 10);
-
-    instructionTable[0xC7] = Instruction("RST &00", &z80::RST_P, 10);
-    instructionTable[0xCF] = Instruction("RST &08", &z80::RST_P, 10);
-    instructionTable[0xD7] = Instruction("RST &10", &z80::RST_P, 10);
-    instructionTable[0xDF] = Instruction("RST &18", &z80::RST_P, 10);
-    instructionTable[0xE7] = Instruction("RST &20", &z80::RST_P, 10);
-    instructionTable[0xEF] = Instruction("RST &28", &z80::RST_P, 10);
-    instructionTable[0xF7] = Instruction("RST &30", &z80::RST_P, 10);
-    instructionTable[0xFF] = Instruction("RST &38", &z80::RST_P, 10);
-
-    instructionTable[0xDB] = Instruction("IN A, (n)", &z80::IN_A_N, 10);
-    instructionTable[0xD3] = Instruction("OUT (n), A", &z80::OUT_N_A, 10);
-
-    // DD-prefixed instructions
-
-    instructionTableDD[0xE9] = Instruction("JP (IX)", &z80::JP_IX, 10);
-    instructionTableDD[0x46] = Instruction("LD B, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x4E] = Instruction("LD C, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x56] = Instruction("LD D, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x5E] = Instruction("LD E, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x66] = Instruction("LD H, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x6E] = Instruction("LD L, (IX+d)", &z80::LD_R_IX_D, 19);
-    instructionTableDD[0x7E] = Instruction("LD A, (IX+d)", &z80::LD_R_IX_D, 19);
-
-    instructionTableDD[0x70] = Instruction("LD (IX+d), B", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x71] = Instruction("LD (IX+d), C", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x72] = Instruction("LD (IX+d), D", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x73] = Instruction("LD (IX+d), E", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x74] = Instruction("LD (IX+d), H", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x75] = Instruction("LD (IX+d), L", &z80::LD_IX_D_R, 19);
-    instructionTableDD[0x77] = Instruction("LD (IX+d), A", &z80::LD_IX_D_R, 19);
-
-    instructionTableDD[0x36] = Instruction("LD (IX+d), N", &z80::LD_IX_D_N, 19);
-    instructionTableDD[0x21] = Instruction("LD IX, nn", &z80::LD_IX_NN, 10);
-    instructionTableDD[0x2A] = Instruction("LD IX, (nn)", &z80::LD_IX_NN2, 10);
-    instructionTableDD[0x22] = Instruction("LD (nn), IX", &z80::LD_NN_IX, 10);
-
-
-    instructionTableDD[0x26] = Instruction("LD IXh, n", &z80::LD_IXH_N, 10);
-    instructionTableDD[0x2E] = Instruction("LD IXl, n", &z80::LD_IXl_N, 10);
-
-    instructionTableDD[0x44] = Instruction("LD B IXh", &z80::LD_R_IXH, 10);
-    instructionTableDD[0x4C] = Instruction("LD C IXh", &z80::LD_R_IXH, 10);
-    instructionTableDD[0x54] = Instruction("LD D IXh", &z80::LD_R_IXH, 10);
-    instructionTableDD[0x5C] = Instruction("LD E IXh", &z80::LD_R_IXH, 10);
-
-    instructionTableDD[0x60] = Instruction("LD IXh B", &z80::LD_IXH_R, 10);
-    instructionTableDD[0x61] = Instruction("LD IXh C", &z80::LD_IXH_R, 10);
-    instructionTableDD[0x62] = Instruction("LD IXh D", &z80::LD_IXH_R, 10);
-    instructionTableDD[0x63] = Instruction("LD IXh E", &z80::LD_IXH_R, 10);
-    instructionTableDD[0x67] = Instruction("LD IXh A", &z80::LD_IXH_R, 10);
-
-    instructionTableDD[0x68] = Instruction("LD IXl B", &z80::LD_IXl_R, 10);
-    instructionTableDD[0x69] = Instruction("LD IXl C", &z80::LD_IXl_R, 10);
-    instructionTableDD[0x6A] = Instruction("LD IXl D", &z80::LD_IXl_R, 10);
-    instructionTableDD[0x6B] = Instruction("LD IXl E", &z80::LD_IXl_R, 10);
-    instructionTableDD[0x6F] = Instruction("LD IXl A", &z80::LD_IXl_R, 10);
-
-    instructionTableDD[0x65] = Instruction("LD IXh IXl", &z80::LD_IXH_IXL, 10);
-    instructionTableDD[0x6C] = Instruction("LD IXl IXh", &z80::LD_IXL_IXH, 10);
-
-    instructionTableDD[0x45] = Instruction("LD B IXl", &z80::LD_R_IXl, 10);
-    instructionTableDD[0x4D] = Instruction("LD C IXl", &z80::LD_R_IXl, 10);
-    instructionTableDD[0x55] = Instruction("LD D IXl", &z80::LD_R_IXl, 10);
-    instructionTableDD[0x5D] = Instruction("LD E IXl", &z80::LD_R_IXl, 10);
-    instructionTableDD[0x7D] = Instruction("LD A IXl", &z80::LD_R_IXl, 10);
-
-    instructionTableDD[0x7C] = Instruction("LD A IXh", &z80::LD_R_IXH, 10);
-
-    instructionTableDD[0x84] = Instruction("ADD A IXh", &z80::ADD_A_IX_H, 10);
-    instructionTableDD[0x85] = Instruction("ADD A IXl", &z80::ADD_A_IX_L, 10);
-
-    instructionTableDD[0x94] = Instruction("SUB A IXh", &z80::SUB_A_IX_H, 10);
-    instructionTableDD[0x95] = Instruction("SUB A IXl", &z80::SUB_A_IX_L, 10);
-
-    instructionTableDD[0x9C] = Instruction("SBC A IXh", &z80::SBC_A_IX_H, 10);
-    instructionTableDD[0x9D] = Instruction("SBC A IXl", &z80::SBC_A_IX_L, 10);
-
-    instructionTableDD[0x8C] = Instruction("ADC A IXh", &z80::ADC_A_IX_H, 10);
-    instructionTableDD[0x8D] = Instruction("ADC A IXl", &z80::ADC_A_IX_L, 10);
-
-    instructionTableDD[0xA4] = Instruction("AND A IXh", &z80::AND_A_IX_H, 10);
-    instructionTableDD[0xA5] = Instruction("AND A IXl", &z80::AND_A_IX_L, 10);
-
-    instructionTableDD[0xAC] = Instruction("XOR A IXh", &z80::XOR_A_IX_H, 10);
-    instructionTableDD[0xAD] = Instruction("XOR A IXl", &z80::XOR_A_IX_L, 10);
-
-    instructionTableDD[0xB4] = Instruction("OR A IXh", &z80::OR_A_IX_H, 10);
-    instructionTableDD[0xB5] = Instruction("OR A IXl", &z80::OR_A_IX_L, 10);
-
-    instructionTableDD[0xBC] = Instruction("CP A IXh", &z80::CP_IX_H, 10);
-    instructionTableDD[0xBD] = Instruction("CP A IXl", &z80::CP_IX_L, 10);
-
-    instructionTableDD[0xF9] = Instruction("LD SP, IX", &z80::LD_SP_IX, 10);
-    instructionTableDD[0xE5] = Instruction(" PUSH IX", &z80::PUSH_IX, 10);
-    instructionTableDD[0xE1] = Instruction(" POP IX", &z80::POP_IX, 10);
-    instructionTableDD[0xE3] = Instruction(" EX (SP), IX", &z80::EX_SP_IX, 10);
-    instructionTableDD[0x86] = Instruction("ADD A,(IX+d)", &z80::ADD_A_IX_D, 10);
-
-    instructionTableDD[0x8E] = Instruction("ADC A,(IX+d)", &z80::ADC_A_IX_D, 10);
-    instructionTableDD[0x96] = Instruction("SUB A,(IX+d)", &z80::SUB_A_IX_D, 10);
-    instructionTableDD[0x9E] = Instruction("SBC A,(IX+d)", &z80::SBC_A_IX_D, 10);
-    instructionTableDD[0xA6] = Instruction("AND A,(IX+d)", &z80::AND_A_IX_D, 10);
-    instructionTableDD[0xB6] = Instruction("OR A,(IX+d)", &z80::OR_A_IX_D, 10);
-    instructionTableDD[0xAE] = Instruction("XOR A,(IX+d)", &z80::XOR_A_IX_D, 10);
-    instructionTableDD[0xBE] = Instruction("CP,(IX+d)", &z80::CP_IX_D, 10);
-    instructionTableDD[0x34] = Instruction("INC,(IX+d)", &z80::INC_IX_D, 10);
-    instructionTableDD[0x35] = Instruction("DEC,(IX+d)", &z80::DEC_IX_D, 10);
-
-    instructionTableDD[0x09] = Instruction("ADD IX, BC", &z80::ADD_IX_PP, 10);
-    instructionTableDD[0x19] = Instruction("ADD IX, DE", &z80::ADD_IX_PP, 10);
-    instructionTableDD[0x29] = Instruction("ADD IX, IX", &z80::ADD_IX_PP, 10);
-    instructionTableDD[0x39] = Instruction("ADD IX, SP", &z80::ADD_IX_PP, 10);
-
-    instructionTableDD[0x23] = Instruction("INC IX", &z80::INC_IX, 10);
-    instructionTableDD[0x24] = Instruction("INC IXh", &z80::INC_IXH, 10);
-    instructionTableDD[0x2C] = Instruction("INC IXl", &z80::INC_IXl, 10);
-    instructionTableDD[0x2B] = Instruction("DEC IX", &z80::DEC_IX, 10);
-    instructionTableDD[0x25] = Instruction("DEC IXH", &z80::DEC_IXH, 10);
-    instructionTableDD[0x2D] = Instruction("DEC IXH", &z80::DEC_IXl, 10);
-    instructionTableDD[0xFD] = Instruction("NOP", &z80::NOP, 10);
-
-    // FD-prefixed instructions
-
-    instructionTableFD[0x46] = Instruction("LD B, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x4E] = Instruction("LD C, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x56] = Instruction("LD D, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x5E] = Instruction("LD E, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x66] = Instruction("LD H, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x6E] = Instruction("LD L, (IY+d)", &z80::LD_R_IY_D, 19);
-    instructionTableFD[0x7E] = Instruction("LD A, (IY+d)", &z80::LD_R_IY_D, 19);
-
-    instructionTableFD[0xE9] = Instruction("JP (IY)", &z80::JP_IY, 10);
-
-    instructionTableFD[0x70] = Instruction("LD (IY+d), B", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x71] = Instruction("LD (IY+d), C", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x72] = Instruction("LD (IY+d), D", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x73] = Instruction("LD (IY+d), E", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x74] = Instruction("LD (IY+d), H", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x75] = Instruction("LD (IY+d), L", &z80::LD_IY_D_R, 19);
-    instructionTableFD[0x77] = Instruction("LD (IY+d), A", &z80::LD_IY_D_R, 19);
-
-    instructionTableFD[0x36] = Instruction("LD (IY+d), N", &z80::LD_IY_D_N, 19);
-
-    instructionTableFD[0x21] = Instruction("LD IY, nn", &z80::LD_IY_NN, 10);
-    instructionTableFD[0x2A] = Instruction("LD IY, (nn)", &z80::LD_IY_NN2, 10);
-    instructionTableFD[0x22] = Instruction("LD (nn), IY", &z80::LD_NN_IY, 10);
-    instructionTableFD[0xF9] = Instruction("LD SP, IY", &z80::LD_SP_IY, 10);
-
-    instructionTableFD[0xE5] = Instruction(" PUSH IY", &z80::PUSH_IY, 10);
-    instructionTableFD[0xE1] = Instruction(" POP IY", &z80::POP_IY, 10);
-    instructionTableFD[0xE3] = Instruction(" EX (SP), IX", &z80::EX_SP_IY, 10);
-    instructionTableFD[0x86] = Instruction("ADD A,(IY+d)", &z80::ADD_A_IY_D, 10);
-
-    instructionTableFD[0x8E] = Instruction("ADC A,(IY+d)", &z80::ADC_A_IY_D, 10);
-    instructionTableFD[0x96] = Instruction("SUB A,(IY+d)", &z80::SUB_A_IY_D, 10);
-    instructionTableFD[0x9E] = Instruction("SBC A,(IY+d)", &z80::SBC_A_IY_D, 10);
-
-    instructionTableFD[0xA6] = Instruction("AND A,(IY+d)", &z80::AND_A_IY_D, 10);
-    instructionTableFD[0xB6] = Instruction("OR A,(IY+d)", &z80::OR_A_IY_D, 10);
-    instructionTableFD[0xAE] = Instruction("OR A,(IY+d)", &z80::XOR_A_IY_D, 10);
-    instructionTableFD[0xBE] = Instruction("CP,(IY+d)", &z80::CP_IY_D, 10);
-
-    instructionTableFD[0x34] = Instruction("INC,(IY+d)", &z80::INC_IY_D, 10);
-    instructionTableFD[0x35] = Instruction("DEC,(IY+d)", &z80::DEC_IY_D, 10);
-
-    instructionTableFD[0x09] = Instruction("ADD IY, BC", &z80::ADD_IY_RR, 10);
-    instructionTableFD[0x19] = Instruction("ADD IY, DE", &z80::ADD_IY_RR, 10);
-    instructionTableFD[0x29] = Instruction("ADD IY, IX", &z80::ADD_IY_RR, 10);
-    instructionTableFD[0x39] = Instruction("ADD IY, SP", &z80::ADD_IY_RR, 10);
-
-    instructionTableFD[0x23] = Instruction("INC IY", &z80::INC_IY, 10);
-    instructionTableFD[0x2B] = Instruction("DEC IY", &z80::DEC_IY, 10);
-
-    instructionTableFD[0x24] = Instruction("INC IY H", &z80::INC_IY_H, 10);
-    instructionTableFD[0x2C] = Instruction("INC IY L", &z80::INC_IY_L, 10);
-
-    instructionTableFD[0x25] = Instruction("DEC IY H", &z80::DEC_IY_H, 10);
-    instructionTableFD[0x2D] = Instruction("DEC IY L", &z80::DEC_IY_L, 10);
-
-    instructionTableFD[0x26] = Instruction("LD IY H, n", &z80::LD_IY_H_N, 10);
-    instructionTableFD[0x2E] = Instruction("LD IY L, n", &z80::LD_IY_L_N, 10);
-
-    instructionTableFD[0x44] = Instruction("LD B IYh", &z80::LD_R_IY_H, 10);
-    instructionTableFD[0x4C] = Instruction("LD C IYh", &z80::LD_R_IY_H, 10);
-    instructionTableFD[0x54] = Instruction("LD D IYh", &z80::LD_R_IY_H, 10);
-    instructionTableFD[0x5C] = Instruction("LD E IYh", &z80::LD_R_IY_H, 10);
-
-    instructionTableFD[0x45] = Instruction("LD B IYl", &z80::LD_R_IY_L, 10);
-    instructionTableFD[0x4D] = Instruction("LD C IYl", &z80::LD_R_IY_L, 10);
-    instructionTableFD[0x55] = Instruction("LD D IYl", &z80::LD_R_IY_L, 10);
-    instructionTableFD[0x5D] = Instruction("LD E IYl", &z80::LD_R_IY_L, 10);
-
-    instructionTableFD[0x60] = Instruction("LD IYh B", &z80::LD_IY_H_R, 10);
-    instructionTableFD[0x61] = Instruction("LD IYh C", &z80::LD_IY_H_R, 10);
-    instructionTableFD[0x62] = Instruction("LD IYh D", &z80::LD_IY_H_R, 10);
-    instructionTableFD[0x63] = Instruction("LD IYh E", &z80::LD_IY_H_R, 10);
-    instructionTableFD[0x67] = Instruction("LD IYh A", &z80::LD_IY_H_R, 10);
-
-    instructionTableFD[0x68] = Instruction("LD IYl B", &z80::LD_IY_L_R, 10);
-    instructionTableFD[0x69] = Instruction("LD IYl C", &z80::LD_IY_L_R, 10);
-    instructionTableFD[0x6A] = Instruction("LD IYl D", &z80::LD_IY_L_R, 10);
-    instructionTableFD[0x6B] = Instruction("LD IYl E", &z80::LD_IY_L_R, 10);
-    instructionTableFD[0x6F] = Instruction("LD IYl A", &z80::LD_IY_L_R, 10);
-
-    instructionTableFD[0x65] = Instruction("LD IYH IYL", &z80::LD_IYH_IYL, 10);
-    instructionTableFD[0x6C] = Instruction("LD IYL IYH", &z80::LD_IYL_IYH, 10);
-
-    instructionTableFD[0x7c] = Instruction("LD A IYH", &z80::LD_R_IY_H, 10);
-    instructionTableFD[0x7D] = Instruction("LD A IYL ", &z80::LD_R_IY_L, 10);
-
-    instructionTableFD[0x84] = Instruction("ADD A IYH", &z80::ADD_A_IY_H, 10);
-    instructionTableFD[0x85] = Instruction("ADD A IYL ", &z80::ADD_A_IY_L, 10);
-
-    instructionTableFD[0x8C] = Instruction("ADC A IYH", &z80::ADC_A_IY_H, 10);
-    instructionTableFD[0x8D] = Instruction("ADC A IYL ", &z80::ADC_A_IY_L, 10);
-
-    instructionTableFD[0x9C] = Instruction("SBC A IYH", &z80::SBC_A_IY_H, 10);
-    instructionTableFD[0x9D] = Instruction("SBC A IYL ", &z80::SBC_A_IY_L, 10);
-
-    instructionTableFD[0x94] = Instruction("SUB A IYH", &z80::SUB_A_IY_H, 10);
-    instructionTableFD[0x95] = Instruction("SUB A IYL ", &z80::SUB_A_IY_L, 10);
-
-    instructionTableFD[0xA4] = Instruction("AND A IYH", &z80::AND_A_IY_H, 10);
-    instructionTableFD[0xA5] = Instruction("AND A IYL ", &z80::AND_A_IY_L, 10);
-
-    instructionTableFD[0xAC] = Instruction("XOR A IYH", &z80::XOR_A_IY_H, 10);
-    instructionTableFD[0xAD] = Instruction("XOR A IYL ", &z80::XOR_A_IY_L, 10);
+    instructionTable[0xC0] = Instruction("RET, NZ", &z80::RET_CC, 5);
+    instructionTable[0xC8] = Instruction("RET, Z", &z80::RET_CC, 5);
+    instructionTable[0xD0] = Instruction("RET, NC", &z80::RET_CC, 5);
+    instructionTable[0xD8] = Instruction("RET, Z", &z80::RET_CC, 5);
+    instructionTable[0xE0] = Instruction("RET, PO", &z80::RET_CC, 5);
+    instructionTable[0xE8] = Instruction("RET, PE", &z80::RET_CC, 5);
+    instructionTable[0xF0] = Instruction("RET, P", &z80::RET_CC, 5);
+    instructionTable[0xF8] = Instruction("RET, M", &z80::RET_CC, 5);
+
+    instructionTable[0xC7] = Instruction("RST &00", &z80::RST_P, 11);
+    instructionTable[0xCF] = Instruction("RST &08", &z80::RST_P, 11);
+    instructionTable[0xD7] = Instruction("RST &10", &z80::RST_P, 11);
+    instructionTable[0xDF] = Instruction("RST &18", &z80::RST_P, 11);
+    instructionTable[0xE7] = Instruction("RST &20", &z80::RST_P, 11);
+    instructionTable[0xEF] = Instruction("RST &28", &z80::RST_P, 11);
+    instructionTable[0xF7] = Instruction("RST &30", &z80::RST_P, 11);
+    instructionTable[0xFF] = Instruction("RST &38", &z80::RST_P, 11);
+
+    instructionTable[0xDB] = Instruction("IN A, (n)", &z80::IN_A_N, 11);
+    instructionTable[0xD3] = Instruction("OUT (n), A", &z80::OUT_N_A, 11);
+
+    return instructionTable;
+}
+
+// The DD and FD tables, and the DDCB and FDCB tables below, are one table
+// each over the index register, see IX_INDEX.
+template <uint8_t Index>
+constexpr InstructionTable buildInstructionTableIndex()
+{
+    InstructionTable table{};
+    constexpr auto pick = [](const char *ix, const char *iy)
+    { return Index == z80::IX_INDEX ? ix : iy; };
+
+    // DD- and FD-prefixed instructions
+
+    table[0xE9] = Instruction(pick("JP (IX)", "JP (IY)"), &z80::JP_XY<Index>, 8);
+    table[0x46] = Instruction(pick("LD B, (IX+d)", "LD B, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x4E] = Instruction(pick("LD C, (IX+d)", "LD C, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x56] = Instruction(pick("LD D, (IX+d)", "LD D, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x5E] = Instruction(pick("LD E, (IX+d)", "LD E, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x66] = Instruction(pick("LD H, (IX+d)", "LD H, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x6E] = Instruction(pick("LD L, (IX+d)", "LD L, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+    table[0x7E] = Instruction(pick("LD A, (IX+d)", "LD A, (IY+d)"), &z80::LD_R_XY_D<Index>, 19);
+
+    table[0x70] = Instruction(pick("LD (IX+d), B", "LD (IY+d), B"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x71] = Instruction(pick("LD (IX+d), C", "LD (IY+d), C"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x72] = Instruction(pick("LD (IX+d), D", "LD (IY+d), D"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x73] = Instruction(pick("LD (IX+d), E", "LD (IY+d), E"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x74] = Instruction(pick("LD (IX+d), H", "LD (IY+d), H"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x75] = Instruction(pick("LD (IX+d), L", "LD (IY+d), L"), &z80::LD_XY_D_R<Index>, 19);
+    table[0x77] = Instruction(pick("LD (IX+d), A", "LD (IY+d), A"), &z80::LD_XY_D_R<Index>, 19);
+
+    table[0x36] = Instruction(pick("LD (IX+d), N", "LD (IY+d), N"), &z80::LD_XY_D_N<Index>, 19);
+    table[0x21] = Instruction(pick("LD IX, nn", "LD IY, nn"), &z80::LD_XY_NN<Index>, 14);
+    table[0x2A] = Instruction(pick("LD IX, (nn)", "LD IY, (nn)"), &z80::LD_XY_NN2<Index>, 20);
+    table[0x22] = Instruction(pick("LD (nn), IX", "LD (nn), IY"), &z80::LD_NN_XY<Index>, 20);
+
+    table[0x26] = Instruction(pick("LD IXh, n", "LD IYh, n"), &z80::LD_XYH_N<Index>, 11);
+    table[0x2E] = Instruction(pick("LD IXl, n", "LD IYl, n"), &z80::LD_XYL_N<Index>, 11);
+
+    table[0x44] = Instruction(pick("LD B IXh", "LD B IYh"), &z80::LD_R_XYH<Index>, 8);
+    table[0x4C] = Instruction(pick("LD C IXh", "LD C IYh"), &z80::LD_R_XYH<Index>, 8);
+    table[0x54] = Instruction(pick("LD D IXh", "LD D IYh"), &z80::LD_R_XYH<Index>, 8);
+    table[0x5C] = Instruction(pick("LD E IXh", "LD E IYh"), &z80::LD_R_XYH<Index>, 8);
+
+    table[0x60] = Instruction(pick("LD IXh B", "LD IYh B"), &z80::LD_XYH_R<Index>, 8);
+    table[0x61] = Instruction(pick("LD IXh C", "LD IYh C"), &z80::LD_XYH_R<Index>, 8);
+    table[0x62] = Instruction(pick("LD IXh D", "LD IYh D"), &z80::LD_XYH_R<Index>, 8);
+    table[0x63] = Instruction(pick("LD IXh E", "LD IYh E"), &z80::LD_XYH_R<Index>, 8);
+    table[0x67] = Instruction(pick("LD IXh A", "LD IYh A"), &z80::LD_XYH_R<Index>, 8);
+
+    table[0x68] = Instruction(pick("LD IXl B", "LD IYl B"), &z80::LD_XYL_R<Index>, 8);
+    table[0x69] = Instruction(pick("LD IXl C", "LD IYl C"), &z80::LD_XYL_R<Index>, 8);
+    table[0x6A] = Instruction(pick("LD IXl D", "LD IYl D"), &z80::LD_XYL_R<Index>, 8);
+    table[0x6B] = Instruction(pick("LD IXl E", "LD IYl E"), &z80::LD_XYL_R<Index>, 8);
+    table[0x6F] = Instruction(pick("LD IXl A", "LD IYl A"), &z80::LD_XYL_R<Index>, 8);
+
+    table[0x65] = Instruction(pick("LD IXh IXl", "LD IYh IYl"), &z80::LD_XYH_XYL<Index>, 8);
+    table[0x6C] = Instruction(pick("LD IXl IXh", "LD IYl IYh"), &z80::LD_XYL_XYH<Index>, 8);
+
+    table[0x45] = Instruction(pick("LD B IXl", "LD B IYl"), &z80::LD_R_XYL<Index>, 8);
+    table[0x4D] = Instruction(pick("LD C IXl", "LD C IYl"), &z80::LD_R_XYL<Index>, 8);
+    table[0x55] = Instruction(pick("LD D IXl", "LD D IYl"), &z80::LD_R_XYL<Index>, 8);
+    table[0x5D] = Instruction(pick("LD E IXl", "LD E IYl"), &z80::LD_R_XYL<Index>, 8);
+    table[0x7D] = Instruction(pick("LD A IXl", "LD A IYl"), &z80::LD_R_XYL<Index>, 8);
+
+    table[0x7C] = Instruction(pick("LD A IXh", "LD A IYh"), &z80::LD_R_XYH<Index>, 8);
+
+    table[0x84] = Instruction(pick("ADD A IXh", "ADD A IYh"), &z80::ADD_A_XYH<Index>, 8);
+    table[0x85] = Instruction(pick("ADD A IXl", "ADD A IYl"), &z80::ADD_A_XYL<Index>, 8);
+
+    table[0x94] = Instruction(pick("SUB A IXh", "SUB A IYh"), &z80::SUB_A_XYH<Index>, 8);
+    table[0x95] = Instruction(pick("SUB A IXl", "SUB A IYl"), &z80::SUB_A_XYL<Index>, 8);
+
+    table[0x9C] = Instruction(pick("SBC A IXh", "SBC A IYh"), &z80::SBC_A_XYH<Index>, 8);
+    table[0x9D] = Instruction(pick("SBC A IXl", "SBC A IYl"), &z80::SBC_A_XYL<Index>, 8);
+
+    table[0x8C] = Instruction(pick("ADC A IXh", "ADC A IYh"), &z80::ADC_A_XYH<Index>, 8);
+    table[0x8D] = Instruction(pick("ADC A IXl", "ADC A IYl"), &z80::ADC_A_XYL<Index>, 8);
+
+    table[0xA4] = Instruction(pick("AND A IXh", "AND A IYh"), &z80::AND_A_XYH<Index>, 8);
+    table[0xA5] = Instruction(pick("AND A IXl", "AND A IYl"), &z80::AND_A_XYL<Index>, 8);
+
+    table[0xAC] = Instruction(pick("XOR A IXh", "XOR A IYh"), &z80::XOR_A_XYH<Index>, 8);
+    table[0xAD] = Instruction(pick("XOR A IXl", "XOR A IYl"), &z80::XOR_A_XYL<Index>, 8);
+
+    table[0xB4] = Instruction(pick("OR A IXh", "OR A IYh"), &z80::OR_A_XYH<Index>, 8);
+    table[0xB5] = Instruction(pick("OR A IXl", "OR A IYl"), &z80::OR_A_XYL<Index>, 8);
+
+    table[0xBC] = Instruction(pick("CP A IXh", "CP A IYh"), &z80::CP_XYH<Index>, 8);
+    table[0xBD] = Instruction(pick("CP A IXl", "CP A IYl"), &z80::CP_XYL<Index>, 8);
+
+    table[0xF9] = Instruction(pick("LD SP, IX", "LD SP, IY"), &z80::LD_SP_XY<Index>, 10);
+    table[0xE5] = Instruction(pick(" PUSH IX", " PUSH IY"), &z80::PUSH_XY<Index>, 15);
+    table[0xE1] = Instruction(pick(" POP IX", " POP IY"), &z80::POP_XY<Index>, 14);
+    table[0xE3] = Instruction(pick(" EX (SP), IX", " EX (SP), IY"), &z80::EX_SP_XY<Index>, 23);
+    table[0x86] = Instruction(pick("ADD A,(IX+d)", "ADD A,(IY+d)"), &z80::ADD_A_XY_D<Index>, 19);
+
+    table[0x8E] = Instruction(pick("ADC A,(IX+d)", "ADC A,(IY+d)"), &z80::ADC_A_XY_D<Index>, 19);
+    table[0x96] = Instruction(pick("SUB A,(IX+d)", "SUB A,(IY+d)"), &z80::SUB_A_XY_D<Index>, 19);
+    table[0x9E] = Instruction(pick("SBC A,(IX+d)", "SBC A,(IY+d)"), &z80::SBC_A_XY_D<Index>, 19);
+    table[0xA6] = Instruction(pick("AND A,(IX+d)", "AND A,(IY+d)"), &z80::AND_A_XY_D<Index>, 19);
+    table[0xB6] = Instruction(pick("OR A,(IX+d)", "OR A,(IY+d)"), &z80::OR_A_XY_D<Index>, 19);
+    table[0xAE] = Instruction(pick("XOR A,(IX+d)", "XOR A,(IY+d)"), &z80::XOR_A_XY_D<Index>, 19);
+    table[0xBE] = Instruction(pick("CP,(IX+d)", "CP,(IY+d)"), &z80::CP_XY_D<Index>, 19);
+    table[0x34] = Instruction(pick("INC,(IX+d)", "INC,(IY+d)"), &z80::INC_XY_D<Index>, 23);
+    table[0x35] = Instruction(pick("DEC,(IX+d)", "DEC,(IY+d)"), &z80::DEC_XY_D<Index>, 23);
+
+    table[0x09] = Instruction(pick("ADD IX, BC", "ADD IY, BC"), &z80::ADD_XY_PP<Index>, 15);
+    table[0x19] = Instruction(pick("ADD IX, DE", "ADD IY, DE"), &z80::ADD_XY_PP<Index>, 15);
+    table[0x29] = Instruction(pick("ADD IX, IX", "ADD IY, IY"), &z80::ADD_XY_PP<Index>, 15);
+    table[0x39] = Instruction(pick("ADD IX, SP", "ADD IY, SP"), &z80::ADD_XY_PP<Index>, 15);
+
+    table[0x23] = Instruction(pick("INC IX", "INC IY"), &z80::INC_XY<Index>, 10);
+    table[0x24] = Instruction(pick("INC IXh", "INC IYh"), &z80::INC_XYH<Index>, 8);
+    table[0x2C] = Instruction(pick("INC IXl", "INC IYl"), &z80::INC_XYL<Index>, 8);
+    table[0x2B] = Instruction(pick("DEC IX", "DEC IY"), &z80::DEC_XY<Index>, 10);
+    table[0x25] = Instruction(pick("DEC IXh", "DEC IYh"), &z80::DEC_XYH<Index>, 8);
+    table[0x2D] = Instruction(pick("DEC IXl", "DEC IYl"), &z80::DEC_XYL<Index>, 8);
+    if (Index == z80::IX_INDEX)
+    {
+        table[0xFD] = Instruction("NOP", &z80::NOP, 8); // DD FD, the FD prefix takes over
+    }
 
-    instructionTableFD[0xB4] = Instruction("OR A IYH", &z80::OR_A_IY_H, 10);
-    instructionTableFD[0xB5] = Instruction("OR A IYL ", &z80::OR_A_IY_L, 10);
+    return table;
+}
 
-    instructionTableFD[0xBC] = Instruction("CP A IYH", &z80::CP_A_IY_H, 10);
-    instructionTableFD[0xBD] = Instruction("CP A IYL ", &z80::CP_A_IY_L, 10);
+constexpr InstructionTable buildInstructionTableED()
+{
+    InstructionTable instructionTableED{};
 
     // ED Instructions
     instructionTableED[0x57] = Instruction("LD A, I", &z80::LD_A_I, 9);
@@ -710,948 +1040,689 @@ void z80::initializeInstructionTable()
     instructionTableED[0x53] = Instruction("LD (nn), DE", &z80::LD_NN_DD, 20);
     instructionTableED[0x63] = Instruction("LD (nn), HL", &z80::LD_NN_DD, 20);
 
-    instructionTableED[0xA0] = Instruction("LDI", &z80::LDI, 20);
-    instructionTableED[0xB0] = Instruction("LDIR", &z80::LDIR, 20);
-    instructionTableED[0xA8] = Instruction("LDD", &z80::LDD, 20);
-    instructionTableED[0xB8] = Instruction("LDDR", &z80::LDDR, 20);
-    instructionTableED[0xA1] = Instruction("CPI", &z80::CPI, 20);
-    instructionTableED[0xB1] = Instruction("CPIR", &z80::CPIR, 20);
-    instructionTableED[0xA9] = Instruction("CPD", &z80::CPD, 20);
-    instructionTableED[0xB9] = Instruction("CPDR", &z80::CPDR, 20);
-    instructionTableED[0x44] = Instruction("NEG ", &z80::NEG, 10);
-
-    instructionTableED[0x4C] = Instruction("NEG ", &z80::NEG, 10);
-
-    instructionTableED[0x54] = Instruction("NEG ", &z80::NEG, 10);
-    instructionTableED[0x5C] = Instruction("NEG ", &z80::NEG, 10);
-    instructionTableED[0x64] = Instruction("NEG ", &z80::NEG, 10);
-    instructionTableED[0x6C] = Instruction("NEG ", &z80::NEG, 10);
-    instructionTableED[0x74] = Instruction("NEG ", &z80::NEG, 10);
-    instructionTableED[0x7C] = Instruction("NEG ", &z80::NEG, 10);
-
-    instructionTableED[0x4E] = Instruction("IM0 ", &z80::IM0, 10);
-    instructionTableED[0x46] = Instruction("IM0 ", &z80::IM0, 10);
-    instructionTableED[0x66] = Instruction("IM0 ", &z80::IM0, 10);
-    instructionTableED[0x6E] = Instruction("IM0 ", &z80::IM0, 10);
-    instructionTableED[0x56] = Instruction("IM1 ", &z80::IM1, 10);
-    instructionTableED[0x5E] = Instruction("IM2 ", &z80::IM2, 10);
-    instructionTableED[0x7E] = Instruction("IM2 ", &z80::IM2, 10);
-
-    instructionTableED[0x4A] = Instruction("ADC HL, BC", &z80::ADC_HL_SS, 10);
-    instructionTableED[0x5A] = Instruction("ADC HL, DE", &z80::ADC_HL_SS, 10);
-    instructionTableED[0x6A] = Instruction("ADC HL, HL", &z80::ADC_HL_SS, 10);
-    instructionTableED[0x7A] = Instruction("ADC HL, SP", &z80::ADC_HL_SS, 10);
-
-    instructionTableED[0x42] = Instruction("SBC HL, BC", &z80::SBC_HL_SS, 10);
-    instructionTableED[0x52] = Instruction("SBC HL, DE", &z80::SBC_HL_SS, 10);
-    instructionTableED[0x62] = Instruction("SBC HL, HL", &z80::SBC_HL_SS, 10);
-    instructionTableED[0x72] = Instruction("SBC HL, SP", &z80::SBC_HL_SS, 10);
-
-    instructionTableED[0x6F] = Instruction("RLD", &z80::RLD, 10);
-    instructionTableED[0x67] = Instruction("RRD", &z80::RRD, 10);
-
-    instructionTableED[0x4D] = Instruction("RETI", &z80::RETI, 10);
-    instructionTableED[0x45] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x55] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x5D] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x65] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x6D] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x75] = Instruction("RETN", &z80::RETN, 10);
-    instructionTableED[0x7D] = Instruction("RETN", &z80::RETN, 10);
-
-    instructionTableED[0x40] = Instruction("IN B, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x48] = Instruction("IN C, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x50] = Instruction("IN D, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x58] = Instruction("IN E, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x60] = Instruction("IN H, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x68] = Instruction("IN L, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x70] = Instruction("IN F, (C)", &z80::IN_R_C, 10);
-    instructionTableED[0x78] = Instruction("IN A, (C)", &z80::IN_R_C, 10);
-
-    instructionTableED[0x41] = Instruction("OUT (C), B", &z80::OUT_C_R, 10);
-    instructionTableED[0x49] = Instruction("OUT (C), C", &z80::OUT_C_R, 10);
-    instructionTableED[0x51] = Instruction("OUT (C), D", &z80::OUT_C_R, 10);
-    instructionTableED[0x59] = Instruction("OUT (C), E", &z80::OUT_C_R, 10);
-    instructionTableED[0x61] = Instruction("OUT (C), H", &z80::OUT_C_R, 10);
-    instructionTableED[0x69] = Instruction("OUT (C), L", &z80::OUT_C_R, 10);
-    instructionTableED[0x71] = Instruction("OUT (C), F", &z80::OUT_C_R, 10);
-    instructionTableED[0x79] = Instruction("OUT (C), A", &z80::OUT_C_R, 10);
-
-    instructionTableED[0xA2] = Instruction("INI", &z80::INI, 10);
-    instructionTableED[0xB2] = Instruction("INIR", &z80::INIR, 10);
-    instructionTableED[0xAA] = Instruction("IND", &z80::IND, 10);
-    instructionTableED[0xBA] = Instruction("INDR", &z80::INDR, 10);
-
-    instructionTableED[0xA3] = Instruction("OUTI", &z80::OUTI, 10);
-    instructionTableED[0xB3] = Instruction("OTIR", &z80::OTIR, 10);
-    instructionTableED[0xAB] = Instruction("OUTD", &z80::OUTD, 10);
-    instructionTableED[0xBB] = Instruction("OTDR", &z80::OTDR, 10);
-    instructionTableED[0x76] = Instruction("IM1", &z80::IM1, 10);
-
-    instructionTableCB[0x00] = Instruction("RLC, B", &z80::RLC_R, 10);
-    instructionTableCB[0x01] = Instruction("RLC, C", &z80::RLC_R, 10);
-    instructionTableCB[0x02] = Instruction("RLC, D", &z80::RLC_R, 10);
-    instructionTableCB[0x03] = Instruction("RLC, E", &z80::RLC_R, 10);
-    instructionTableCB[0x04] = Instruction("RLC, H", &z80::RLC_R, 10);
-    instructionTableCB[0x05] = Instruction("RLC, L", &z80::RLC_R, 10);
-    instructionTableCB[0x07] = Instruction("RLC, A", &z80::RLC_R, 10);
-    instructionTableCB[0x06] = Instruction("RLC, HL", &z80::RLC_HL, 10);
-
-    instructionTableCB[0x10] = Instruction("RL, B", &z80::RL_R, 10);
-    instructionTableCB[0x11] = Instruction("RL, C", &z80::RL_R, 10);
-    instructionTableCB[0x12] = Instruction("RL, D", &z80::RL_R, 10);
-    instructionTableCB[0x13] = Instruction("RL, E", &z80::RL_R, 10);
-    instructionTableCB[0x14] = Instruction("RL, H", &z80::RL_R, 10);
-    instructionTableCB[0x15] = Instruction("RL, L", &z80::RL_R, 10);
-    instructionTableCB[0x17] = Instruction("RL, A", &z80::RL_R, 10);
-    instructionTableCB[0x16] = Instruction("RL, (HL)", &z80::RL_HL, 10);
-
-    instructionTableCB[0x18] = Instruction("RR, B", &z80::RR_R, 10);
-    instructionTableCB[0x19] = Instruction("RR, C", &z80::RR_R, 10);
-    instructionTableCB[0x1A] = Instruction("RR, D", &z80::RR_R, 10);
-    instructionTableCB[0x1B] = Instruction("RR, E", &z80::RR_R, 10);
-    instructionTableCB[0x1C] = Instruction("RR, H", &z80::RR_R, 10);
-    instructionTableCB[0x1D] = Instruction("RR, L", &z80::RR_R, 10);
-    instructionTableCB[0x1F] = Instruction("RR, A", &z80::RR_R, 10);
-    instructionTableCB[0x1E] = Instruction("RR, (HL)", &z80::RR_HL, 10);
-
-    instructionTableCB[0x08] = Instruction("RRC, B", &z80::RRC_R, 10);
-    instructionTableCB[0x09] = Instruction("RRC, C", &z80::RRC_R, 10);
-    instructionTableCB[0x0A] = Instruction("RRC, D", &z80::RRC_R, 10);
-    instructionTableCB[0x0B] = Instruction("RRC, E", &z80::RRC_R, 10);
-    instructionTableCB[0x0C] = Instruction("RRC, H", &z80::RRC_R, 10);
-    instructionTableCB[0x0D] = Instruction("RRC, L", &z80::RRC_R, 10);
-    instructionTableCB[0x0F] = Instruction("RRC, A", &z80::RRC_R, 10);
-    instructionTableCB[0x0E] = Instruction("RRC, (HL)", &z80::RRC_HL, 10);
-
-    instructionTableCB[0x20] = Instruction("SLA, B", &z80::SLA_R, 10);
-    instructionTableCB[0x21] = Instruction("SLA, C", &z80::SLA_R, 10);
-    instructionTableCB[0x22] = Instruction("SLA, D", &z80::SLA_R, 10);
-    instructionTableCB[0x23] = Instruction("SLA, E", &z80::SLA_R, 10);
-    instructionTableCB[0x24] = Instruction("SLA, H", &z80::SLA_R, 10);
-    instructionTableCB[0x25] = Instruction("SLA, L", &z80::SLA_R, 10);
-    instructionTableCB[0x27] = Instruction("SLA, A", &z80::SLA_R, 10);
-    instructionTableCB[0x26] = Instruction("SLA, (HL)", &z80::SLA_HL, 10);
-
-    instructionTableCB[0x30] = Instruction("SLS, B", &z80::SLS_R, 10);
-    instructionTableCB[0x31] = Instruction("SLS, C", &z80::SLS_R, 10);
-    instructionTableCB[0x32] = Instruction("SLS, D", &z80::SLS_R, 10);
-    instructionTableCB[0x33] = Instruction("SLS, E", &z80::SLS_R, 10);
-    instructionTableCB[0x34] = Instruction("SLS, H", &z80::SLS_R, 10);
-    instructionTableCB[0x35] = Instruction("SLS, L", &z80::SLS_R, 10);
-    instructionTableCB[0x37] = Instruction("SLS, A", &z80::SLS_R, 10);
-    instructionTableCB[0x36] = Instruction("SLS, (HL)", &z80::SLS_HL, 10);
-
-    instructionTableCB[0x28] = Instruction("SRA, B", &z80::SRA_R, 10);
-    instructionTableCB[0x29] = Instruction("SRA, C", &z80::SRA_R, 10);
-    instructionTableCB[0x2A] = Instruction("SRA, D", &z80::SRA_R, 10);
-    instructionTableCB[0x2B] = Instruction("SRA, E", &z80::SRA_R, 10);
-    instructionTableCB[0x2C] = Instruction("SRA, H", &z80::SRA_R, 10);
-    instructionTableCB[0x2D] = Instruction("SRA, L", &z80::SRA_R, 10);
-    instructionTableCB[0x2F] = Instruction("SRA, A", &z80::SRA_R, 10);
-    instructionTableCB[0x2E] = Instruction("SRA, (HL)", &z80::SRA_HL, 10);
-
-    instructionTableCB[0x38] = Instruction("SRL, B", &z80::SRL_R, 10);
-    instructionTableCB[0x39] = Instruction("SRL, C", &z80::SRL_R, 10);
-    instructionTableCB[0x3A] = Instruction("SRL, D", &z80::SRL_R, 10);
-    instructionTableCB[0x3B] = Instruction("SRL, E", &z80::SRL_R, 10);
-    instructionTableCB[0x3C] = Instruction("SRL, H", &z80::SRL_R, 10);
-    instructionTableCB[0x3D] = Instruction("SRL, L", &z80::SRL_R, 10);
-    instructionTableCB[0x3F] = Instruction("SRL, A", &z80::SRL_R, 10);
-    instructionTableCB[0x3E] = Instruction("SRL, (HL)", &z80::SRL_HL, 10);
-
-    instructionTableCB[0x40] = Instruction("BIT 0, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x41] = Instruction("BIT 0, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x42] = Instruction("BIT 0, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x43] = Instruction("BIT 0, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x44] = Instruction("BIT 0, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x45] = Instruction("BIT 0, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x47] = Instruction("BIT 0, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x46] = Instruction("BIT 0, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xC0] = Instruction("SET 0, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xC1] = Instruction("SET 0, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xC2] = Instruction("SET 0, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xC3] = Instruction("SET 0, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xC4] = Instruction("SET 0, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xC5] = Instruction("SET 0, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xC7] = Instruction("SET 0, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xC6] = Instruction("SET 0, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0x80] = Instruction("RES 0, B", &z80::RES_B_R, 10);
-    instructionTableCB[0x81] = Instruction("RES 0, C", &z80::RES_B_R, 10);
-    instructionTableCB[0x82] = Instruction("RES 0, D", &z80::RES_B_R, 10);
-    instructionTableCB[0x83] = Instruction("RES 0, E", &z80::RES_B_R, 10);
-    instructionTableCB[0x84] = Instruction("RES 0, H", &z80::RES_B_R, 10);
-    instructionTableCB[0x85] = Instruction("RES 0, L", &z80::RES_B_R, 10);
-    instructionTableCB[0x87] = Instruction("RES 0, A", &z80::RES_B_R, 10);
-    instructionTableCB[0x86] = Instruction("RES 0, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x48] = Instruction("BIT 1, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x49] = Instruction("BIT 1, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4A] = Instruction("BIT 1, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4B] = Instruction("BIT 1, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4C] = Instruction("BIT 1, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4D] = Instruction("BIT 1, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4F] = Instruction("BIT 1, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x4E] = Instruction("BIT 1, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xC8] = Instruction("SET 1, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xC9] = Instruction("SET 1, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xCA] = Instruction("SET 1, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xCB] = Instruction("SET 1, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xCC] = Instruction("SET 1, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xCD] = Instruction("SET 1, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xCF] = Instruction("SET 1, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xCE] = Instruction("SET 1, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0x88] = Instruction("RES 1, B", &z80::RES_B_R, 10);
-    instructionTableCB[0x89] = Instruction("RES 1, C", &z80::RES_B_R, 10);
-    instructionTableCB[0x8A] = Instruction("RES 1, D", &z80::RES_B_R, 10);
-    instructionTableCB[0x8B] = Instruction("RES 1, E", &z80::RES_B_R, 10);
-    instructionTableCB[0x8C] = Instruction("RES 1, H", &z80::RES_B_R, 10);
-    instructionTableCB[0x8D] = Instruction("RES 1, L", &z80::RES_B_R, 10);
-    instructionTableCB[0x8F] = Instruction("RES 1, A", &z80::RES_B_R, 10);
-    instructionTableCB[0x8E] = Instruction("RES 1, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x50] = Instruction("BIT 2, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x51] = Instruction("BIT 2, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x52] = Instruction("BIT 2, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x53] = Instruction("BIT 2, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x54] = Instruction("BIT 2, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x55] = Instruction("BIT 2, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x57] = Instruction("BIT 2, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x56] = Instruction("BIT 2, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xD0] = Instruction("SET 2, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xD1] = Instruction("SET 2, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xD2] = Instruction("SET 2, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xD3] = Instruction("SET 2, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xD4] = Instruction("SET 2, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xD5] = Instruction("SET 2, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xD7] = Instruction("SET 2, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xD6] = Instruction("SET 2, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0x90] = Instruction("RES 2, B", &z80::RES_B_R, 10);
-    instructionTableCB[0x91] = Instruction("RES 2, C", &z80::RES_B_R, 10);
-    instructionTableCB[0x92] = Instruction("RES 2, D", &z80::RES_B_R, 10);
-    instructionTableCB[0x93] = Instruction("RES 2, E", &z80::RES_B_R, 10);
-    instructionTableCB[0x94] = Instruction("RES 2, H", &z80::RES_B_R, 10);
-    instructionTableCB[0x95] = Instruction("RES 2, L", &z80::RES_B_R, 10);
-    instructionTableCB[0x97] = Instruction("RES 2, A", &z80::RES_B_R, 10);
-    instructionTableCB[0x96] = Instruction("RES 2, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x58] = Instruction("BIT 3, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x59] = Instruction("BIT 3, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5A] = Instruction("BIT 3, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5B] = Instruction("BIT 3, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5C] = Instruction("BIT 3, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5D] = Instruction("BIT 3, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5F] = Instruction("BIT 3, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x5E] = Instruction("BIT 3, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xD8] = Instruction("SET 3, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xD9] = Instruction("SET 3, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xDA] = Instruction("SET 3, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xDB] = Instruction("SET 3, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xDC] = Instruction("SET 3, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xDD] = Instruction("SET 3, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xDF] = Instruction("SET 3, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xDE] = Instruction("SET 3, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0x98] = Instruction("RES 3, B", &z80::RES_B_R, 10);
-    instructionTableCB[0x99] = Instruction("RES 3, C", &z80::RES_B_R, 10);
-    instructionTableCB[0x9A] = Instruction("RES 3, D", &z80::RES_B_R, 10);
-    instructionTableCB[0x9B] = Instruction("RES 3, E", &z80::RES_B_R, 10);
-    instructionTableCB[0x9C] = Instruction("RES 3, H", &z80::RES_B_R, 10);
-    instructionTableCB[0x9D] = Instruction("RES 3, L", &z80::RES_B_R, 10);
-    instructionTableCB[0x9F] = Instruction("RES 3, A", &z80::RES_B_R, 10);
-    instructionTableCB[0x9E] = Instruction("RES 3, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x60] = Instruction("BIT 4, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x61] = Instruction("BIT 4, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x62] = Instruction("BIT 4, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x63] = Instruction("BIT 4, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x64] = Instruction("BIT 4, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x65] = Instruction("BIT 4, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x67] = Instruction("BIT 4, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x66] = Instruction("BIT 4, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xE0] = Instruction("SET 4, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xE1] = Instruction("SET 4, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xE2] = Instruction("SET 4, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xE3] = Instruction("SET 4, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xE4] = Instruction("SET 4, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xE5] = Instruction("SET 4, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xE7] = Instruction("SET 4, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xE6] = Instruction("SET 4, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0xA0] = Instruction("RES 4, B", &z80::RES_B_R, 10);
-    instructionTableCB[0xA1] = Instruction("RES 4, C", &z80::RES_B_R, 10);
-    instructionTableCB[0xA2] = Instruction("RES 4, D", &z80::RES_B_R, 10);
-    instructionTableCB[0xA3] = Instruction("RES 4, E", &z80::RES_B_R, 10);
-    instructionTableCB[0xA4] = Instruction("RES 4, H", &z80::RES_B_R, 10);
-    instructionTableCB[0xA5] = Instruction("RES 4, L", &z80::RES_B_R, 10);
-    instructionTableCB[0xA7] = Instruction("RES 4, A", &z80::RES_B_R, 10);
-    instructionTableCB[0xA6] = Instruction("RES 4, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x68] = Instruction("BIT 5, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x69] = Instruction("BIT 5, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6A] = Instruction("BIT 5, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6B] = Instruction("BIT 5, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6C] = Instruction("BIT 5, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6D] = Instruction("BIT 5, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6F] = Instruction("BIT 5, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x6E] = Instruction("BIT 5, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xE8] = Instruction("SET 5, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xE9] = Instruction("SET 5, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xEA] = Instruction("SET 5, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xEB] = Instruction("SET 5, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xEC] = Instruction("SET 5, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xED] = Instruction("SET 5, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xEF] = Instruction("SET 5, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xEE] = Instruction("SET 5, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0xA8] = Instruction("RES 5, B", &z80::RES_B_R, 10);
-    instructionTableCB[0xA9] = Instruction("RES 5, C", &z80::RES_B_R, 10);
-    instructionTableCB[0xAA] = Instruction("RES 5, D", &z80::RES_B_R, 10);
-    instructionTableCB[0xAB] = Instruction("RES 5, E", &z80::RES_B_R, 10);
-    instructionTableCB[0xAC] = Instruction("RES 5, H", &z80::RES_B_R, 10);
-    instructionTableCB[0xAD] = Instruction("RES 5, L", &z80::RES_B_R, 10);
-    instructionTableCB[0xAF] = Instruction("RES 5, A", &z80::RES_B_R, 10);
-    instructionTableCB[0xAE] = Instruction("RES 5, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x70] = Instruction("BIT 6, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x71] = Instruction("BIT 6, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x72] = Instruction("BIT 6, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x73] = Instruction("BIT 6, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x74] = Instruction("BIT 6, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x75] = Instruction("BIT 6, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x77] = Instruction("BIT 6, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x76] = Instruction("BIT 6, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xF0] = Instruction("SET 6, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xF1] = Instruction("SET 6, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xF2] = Instruction("SET 6, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xF3] = Instruction("SET 6, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xF4] = Instruction("SET 6, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xF5] = Instruction("SET 6, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xF7] = Instruction("SET 6, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xF6] = Instruction("SET 6, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0xB0] = Instruction("RES 6, B", &z80::RES_B_R, 10);
-    instructionTableCB[0xB1] = Instruction("RES 6, C", &z80::RES_B_R, 10);
-    instructionTableCB[0xB2] = Instruction("RES 6, D", &z80::RES_B_R, 10);
-    instructionTableCB[0xB3] = Instruction("RES 6, E", &z80::RES_B_R, 10);
-    instructionTableCB[0xB4] = Instruction("RES 6, H", &z80::RES_B_R, 10);
-    instructionTableCB[0xB5] = Instruction("RES 6, L", &z80::RES_B_R, 10);
-    instructionTableCB[0xB7] = Instruction("RES 6, A", &z80::RES_B_R, 10);
-    instructionTableCB[0xB6] = Instruction("RES 6, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableCB[0x78] = Instruction("BIT 7, B", &z80::BIT_B_R, 10);
-    instructionTableCB[0x79] = Instruction("BIT 7, C", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7A] = Instruction("BIT 7, D", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7B] = Instruction("BIT 7, E", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7C] = Instruction("BIT 7, H", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7D] = Instruction("BIT 7, L", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7F] = Instruction("BIT 7, A", &z80::BIT_B_R, 10);
-    instructionTableCB[0x7E] = Instruction("BIT 7, (HL)", &z80::BIT_B_HL, 10);
-
-    instructionTableCB[0xF8] = Instruction("SET 7, B", &z80::SET_B_R, 10);
-    instructionTableCB[0xF9] = Instruction("SET 7, C", &z80::SET_B_R, 10);
-    instructionTableCB[0xFA] = Instruction("SET 7, D", &z80::SET_B_R, 10);
-    instructionTableCB[0xFB] = Instruction("SET 7, E", &z80::SET_B_R, 10);
-    instructionTableCB[0xFC] = Instruction("SET 7, H", &z80::SET_B_R, 10);
-    instructionTableCB[0xFD] = Instruction("SET 7, L", &z80::SET_B_R, 10);
-    instructionTableCB[0xFF] = Instruction("SET 7, A", &z80::SET_B_R, 10);
-    instructionTableCB[0xFE] = Instruction("SET 7, (HL)", &z80::SET_B_HL, 10);
-
-    instructionTableCB[0xB8] = Instruction("RES 7, B", &z80::RES_B_R, 10);
-    instructionTableCB[0xB9] = Instruction("RES 7, C", &z80::RES_B_R, 10);
-    instructionTableCB[0xBA] = Instruction("RES 7, D", &z80::RES_B_R, 10);
-    instructionTableCB[0xBB] = Instruction("RES 7, E", &z80::RES_B_R, 10);
-    instructionTableCB[0xBC] = Instruction("RES 7, H", &z80::RES_B_R, 10);
-    instructionTableCB[0xBD] = Instruction("RES 7, L", &z80::RES_B_R, 10);
-    instructionTableCB[0xBF] = Instruction("RES 7, A", &z80::RES_B_R, 10);
-    instructionTableCB[0xBE] = Instruction("RES 7, (HL)", &z80::RES_B_HL, 10);
-
-    instructionTableDDCB[0x40] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x41] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x42] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x43] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x44] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x45] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x46] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x47] = Instruction("BIT 0, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xC0] = Instruction("SET 0, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC1] = Instruction("SET 0, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC2] = Instruction("SET 0, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC3] = Instruction("SET 0, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC4] = Instruction("SET 0, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC5] = Instruction("SET 0, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC6] = Instruction("SET 0, (IX+d)", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC7] = Instruction("SET 0, (IX+d) ,A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0x80] = Instruction("RES 0, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x81] = Instruction("RES 0, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x82] = Instruction("RES 0, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x83] = Instruction("RES 0, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x84] = Instruction("RES 0, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x85] = Instruction("RES 0, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x86] = Instruction("RES 0, (IX+d)", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x87] = Instruction("RES 0, (IX+d) ,A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x48] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x49] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4A] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4B] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4C] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4D] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4E] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x4F] = Instruction("BIT 1, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xC8] = Instruction("SET 1, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xC9] = Instruction("SET 1, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCA] = Instruction("SET 1, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCB] = Instruction("SET 1, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCC] = Instruction("SET 1, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCD] = Instruction("SET 1, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCE] = Instruction("SET 1, (IX+d),", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xCF] = Instruction("SET 1, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0x88] = Instruction("RES 1, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x89] = Instruction("RES 1, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8A] = Instruction("RES 1, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8B] = Instruction("RES 1, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8C] = Instruction("RES 1, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8D] = Instruction("RES 1, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8E] = Instruction("RES 1, (IX+d),", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x8F] = Instruction("RES 1, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x50] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x51] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x52] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x53] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x54] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x55] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x56] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x57] = Instruction("BIT 2, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xD0] = Instruction("SET 2, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD1] = Instruction("SET 2, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD2] = Instruction("SET 2, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD3] = Instruction("SET 2, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD4] = Instruction("SET 2, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD5] = Instruction("SET 2, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD6] = Instruction("SET 2, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD7] = Instruction("SET 2, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0x90] = Instruction("RES 2, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x91] = Instruction("RES 2, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x92] = Instruction("RES 2, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x93] = Instruction("RES 2, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x94] = Instruction("RES 2, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x95] = Instruction("RES 2, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x96] = Instruction("RES 2, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x97] = Instruction("RES 2, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x58] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x59] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5A] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5B] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5C] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5D] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5E] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x5F] = Instruction("BIT 3, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xD8] = Instruction("SET 3, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xD9] = Instruction("SET 3, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDA] = Instruction("SET 3, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDB] = Instruction("SET 3, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDC] = Instruction("SET 3, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDD] = Instruction("SET 3, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDE] = Instruction("SET 3, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xDF] = Instruction("SET 3, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0x98] = Instruction("RES 3, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x99] = Instruction("RES 3, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9A] = Instruction("RES 3, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9B] = Instruction("RES 3, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9C] = Instruction("RES 3, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9D] = Instruction("RES 3, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9E] = Instruction("RES 3, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0x9F] = Instruction("RES 3, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x60] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x61] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x62] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x63] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x64] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x65] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x66] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x67] = Instruction("BIT 4, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xE0] = Instruction("SET 4, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE1] = Instruction("SET 4, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE2] = Instruction("SET 4, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE3] = Instruction("SET 4, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE4] = Instruction("SET 4, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE5] = Instruction("SET 4, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE6] = Instruction("SET 4, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE7] = Instruction("SET 4, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0xA0] = Instruction("RES 4, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA1] = Instruction("RES 4, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA2] = Instruction("RES 4, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA3] = Instruction("RES 4, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA4] = Instruction("RES 4, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA5] = Instruction("RES 4, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA6] = Instruction("RES 4, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA7] = Instruction("RES 4, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x68] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x69] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6A] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6B] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6C] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6D] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6E] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x6F] = Instruction("BIT 5, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xE8] = Instruction("SET 5, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xE9] = Instruction("SET 5, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xEA] = Instruction("SET 5, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xEB] = Instruction("SET 5, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xEC] = Instruction("SET 5, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xED] = Instruction("SET 5, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xEE] = Instruction("SET 5, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xEF] = Instruction("SET 5, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0xA8] = Instruction("RES 5, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xA9] = Instruction("RES 5, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAA] = Instruction("RES 5, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAB] = Instruction("RES 5, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAC] = Instruction("RES 5, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAD] = Instruction("RES 5, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAE] = Instruction("RES 5, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xAF] = Instruction("RES 5, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x70] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x71] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x72] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x73] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x74] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x75] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x76] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x77] = Instruction("BIT 6, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xF0] = Instruction("SET 6, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF1] = Instruction("SET 6, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF2] = Instruction("SET 6, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF3] = Instruction("SET 6, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF4] = Instruction("SET 6, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF5] = Instruction("SET 6, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF6] = Instruction("SET 6, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF7] = Instruction("SET 6, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0xB0] = Instruction("RES 6, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB1] = Instruction("RES 6, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB2] = Instruction("RES 6, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB3] = Instruction("RES 6, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB4] = Instruction("RES 6, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB5] = Instruction("RES 6, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB6] = Instruction("RES 6, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB7] = Instruction("RES 6, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x78] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x79] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7A] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7B] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7C] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7D] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7E] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-    instructionTableDDCB[0x7F] = Instruction("BIT 7, (IX+d)", &z80::BIT_B_IX_D, 10);
-
-    instructionTableDDCB[0xF8] = Instruction("SET 7, (IX+d), B", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xF9] = Instruction("SET 7, (IX+d), C", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFA] = Instruction("SET 7, (IX+d), D", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFB] = Instruction("SET 7, (IX+d), E", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFC] = Instruction("SET 7, (IX+d), H", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFD] = Instruction("SET 7, (IX+d), L", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFE] = Instruction("SET 7, (IX+d),  ", &z80::SET_B_IX_D, 10);
-    instructionTableDDCB[0xFF] = Instruction("SET 7, (IX+d), A", &z80::SET_B_IX_D, 10);
-
-    instructionTableDDCB[0xB8] = Instruction("RES 7, (IX+d), B", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xB9] = Instruction("RES 7, (IX+d), C", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBA] = Instruction("RES 7, (IX+d), D", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBB] = Instruction("RES 7, (IX+d), E", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBC] = Instruction("RES 7, (IX+d), H", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBD] = Instruction("RES 7, (IX+d), L", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBE] = Instruction("RES 7, (IX+d),  ", &z80::RES_B_IX_D, 10);
-    instructionTableDDCB[0xBF] = Instruction("RES 7, (IX+d), A", &z80::RES_B_IX_D, 10);
-
-    instructionTableDDCB[0x00] = Instruction("RLC (IX+d), B", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x01] = Instruction("RLC (IX+d), C", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x02] = Instruction("RLC (IX+d), D", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x03] = Instruction("RLC (IX+d), E", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x04] = Instruction("RLC (IX+d), H", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x05] = Instruction("RLC (IX+d), L", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x06] = Instruction("RLC (IX+d)", &z80::RLC_IX_D, 10);
-    instructionTableDDCB[0x07] = Instruction("RLC (IX+d), A", &z80::RLC_IX_D, 10);
-
-    instructionTableDDCB[0x10] = Instruction("RL (IX+d), B", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x11] = Instruction("RL (IX+d), C", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x12] = Instruction("RL (IX+d), D", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x13] = Instruction("RL (IX+d), E", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x14] = Instruction("RL (IX+d), H", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x15] = Instruction("RL (IX+d), L", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x16] = Instruction("RL (IX+d)", &z80::RL_IX_D, 10);
-    instructionTableDDCB[0x17] = Instruction("RL (IX+d), A", &z80::RL_IX_D, 10);
-
-    instructionTableDDCB[0x08] = Instruction("RRC (IX+d), B", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x09] = Instruction("RRC (IX+d), C", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0A] = Instruction("RRC (IX+d), D", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0B] = Instruction("RRC (IX+d), E", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0C] = Instruction("RRC (IX+d), H", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0D] = Instruction("RRC (IX+d), L", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0E] = Instruction("RRC (IX+d)", &z80::RRC_IX_D, 10);
-    instructionTableDDCB[0x0F] = Instruction("RRC (IX+d), A", &z80::RRC_IX_D, 10);
-
-    instructionTableDDCB[0x18] = Instruction("RR (IX+d), B", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x19] = Instruction("RR (IX+d), C", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1A] = Instruction("RR (IX+d), D", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1B] = Instruction("RR (IX+d), E", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1C] = Instruction("RR (IX+d), H", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1D] = Instruction("RR (IX+d), L", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1E] = Instruction("RR (IX+d)", &z80::RR_IX_D, 10);
-    instructionTableDDCB[0x1F] = Instruction("RR (IX+d), A", &z80::RR_IX_D, 10);
-
-    instructionTableDDCB[0x20] = Instruction("SLA (IX+d), B", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x21] = Instruction("SLA (IX+d), C", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x22] = Instruction("SLA (IX+d), D", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x23] = Instruction("SLA (IX+d), E", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x24] = Instruction("SLA (IX+d), H", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x25] = Instruction("SLA (IX+d), L", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x26] = Instruction("SLA (IX+d)", &z80::SLA_IX_D, 10);
-    instructionTableDDCB[0x27] = Instruction("SLA (IX+d), A", &z80::SLA_IX_D, 10);
-
-    instructionTableDDCB[0x30] = Instruction("SLS (IX+d), B", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x31] = Instruction("SLS (IX+d), C", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x32] = Instruction("SLS (IX+d), D", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x33] = Instruction("SLS (IX+d), E", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x34] = Instruction("SLS (IX+d), H", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x35] = Instruction("SLS (IX+d), L", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x36] = Instruction("SLS (IX+d)", &z80::SLS_IX_D, 10);
-    instructionTableDDCB[0x37] = Instruction("SLS (IX+d), A", &z80::SLS_IX_D, 10);
-
-    instructionTableDDCB[0x28] = Instruction("SRA (IX+d), B", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x29] = Instruction("SRA (IX+d), C", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2A] = Instruction("SRA (IX+d), D", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2B] = Instruction("SRA (IX+d), E", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2C] = Instruction("SRA (IX+d), H", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2D] = Instruction("SRA (IX+d), L", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2E] = Instruction("SRA (IX+d)", &z80::SRA_IX_D, 10);
-    instructionTableDDCB[0x2F] = Instruction("SRA (IX+d), A", &z80::SRA_IX_D, 10);
-
-    instructionTableDDCB[0x38] = Instruction("SRL (IX+d), B", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x39] = Instruction("SRL (IX+d), C", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3A] = Instruction("SRL (IX+d), D", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3B] = Instruction("SRL (IX+d), E", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3C] = Instruction("SRL (IX+d), H", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3D] = Instruction("SRL (IX+d), L", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3E] = Instruction("SRL (IX+d)", &z80::SRL_IX_D, 10);
-    instructionTableDDCB[0x3F] = Instruction("SRL (IX+d), A", &z80::SRL_IX_D, 10);
-
-    instructionTableFDCB[0x00] = Instruction("RLC (IY+d), B", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x01] = Instruction("RLC (IY+d), C", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x02] = Instruction("RLC (IY+d), D", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x03] = Instruction("RLC (IY+d), E", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x04] = Instruction("RLC (IY+d), H", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x05] = Instruction("RLC (IY+d), L", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x06] = Instruction("RLC (IY+d)", &z80::RLC_IY_D, 10);
-    instructionTableFDCB[0x07] = Instruction("RLC (IY+d), A", &z80::RLC_IY_D, 10);
-
-    instructionTableFDCB[0x10] = Instruction("RL (IY+d), B", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x11] = Instruction("RL (IY+d), C", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x12] = Instruction("RL (IY+d), D", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x13] = Instruction("RL (IY+d), E", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x14] = Instruction("RL (IY+d), H", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x15] = Instruction("RL (IY+d), L", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x16] = Instruction("RL (IY+d)", &z80::RL_IY_D, 10);
-    instructionTableFDCB[0x17] = Instruction("RL (IY+d), A", &z80::RL_IY_D, 10);
-
-    instructionTableFDCB[0x08] = Instruction("RRC (IY+d), B", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x09] = Instruction("RRC (IY+d), C", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0A] = Instruction("RRC (IY+d), D", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0B] = Instruction("RRC (IY+d), E", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0C] = Instruction("RRC (IY+d), H", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0D] = Instruction("RRC (IY+d), L", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0E] = Instruction("RRC (IY+d)", &z80::RRC_IY_D, 10);
-    instructionTableFDCB[0x0F] = Instruction("RRC (IY+d), A", &z80::RRC_IY_D, 10);
-
-    instructionTableFDCB[0x18] = Instruction("RR (IY+d), B", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x19] = Instruction("RR (IY+d), C", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1A] = Instruction("RR (IY+d), D", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1B] = Instruction("RR (IY+d), E", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1C] = Instruction("RR (IY+d), H", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1D] = Instruction("RR (IY+d), L", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1E] = Instruction("RR (IY+d)", &z80::RR_IY_D, 10);
-    instructionTableFDCB[0x1F] = Instruction("RR (IY+d), A", &z80::RR_IY_D, 10);
-
-    instructionTableFDCB[0x20] = Instruction("SLA (IY+d), B", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x21] = Instruction("SLA (IY+d), C", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x22] = Instruction("SLA (IY+d), D", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x23] = Instruction("SLA (IY+d), E", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x24] = Instruction("SLA (IY+d), H", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x25] = Instruction("SLA (IY+d), L", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x26] = Instruction("SLA (IY+d)", &z80::SLA_IY_D, 10);
-    instructionTableFDCB[0x27] = Instruction("SLA (IY+d), A", &z80::SLA_IY_D, 10);
-
-    instructionTableFDCB[0x30] = Instruction("SLS (IY+d), B", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x31] = Instruction("SLS (IY+d), C", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x32] = Instruction("SLS (IY+d), D", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x33] = Instruction("SLS (IY+d), E", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x34] = Instruction("SLS (IY+d), H", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x35] = Instruction("SLS (IY+d), L", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x36] = Instruction("SLS (IY+d)", &z80::SLS_IY_D, 10);
-    instructionTableFDCB[0x37] = Instruction("SLS (IY+d), A", &z80::SLS_IY_D, 10);
-
-    instructionTableFDCB[0x28] = Instruction("SRA (IY+d), B", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x29] = Instruction("SRA (IY+d), C", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2A] = Instruction("SRA (IY+d), D", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2B] = Instruction("SRA (IY+d), E", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2C] = Instruction("SRA (IY+d), H", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2D] = Instruction("SRA (IY+d), L", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2E] = Instruction("SRA (IY+d)", &z80::SRA_IY_D, 10);
-    instructionTableFDCB[0x2F] = Instruction("SRA (IY+d), A", &z80::SRA_IY_D, 10);
-
-    instructionTableFDCB[0x38] = Instruction("SRL (IY+d), B", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x39] = Instruction("SRL (IY+d), C", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3A] = Instruction("SRL (IY+d), D", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3B] = Instruction("SRL (IY+d), E", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3C] = Instruction("SRL (IY+d), H", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3D] = Instruction("SRL (IY+d), L", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3E] = Instruction("SRL (IY+d)", &z80::SRL_IY_D, 10);
-    instructionTableFDCB[0x3F] = Instruction("SRL (IY+d), A", &z80::SRL_IY_D, 10);
-
-    instructionTableFDCB[0x40] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x41] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x42] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x43] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x44] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x45] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x46] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x47] = Instruction("BIT 0, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xC0] = Instruction("SET 0, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC1] = Instruction("SET 0, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC2] = Instruction("SET 0, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC3] = Instruction("SET 0, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC4] = Instruction("SET 0, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC5] = Instruction("SET 0, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC6] = Instruction("SET 0, (IY+d)", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC7] = Instruction("SET 0, (IY+d) ,A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0x80] = Instruction("RES 0, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x81] = Instruction("RES 0, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x82] = Instruction("RES 0, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x83] = Instruction("RES 0, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x84] = Instruction("RES 0, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x85] = Instruction("RES 0, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x86] = Instruction("RES 0, (IY+d)", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x87] = Instruction("RES 0, (IY+d) ,A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x48] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x49] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4A] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4B] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4C] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4D] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4E] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x4F] = Instruction("BIT 1, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xC8] = Instruction("SET 1, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xC9] = Instruction("SET 1, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCA] = Instruction("SET 1, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCB] = Instruction("SET 1, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCC] = Instruction("SET 1, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCD] = Instruction("SET 1, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCE] = Instruction("SET 1, (IY+d),", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xCF] = Instruction("SET 1, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0x88] = Instruction("RES 1, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x89] = Instruction("RES 1, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8A] = Instruction("RES 1, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8B] = Instruction("RES 1, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8C] = Instruction("RES 1, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8D] = Instruction("RES 1, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8E] = Instruction("RES 1, (IY+d),", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x8F] = Instruction("RES 1, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x50] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x51] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x52] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x53] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x54] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x55] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x56] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x57] = Instruction("BIT 2, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xD0] = Instruction("SET 2, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD1] = Instruction("SET 2, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD2] = Instruction("SET 2, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD3] = Instruction("SET 2, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD4] = Instruction("SET 2, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD5] = Instruction("SET 2, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD6] = Instruction("SET 2, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD7] = Instruction("SET 2, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0x90] = Instruction("RES 2, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x91] = Instruction("RES 2, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x92] = Instruction("RES 2, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x93] = Instruction("RES 2, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x94] = Instruction("RES 2, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x95] = Instruction("RES 2, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x96] = Instruction("RES 2, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x97] = Instruction("RES 2, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x58] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x59] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5A] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5B] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5C] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5D] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5E] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x5F] = Instruction("BIT 3, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xD8] = Instruction("SET 3, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xD9] = Instruction("SET 3, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDA] = Instruction("SET 3, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDB] = Instruction("SET 3, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDC] = Instruction("SET 3, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDD] = Instruction("SET 3, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDE] = Instruction("SET 3, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xDF] = Instruction("SET 3, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0x98] = Instruction("RES 3, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x99] = Instruction("RES 3, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9A] = Instruction("RES 3, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9B] = Instruction("RES 3, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9C] = Instruction("RES 3, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9D] = Instruction("RES 3, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9E] = Instruction("RES 3, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0x9F] = Instruction("RES 3, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x60] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x61] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x62] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x63] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x64] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x65] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x66] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x67] = Instruction("BIT 4, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xE0] = Instruction("SET 4, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE1] = Instruction("SET 4, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE2] = Instruction("SET 4, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE3] = Instruction("SET 4, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE4] = Instruction("SET 4, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE5] = Instruction("SET 4, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE6] = Instruction("SET 4, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE7] = Instruction("SET 4, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0xA0] = Instruction("RES 4, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA1] = Instruction("RES 4, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA2] = Instruction("RES 4, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA3] = Instruction("RES 4, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA4] = Instruction("RES 4, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA5] = Instruction("RES 4, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA6] = Instruction("RES 4, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA7] = Instruction("RES 4, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x68] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x69] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6A] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6B] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6C] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6D] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6E] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x6F] = Instruction("BIT 5, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xE8] = Instruction("SET 5, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xE9] = Instruction("SET 5, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xEA] = Instruction("SET 5, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xEB] = Instruction("SET 5, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xEC] = Instruction("SET 5, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xED] = Instruction("SET 5, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xEE] = Instruction("SET 5, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xEF] = Instruction("SET 5, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0xA8] = Instruction("RES 5, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xA9] = Instruction("RES 5, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAA] = Instruction("RES 5, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAB] = Instruction("RES 5, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAC] = Instruction("RES 5, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAD] = Instruction("RES 5, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAE] = Instruction("RES 5, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xAF] = Instruction("RES 5, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x70] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x71] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x72] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x73] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x74] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x75] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x76] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x77] = Instruction("BIT 6, (IY+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xF0] = Instruction("SET 6, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF1] = Instruction("SET 6, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF2] = Instruction("SET 6, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF3] = Instruction("SET 6, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF4] = Instruction("SET 6, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF5] = Instruction("SET 6, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF6] = Instruction("SET 6, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF7] = Instruction("SET 6, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0xB0] = Instruction("RES 6, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB1] = Instruction("RES 6, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB2] = Instruction("RES 6, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB3] = Instruction("RES 6, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB4] = Instruction("RES 6, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB5] = Instruction("RES 6, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB6] = Instruction("RES 6, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB7] = Instruction("RES 6, (IY+d), A", &z80::RES_B_IY_D, 10);
-
-    instructionTableFDCB[0x78] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x79] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7A] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7B] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7C] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7D] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7E] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-    instructionTableFDCB[0x7F] = Instruction("BIT 7, (Iy+d)", &z80::BIT_B_IY_D, 10);
-
-    instructionTableFDCB[0xF8] = Instruction("SET 7, (IY+d), B", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xF9] = Instruction("SET 7, (IY+d), C", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFA] = Instruction("SET 7, (IY+d), D", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFB] = Instruction("SET 7, (IY+d), E", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFC] = Instruction("SET 7, (IY+d), H", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFD] = Instruction("SET 7, (IY+d), L", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFE] = Instruction("SET 7, (IY+d),  ", &z80::SET_B_IY_D, 10);
-    instructionTableFDCB[0xFF] = Instruction("SET 7, (IY+d), A", &z80::SET_B_IY_D, 10);
-
-    instructionTableFDCB[0xB8] = Instruction("RES 7, (IY+d), B", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xB9] = Instruction("RES 7, (IY+d), C", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBA] = Instruction("RES 7, (IY+d), D", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBB] = Instruction("RES 7, (IY+d), E", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBC] = Instruction("RES 7, (IY+d), H", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBD] = Instruction("RES 7, (IY+d), L", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBE] = Instruction("RES 7, (IY+d),  ", &z80::RES_B_IY_D, 10);
-    instructionTableFDCB[0xBF] = Instruction("RES 7, (IY+d), A", &z80::RES_B_IY_D, 10);
-}
+    instructionTableED[0xA0] = Instruction("LDI", &z80::LDI, 16);
+    instructionTableED[0xB0] = Instruction("LDIR", &z80::LDIR, 16);
+    instructionTableED[0xA8] = Instruction("LDD", &z80::LDD, 16);
+    instructionTableED[0xB8] = Instruction("LDDR", &z80::LDDR, 16);
+    instructionTableED[0xA1] = Instruction("CPI", &z80::CPI, 16);
+    instructionTableED[0xB1] = Instruction("CPIR", &z80::CPIR, 16);
+    instructionTableED[0xA9] = Instruction("CPD", &z80::CPD, 16);
+    instructionTableED[0xB9] = Instruction("CPDR", &z80::CPDR, 16);
+    instructionTableED[0x44] = Instruction("NEG ", &z80::NEG, 8);
+
+    instructionTableED[0x4C] = Instruction("NEG ", &z80::NEG, 8);
+
+    instructionTableED[0x54] = Instruction("NEG ", &z80::NEG, 8);
+    instructionTableED[0x5C] = Instruction("NEG ", &z80::NEG, 8);
+    instructionTableED[0x64] = Instruction("NEG ", &z80::NEG, 8);
+    instructionTableED[0x6C] = Instruction("NEG ", &z80::NEG, 8);
+    instructionTableED[0x74] = Instruction("NEG ", &z80::NEG, 8);
+    instructionTableED[0x7C] = Instruction("NEG ", &z80::NEG, 8);
+
+    instructionTableED[0x4E] = Instruction("IM0 ", &z80::IM0, 8);
+    instructionTableED[0x46] = Instruction("IM0 ", &z80::IM0, 8);
+    instructionTableED[0x66] = Instruction("IM0 ", &z80::IM0, 8);
+    instructionTableED[0x6E] = Instruction("IM0 ", &z80::IM0, 8);
+    instructionTableED[0x56] = Instruction("IM1 ", &z80::IM1, 8);
+    instructionTableED[0x5E] = Instruction("IM2 ", &z80::IM2, 8);
+    instructionTableED[0x7E] = Instruction("IM2 ", &z80::IM2, 8);
+
+    instructionTableED[0x4A] = Instruction("ADC HL, BC", &z80::ADC_HL_SS, 15);
+    instructionTableED[0x5A] = Instruction("ADC HL, DE", &z80::ADC_HL_SS, 15);
+    instructionTableED[0x6A] = Instruction("ADC HL, HL", &z80::ADC_HL_SS, 15);
+    instructionTableED[0x7A] = Instruction("ADC HL, SP", &z80::ADC_HL_SS, 15);
+
+    instructionTableED[0x42] = Instruction("SBC HL, BC", &z80::SBC_HL_SS, 15);
+    instructionTableED[0x52] = Instruction("SBC HL, DE", &z80::SBC_HL_SS, 15);
+    instructionTableED[0x62] = Instruction("SBC HL, HL", &z80::SBC_HL_SS, 15);
+    instructionTableED[0x72] = Instruction("SBC HL, SP", &z80::SBC_HL_SS, 15);
+
+    instructionTableED[0x6F] = Instruction("RLD", &z80::RLD, 18);
+    instructionTableED[0x67] = Instruction("RRD", &z80::RRD, 18);
+
+    instructionTableED[0x4D] = Instruction("RETI", &z80::RETI, 14);
+    instructionTableED[0x45] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x55] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x5D] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x65] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x6D] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x75] = Instruction("RETN", &z80::RETN, 14);
+    instructionTableED[0x7D] = Instruction("RETN", &z80::RETN, 14);
+
+    instructionTableED[0x40] = Instruction("IN B, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x48] = Instruction("IN C, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x50] = Instruction("IN D, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x58] = Instruction("IN E, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x60] = Instruction("IN H, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x68] = Instruction("IN L, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x70] = Instruction("IN F, (C)", &z80::IN_R_C, 12);
+    instructionTableED[0x78] = Instruction("IN A, (C)", &z80::IN_R_C, 12);
+
+    instructionTableED[0x41] = Instruction("OUT (C), B", &z80::OUT_C_R, 12);
+    instructionTableED[0x49] = Instruction("OUT (C), C", &z80::OUT_C_R, 12);
+    instructionTableED[0x51] = Instruction("OUT (C), D", &z80::OUT_C_R, 12);
+    instructionTableED[0x59] = Instruction("OUT (C), E", &z80::OUT_C_R, 12);
+    instructionTableED[0x61] = Instruction("OUT (C), H", &z80::OUT_C_R, 12);
+    instructionTableED[0x69] = Instruction("OUT (C), L", &z80::OUT_C_R, 12);
+    instructionTableED[0x71] = Instruction("OUT (C), F", &z80::OUT_C_R, 12);
+    instructionTableED[0x79] = Instruction("OUT (C), A", &z80::OUT_C_R, 12);
+
+    instructionTableED[0xA2] = Instruction("INI", &z80::INI, 16);
+    instructionTableED[0xB2] = Instruction("INIR", &z80::INIR, 16);
+    instructionTableED[0xAA] = Instruction("IND", &z80::IND, 16);
+    instructionTableED[0xBA] = Instruction("INDR", &z80::INDR, 16);
+
+    instructionTableED[0xA3] = Instruction("OUTI", &z80::OUTI, 16);
+    instructionTableED[0xB3] = Instruction("OTIR", &z80::OTIR, 16);
+    instructionTableED[0xAB] = Instruction("OUTD", &z80::OUTD, 16);
+    instructionTableED[0xBB] = Instruction("OTDR", &z80::OTDR, 16);
+    instructionTableED[0x76] = Instruction("IM1", &z80::IM1, 8);
+
+    return instructionTableED;
+}
+
+constexpr InstructionTable buildInstructionTableCB()
+{
+    InstructionTable instructionTableCB{};
+
+    instructionTableCB[0x00] = Instruction("RLC, B", &z80::RLC_R, 8);
+    instructionTableCB[0x01] = Instruction("RLC, C", &z80::RLC_R, 8);
+    instructionTableCB[0x02] = Instruction("RLC, D", &z80::RLC_R, 8);
+    instructionTableCB[0x03] = Instruction("RLC, E", &z80::RLC_R, 8);
+    instructionTableCB[0x04] = Instruction("RLC, H", &z80::RLC_R, 8);
+    instructionTableCB[0x05] = Instruction("RLC, L", &z80::RLC_R, 8);
+    instructionTableCB[0x07] = Instruction("RLC, A", &z80::RLC_R, 8);
+    instructionTableCB[0x06] = Instruction("RLC, HL", &z80::RLC_HL, 15);
+
+    instructionTableCB[0x10] = Instruction("RL, B", &z80::RL_R, 8);
+    instructionTableCB[0x11] = Instruction("RL, C", &z80::RL_R, 8);
+    instructionTableCB[0x12] = Instruction("RL, D", &z80::RL_R, 8);
+    instructionTableCB[0x13] = Instruction("RL, E", &z80::RL_R, 8);
+    instructionTableCB[0x14] = Instruction("RL, H", &z80::RL_R, 8);
+    instructionTableCB[0x15] = Instruction("RL, L", &z80::RL_R, 8);
+    instructionTableCB[0x17] = Instruction("RL, A", &z80::RL_R, 8);
+    instructionTableCB[0x16] = Instruction("RL, (HL)", &z80::RL_HL, 15);
+
+    instructionTableCB[0x18] = Instruction("RR, B", &z80::RR_R, 8);
+    instructionTableCB[0x19] = Instruction("RR, C", &z80::RR_R, 8);
+    instructionTableCB[0x1A] = Instruction("RR, D", &z80::RR_R, 8);
+    instructionTableCB[0x1B] = Instruction("RR, E", &z80::RR_R, 8);
+    instructionTableCB[0x1C] = Instruction("RR, H", &z80::RR_R, 8);
+    instructionTableCB[0x1D] = Instruction("RR, L", &z80::RR_R, 8);
+    instructionTableCB[0x1F] = Instruction("RR, A", &z80::RR_R, 8);
+    instructionTableCB[0x1E] = Instruction("RR, (HL)", &z80::RR_HL, 15);
+
+    instructionTableCB[0x08] = Instruction("RRC, B", &z80::RRC_R, 8);
+    instructionTableCB[0x09] = Instruction("RRC, C", &z80::RRC_R, 8);
+    instructionTableCB[0x0A] = Instruction("RRC, D", &z80::RRC_R, 8);
+    instructionTableCB[0x0B] = Instruction("RRC, E", &z80::RRC_R, 8);
+    instructionTableCB[0x0C] = Instruction("RRC, H", &z80::RRC_R, 8);
+    instructionTableCB[0x0D] = Instruction("RRC, L", &z80::RRC_R, 8);
+    instructionTableCB[0x0F] = Instruction("RRC, A", &z80::RRC_R, 8);
+    instructionTableCB[0x0E] = Instruction("RRC, (HL)", &z80::RRC_HL, 15);
+
+    instructionTableCB[0x20] = Instruction("SLA, B", &z80::SLA_R, 8);
+    instructionTableCB[0x21] = Instruction("SLA, C", &z80::SLA_R, 8);
+    instructionTableCB[0x22] = Instruction("SLA, D", &z80::SLA_R, 8);
+    instructionTableCB[0x23] = Instruction("SLA, E", &z80::SLA_R, 8);
+    instructionTableCB[0x24] = Instruction("SLA, H", &z80::SLA_R, 8);
+    instructionTableCB[0x25] = Instruction("SLA, L", &z80::SLA_R, 8);
+    instructionTableCB[0x27] = Instruction("SLA, A", &z80::SLA_R, 8);
+    instructionTableCB[0x26] = Instruction("SLA, (HL)", &z80::SLA_HL, 15);
+
+    instructionTableCB[0x30] = Instruction("SLS, B", &z80::SLS_R, 8);
+    instructionTableCB[0x31] = Instruction("SLS, C", &z80::SLS_R, 8);
+    instructionTableCB[0x32] = Instruction("SLS, D", &z80::SLS_R, 8);
+    instructionTableCB[0x33] = Instruction("SLS, E", &z80::SLS_R, 8);
+    instructionTableCB[0x34] = Instruction("SLS, H", &z80::SLS_R, 8);
+    instructionTableCB[0x35] = Instruction("SLS, L", &z80::SLS_R, 8);
+    instructionTableCB[0x37] = Instruction("SLS, A", &z80::SLS_R, 8);
+    instructionTableCB[0x36] = Instruction("SLS, (HL)", &z80::SLS_HL, 15);
+
+    instructionTableCB[0x28] = Instruction("SRA, B", &z80::SRA_R, 8);
+    instructionTableCB[0x29] = Instruction("SRA, C", &z80::SRA_R, 8);
+    instructionTableCB[0x2A] = Instruction("SRA, D", &z80::SRA_R, 8);
+    instructionTableCB[0x2B] = Instruction("SRA, E", &z80::SRA_R, 8);
+    instructionTableCB[0x2C] = Instruction("SRA, H", &z80::SRA_R, 8);
+    instructionTableCB[0x2D] = Instruction("SRA, L", &z80::SRA_R, 8);
+    instructionTableCB[0x2F] = Instruction("SRA, A", &z80::SRA_R, 8);
+    instructionTableCB[0x2E] = Instruction("SRA, (HL)", &z80::SRA_HL, 15);
+
+    instructionTableCB[0x38] = Instruction("SRL, B", &z80::SRL_R, 8);
+    instructionTableCB[0x39] = Instruction("SRL, C", &z80::SRL_R, 8);
+    instructionTableCB[0x3A] = Instruction("SRL, D", &z80::SRL_R, 8);
+    instructionTableCB[0x3B] = Instruction("SRL, E", &z80::SRL_R, 8);
+    instructionTableCB[0x3C] = Instruction("SRL, H", &z80::SRL_R, 8);
+    instructionTableCB[0x3D] = Instruction("SRL, L", &z80::SRL_R, 8);
+    instructionTableCB[0x3F] = Instruction("SRL, A", &z80::SRL_R, 8);
+    instructionTableCB[0x3E] = Instruction("SRL, (HL)", &z80::SRL_HL, 15);
+
+    instructionTableCB[0x40] = Instruction("BIT 0, B", &z80::BIT_B_R<0, 0>, 8);
+    instructionTableCB[0x41] = Instruction("BIT 0, C", &z80::BIT_B_R<0, 1>, 8);
+    instructionTableCB[0x42] = Instruction("BIT 0, D", &z80::BIT_B_R<0, 2>, 8);
+    instructionTableCB[0x43] = Instruction("BIT 0, E", &z80::BIT_B_R<0, 3>, 8);
+    instructionTableCB[0x44] = Instruction("BIT 0, H", &z80::BIT_B_R<0, 4>, 8);
+    instructionTableCB[0x45] = Instruction("BIT 0, L", &z80::BIT_B_R<0, 5>, 8);
+    instructionTableCB[0x47] = Instruction("BIT 0, A", &z80::BIT_B_R<0, 7>, 8);
+    instructionTableCB[0x46] = Instruction("BIT 0, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xC0] = Instruction("SET 0, B", &z80::SET_B_R<0, 0>, 8);
+    instructionTableCB[0xC1] = Instruction("SET 0, C", &z80::SET_B_R<0, 1>, 8);
+    instructionTableCB[0xC2] = Instruction("SET 0, D", &z80::SET_B_R<0, 2>, 8);
+    instructionTableCB[0xC3] = Instruction("SET 0, E", &z80::SET_B_R<0, 3>, 8);
+    instructionTableCB[0xC4] = Instruction("SET 0, H", &z80::SET_B_R<0, 4>, 8);
+    instructionTableCB[0xC5] = Instruction("SET 0, L", &z80::SET_B_R<0, 5>, 8);
+    instructionTableCB[0xC7] = Instruction("SET 0, A", &z80::SET_B_R<0, 7>, 8);
+    instructionTableCB[0xC6] = Instruction("SET 0, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0x80] = Instruction("RES 0, B", &z80::RES_B_R<0, 0>, 8);
+    instructionTableCB[0x81] = Instruction("RES 0, C", &z80::RES_B_R<0, 1>, 8);
+    instructionTableCB[0x82] = Instruction("RES 0, D", &z80::RES_B_R<0, 2>, 8);
+    instructionTableCB[0x83] = Instruction("RES 0, E", &z80::RES_B_R<0, 3>, 8);
+    instructionTableCB[0x84] = Instruction("RES 0, H", &z80::RES_B_R<0, 4>, 8);
+    instructionTableCB[0x85] = Instruction("RES 0, L", &z80::RES_B_R<0, 5>, 8);
+    instructionTableCB[0x87] = Instruction("RES 0, A", &z80::RES_B_R<0, 7>, 8);
+    instructionTableCB[0x86] = Instruction("RES 0, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x48] = Instruction("BIT 1, B", &z80::BIT_B_R<1, 0>, 8);
+    instructionTableCB[0x49] = Instruction("BIT 1, C", &z80::BIT_B_R<1, 1>, 8);
+    instructionTableCB[0x4A] = Instruction("BIT 1, D", &z80::BIT_B_R<1, 2>, 8);
+    instructionTableCB[0x4B] = Instruction("BIT 1, E", &z80::BIT_B_R<1, 3>, 8);
+    instructionTableCB[0x4C] = Instruction("BIT 1, H", &z80::BIT_B_R<1, 4>, 8);
+    instructionTableCB[0x4D] = Instruction("BIT 1, L", &z80::BIT_B_R<1, 5>, 8);
+    instructionTableCB[0x4F] = Instruction("BIT 1, A", &z80::BIT_B_R<1, 7>, 8);
+    instructionTableCB[0x4E] = Instruction("BIT 1, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xC8] = Instruction("SET 1, B", &z80::SET_B_R<1, 0>, 8);
+    instructionTableCB[0xC9] = Instruction("SET 1, C", &z80::SET_B_R<1, 1>, 8);
+    instructionTableCB[0xCA] = Instruction("SET 1, D", &z80::SET_B_R<1, 2>, 8);
+    instructionTableCB[0xCB] = Instruction("SET 1, E", &z80::SET_B_R<1, 3>, 8);
+    instructionTableCB[0xCC] = Instruction("SET 1, H", &z80::SET_B_R<1, 4>, 8);
+    instructionTableCB[0xCD] = Instruction("SET 1, L", &z80::SET_B_R<1, 5>, 8);
+    instructionTableCB[0xCF] = Instruction("SET 1, A", &z80::SET_B_R<1, 7>, 8);
+    instructionTableCB[0xCE] = Instruction("SET 1, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0x88] = Instruction("RES 1, B", &z80::RES_B_R<1, 0>, 8);
+    instructionTableCB[0x89] = Instruction("RES 1, C", &z80::RES_B_R<1, 1>, 8);
+    instructionTableCB[0x8A] = Instruction("RES 1, D", &z80::RES_B_R<1, 2>, 8);
+    instructionTableCB[0x8B] = Instruction("RES 1, E", &z80::RES_B_R<1, 3>, 8);
+    instructionTableCB[0x8C] = Instruction("RES 1, H", &z80::RES_B_R<1, 4>, 8);
+    instructionTableCB[0x8D] = Instruction("RES 1, L", &z80::RES_B_R<1, 5>, 8);
+    instructionTableCB[0x8F] = Instruction("RES 1, A", &z80::RES_B_R<1, 7>, 8);
+    instructionTableCB[0x8E] = Instruction("RES 1, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x50] = Instruction("BIT 2, B", &z80::BIT_B_R<2, 0>, 8);
+    instructionTableCB[0x51] = Instruction("BIT 2, C", &z80::BIT_B_R<2, 1>, 8);
+    instructionTableCB[0x52] = Instruction("BIT 2, D", &z80::BIT_B_R<2, 2>, 8);
+    instructionTableCB[0x53] = Instruction("BIT 2, E", &z80::BIT_B_R<2, 3>, 8);
+    instructionTableCB[0x54] = Instruction("BIT 2, H", &z80::BIT_B_R<2, 4>, 8);
+    instructionTableCB[0x55] = Instruction("BIT 2, L", &z80::BIT_B_R<2, 5>, 8);
+    instructionTableCB[0x57] = Instruction("BIT 2, A", &z80::BIT_B_R<2, 7>, 8);
+    instructionTableCB[0x56] = Instruction("BIT 2, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xD0] = Instruction("SET 2, B", &z80::SET_B_R<2, 0>, 8);
+    instructionTableCB[0xD1] = Instruction("SET 2, C", &z80::SET_B_R<2, 1>, 8);
+    instructionTableCB[0xD2] = Instruction("SET 2, D", &z80::SET_B_R<2, 2>, 8);
+    instructionTableCB[0xD3] = Instruction("SET 2, E", &z80::SET_B_R<2, 3>, 8);
+    instructionTableCB[0xD4] = Instruction("SET 2, H", &z80::SET_B_R<2, 4>, 8);
+    instructionTableCB[0xD5] = Instruction("SET 2, L", &z80::SET_B_R<2, 5>, 8);
+    instructionTableCB[0xD7] = Instruction("SET 2, A", &z80::SET_B_R<2, 7>, 8);
+    instructionTableCB[0xD6] = Instruction("SET 2, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0x90] = Instruction("RES 2, B", &z80::RES_B_R<2, 0>, 8);
+    instructionTableCB[0x91] = Instruction("RES 2, C", &z80::RES_B_R<2, 1>, 8);
+    instructionTableCB[0x92] = Instruction("RES 2, D", &z80::RES_B_R<2, 2>, 8);
+    instructionTableCB[0x93] = Instruction("RES 2, E", &z80::RES_B_R<2, 3>, 8);
+    instructionTableCB[0x94] = Instruction("RES 2, H", &z80::RES_B_R<2, 4>, 8);
+    instructionTableCB[0x95] = Instruction("RES 2, L", &z80::RES_B_R<2, 5>, 8);
+    instructionTableCB[0x97] = Instruction("RES 2, A", &z80::RES_B_R<2, 7>, 8);
+    instructionTableCB[0x96] = Instruction("RES 2, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x58] = Instruction("BIT 3, B", &z80::BIT_B_R<3, 0>, 8);
+    instructionTableCB[0x59] = Instruction("BIT 3, C", &z80::BIT_B_R<3, 1>, 8);
+    instructionTableCB[0x5A] = Instruction("BIT 3, D", &z80::BIT_B_R<3, 2>, 8);
+    instructionTableCB[0x5B] = Instruction("BIT 3, E", &z80::BIT_B_R<3, 3>, 8);
+    instructionTableCB[0x5C] = Instruction("BIT 3, H", &z80::BIT_B_R<3, 4>, 8);
+    instructionTableCB[0x5D] = Instruction("BIT 3, L", &z80::BIT_B_R<3, 5>, 8);
+    instructionTableCB[0x5F] = Instruction("BIT 3, A", &z80::BIT_B_R<3, 7>, 8);
+    instructionTableCB[0x5E] = Instruction("BIT 3, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xD8] = Instruction("SET 3, B", &z80::SET_B_R<3, 0>, 8);
+    instructionTableCB[0xD9] = Instruction("SET 3, C", &z80::SET_B_R<3, 1>, 8);
+    instructionTableCB[0xDA] = Instruction("SET 3, D", &z80::SET_B_R<3, 2>, 8);
+    instructionTableCB[0xDB] = Instruction("SET 3, E", &z80::SET_B_R<3, 3>, 8);
+    instructionTableCB[0xDC] = Instruction("SET 3, H", &z80::SET_B_R<3, 4>, 8);
+    instructionTableCB[0xDD] = Instruction("SET 3, L", &z80::SET_B_R<3, 5>, 8);
+    instructionTableCB[0xDF] = Instruction("SET 3, A", &z80::SET_B_R<3, 7>, 8);
+    instructionTableCB[0xDE] = Instruction("SET 3, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0x98] = Instruction("RES 3, B", &z80::RES_B_R<3, 0>, 8);
+    instructionTableCB[0x99] = Instruction("RES 3, C", &z80::RES_B_R<3, 1>, 8);
+    instructionTableCB[0x9A] = Instruction("RES 3, D", &z80::RES_B_R<3, 2>, 8);
+    instructionTableCB[0x9B] = Instruction("RES 3, E", &z80::RES_B_R<3, 3>, 8);
+    instructionTableCB[0x9C] = Instruction("RES 3, H", &z80::RES_B_R<3, 4>, 8);
+    instructionTableCB[0x9D] = Instruction("RES 3, L", &z80::RES_B_R<3, 5>, 8);
+    instructionTableCB[0x9F] = Instruction("RES 3, A", &z80::RES_B_R<3, 7>, 8);
+    instructionTableCB[0x9E] = Instruction("RES 3, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x60] = Instruction("BIT 4, B", &z80::BIT_B_R<4, 0>, 8);
+    instructionTableCB[0x61] = Instruction("BIT 4, C", &z80::BIT_B_R<4, 1>, 8);
+    instructionTableCB[0x62] = Instruction("BIT 4, D", &z80::BIT_B_R<4, 2>, 8);
+    instructionTableCB[0x63] = Instruction("BIT 4, E", &z80::BIT_B_R<4, 3>, 8);
+    instructionTableCB[0x64] = Instruction("BIT 4, H", &z80::BIT_B_R<4, 4>, 8);
+    instructionTableCB[0x65] = Instruction("BIT 4, L", &z80::BIT_B_R<4, 5>, 8);
+    instructionTableCB[0x67] = Instruction("BIT 4, A", &z80::BIT_B_R<4, 7>, 8);
+    instructionTableCB[0x66] = Instruction("BIT 4, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xE0] = Instruction("SET 4, B", &z80::SET_B_R<4, 0>, 8);
+    instructionTableCB[0xE1] = Instruction("SET 4, C", &z80::SET_B_R<4, 1>, 8);
+    instructionTableCB[0xE2] = Instruction("SET 4, D", &z80::SET_B_R<4, 2>, 8);
+    instructionTableCB[0xE3] = Instruction("SET 4, E", &z80::SET_B_R<4, 3>, 8);
+    instructionTableCB[0xE4] = Instruction("SET 4, H", &z80::SET_B_R<4, 4>, 8);
+    instructionTableCB[0xE5] = Instruction("SET 4, L", &z80::SET_B_R<4, 5>, 8);
+    instructionTableCB[0xE7] = Instruction("SET 4, A", &z80::SET_B_R<4, 7>, 8);
+    instructionTableCB[0xE6] = Instruction("SET 4, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0xA0] = Instruction("RES 4, B", &z80::RES_B_R<4, 0>, 8);
+    instructionTableCB[0xA1] = Instruction("RES 4, C", &z80::RES_B_R<4, 1>, 8);
+    instructionTableCB[0xA2] = Instruction("RES 4, D", &z80::RES_B_R<4, 2>, 8);
+    instructionTableCB[0xA3] = Instruction("RES 4, E", &z80::RES_B_R<4, 3>, 8);
+    instructionTableCB[0xA4] = Instruction("RES 4, H", &z80::RES_B_R<4, 4>, 8);
+    instructionTableCB[0xA5] = Instruction("RES 4, L", &z80::RES_B_R<4, 5>, 8);
+    instructionTableCB[0xA7] = Instruction("RES 4, A", &z80::RES_B_R<4, 7>, 8);
+    instructionTableCB[0xA6] = Instruction("RES 4, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x68] = Instruction("BIT 5, B", &z80::BIT_B_R<5, 0>, 8);
+    instructionTableCB[0x69] = Instruction("BIT 5, C", &z80::BIT_B_R<5, 1>, 8);
+    instructionTableCB[0x6A] = Instruction("BIT 5, D", &z80::BIT_B_R<5, 2>, 8);
+    instructionTableCB[0x6B] = Instruction("BIT 5, E", &z80::BIT_B_R<5, 3>, 8);
+    instructionTableCB[0x6C] = Instruction("BIT 5, H", &z80::BIT_B_R<5, 4>, 8);
+    instructionTableCB[0x6D] = Instruction("BIT 5, L", &z80::BIT_B_R<5, 5>, 8);
+    instructionTableCB[0x6F] = Instruction("BIT 5, A", &z80::BIT_B_R<5, 7>, 8);
+    instructionTableCB[0x6E] = Instruction("BIT 5, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xE8] = Instruction("SET 5, B", &z80::SET_B_R<5, 0>, 8);
+    instructionTableCB[0xE9] = Instruction("SET 5, C", &z80::SET_B_R<5, 1>, 8);
+    instructionTableCB[0xEA] = Instruction("SET 5, D", &z80::SET_B_R<5, 2>, 8);
+    instructionTableCB[0xEB] = Instruction("SET 5, E", &z80::SET_B_R<5, 3>, 8);
+    instructionTableCB[0xEC] = Instruction("SET 5, H", &z80::SET_B_R<5, 4>, 8);
+    instructionTableCB[0xED] = Instruction("SET 5, L", &z80::SET_B_R<5, 5>, 8);
+    instructionTableCB[0xEF] = Instruction("SET 5, A", &z80::SET_B_R<5, 7>, 8);
+    instructionTableCB[0xEE] = Instruction("SET 5, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0xA8] = Instruction("RES 5, B", &z80::RES_B_R<5, 0>, 8);
+    instructionTableCB[0xA9] = Instruction("RES 5, C", &z80::RES_B_R<5, 1>, 8);
+    instructionTableCB[0xAA] = Instruction("RES 5, D", &z80::RES_B_R<5, 2>, 8);
+    instructionTableCB[0xAB] = Instruction("RES 5, E", &z80::RES_B_R<5, 3>, 8);
+    instructionTableCB[0xAC] = Instruction("RES 5, H", &z80::RES_B_R<5, 4>, 8);
+    instructionTableCB[0xAD] = Instruction("RES 5, L", &z80::RES_B_R<5, 5>, 8);
+    instructionTableCB[0xAF] = Instruction("RES 5, A", &z80::RES_B_R<5, 7>, 8);
+    instructionTableCB[0xAE] = Instruction("RES 5, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x70] = Instruction("BIT 6, B", &z80::BIT_B_R<6, 0>, 8);
+    instructionTableCB[0x71] = Instruction("BIT 6, C", &z80::BIT_B_R<6, 1>, 8);
+    instructionTableCB[0x72] = Instruction("BIT 6, D", &z80::BIT_B_R<6, 2>, 8);
+    instructionTableCB[0x73] = Instruction("BIT 6, E", &z80::BIT_B_R<6, 3>, 8);
+    instructionTableCB[0x74] = Instruction("BIT 6, H", &z80::BIT_B_R<6, 4>, 8);
+    instructionTableCB[0x75] = Instruction("BIT 6, L", &z80::BIT_B_R<6, 5>, 8);
+    instructionTableCB[0x77] = Instruction("BIT 6, A", &z80::BIT_B_R<6, 7>, 8);
+    instructionTableCB[0x76] = Instruction("BIT 6, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xF0] = Instruction("SET 6, B", &z80::SET_B_R<6, 0>, 8);
+    instructionTableCB[0xF1] = Instruction("SET 6, C", &z80::SET_B_R<6, 1>, 8);
+    instructionTableCB[0xF2] = Instruction("SET 6, D", &z80::SET_B_R<6, 2>, 8);
+    instructionTableCB[0xF3] = Instruction("SET 6, E", &z80::SET_B_R<6, 3>, 8);
+    instructionTableCB[0xF4] = Instruction("SET 6, H", &z80::SET_B_R<6, 4>, 8);
+    instructionTableCB[0xF5] = Instruction("SET 6, L", &z80::SET_B_R<6, 5>, 8);
+    instructionTableCB[0xF7] = Instruction("SET 6, A", &z80::SET_B_R<6, 7>, 8);
+    instructionTableCB[0xF6] = Instruction("SET 6, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0xB0] = Instruction("RES 6, B", &z80::RES_B_R<6, 0>, 8);
+    instructionTableCB[0xB1] = Instruction("RES 6, C", &z80::RES_B_R<6, 1>, 8);
+    instructionTableCB[0xB2] = Instruction("RES 6, D", &z80::RES_B_R<6, 2>, 8);
+    instructionTableCB[0xB3] = Instruction("RES 6, E", &z80::RES_B_R<6, 3>, 8);
+    instructionTableCB[0xB4] = Instruction("RES 6, H", &z80::RES_B_R<6, 4>, 8);
+    instructionTableCB[0xB5] = Instruction("RES 6, L", &z80::RES_B_R<6, 5>, 8);
+    instructionTableCB[0xB7] = Instruction("RES 6, A", &z80::RES_B_R<6, 7>, 8);
+    instructionTableCB[0xB6] = Instruction("RES 6, (HL)", &z80::RES_B_HL, 15);
+
+    instructionTableCB[0x78] = Instruction("BIT 7, B", &z80::BIT_B_R<7, 0>, 8);
+    instructionTableCB[0x79] = Instruction("BIT 7, C", &z80::BIT_B_R<7, 1>, 8);
+    instructionTableCB[0x7A] = Instruction("BIT 7, D", &z80::BIT_B_R<7, 2>, 8);
+    instructionTableCB[0x7B] = Instruction("BIT 7, E", &z80::BIT_B_R<7, 3>, 8);
+    instructionTableCB[0x7C] = Instruction("BIT 7, H", &z80::BIT_B_R<7, 4>, 8);
+    instructionTableCB[0x7D] = Instruction("BIT 7, L", &z80::BIT_B_R<7, 5>, 8);
+    instructionTableCB[0x7F] = Instruction("BIT 7, A", &z80::BIT_B_R<7, 7>, 8);
+    instructionTableCB[0x7E] = Instruction("BIT 7, (HL)", &z80::BIT_B_HL, 12);
+
+    instructionTableCB[0xF8] = Instruction("SET 7, B", &z80::SET_B_R<7, 0>, 8);
+    instructionTableCB[0xF9] = Instruction("SET 7, C", &z80::SET_B_R<7, 1>, 8);
+    instructionTableCB[0xFA] = Instruction("SET 7, D", &z80::SET_B_R<7, 2>, 8);
+    instructionTableCB[0xFB] = Instruction("SET 7, E", &z80::SET_B_R<7, 3>, 8);
+    instructionTableCB[0xFC] = Instruction("SET 7, H", &z80::SET_B_R<7, 4>, 8);
+    instructionTableCB[0xFD] = Instruction("SET 7, L", &z80::SET_B_R<7, 5>, 8);
+    instructionTableCB[0xFF] = Instruction("SET 7, A", &z80::SET_B_R<7, 7>, 8);
+    instructionTableCB[0xFE] = Instruction("SET 7, (HL)", &z80::SET_B_HL, 15);
+
+    instructionTableCB[0xB8] = Instruction("RES 7, B", &z80::RES_B_R<7, 0>, 8);
+    instructionTableCB[0xB9] = Instruction("RES 7, C", &z80::RES_B_R<7, 1>, 8);
+    instructionTableCB[0xBA] = Instruction("RES 7, D", &z80::RES_B_R<7, 2>, 8);
+    instructionTableCB[0xBB] = Instruction("RES 7, E", &z80::RES_B_R<7, 3>, 8);
+    instructionTableCB[0xBC] = Instruction("RES 7, H", &z80::RES_B_R<7, 4>, 8);
+    instructionTableCB[0xBD] = Instruction("RES 7, L", &z80::RES_B_R<7, 5>, 8);
+    instructionTableCB[0xBF] = Instruction("RES 7, A", &z80::RES_B_R<7, 7>, 8);
+    instructionTableCB[0xBE] = Instruction("RES 7, (HL)", &z80::RES_B_HL, 15);
+
+    return instructionTableCB;
+}
+
+template <uint8_t Index>
+constexpr InstructionTable buildInstructionTableIndexCB()
+{
+    InstructionTable table{};
+    constexpr auto pick = [](const char *ix, const char *iy)
+    { return Index == z80::IX_INDEX ? ix : iy; };
+
+    table[0x40] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x41] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x42] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x43] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x44] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x45] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x46] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x47] = Instruction(pick("BIT 0, (IX+d)", "BIT 0, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xC0] = Instruction(pick("SET 0, (IX+d), B", "SET 0, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC1] = Instruction(pick("SET 0, (IX+d), C", "SET 0, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC2] = Instruction(pick("SET 0, (IX+d), D", "SET 0, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC3] = Instruction(pick("SET 0, (IX+d), E", "SET 0, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC4] = Instruction(pick("SET 0, (IX+d), H", "SET 0, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC5] = Instruction(pick("SET 0, (IX+d), L", "SET 0, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC6] = Instruction(pick("SET 0, (IX+d)", "SET 0, (IY+d)"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC7] = Instruction(pick("SET 0, (IX+d) ,A", "SET 0, (IY+d) ,A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0x80] = Instruction(pick("RES 0, (IX+d), B", "RES 0, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x81] = Instruction(pick("RES 0, (IX+d), C", "RES 0, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x82] = Instruction(pick("RES 0, (IX+d), D", "RES 0, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x83] = Instruction(pick("RES 0, (IX+d), E", "RES 0, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x84] = Instruction(pick("RES 0, (IX+d), H", "RES 0, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x85] = Instruction(pick("RES 0, (IX+d), L", "RES 0, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x86] = Instruction(pick("RES 0, (IX+d)", "RES 0, (IY+d)"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x87] = Instruction(pick("RES 0, (IX+d) ,A", "RES 0, (IY+d) ,A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x48] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x49] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4A] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4B] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4C] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4D] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4E] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x4F] = Instruction(pick("BIT 1, (IX+d)", "BIT 1, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xC8] = Instruction(pick("SET 1, (IX+d), B", "SET 1, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xC9] = Instruction(pick("SET 1, (IX+d), C", "SET 1, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCA] = Instruction(pick("SET 1, (IX+d), D", "SET 1, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCB] = Instruction(pick("SET 1, (IX+d), E", "SET 1, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCC] = Instruction(pick("SET 1, (IX+d), H", "SET 1, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCD] = Instruction(pick("SET 1, (IX+d), L", "SET 1, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCE] = Instruction(pick("SET 1, (IX+d),", "SET 1, (IY+d),"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xCF] = Instruction(pick("SET 1, (IX+d), A", "SET 1, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0x88] = Instruction(pick("RES 1, (IX+d), B", "RES 1, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x89] = Instruction(pick("RES 1, (IX+d), C", "RES 1, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8A] = Instruction(pick("RES 1, (IX+d), D", "RES 1, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8B] = Instruction(pick("RES 1, (IX+d), E", "RES 1, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8C] = Instruction(pick("RES 1, (IX+d), H", "RES 1, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8D] = Instruction(pick("RES 1, (IX+d), L", "RES 1, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8E] = Instruction(pick("RES 1, (IX+d),", "RES 1, (IY+d),"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x8F] = Instruction(pick("RES 1, (IX+d), A", "RES 1, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x50] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x51] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x52] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x53] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x54] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x55] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x56] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x57] = Instruction(pick("BIT 2, (IX+d)", "BIT 2, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xD0] = Instruction(pick("SET 2, (IX+d), B", "SET 2, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD1] = Instruction(pick("SET 2, (IX+d), C", "SET 2, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD2] = Instruction(pick("SET 2, (IX+d), D", "SET 2, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD3] = Instruction(pick("SET 2, (IX+d), E", "SET 2, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD4] = Instruction(pick("SET 2, (IX+d), H", "SET 2, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD5] = Instruction(pick("SET 2, (IX+d), L", "SET 2, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD6] = Instruction(pick("SET 2, (IX+d),  ", "SET 2, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD7] = Instruction(pick("SET 2, (IX+d), A", "SET 2, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0x90] = Instruction(pick("RES 2, (IX+d), B", "RES 2, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x91] = Instruction(pick("RES 2, (IX+d), C", "RES 2, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x92] = Instruction(pick("RES 2, (IX+d), D", "RES 2, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x93] = Instruction(pick("RES 2, (IX+d), E", "RES 2, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x94] = Instruction(pick("RES 2, (IX+d), H", "RES 2, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x95] = Instruction(pick("RES 2, (IX+d), L", "RES 2, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x96] = Instruction(pick("RES 2, (IX+d),  ", "RES 2, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0x97] = Instruction(pick("RES 2, (IX+d), A", "RES 2, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x58] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x59] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5A] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5B] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5C] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5D] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5E] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x5F] = Instruction(pick("BIT 3, (IX+d)", "BIT 3, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xD8] = Instruction(pick("SET 3, (IX+d), B", "SET 3, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xD9] = Instruction(pick("SET 3, (IX+d), C", "SET 3, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDA] = Instruction(pick("SET 3, (IX+d), D", "SET 3, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDB] = Instruction(pick("SET 3, (IX+d), E", "SET 3, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDC] = Instruction(pick("SET 3, (IX+d), H", "SET 3, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDD] = Instruction(pick("SET 3, (IX+d), L", "SET 3, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDE] = Instruction(pick("SET 3, (IX+d),  ", "SET 3, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xDF] = Instruction(pick("SET 3, (IX+d), A", "SET 3, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0x98] = Instruction(pick("RES 3, (IX+d), B", "RES 3, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x99] = Instruction(pick("RES 3, (IX+d), C", "RES 3, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9A] = Instruction(pick("RES 3, (IX+d), D", "RES 3, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9B] = Instruction(pick("RES 3, (IX+d), E", "RES 3, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9C] = Instruction(pick("RES 3, (IX+d), H", "RES 3, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9D] = Instruction(pick("RES 3, (IX+d), L", "RES 3, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9E] = Instruction(pick("RES 3, (IX+d),  ", "RES 3, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0x9F] = Instruction(pick("RES 3, (IX+d), A", "RES 3, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x60] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x61] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x62] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x63] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x64] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x65] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x66] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x67] = Instruction(pick("BIT 4, (IX+d)", "BIT 4, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xE0] = Instruction(pick("SET 4, (IX+d), B", "SET 4, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE1] = Instruction(pick("SET 4, (IX+d), C", "SET 4, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE2] = Instruction(pick("SET 4, (IX+d), D", "SET 4, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE3] = Instruction(pick("SET 4, (IX+d), E", "SET 4, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE4] = Instruction(pick("SET 4, (IX+d), H", "SET 4, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE5] = Instruction(pick("SET 4, (IX+d), L", "SET 4, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE6] = Instruction(pick("SET 4, (IX+d),  ", "SET 4, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE7] = Instruction(pick("SET 4, (IX+d), A", "SET 4, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0xA0] = Instruction(pick("RES 4, (IX+d), B", "RES 4, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA1] = Instruction(pick("RES 4, (IX+d), C", "RES 4, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA2] = Instruction(pick("RES 4, (IX+d), D", "RES 4, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA3] = Instruction(pick("RES 4, (IX+d), E", "RES 4, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA4] = Instruction(pick("RES 4, (IX+d), H", "RES 4, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA5] = Instruction(pick("RES 4, (IX+d), L", "RES 4, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA6] = Instruction(pick("RES 4, (IX+d),  ", "RES 4, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA7] = Instruction(pick("RES 4, (IX+d), A", "RES 4, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x68] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x69] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6A] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6B] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6C] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6D] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6E] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x6F] = Instruction(pick("BIT 5, (IX+d)", "BIT 5, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xE8] = Instruction(pick("SET 5, (IX+d), B", "SET 5, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xE9] = Instruction(pick("SET 5, (IX+d), C", "SET 5, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xEA] = Instruction(pick("SET 5, (IX+d), D", "SET 5, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xEB] = Instruction(pick("SET 5, (IX+d), E", "SET 5, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xEC] = Instruction(pick("SET 5, (IX+d), H", "SET 5, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xED] = Instruction(pick("SET 5, (IX+d), L", "SET 5, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xEE] = Instruction(pick("SET 5, (IX+d),  ", "SET 5, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xEF] = Instruction(pick("SET 5, (IX+d), A", "SET 5, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0xA8] = Instruction(pick("RES 5, (IX+d), B", "RES 5, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xA9] = Instruction(pick("RES 5, (IX+d), C", "RES 5, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAA] = Instruction(pick("RES 5, (IX+d), D", "RES 5, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAB] = Instruction(pick("RES 5, (IX+d), E", "RES 5, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAC] = Instruction(pick("RES 5, (IX+d), H", "RES 5, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAD] = Instruction(pick("RES 5, (IX+d), L", "RES 5, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAE] = Instruction(pick("RES 5, (IX+d),  ", "RES 5, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0xAF] = Instruction(pick("RES 5, (IX+d), A", "RES 5, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x70] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x71] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x72] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x73] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x74] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x75] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x76] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x77] = Instruction(pick("BIT 6, (IX+d)", "BIT 6, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xF0] = Instruction(pick("SET 6, (IX+d), B", "SET 6, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF1] = Instruction(pick("SET 6, (IX+d), C", "SET 6, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF2] = Instruction(pick("SET 6, (IX+d), D", "SET 6, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF3] = Instruction(pick("SET 6, (IX+d), E", "SET 6, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF4] = Instruction(pick("SET 6, (IX+d), H", "SET 6, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF5] = Instruction(pick("SET 6, (IX+d), L", "SET 6, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF6] = Instruction(pick("SET 6, (IX+d),  ", "SET 6, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF7] = Instruction(pick("SET 6, (IX+d), A", "SET 6, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0xB0] = Instruction(pick("RES 6, (IX+d), B", "RES 6, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB1] = Instruction(pick("RES 6, (IX+d), C", "RES 6, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB2] = Instruction(pick("RES 6, (IX+d), D", "RES 6, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB3] = Instruction(pick("RES 6, (IX+d), E", "RES 6, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB4] = Instruction(pick("RES 6, (IX+d), H", "RES 6, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB5] = Instruction(pick("RES 6, (IX+d), L", "RES 6, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB6] = Instruction(pick("RES 6, (IX+d),  ", "RES 6, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB7] = Instruction(pick("RES 6, (IX+d), A", "RES 6, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x78] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x79] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7A] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7B] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7C] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7D] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7E] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+    table[0x7F] = Instruction(pick("BIT 7, (IX+d)", "BIT 7, (IY+d)"), &z80::BIT_B_XY_D<Index>, 20);
+
+    table[0xF8] = Instruction(pick("SET 7, (IX+d), B", "SET 7, (IY+d), B"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xF9] = Instruction(pick("SET 7, (IX+d), C", "SET 7, (IY+d), C"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFA] = Instruction(pick("SET 7, (IX+d), D", "SET 7, (IY+d), D"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFB] = Instruction(pick("SET 7, (IX+d), E", "SET 7, (IY+d), E"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFC] = Instruction(pick("SET 7, (IX+d), H", "SET 7, (IY+d), H"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFD] = Instruction(pick("SET 7, (IX+d), L", "SET 7, (IY+d), L"), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFE] = Instruction(pick("SET 7, (IX+d),  ", "SET 7, (IY+d),  "), &z80::SET_B_XY_D<Index>, 23);
+    table[0xFF] = Instruction(pick("SET 7, (IX+d), A", "SET 7, (IY+d), A"), &z80::SET_B_XY_D<Index>, 23);
+
+    table[0xB8] = Instruction(pick("RES 7, (IX+d), B", "RES 7, (IY+d), B"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xB9] = Instruction(pick("RES 7, (IX+d), C", "RES 7, (IY+d), C"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBA] = Instruction(pick("RES 7, (IX+d), D", "RES 7, (IY+d), D"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBB] = Instruction(pick("RES 7, (IX+d), E", "RES 7, (IY+d), E"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBC] = Instruction(pick("RES 7, (IX+d), H", "RES 7, (IY+d), H"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBD] = Instruction(pick("RES 7, (IX+d), L", "RES 7, (IY+d), L"), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBE] = Instruction(pick("RES 7, (IX+d),  ", "RES 7, (IY+d),  "), &z80::RES_B_XY_D<Index>, 23);
+    table[0xBF] = Instruction(pick("RES 7, (IX+d), A", "RES 7, (IY+d), A"), &z80::RES_B_XY_D<Index>, 23);
+
+    table[0x00] = Instruction(pick("RLC (IX+d), B", "RLC (IY+d), B"), &z80::RLC_XY_D<Index>, 23);
+    table[0x01] = Instruction(pick("RLC (IX+d), C", "RLC (IY+d), C"), &z80::RLC_XY_D<Index>, 23);
+    table[0x02] = Instruction(pick("RLC (IX+d), D", "RLC (IY+d), D"), &z80::RLC_XY_D<Index>, 23);
+    table[0x03] = Instruction(pick("RLC (IX+d), E", "RLC (IY+d), E"), &z80::RLC_XY_D<Index>, 23);
+    table[0x04] = Instruction(pick("RLC (IX+d), H", "RLC (IY+d), H"), &z80::RLC_XY_D<Index>, 23);
+    table[0x05] = Instruction(pick("RLC (IX+d), L", "RLC (IY+d), L"), &z80::RLC_XY_D<Index>, 23);
+    table[0x06] = Instruction(pick("RLC (IX+d)", "RLC (IY+d)"), &z80::RLC_XY_D<Index>, 23);
+    table[0x07] = Instruction(pick("RLC (IX+d), A", "RLC (IY+d), A"), &z80::RLC_XY_D<Index>, 23);
+
+    table[0x10] = Instruction(pick("RL (IX+d), B", "RL (IY+d), B"), &z80::RL_XY_D<Index>, 23);
+    table[0x11] = Instruction(pick("RL (IX+d), C", "RL (IY+d), C"), &z80::RL_XY_D<Index>, 23);
+    table[0x12] = Instruction(pick("RL (IX+d), D", "RL (IY+d), D"), &z80::RL_XY_D<Index>, 23);
+    table[0x13] = Instruction(pick("RL (IX+d), E", "RL (IY+d), E"), &z80::RL_XY_D<Index>, 23);
+    table[0x14] = Instruction(pick("RL (IX+d), H", "RL (IY+d), H"), &z80::RL_XY_D<Index>, 23);
+    table[0x15] = Instruction(pick("RL (IX+d), L", "RL (IY+d), L"), &z80::RL_XY_D<Index>, 23);
+    table[0x16] = Instruction(pick("RL (IX+d)", "RL (IY+d)"), &z80::RL_XY_D<Index>, 23);
+    table[0x17] = Instruction(pick("RL (IX+d), A", "RL (IY+d), A"), &z80::RL_XY_D<Index>, 23);
+
+    table[0x08] = Instruction(pick("RRC (IX+d), B", "RRC (IY+d), B"), &z80::RRC_XY_D<Index>, 23);
+    table[0x09] = Instruction(pick("RRC (IX+d), C", "RRC (IY+d), C"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0A] = Instruction(pick("RRC (IX+d), D", "RRC (IY+d), D"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0B] = Instruction(pick("RRC (IX+d), E", "RRC (IY+d), E"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0C] = Instruction(pick("RRC (IX+d), H", "RRC (IY+d), H"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0D] = Instruction(pick("RRC (IX+d), L", "RRC (IY+d), L"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0E] = Instruction(pick("RRC (IX+d)", "RRC (IY+d)"), &z80::RRC_XY_D<Index>, 23);
+    table[0x0F] = Instruction(pick("RRC (IX+d), A", "RRC (IY+d), A"), &z80::RRC_XY_D<Index>, 23);
+
+    table[0x18] = Instruction(pick("RR (IX+d), B", "RR (IY+d), B"), &z80::RR_XY_D<Index>, 23);
+    table[0x19] = Instruction(pick("RR (IX+d), C", "RR (IY+d), C"), &z80::RR_XY_D<Index>, 23);
+    table[0x1A] = Instruction(pick("RR (IX+d), D", "RR (IY+d), D"), &z80::RR_XY_D<Index>, 23);
+    table[0x1B] = Instruction(pick("RR (IX+d), E", "RR (IY+d), E"), &z80::RR_XY_D<Index>, 23);
+    table[0x1C] = Instruction(pick("RR (IX+d), H", "RR (IY+d), H"), &z80::RR_XY_D<Index>, 23);
+    table[0x1D] = Instruction(pick("RR (IX+d), L", "RR (IY+d), L"), &z80::RR_XY_D<Index>, 23);
+    table[0x1E] = Instruction(pick("RR (IX+d)", "RR (IY+d)"), &z80::RR_XY_D<Index>, 23);
+    table[0x1F] = Instruction(pick("RR (IX+d), A", "RR (IY+d), A"), &z80::RR_XY_D<Index>, 23);
+
+    table[0x20] = Instruction(pick("SLA (IX+d), B", "SLA (IY+d), B"), &z80::SLA_XY_D<Index>, 23);
+    table[0x21] = Instruction(pick("SLA (IX+d), C", "SLA (IY+d), C"), &z80::SLA_XY_D<Index>, 23);
+    table[0x22] = Instruction(pick("SLA (IX+d), D", "SLA (IY+d), D"), &z80::SLA_XY_D<Index>, 23);
+    table[0x23] = Instruction(pick("SLA (IX+d), E", "SLA (IY+d), E"), &z80::SLA_XY_D<Index>, 23);
+    table[0x24] = Instruction(pick("SLA (IX+d), H", "SLA (IY+d), H"), &z80::SLA_XY_D<Index>, 23);
+    table[0x25] = Instruction(pick("SLA (IX+d), L", "SLA (IY+d), L"), &z80::SLA_XY_D<Index>, 23);
+    table[0x26] = Instruction(pick("SLA (IX+d)", "SLA (IY+d)"), &z80::SLA_XY_D<Index>, 23);
+    table[0x27] = Instruction(pick("SLA (IX+d), A", "SLA (IY+d), A"), &z80::SLA_XY_D<Index>, 23);
+
+    table[0x30] = Instruction(pick("SLS (IX+d), B", "SLS (IY+d), B"), &z80::SLS_XY_D<Index>, 23);
+    table[0x31] = Instruction(pick("SLS (IX+d), C", "SLS (IY+d), C"), &z80::SLS_XY_D<Index>, 23);
+    table[0x32] = Instruction(pick("SLS (IX+d), D", "SLS (IY+d), D"), &z80::SLS_XY_D<Index>, 23);
+    table[0x33] = Instruction(pick("SLS (IX+d), E", "SLS (IY+d), E"), &z80::SLS_XY_D<Index>, 23);
+    table[0x34] = Instruction(pick("SLS (IX+d), H", "SLS (IY+d), H"), &z80::SLS_XY_D<Index>, 23);
+    table[0x35] = Instruction(pick("SLS (IX+d), L", "SLS (IY+d), L"), &z80::SLS_XY_D<Index>, 23);
+    table[0x36] = Instruction(pick("SLS (IX+d)", "SLS (IY+d)"), &z80::SLS_XY_D<Index>, 23);
+    table[0x37] = Instruction(pick("SLS (IX+d), A", "SLS (IY+d), A"), &z80::SLS_XY_D<Index>, 23);
+
+    table[0x28] = Instruction(pick("SRA (IX+d), B", "SRA (IY+d), B"), &z80::SRA_XY_D<Index>, 23);
+    table[0x29] = Instruction(pick("SRA (IX+d), C", "SRA (IY+d), C"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2A] = Instruction(pick("SRA (IX+d), D", "SRA (IY+d), D"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2B] = Instruction(pick("SRA (IX+d), E", "SRA (IY+d), E"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2C] = Instruction(pick("SRA (IX+d), H", "SRA (IY+d), H"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2D] = Instruction(pick("SRA (IX+d), L", "SRA (IY+d), L"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2E] = Instruction(pick("SRA (IX+d)", "SRA (IY+d)"), &z80::SRA_XY_D<Index>, 23);
+    table[0x2F] = Instruction(pick("SRA (IX+d), A", "SRA (IY+d), A"), &z80::SRA_XY_D<Index>, 23);
+
+    table[0x38] = Instruction(pick("SRL (IX+d), B", "SRL (IY+d), B"), &z80::SRL_XY_D<Index>, 23);
+    table[0x39] = Instruction(pick("SRL (IX+d), C", "SRL (IY+d), C"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3A] = Instruction(pick("SRL (IX+d), D", "SRL (IY+d), D"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3B] = Instruction(pick("SRL (IX+d), E", "SRL (IY+d), E"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3C] = Instruction(pick("SRL (IX+d), H", "SRL (IY+d), H"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3D] = Instruction(pick("SRL (IX+d), L", "SRL (IY+d), L"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3E] = Instruction(pick("SRL (IX+d)", "SRL (IY+d)"), &z80::SRL_XY_D<Index>, 23);
+    table[0x3F] = Instruction(pick("SRL (IX+d), A", "SRL (IY+d), A"), &z80::SRL_XY_D<Index>, 23);
+
+    return table;
+}
+
+} // namespace
+
+constexpr InstructionTable z80::instructionTable = buildInstructionTable();
+constexpr InstructionTable z80::instructionTableDD = buildInstructionTableIndex<z80::IX_INDEX>();
+constexpr InstructionTable z80::instructionTableFD = buildInstructionTableIndex<z80::IY_INDEX>();
+constexpr InstructionTable z80::instructionTableED = buildInstructionTableED();
+constexpr InstructionTable z80::instructionTableCB = buildInstructionTableCB();
+constexpr InstructionTable z80::instructionTableDDCB = buildInstructionTableIndexCB<z80::IX_INDEX>();
+constexpr InstructionTable z80::instructionTableFDCB = buildInstructionTableIndexCB<z80::IY_INDEX>();
 
 uint8_t z80::fetchImmediate()
 {
@@ -1665,64 +1736,98 @@ uint8_t z80::fetchHL()
     uint8_t value = bus->read(adress);
     return value;
 }
-uint16_t z80::getBC()
+
+// (IX+d) or (IY+d). Fetches d and leaves the address in MEMPTR, like every
+// indexed memory access does.
+template <uint8_t Index>
+uint16_t z80::indexedAddress()
 {
-    // Combine B (high byte) and C (low byte) to form a 16-bit address
-    uint16_t address = (B << 8) | C; // iF does not work try to cast before...
+    int8_t displacement = fetchImmediate();
+    MPTR = regs16[Index] + displacement;
+    return MPTR;
+}
+
+// DDCB and FDCB put d before the opcode, which the handler already has, so it
+// is only stepped over
+template <uint8_t Index>
+uint16_t z80::indexedBitAddress()
+{
+    uint16_t address = indexedAddress<Index>();
+    fetchImmediate();
     return address;
 }
+
+// The undocumented DDCB and FDCB forms also copy the result to the register in
+// the low three bits of the opcode
+void z80::writeIndexedResult(uint16_t address, uint8_t opCode, uint8_t value)
+{
+    if ((opCode & 0b00000111) != 6)
+    {
+        writeToRegister(opCode & 0b00000111, value);
+    }
+    bus->write(address, value);
+}
+uint16_t z80::getBC()
+{
+    return BC;
+}
 uint16_t z80::getBC1()
 {
-    // Combine B (high byte) and C (low byte) to form a 16-bit address
-    uint16_t address = (B1 << 8) | C1; // iF does not work try to cast before...
-    return address;
+    return BC1;
 }
 uint16_t z80::getDE()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (D << 8) | E; // iF does not work try to cast before...
-    return address;
+    return DE;
 }
 uint16_t z80::getDE1()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (D1 << 8) | E1; // iF does not work try to cast before...
-    return address;
+    return DE1;
 }
 uint16_t z80::getHL()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (H << 8) | L; // iF does not work try to cast before...
-    return address;
+    return HL;
 }
 uint16_t z80::getHL1()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (H1 << 8) | L1; // iF does not work try to cast before...
-    return address;
+    return HL1;
 }
 uint16_t z80::getAF()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (A << 8) | F; // iF does not work try to cast before...
-    return address;
+    resolveFlags();
+    return AF;
 }
 uint16_t z80::getAF1()
 {
-    // Combine D (high byte) and E (low byte) to form a 16-bit address
-    uint16_t address = (A1 << 8) | F1; // iF does not work try to cast before...
-    return address;
+    return AF1;
 }
 
 // Function to execute instructions based on opcode
 void z80::execute(uint8_t opCode)
 {
-    // Check for regular instructions in the main table
-    if (instructionTable.find(opCode) != instructionTable.end())
+    if (engine == ExecutionEngine::Switch)
+    {
+        executeSwitch(opCode);
+    }
+    else if (engine == ExecutionEngine::Predecoded || engine == ExecutionEngine::Block ||
+             engine == ExecutionEngine::Jit)
+    {
+        executePredecoded(opCode);
+    }
+    else
+    {
+        executeTable(opCode);
+    }
+}
+
+void z80::executeTable(uint8_t opCode)
+{
+    // Regular instructions are a direct index into the main table
+    const Instruction &instruction = instructionTable[opCode];
+    if (instruction.hasOperation())
     {
         IncrementRefreshRegister(1);
-        Instruction &instruction = instructionTable[opCode]; // Get the instruction
-        instruction.execute(*this, opCode);
+        addBaseCycles(instruction.getCycles(), 1);
+        (this->*instruction.getOperation())(opCode);
         PC++;
     }
     // Handle DD-prefixed instructions
@@ -1734,12 +1839,9 @@ void z80::execute(uint8_t opCode)
         {
             IncrementRefreshRegister(2);
             opCode = bus->read(PC + 2); // dont increment PC here the function call fetchImmidiate 2 times so it will do it.
-            if (instructionTableDDCB.find(opCode) != instructionTableDDCB.end())
-            {
-                Instruction &instruction = instructionTableDDCB[opCode];
-                instruction.execute(*this, opCode); // Execute the instruction
-                PC++;
-            }
+            addBaseCycles(instructionTableDDCB[opCode].getCycles(), 2);
+            (this->*instructionTableDDCB[opCode].getOperation())(opCode);
+            PC++;
         }
         else
         {
@@ -1752,12 +1854,17 @@ void z80::execute(uint8_t opCode)
                 IncrementRefreshRegister(2);
             }
 
-            if (instructionTableDD.find(opCode) != instructionTableDD.end())
+            const Instruction &instructionDD = instructionTableDD[opCode];
+            if (instructionDD.hasOperation())
             {
-                Instruction &instruction = instructionTableDD[opCode];
-                instruction.execute(*this, opCode); // Execute the instruction
+                addBaseCycles(instructionDD.getCycles(), 2);
+                (this->*instructionDD.getOperation())(opCode);
                 PC++;
             }
+            else
+            {
+                tstates += 4; // The prefix acts as a NOP and the opcode runs unprefixed
+            }
         }
     }
     // Handle FD-prefixed instructions
@@ -1770,12 +1877,9 @@ void z80::execute(uint8_t opCode)
         {
             IncrementRefreshRegister(2);
             opCode = bus->read(PC + 2); // dont increment PC here the function call fetchImmidiate 2 times so it will do it.
-            if (instructionTableFDCB.find(opCode) != instructionTableFDCB.end())
-            {
-                Instruction &instruction = instructionTableFDCB[opCode];
-                instruction.execute(*this, opCode); // Execute the instruction
-                PC++;
-            }
+            addBaseCycles(instructionTableFDCB[opCode].getCycles(), 2);
+            (this->*instructionTableFDCB[opCode].getOperation())(opCode);
+            PC++;
         }
         else
         {
@@ -1788,12 +1892,17 @@ void z80::execute(uint8_t opCode)
                 IncrementRefreshRegister(2);
             }
 
-            if (instructionTableFD.find(opCode) != instructionTableFD.end())
+            const Instruction &instructionFD = instructionTableFD[opCode];
+            if (instructionFD.hasOperation())
             {
-                Instruction &instruction = instructionTableFD[opCode];
-                instruction.execute(*this, opCode); // Execute the instruction
+                addBaseCycles(instructionFD.getCycles(), 2);
+                (this->*instructionFD.getOperation())(opCode);
                 PC++;
             }
+            else
+            {
+                tstates += 4; // The prefix acts as a NOP and the opcode runs unprefixed
+            }
         }
     }
     // Handle ED-prefixed instructions
@@ -1804,24 +1913,26 @@ void z80::execute(uint8_t opCode)
 
         PC++;                   // Move to the next part of long opCode
         opCode = bus->read(PC); // Read the next opcode
-        if (instructionTableED.find(opCode) != instructionTableED.end())
+        const Instruction &instructionED = instructionTableED[opCode];
+        if (instructionED.hasOperation())
         {
-            Instruction &instruction = instructionTableED[opCode];
-            instruction.execute(*this, opCode); // Execute the instruction
+            addBaseCycles(instructionED.getCycles(), 2);
+            (this->*instructionED.getOperation())(opCode);
             PC++;
         }
+        else
+        {
+            tstates += 4;
+        }
     }
     else if (opCode == 0xCB)
     {
         IncrementRefreshRegister(2);
         PC++;                   // Move to the next part of long opCode
         opCode = bus->read(PC); // Read the next opcode
-        if (instructionTableCB.find(opCode) != instructionTableCB.end())
-        {
-            Instruction &instruction = instructionTableCB[opCode];
-            instruction.execute(*this, opCode); // Execute the instruction
-            PC++;
-        }
+        addBaseCycles(instructionTableCB[opCode].getCycles(), 2);
+        (this->*instructionTableCB[opCode].getOperation())(opCode);
+        PC++;
     }
     else
     {
@@ -1833,8 +1944,2323 @@ void z80::execute(uint8_t opCode)
     }
 }
 
-/*****************************************|
- *                                        |
+// Instruction lengths and block ends, from the x/y/z/p/q fields of the opcode
+// the handler runs for (see executeSwitch()).
+namespace
+{
+constexpr uint8_t unprefixedLength(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6, y = (opCode >> 3) & 7, z = opCode & 7;
+    uint8_t p = y >> 1, q = y & 1;
+    if (x == 0)
+    {
+        if (z == 0)
+            return y >= 2 ? 2 : 1; // DJNZ and JR take e
+        if (z == 1)
+            return q == 0 ? 3 : 1; // LD rr, nn
+        if (z == 2)
+            return y >= 4 ? 3 : 1; // LD (nn), HL/A and back
+        return z == 6 ? 2 : 1;     // LD r, n
+    }
+    if (x == 3)
+    {
+        if (z == 2 || z == 4)
+            return 3; // JP cc and CALL cc
+        if (z == 3)
+            return y == 0 ? 3 : (y == 2 || y == 3) ? 2 : 1; // JP nn, OUT (n), A and IN A, (n)
+        if (z == 5)
+            return (q == 1 && p == 0) ? 3 : 1; // CALL nn
+        return z == 6 ? 2 : 1;                 // ALU n
+    }
+    return 1;
+}
+
+// Whether the opcode takes an (HL) operand, which becomes (IX+d) after DD/FD
+constexpr bool usesHLOperand(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6, y = (opCode >> 3) & 7, z = opCode & 7;
+    if (x == 0)
+        return y == 6 && (z == 4 || z == 5 || z == 6);
+    if (x == 1)
+        return (y == 6 || z == 6) && opCode != 0x76;
+    return x == 2 && z == 6;
+}
+
+// Whether execution can continue anywhere but the next instruction
+constexpr bool endsBlock(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6, y = (opCode >> 3) & 7, z = opCode & 7;
+    uint8_t p = y >> 1, q = y & 1;
+    if (x == 0)
+        return z == 0 && y >= 2; // DJNZ and JR
+    if (x == 1)
+        return opCode == 0x76; // HALT
+    if (x == 3)
+    {
+        return z == 0 || z == 2 || z == 4 || z == 7 ||  // RET cc, JP cc, CALL cc, RST
+               (z == 1 && q == 1 && (p == 0 || p == 2)) || // RET and JP (HL)
+               (z == 3 && y == 0) ||                         // JP nn
+               (z == 5 && q == 1 && p == 0);                 // CALL nn
+    }
+    return false;
+}
+
+constexpr bool endsBlockED(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6, y = (opCode >> 3) & 7, z = opCode & 7;
+    return (x == 1 && z == 5) ||          // RETN and RETI
+           (x == 2 && y >= 6 && z <= 3); // LDIR, CPIR, INIR, OTIR and the decrementing ones
+}
+}
+
+// Third execution engine. The decoded prefix chain of every address is kept in
+// decodeCache, so code that runs again skips the prefix handling and the table
+// lookups. An entry is only used while the memory pages its bytes came from
+// have not been written since it was decoded, which keeps self-modifying code
+// correct. Pages that are never written, like the ROM, never decode twice.
+void z80::executePredecoded(uint8_t opCode)
+{
+    if (decodeCache.empty())
+    {
+        decodeCache.resize(0x10000);
+    }
+
+    DecodedInstruction &decoded = decodeCache[PC];
+    uint32_t generation = decodeGeneration(PC);
+    if (decoded.generation == generation && decoded.leadByte == opCode)
+    {
+        ++decodeCacheHits;
+    }
+    else if (bus->Bus::read(PC) != opCode)
+    {
+        // Called with an opcode that is not in memory, nothing to cache
+        executeTable(opCode);
+        return;
+    }
+    else
+    {
+        ++decodeCacheMisses;
+        decodeInstruction(PC, decoded);
+        decoded.generation = generation;
+    }
+
+    chargeFetches(decoded, true);
+    IncrementRefreshRegister(decoded.refresh);
+    addBaseCycles(decoded.cycles, decoded.refresh);
+    PC += decoded.prefixLength;
+    if (decoded.operation != nullptr)
+    {
+        (this->*decoded.operation)(decoded.opCode);
+        PC++;
+    }
+}
+
+// Generation of the memory an instruction at address is decoded from. The
+// longest prefix chain, DD CB d op, is 4 bytes, so near the end of a page the
+// next page counts too. Generations only grow, so neither page can be written
+// without the sum changing.
+uint32_t z80::decodeGeneration(uint16_t address)
+{
+    uint32_t generation = bus->getPageGeneration(address);
+    if ((address & 0xFF) > 0xFC)
+    {
+        generation += bus->getPageGeneration(address + 4);
+    }
+    return generation;
+}
+
+// Decodes the instruction at address the same way executeTable() walks it.
+// The bytes are read with the bare Bus::read(), chargeFetches() puts the
+// reads on the bus when the instruction runs.
+void z80::decodeInstruction(uint16_t address, DecodedInstruction &decoded)
+{
+    uint8_t opCode = bus->Bus::read(address);
+    const Instruction *instruction = &instructionTable[opCode];
+    decoded.leadByte = opCode;
+    decoded.opCode = opCode;
+    decoded.prefixLength = 0;
+    decoded.prefixFetches = 0;
+    decoded.refresh = 1;
+    decoded.length = unprefixedLength(opCode);
+    decoded.endsBlock = endsBlock(opCode);
+    decoded.fusion = 0;
+
+    if (!instruction->hasOperation())
+    {
+        uint8_t next = bus->Bus::read(address + 1);
+        decoded.prefixLength = 1;
+        decoded.prefixFetches = 1;
+        decoded.refresh = 2;
+        decoded.opCode = next;
+
+        if ((opCode == 0xDD || opCode == 0xFD) && next == 0xCB)
+        {
+            // The handler fetches d and the opcode itself
+            decoded.opCode = bus->Bus::read(address + 3);
+            decoded.prefixFetches = 2;
+            decoded.length = 4;
+            decoded.endsBlock = false;
+            instruction = opCode == 0xDD ? &instructionTableDDCB[decoded.opCode]
+                                         : &instructionTableFDCB[decoded.opCode];
+        }
+        else if (opCode == 0xDD || opCode == 0xFD)
+        {
+            if (next == 0x64 || next == 0x6D || (opCode == 0xDD && next == 0x00))
+            {
+                decoded.refresh = 1;
+            }
+            instruction = opCode == 0xDD ? &instructionTableDD[next] : &instructionTableFD[next];
+            decoded.length = 1 + unprefixedLength(next) + (usesHLOperand(next) ? 1 : 0);
+            decoded.endsBlock = endsBlock(next);
+        }
+        else if (opCode == 0xED)
+        {
+            instruction = &instructionTableED[next];
+            decoded.length = ((next >> 6) == 1 && (next & 7) == 3) ? 4 : 2; // LD (nn), rr and back
+            decoded.endsBlock = endsBlockED(next);
+        }
+        else if (opCode == 0xCB)
+        {
+            instruction = &instructionTableCB[next];
+            decoded.length = 2;
+            decoded.endsBlock = false;
+        }
+        else
+        {
+            // Not a prefix either, executeTable() does nothing here as well
+            decoded.operation = nullptr;
+            decoded.prefixLength = 0;
+            decoded.prefixFetches = 0;
+            decoded.refresh = 0;
+            decoded.cycles = 0;
+            decoded.length = 1;
+            decoded.endsBlock = true;
+            return;
+        }
+    }
+
+    if (instruction->hasOperation())
+    {
+        decoded.operation = instruction->getOperation();
+        decoded.cycles = instruction->getCycles();
+    }
+    else
+    {
+        // The prefix acts as a NOP and the opcode runs unprefixed
+        decoded.operation = nullptr;
+        decoded.cycles = 4;
+        decoded.length = 1;
+        decoded.endsBlock = false;
+    }
+}
+
+// Fourth execution engine, used by runFor(). Straight-line code is translated
+// into a TranslatedBlock once and then run without going back through
+// execute() for every instruction. A block ends at the first instruction that
+// can jump, at a HALT or at a repeating block instruction. Blocks are
+// invalidated by page generations like the decode cache. runFor() samples INT
+// between calls, and while INT is held it passes a one T-state deadline so
+// that every call runs a single instruction. Whole blocks therefore only run
+// while INT is low, and interrupts are taken at the same instruction
+// boundaries as in the per instruction loop.
+void z80::runBlocks(uint64_t deadline)
+{
+    TranslatedBlock *block = &findBlock(PC);
+    // Taken afresh on every call, the keyboard may have changed since the last
+    IdleSnapshot idle;
+    while (true)
+    {
+        if (skipIdleLoops && !CpuBus::ADDS_WAITS)
+        {
+            if (idle.head == block || ++idle.blocksSince > IDLE_LOOP_BLOCKS)
+            {
+                checkIdleLoop(idle, *block, deadline);
+            }
+            else
+            {
+                idle.lowest = std::min(idle.lowest, block->start);
+            }
+        }
+
+        const size_t count = block->instructions.size();
+        // A block that would start its last instruction past the deadline runs
+        // one instruction at a time, exactly like the loop in runFor(). So does
+        // every block on a bus that adds waits, where that is only known after.
+        const bool wholeBlock = !CpuBus::ADDS_WAITS && tstates + block->cyclesBeforeLast < deadline;
+        const uint32_t generation = block->generation;
+        ++blocksExecuted;
+
+        if (pairProfiling)
+        {
+            for (size_t i = 0; i + 1 < count; ++i)
+            {
+                uint32_t pair = instructionKey(block->instructions[i]) << 16 | instructionKey(block->instructions[i + 1]);
+                ++pairCounts[pair];
+            }
+        }
+
+#ifdef Z80_JIT_NATIVE
+        if (engine == ExecutionEngine::Jit && wholeBlock && block->native == nullptr &&
+            ++block->executions == jitThreshold)
+        {
+            compileBlock(*block);
+        }
+#endif
+        if (wholeBlock && block->native != nullptr && (block->staticCode || engine == ExecutionEngine::Jit))
+        {
+            if (block->staticCode)
+            {
+                ++staticBlocksRun;
+            }
+#ifdef Z80_JIT
+            else
+            {
+                ++jitBlocksRun;
+            }
+#endif
+            bool completed = block->native(this);
+#ifdef Z80_JIT
+            if (jitShadow)
+            {
+                syncJitShadow();
+            }
+#endif
+            if (!completed)
+                return;
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const DecodedInstruction &decoded = block->instructions[i];
+                if (decoded.fusion != 0 && wholeBlock)
+                {
+                    ++fusedPairsRun;
+                    if (!(this->*fusedPairs[decoded.fusion].run)(&decoded))
+                        return;
+                    ++i;
+                }
+                else
+                {
+                    chargeFetches(decoded, false);
+                    IncrementRefreshRegister(decoded.refresh);
+                    addBaseCycles(decoded.cycles, decoded.refresh);
+                    PC += decoded.prefixLength;
+                    if (decoded.operation != nullptr)
+                    {
+                        (this->*decoded.operation)(decoded.opCode);
+                        PC++;
+                    }
+                }
+
+                if (i + 1 < count)
+                {
+                    // The rest of the block may have just been written over
+                    if (blockGeneration(*block) != generation)
+                        return;
+                    if (!wholeBlock && tstates >= deadline)
+                        return;
+                }
+            }
+#ifdef Z80_JIT
+            if (jitShadow)
+            {
+                syncJitShadow();
+            }
+#endif
+        }
+
+        if (halted || tstates >= deadline)
+            return;
+
+        // Chain to the next block without going through blockCache
+        TranslatedBlock *next = nullptr;
+        for (TranslatedBlock *successor : block->successors)
+        {
+            if (successor != nullptr && successor->start == PC)
+            {
+                next = successor;
+                break;
+            }
+        }
+        if (next != nullptr && blockGeneration(*next) == next->generation)
+        {
+            ++blocksChained;
+        }
+        else
+        {
+            next = &findBlock(PC);
+            block->successors[1] = block->successors[0];
+            block->successors[0] = next;
+        }
+        block = next;
+    }
+}
+
+// Returns the valid block starting at address, translating it if needed
+TranslatedBlock &z80::findBlock(uint16_t address)
+{
+    if (blockCache.empty())
+    {
+        blockCache.resize(0x10000);
+    }
+
+    std::unique_ptr<TranslatedBlock> &block = blockCache[address];
+    if (!block)
+    {
+        block.reset(new TranslatedBlock());
+        translateBlock(address, *block);
+    }
+    else if (blockGeneration(*block) != block->generation)
+    {
+        translateBlock(address, *block);
+    }
+    return *block;
+}
+
+void z80::translateBlock(uint16_t address, TranslatedBlock &block)
+{
+    ++blocksTranslated;
+    ++block.translations;
+    block.native = nullptr;
+    block.staticCode = false;
+    block.executions = 0;
+    block.instructions.clear();
+    block.start = address;
+    block.cycles = 0;
+    block.cyclesBeforeLast = 0;
+
+    uint16_t next = address;
+    while (block.instructions.size() < MAX_BLOCK_LENGTH)
+    {
+        DecodedInstruction decoded;
+        decodeInstruction(next, decoded);
+
+        // Keep every block within two pages so one or two generations cover it
+        uint16_t last = next + decoded.length - 1;
+        if (!block.instructions.empty() && (((last >> 8) - (address >> 8)) & 0xFF) > 1)
+            break;
+
+        block.cyclesBeforeLast = block.cycles;
+        block.cycles += decoded.cycles;
+        block.last = last;
+        block.instructions.push_back(decoded);
+        next += decoded.length;
+
+        if (decoded.endsBlock)
+            break;
+    }
+    block.generation = blockGeneration(block);
+    block.countdown = isCountdown(block);
+    if (fuseInstructions)
+    {
+        fuseBlock(block);
+    }
+
+    if (address < staticBlocks.size() && staticBlocks[address] != nullptr &&
+        staticBlocks[address]->last == block.last && staticCodeIntact(block.start, block.last))
+    {
+        block.native = staticBlocks[address]->run;
+        block.staticCode = true;
+    }
+}
+
+bool z80::isCountdown(const TranslatedBlock &block)
+{
+    const size_t count = block.instructions.size();
+    for (size_t i = 0; i + 1 < count; ++i)
+    {
+        Operation operation = block.instructions[i].operation;
+        if (operation != nullptr && operation != &z80::NOP) // null is a prefix run as a NOP
+            return false;
+    }
+    return block.instructions[count - 1].operation == &z80::DJNZ_E;
+}
+
+void z80::takeIdleSnapshot(IdleSnapshot &idle, const TranslatedBlock &head)
+{
+    resolveFlags();
+    idle.head = &head;
+    idle.blocksSince = 0;
+    idle.lowest = head.start;
+    idle.tstates = tstates;
+    std::copy(regs16, regs16 + 13, idle.registers);
+    idle.I = I;
+    idle.R = R;
+    idle.IFF1 = IFF1;
+    idle.IFF2 = IFF2;
+    idle.interruptMode = interruptMode;
+    idle.memoryChanges = bus->getMemoryChanges();
+    idle.portSideEffects = bus->portSideEffects;
+    idle.refreshReads = refreshReads;
+}
+
+// Called before block runs. When block is the head of the snapshot and the
+// CPU is back in the state the snapshot holds, R aside, whatever ran since is
+// a loop that runs the same way until the deadline: the loop can only read
+// what the snapshot covers, keyboard ports and all, and that cannot change
+// before then. The iterations that end before the deadline are credited at
+// once, the one the deadline falls in runs normally so it can stop between
+// instructions. A countdown block looping to itself may move B and the F its
+// DJNZ sets as well, and is credited up to the iteration that takes B to 0.
+// Otherwise the snapshot is taken again here. runBlocks() also calls this when
+// the head has not come round for IDLE_LOOP_BLOCKS blocks, to move it here.
+void z80::checkIdleLoop(IdleSnapshot &idle, const TranslatedBlock &block, uint64_t deadline)
+{
+    // Most loops that come round write memory, which rules them out cheaply
+    if (idle.head != &block || bus->getMemoryChanges() != idle.memoryChanges)
+    {
+        takeIdleSnapshot(idle, block);
+        return;
+    }
+
+    resolveFlags();
+    uint16_t registers[13];
+    std::copy(regs16, regs16 + 13, registers);
+    if (block.countdown)
+    {
+        registers[0] += 0x100;                                              // BC
+        registers[4] = (registers[4] & 0xFF00) | (idle.registers[4] & 0xFF); // AF
+    }
+    const uint64_t period = tstates - idle.tstates;
+    uint64_t iterations = (deadline - tstates - 1) / period;
+    if (block.countdown)
+    {
+        iterations = B > 0 ? std::min<uint64_t>(iterations, B - 1) : 0;
+    }
+
+    if (iterations > 0 && std::equal(registers, registers + 13, idle.registers) && I == idle.I &&
+        IFF1 == idle.IFF1 && IFF2 == idle.IFF2 && interruptMode == idle.interruptMode &&
+        bus->portSideEffects == idle.portSideEffects &&
+        refreshReads == idle.refreshReads)
+    {
+        if (block.countdown)
+        {
+            B -= iterations;
+            DecFlags(B + 1, B);
+        }
+        uint64_t refresh = (R - idle.R) & 0x7F;
+        tstates += iterations * period;
+        IncrementRefreshRegister(static_cast<int>((iterations * refresh) & 0x7F)); // R counts in 7 bits
+        idleLoops[idle.lowest] += iterations * period;
+    }
+    takeIdleSnapshot(idle, block);
+}
+
+uint32_t z80::blockGeneration(const TranslatedBlock &block)
+{
+    uint32_t generation = bus->getPageGeneration(block.start);
+    if ((block.last >> 8) != (block.start >> 8))
+    {
+        generation += bus->getPageGeneration(block.last);
+    }
+    return generation;
+}
+
+// Superinstructions. The pairs below are the most frequent pairs of handlers
+// in the 48K ROM boot, the calculator and the screen clearing routines, as
+// reported by the pair profile (see benchmark/fusionBenchmark.cpp). A fused
+// pair runs both handlers with the same R, T-state and PC bookkeeping that
+// runBlocks() does between them, so R, MEMPTR and tstates come out the same.
+// It only saves the second dispatch and lets the compiler see both handlers
+// at once. Pairs are never split by the deadline, because runBlocks() only
+// runs them when the whole block fits in the budget.
+//
+// When the first handler writes memory it may write over the second opcode.
+// The pair then stops in between, with PC on the second instruction, as if
+// the block had been written over.
+template <Operation First, Operation Second, bool FirstWrites>
+bool z80::runFused(const DecodedInstruction *pair)
+{
+    chargeFetches(pair[0], false);
+    IncrementRefreshRegister(pair[0].refresh);
+    addBaseCycles(pair[0].cycles, pair[0].refresh);
+    PC += pair[0].prefixLength;
+    (this->*First)(pair[0].opCode);
+    PC++;
+    if (FirstWrites && (bus->Bus::read(PC) != pair[1].leadByte ||
+                        (pair[1].prefixLength != 0 && bus->Bus::read(PC + 1) != pair[1].opCode)))
+        return false;
+
+    chargeFetches(pair[1], false);
+    IncrementRefreshRegister(pair[1].refresh);
+    addBaseCycles(pair[1].cycles, pair[1].refresh);
+    PC += pair[1].prefixLength;
+    (this->*Second)(pair[1].opCode);
+    PC++;
+    return true;
+}
+
+// Entry 0 stands for no fusion
+const z80::FusedPair z80::fusedPairs[] = {
+    {nullptr, nullptr, nullptr},
+    // Walking through memory
+    {&z80::LD_R_HL, &z80::INC_SS, &z80::runFused<&z80::LD_R_HL, &z80::INC_SS, false>},
+    {&z80::INC_SS, &z80::LD_R_HL, &z80::runFused<&z80::INC_SS, &z80::LD_R_HL, false>},
+    {&z80::LD_HL_R, &z80::INC_SS, &z80::runFused<&z80::LD_HL_R, &z80::INC_SS, true>},
+    {&z80::LD_HL_N, &z80::DEC_SS, &z80::runFused<&z80::LD_HL_N, &z80::DEC_SS, true>},
+    {&z80::LD_R_HL, &z80::EX_DE_HL, &z80::runFused<&z80::LD_R_HL, &z80::EX_DE_HL, false>},
+    {&z80::INC_SS, &z80::INC_SS, &z80::runFused<&z80::INC_SS, &z80::INC_SS, false>},
+    {&z80::ADD_HL_SS, &z80::INC_SS, &z80::runFused<&z80::ADD_HL_SS, &z80::INC_SS, false>},
+    // Loop ends
+    {&z80::DEC_R, &z80::JR_NZ_E, &z80::runFused<&z80::DEC_R, &z80::JR_NZ_E, false>},
+    {&z80::DEC_HL, &z80::JR_Z_E, &z80::runFused<&z80::DEC_HL, &z80::JR_Z_E, true>},
+    {&z80::CP_R, &z80::JR_NZ_E, &z80::runFused<&z80::CP_R, &z80::JR_NZ_E, false>},
+    {&z80::INC_SS, &z80::JR_E, &z80::runFused<&z80::INC_SS, &z80::JR_E, false>},
+    {&z80::INC_SS, &z80::JR_NC_E, &z80::runFused<&z80::INC_SS, &z80::JR_NC_E, false>},
+    {&z80::INC_SS, &z80::DJNZ_E, &z80::runFused<&z80::INC_SS, &z80::DJNZ_E, false>},
+    // Calculator arithmetic, which keeps switching register banks
+    {&z80::EXX, &z80::RET, &z80::runFused<&z80::EXX, &z80::RET, false>},
+    {&z80::POP_QQ, &z80::EXX, &z80::runFused<&z80::POP_QQ, &z80::EXX, false>},
+    {&z80::EXX, &z80::PUSH_QQ, &z80::runFused<&z80::EXX, &z80::PUSH_QQ, false>},
+    {&z80::AND_A_R, &z80::SBC_HL_SS, &z80::runFused<&z80::AND_A_R, &z80::SBC_HL_SS, false>},
+    {&z80::SBC_HL_SS, &z80::ADD_HL_SS, &z80::runFused<&z80::SBC_HL_SS, &z80::ADD_HL_SS, false>},
+    {&z80::SBC_HL_SS, &z80::EXX, &z80::runFused<&z80::SBC_HL_SS, &z80::EXX, false>},
+    {&z80::RL_R, &z80::RL_R, &z80::runFused<&z80::RL_R, &z80::RL_R, false>},
+    {&z80::RL_R, &z80::EXX, &z80::runFused<&z80::RL_R, &z80::EXX, false>},
+    {&z80::EX_DE_HL, &z80::CALL_NN, &z80::runFused<&z80::EX_DE_HL, &z80::CALL_NN, false>},
+};
+
+// Marks the pairs in a block that have a fused handler. Only unprefixed, ED
+// and CB instructions are fused, whose opcode is the byte after the prefix.
+// Pairs do not overlap, the first match from the start wins.
+void z80::fuseBlock(TranslatedBlock &block)
+{
+    auto fusable = [](const DecodedInstruction &decoded)
+    { return decoded.prefixLength == 0 || decoded.leadByte == 0xED || decoded.leadByte == 0xCB; };
+
+    for (size_t i = 0; i + 1 < block.instructions.size(); ++i)
+    {
+        DecodedInstruction &first = block.instructions[i];
+        const DecodedInstruction &second = block.instructions[i + 1];
+        if (first.operation == nullptr || !fusable(first) || !fusable(second))
+            continue;
+
+        for (size_t fusion = 1; fusion < std::size(fusedPairs); ++fusion)
+        {
+            if (fusedPairs[fusion].first == first.operation && fusedPairs[fusion].second == second.operation)
+            {
+                first.fusion = static_cast<uint8_t>(fusion);
+                ++i;
+                break;
+            }
+        }
+    }
+}
+
+void z80::enablePairProfile()
+{
+    pairProfiling = true;
+    pairCounts.clear();
+}
+
+// The count most frequent pairs, most frequent first
+std::vector<std::pair<std::string, uint64_t>> z80::topPairs(size_t count) const
+{
+    std::vector<std::pair<uint32_t, uint64_t>> pairs(pairCounts.begin(), pairCounts.end());
+    count = std::min(count, pairs.size());
+    std::partial_sort(pairs.begin(), pairs.begin() + count, pairs.end(),
+                      [](const std::pair<uint32_t, uint64_t> &a, const std::pair<uint32_t, uint64_t> &b)
+                      { return a.second > b.second; });
+
+    std::vector<std::pair<std::string, uint64_t>> top;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string name = instructionForKey(pairs[i].first >> 16).getMnemonic() + "; " +
+                           instructionForKey(pairs[i].first & 0xFFFF).getMnemonic();
+        top.emplace_back(name, pairs[i].second);
+    }
+    return top;
+}
+
+// Decode table number in the high byte, opcode in the low byte. A prefix that
+// runs as a NOP counts as NOP.
+uint16_t z80::instructionKey(const DecodedInstruction &decoded) const
+{
+    const uint8_t op = decoded.opCode;
+    if (decoded.operation == nullptr)
+        return 0x0000;
+    if (decoded.prefixLength == 0)
+        return op;
+    switch (decoded.leadByte)
+    {
+    case 0xDD:
+        return (instructionTableDD[op].getOperation() == decoded.operation ? 0x100 : 0x500) | op;
+    case 0xFD:
+        return (instructionTableFD[op].getOperation() == decoded.operation ? 0x200 : 0x600) | op;
+    case 0xED:
+        return 0x300 | op;
+    default:
+        return 0x400 | op;
+    }
+}
+
+const Instruction &z80::instructionForKey(uint16_t key) const
+{
+    static const InstructionTable *const tables[] = {&instructionTable, &instructionTableDD, &instructionTableFD,
+                                                     &instructionTableED, &instructionTableCB, &instructionTableDDCB,
+                                                     &instructionTableFDCB};
+    return (*tables[key >> 8])[key & 0xFF];
+}
+
+bool z80::attachStaticTranslation(const StaticTranslation &translation)
+{
+    uint64_t checksum = 1469598103934665603ull;
+    for (uint32_t address = 0; address < translation.size; ++address)
+    {
+        checksum ^= bus->Bus::read(address);
+        checksum *= 1099511628211ull;
+    }
+    if (translation.size == 0 || translation.size > 0x10000 || checksum != translation.checksum)
+        return false;
+
+    staticBlocks.assign(translation.size, nullptr);
+    for (size_t i = 0; i < translation.blockCount; ++i)
+    {
+        staticBlocks[translation.blocks[i].start] = &translation.blocks[i];
+    }
+    staticGenerations.clear();
+    staticCounters.clear();
+    for (uint32_t page = 0; page < translation.size; page += 0x100)
+    {
+        staticGenerations.push_back(bus->getPageGeneration(page));
+        staticCounters.push_back(bus->getPageGenerationPointer(page));
+    }
+
+    // Blocks translated before now may start where a static block does
+    blockCache.clear();
+    return true;
+}
+
+#ifdef Z80_JIT
+// x86-64 recompiler for the Jit engine. A block that has run jitThreshold
+// times is compiled into native code:
+//
+//   - A, F, BC, DE and HL live in host registers while the block runs. They
+//     are loaded on first use, written back before a handler call and at
+//     every exit, and taken as clobbered by a handler.
+//   - Register moves (LD r, r', LD r, n, LD rr, nn, INC/DEC rr, EX DE, HL,
+//     EXX, LD SP, HL), the 8-bit ALU with a register or immediate operand,
+//     INC/DEC r, DI, NOP and the JP nn, JR, JR cc and DJNZ ending a block
+//     are emitted natively. Flags come from the same tables computeFlags()
+//     uses. Lazy flag builds leave the instructions that touch F to their
+//     handlers.
+//   - Flags no instruction can see are not computed: a backward pass over
+//     the block finds the ALU results that a later one overwrites before a
+//     handler call, a conditional jump or the end of the block reads them.
+//   - Everything else is a direct call to its handler.
+//   - PC is only written before a handler call and at the end of the block.
+//     R and tstates are added up and written once before each handler.
+//   - After every handler the page generations of the block are checked, so
+//     code that writes over the rest of its block leaves the native code.
+//   - A block that jumps back to its own start loops without leaving the
+//     native code while the next iteration still fits before the runFor()
+//     deadline, like runBlocks() would run it, and counts each iteration as
+//     a block run. With idle loop skipping on, only blocks that count with
+//     INC or DEC do, so runBlocks() still gets to see the loops it can skip.
+//
+// rbx holds the z80 pointer for the whole block. Blocks with I/O
+// instructions and blocks that keep being translated again stay interpreted,
+// and so does everything on a bus that charges opcode fetches.
+namespace
+{
+#ifdef Z80_JIT_NATIVE
+void jitRunHandler(z80 *cpu, const DecodedInstruction *decoded)
+{
+    // The instruction's T-states are already on the clock
+    cpu->bus->startAccesses(cpu->tstates - decoded->cycles + 4 * decoded->refresh);
+    (cpu->*decoded->operation)(decoded->opCode);
+}
+
+// Host registers by their encoding
+enum HostRegister : uint8_t
+{
+    RAX = 0,
+    RCX = 1,
+    RDX = 2,
+    RBX = 3,
+    RSI = 6,
+    RDI = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11,
+};
+
+// x86 condition codes for jumps
+enum Condition : uint8_t
+{
+    ALWAYS = 0,
+    BELOW = 0x2,
+    ABOVE_OR_EQUAL = 0x3,
+    EQUAL = 0x4,
+    NOT_EQUAL = 0x5,
+};
+
+class X86Emitter
+{
+public:
+    std::vector<uint8_t> code;
+
+    void bytes(std::initializer_list<uint8_t> values)
+    {
+        code.insert(code.end(), values);
+    }
+    void imm16(uint16_t value)
+    {
+        bytes({uint8_t(value), uint8_t(value >> 8)});
+    }
+    void imm32(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            code.push_back(uint8_t(value >> (8 * i)));
+    }
+    void imm64(uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            code.push_back(uint8_t(value >> (8 * i)));
+    }
+    // ModRM and disp32 for [rbx + disp], reg is a register or a /digit
+    void rbx(uint8_t reg, int32_t disp)
+    {
+        code.push_back(0x83 | ((reg & 7) << 3));
+        imm32(disp);
+    }
+    // REX for the registers in the ModRM reg and r/m fields, W for 64-bit
+    // operands. Byte operands always get one, so 4 to 7 are spl to dil.
+    void rex(bool wide, uint8_t reg, uint8_t rm, bool byteOperand = false)
+    {
+        uint8_t prefix = 0x40 | (wide ? 8 : 0) | ((reg & 8) >> 1) | ((rm & 8) >> 3);
+        if (prefix != 0x40 || byteOperand)
+            code.push_back(prefix);
+    }
+    // ModRM for two registers
+    void registers(uint8_t reg, uint8_t rm)
+    {
+        code.push_back(0xC0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    // mov [rbx + disp], al
+    void storeByte(int32_t disp)
+    {
+        bytes({0x88});
+        rbx(0, disp);
+    }
+    void storeByteImm(int32_t disp, uint8_t value)
+    {
+        bytes({0xC6});
+        rbx(0, disp);
+        code.push_back(value);
+    }
+    void storeWordImm(int32_t disp, uint16_t value)
+    {
+        bytes({0x66, 0xC7});
+        rbx(0, disp);
+        imm16(value);
+    }
+    void incWord(int32_t disp)
+    {
+        bytes({0x66, 0xFF});
+        rbx(0, disp);
+    }
+    void decWord(int32_t disp)
+    {
+        bytes({0x66, 0xFF});
+        rbx(1, disp);
+    }
+    void addQwordImm(int32_t disp, uint32_t value)
+    {
+        bytes({0x48, 0x81});
+        rbx(0, disp);
+        imm32(value);
+    }
+
+    // movzx reg, byte or word [rbx + disp]
+    void loadZeroExtended(uint8_t reg, int32_t disp, bool word)
+    {
+        rex(false, reg, RBX);
+        bytes({0x0F, uint8_t(word ? 0xB7 : 0xB6)});
+        rbx(reg, disp);
+    }
+    // mov [rbx + disp], the low byte or word of reg
+    void storeRegister(uint8_t reg, int32_t disp, bool word)
+    {
+        if (word)
+            code.push_back(0x66);
+        rex(false, reg, RBX, !word);
+        code.push_back(word ? 0x89 : 0x88);
+        rbx(reg, disp);
+    }
+    // 32-bit mov dst, src and mov dst, imm
+    void move(uint8_t dst, uint8_t src)
+    {
+        rex(false, src, dst);
+        code.push_back(0x89);
+        registers(src, dst);
+    }
+    void moveImm(uint8_t dst, uint32_t value)
+    {
+        rex(false, 0, dst);
+        code.push_back(0xB8 | (dst & 7));
+        imm32(value);
+    }
+    void moveImm64(uint8_t dst, uint64_t value)
+    {
+        rex(true, 0, dst);
+        code.push_back(0xB8 | (dst & 7));
+        imm64(value);
+    }
+    // mov dst8, src8 and movzx dst, src8
+    void moveByte(uint8_t dst, uint8_t src)
+    {
+        rex(false, src, dst, true);
+        code.push_back(0x88);
+        registers(src, dst);
+    }
+    void zeroExtendByte(uint8_t dst, uint8_t src)
+    {
+        rex(false, dst, src, true);
+        bytes({0x0F, 0xB6});
+        registers(dst, src);
+    }
+    // movzx dst, dh and mov dh, al, which only exist without a REX
+    void zeroExtendDH(uint8_t dst)
+    {
+        bytes({0x0F, 0xB6});
+        registers(dst, 6);
+    }
+    void storeDH()
+    {
+        bytes({0x88, 0xC6});
+    }
+    // 32-bit ALU dst, src with its r/m, r opcode (add 01, or 09, and 21,
+    // sub 29, xor 31, cmp 39) and dst, imm with its /digit
+    void alu(uint8_t opcode, uint8_t dst, uint8_t src)
+    {
+        rex(false, src, dst);
+        code.push_back(opcode);
+        registers(src, dst);
+    }
+    void aluImm(uint8_t digit, uint8_t dst, uint32_t value)
+    {
+        rex(false, 0, dst);
+        code.push_back(0x81);
+        registers(digit, dst);
+        imm32(value);
+    }
+    // shl (/4) or shr (/5) by count
+    void shift(uint8_t digit, uint8_t reg, uint8_t count)
+    {
+        rex(false, 0, reg);
+        code.push_back(0xC1);
+        registers(digit, reg);
+        code.push_back(count);
+    }
+    // Swaps the bytes of the low word, which leaves the rest alone
+    void swapBytes(uint8_t reg)
+    {
+        code.push_back(0x66);
+        rex(false, 0, reg);
+        code.push_back(0xC1);
+        registers(0, reg); // rol reg16, 8
+        code.push_back(8);
+    }
+    // inc (/0) or dec (/1) of the low word
+    void stepWord(uint8_t digit, uint8_t reg)
+    {
+        code.push_back(0x66);
+        rex(false, 0, reg);
+        code.push_back(0xFF);
+        registers(digit, reg);
+    }
+    void exchange(uint8_t first, uint8_t second)
+    {
+        rex(false, first, second);
+        code.push_back(0x87);
+        registers(first, second);
+    }
+    // movzx dst, byte [table + rax]
+    void lookup(uint8_t dst, const uint8_t *table)
+    {
+        moveImm64(RSI, reinterpret_cast<uint64_t>(table));
+        rex(false, dst, RAX);
+        bytes({0x0F, 0xB6});
+        code.push_back(0x04 | ((dst & 7) << 3));
+        code.push_back(0x06); // [rsi + rax]
+    }
+    // test reg8, mask
+    void testByte(uint8_t reg, uint8_t mask)
+    {
+        rex(false, 0, reg, true);
+        code.push_back(0xF6);
+        registers(0, reg);
+        code.push_back(mask);
+    }
+
+    // Forward jump, bound later to where it goes
+    size_t jump(Condition condition)
+    {
+        if (condition == ALWAYS)
+            code.push_back(0xE9);
+        else
+            bytes({0x0F, uint8_t(0x80 | condition)});
+        imm32(0);
+        return code.size() - 4;
+    }
+    void bind(size_t jump)
+    {
+        uint32_t distance = static_cast<uint32_t>(code.size() - (jump + 4));
+        for (int i = 0; i < 4; ++i)
+            code[jump + i] = uint8_t(distance >> (8 * i));
+    }
+    void jumpBack(size_t target)
+    {
+        code.push_back(0xE9);
+        imm32(static_cast<uint32_t>(target - (code.size() + 4)));
+    }
+
+    // R keeps bit 7 and counts in the low 7 bits
+    void addRefresh(int32_t disp, uint8_t steps)
+    {
+        bytes({0x0F, 0xB6}); // movzx eax, byte [rbx + disp]
+        rbx(0, disp);
+        bytes({0x89, 0xC1});        // mov ecx, eax
+        bytes({0x83, 0xC0, steps}); // add eax, steps
+        bytes({0x83, 0xE0, 0x7F});  // and eax, 0x7F
+        bytes({0x81, 0xE1});        // and ecx, 0x80
+        imm32(0x80);
+        bytes({0x09, 0xC8}); // or eax, ecx
+        storeByte(disp);
+    }
+
+    void callHandler(const DecodedInstruction *decoded)
+    {
+        bytes({0x48, 0x89, 0xDF}); // mov rdi, rbx
+        bytes({0x48, 0xBE});       // mov rsi, decoded
+        imm64(reinterpret_cast<uint64_t>(decoded));
+        bytes({0x48, 0xB8}); // mov rax, jitRunHandler
+        imm64(reinterpret_cast<uint64_t>(&jitRunHandler));
+        bytes({0xFF, 0xD0}); // call rax
+    }
+
+    // Returns completed from the block
+    void leave(bool completed)
+    {
+        moveImm(RAX, completed ? 1 : 0);
+        bytes({0x5B, 0xC3}); // pop rbx; ret
+    }
+
+    // Returns false with PC set to pc unless counter still holds generation
+    void exitUnlessGeneration(const uint32_t *counter, uint32_t generation, int32_t pcDisp, uint16_t pc)
+    {
+        moveImm64(RAX, reinterpret_cast<uint64_t>(counter));
+        bytes({0x81, 0x38}); // cmp dword [rax], generation
+        imm32(generation);
+        size_t same = jump(EQUAL);
+        storeWordImm(pcDisp, pc);
+        leave(false);
+        bind(same);
+    }
+
+    // Jumps when tstates + cycles reaches the qword at deadlineDisp
+    size_t jumpUnlessBefore(int32_t tstatesDisp, uint32_t cycles, int32_t deadlineDisp)
+    {
+        rex(true, RAX, RBX);
+        code.push_back(0x8B); // mov rax, [rbx + tstates]
+        rbx(RAX, tstatesDisp);
+        rex(true, 0, RAX);
+        code.push_back(0x81); // add rax, cycles
+        registers(0, RAX);
+        imm32(cycles);
+        rex(true, RAX, RBX);
+        code.push_back(0x3B); // cmp rax, [rbx + deadline]
+        rbx(RAX, deadlineDisp);
+        return jump(ABOVE_OR_EQUAL);
+    }
+    // Jumps when the byte at disp is not 0
+    size_t jumpIfSet(int32_t disp)
+    {
+        code.push_back(0x80); // cmp byte [rbx + disp], 0
+        rbx(7, disp);
+        code.push_back(0);
+        return jump(NOT_EQUAL);
+    }
+    void incQword(int32_t disp)
+    {
+        bytes({0x48, 0xFF});
+        rbx(0, disp);
+    }
+};
+
+
+// The Z80 registers a compiled block holds in host registers: A and F in
+// r8d and r9d, BC, DE and HL in r10d, r11d and edx, the rest of each host
+// register 0. Tracks which of them are loaded and which differ from the
+// register file, and emits the loads and stores that keep the two in step.
+class JitRegisters
+{
+public:
+    enum Slot
+    {
+        A_SLOT,
+        F_SLOT,
+        BC_SLOT,
+        DE_SLOT,
+        HL_SLOT,
+        SLOTS
+    };
+    struct State
+    {
+        bool held[SLOTS] = {};
+        bool dirty[SLOTS] = {};
+    };
+    State state;
+
+    JitRegisters(X86Emitter &x86, int32_t regs8Disp) : x86(x86)
+    {
+        // F and A are the low and high byte of the AF lane
+        disps[A_SLOT] = regs8Disp + z80::readRegisterOffset[7];
+        disps[F_SLOT] = disps[A_SLOT] - 1;
+        for (int pair = 0; pair < 3; ++pair)
+            disps[BC_SLOT + pair] = regs8Disp + 2 * pair;
+    }
+
+    static uint8_t host(int slot)
+    {
+        static const uint8_t hosts[SLOTS] = {R8, R9, R10, R11, RDX};
+        return hosts[slot];
+    }
+
+    void use(int slot)
+    {
+        if (!state.held[slot])
+        {
+            x86.loadZeroExtended(host(slot), disps[slot], slot >= BC_SLOT);
+            state.held[slot] = true;
+            state.dirty[slot] = false;
+        }
+    }
+    // The host register has been written
+    void changed(int slot)
+    {
+        state.held[slot] = true;
+        state.dirty[slot] = true;
+    }
+    // Every register a block keeps, loaded
+    void holdAll()
+    {
+        for (int slot = 0; slot < SLOTS; ++slot)
+        {
+#ifdef Z80_LAZY_FLAGS
+            if (slot == F_SLOT)
+                continue; // F is not current while a flag operation is pending
+#endif
+            use(slot);
+        }
+    }
+    void writeBack()
+    {
+        for (int slot = 0; slot < SLOTS; ++slot)
+        {
+            if (state.dirty[slot])
+            {
+                x86.storeRegister(host(slot), disps[slot], slot >= BC_SLOT);
+                state.dirty[slot] = false;
+            }
+        }
+    }
+    // After a handler, which may have changed any of them
+    void forget()
+    {
+        state = State();
+    }
+
+    // 8-bit register r (B, C, D, E, H, L, -, A) into dst, which is eax or ecx
+    void read(uint8_t r, uint8_t dst)
+    {
+        if (r == 7)
+        {
+            use(A_SLOT);
+            x86.move(dst, R8);
+            return;
+        }
+        const int slot = BC_SLOT + r / 2;
+        use(slot);
+        if (r & 1)
+            x86.zeroExtendByte(dst, host(slot));
+        else if (host(slot) == RDX)
+            x86.zeroExtendDH(dst);
+        else
+        {
+            x86.move(dst, host(slot));
+            x86.shift(5, dst, 8); // shr dst, 8
+        }
+    }
+    // al into 8-bit register r
+    void write(uint8_t r)
+    {
+        if (r == 7)
+        {
+            x86.zeroExtendByte(R8, RAX);
+            changed(A_SLOT);
+            return;
+        }
+        const int slot = BC_SLOT + r / 2;
+        use(slot);
+        if (r & 1)
+            x86.moveByte(host(slot), RAX);
+        else if (host(slot) == RDX)
+            x86.storeDH();
+        else
+        {
+            x86.swapBytes(host(slot));
+            x86.moveByte(host(slot), RAX);
+            x86.swapBytes(host(slot));
+        }
+        changed(slot);
+    }
+
+private:
+    X86Emitter &x86;
+    int32_t disps[SLOTS];
+};
+
+// What the compiler makes of an instruction
+enum class JitKind
+{
+    Handler,
+    Nop,
+    LoadRegister,  // LD r, r'
+    LoadImmediate, // LD r, n
+    LoadPair,      // LD rr, nn
+    StepPair,      // INC rr, DEC rr
+    LoadSPHL,
+    ExchangeDEHL,
+    ExchangeAll, // EXX
+    DisableInterrupts,
+    Alu,          // ADD to CP with a register
+    AluImmediate, // ADD to CP with n
+    Increment,    // INC r
+    Decrement,    // DEC r
+    Jump,         // JP nn
+    RelativeJump, // JR e
+    ConditionalJump,
+    Countdown, // DJNZ
+};
+
+JitKind classifyForJit(const DecodedInstruction &decoded, bool last)
+{
+    const Operation operation = decoded.operation;
+    const uint8_t op = decoded.opCode;
+    const uint8_t y = (op >> 3) & 7;
+    if (operation == nullptr)
+        return JitKind::Nop; // A prefix that runs as one
+    if (decoded.prefixLength != 0)
+        return JitKind::Handler;
+    if (operation == &z80::NOP)
+        return JitKind::Nop;
+    if ((op & 0xC0) == 0x40 && (op & 7) != 6 && y != 6)
+        return JitKind::LoadRegister;
+    if (operation == &z80::LD_R_N && y != 6)
+        return JitKind::LoadImmediate;
+    if (operation == &z80::LD_DD_NN)
+        return JitKind::LoadPair;
+    if (operation == &z80::INC_SS || operation == &z80::DEC_SS)
+        return JitKind::StepPair;
+    if (operation == &z80::LD_SP_HL)
+        return JitKind::LoadSPHL;
+    if (operation == &z80::EX_DE_HL)
+        return JitKind::ExchangeDEHL;
+    if (operation == &z80::EXX)
+        return JitKind::ExchangeAll;
+    if (operation == &z80::DI)
+        return JitKind::DisableInterrupts;
+    if (operation == &z80::JP_NN && last)
+        return JitKind::Jump;
+    if (op == 0x18 && last)
+        return JitKind::RelativeJump;
+#ifndef Z80_LAZY_FLAGS
+    if ((op & 0xC0) == 0x80 && (op & 7) != 6)
+        return JitKind::Alu;
+    if ((op & 0xC7) == 0xC6)
+        return JitKind::AluImmediate;
+    if ((op & 0xC7) == 0x04 && y != 6)
+        return JitKind::Increment;
+    if ((op & 0xC7) == 0x05 && y != 6)
+        return JitKind::Decrement;
+    if ((op & 0xE7) == 0x20 && last)
+        return JitKind::ConditionalJump;
+    if (op == 0x10 && last)
+        return JitKind::Countdown;
+#endif
+    return JitKind::Handler;
+}
+
+// Flags an instruction reads, and flags it sets whatever they were before
+void jitFlagEffects(JitKind kind, uint8_t op, uint8_t &uses, uint8_t &defines)
+{
+    uses = defines = 0;
+    switch (kind)
+    {
+    case JitKind::Handler:
+        uses = 0xFF;
+        break;
+    case JitKind::Alu:
+    case JitKind::AluImmediate:
+    {
+        const uint8_t y = (op >> 3) & 7;
+        uses = y == 1 || y == 3 ? z80::C_flag : 0; // ADC, SBC
+        defines = 0xFF;
+        break;
+    }
+    case JitKind::Increment:
+    case JitKind::Decrement:
+    case JitKind::Countdown:
+        defines = static_cast<uint8_t>(~z80::C_flag);
+        break;
+    case JitKind::ConditionalJump:
+        uses = op < 0x30 ? z80::Z : z80::C_flag;
+        break;
+    default:
+        break;
+    }
+}
+
+// IN and OUT in all their forms, which stay with the interpreter
+bool isIOInstruction(const DecodedInstruction &decoded)
+{
+    if (decoded.leadByte == 0xDB || decoded.leadByte == 0xD3)
+        return true;
+    if (decoded.leadByte != 0xED)
+        return false;
+    uint8_t x = decoded.opCode >> 6, y = (decoded.opCode >> 3) & 7, z = decoded.opCode & 7;
+    return (x == 1 && z <= 1) || (x == 2 && y >= 4 && (z == 2 || z == 3));
+}
+#endif
+}
+
+void z80::enableJitDifferential(CpuBus *shadowBus)
+{
+    resolveFlags();
+    jitShadow.reset(new z80());
+    jitShadow->reset(shadowBus);
+    jitShadow->engine = ExecutionEngine::Table;
+    std::copy(std::begin(regs16), std::end(regs16), std::begin(jitShadow->regs16));
+    jitShadow->tstates = tstates;
+    jitShadow->interruptMode = interruptMode;
+    jitShadow->IFF1 = IFF1;
+    jitShadow->IFF2 = IFF2;
+    jitShadow->halted = halted;
+    jitShadowGenerations.assign(2 * Bus::PAGES, 0);
+    compareJitShadowMemory(true);
+}
+
+// Lets the shadow CPU catch up with this one and compares the two
+void z80::syncJitShadow()
+{
+    z80 &shadow = *jitShadow;
+    while (shadow.tstates < tstates)
+    {
+        if (shadow.halted)
+        {
+            shadow.skipHalted(tstates);
+        }
+        else
+        {
+            shadow.execute(shadow.bus->read(shadow.PC));
+        }
+    }
+
+    resolveFlags();
+    shadow.resolveFlags();
+    // Everything up to I and R, the (HL) slots after them are scratch
+    bool same = std::equal(regs16, regs16 + 14, shadow.regs16) && tstates == shadow.tstates &&
+                IFF1 == shadow.IFF1 && IFF2 == shadow.IFF2 && halted == shadow.halted &&
+                compareJitShadowMemory(false);
+    if (!same)
+    {
+        ++jitMismatches;
+        if (onJitMismatch)
+        {
+            onJitMismatch(shadow);
+        }
+
+        // Carry on from the JIT state
+        std::copy(std::begin(regs16), std::end(regs16), std::begin(shadow.regs16));
+        shadow.tstates = tstates;
+        shadow.IFF1 = IFF1;
+        shadow.IFF2 = IFF2;
+        shadow.halted = halted;
+        compareJitShadowMemory(true);
+    }
+}
+
+// Compares the pages either bus has written since they last matched. With
+// repair, the bytes that differ are copied over to the shadow bus. Reads skip
+// the bus policy, so a ContendedBus is not charged for them.
+bool z80::compareJitShadowMemory(bool repair)
+{
+    CpuBus &shadowBus = *jitShadow->bus;
+    bool same = true;
+    for (int page = 0; page < Bus::PAGES; ++page)
+    {
+        const uint16_t first = static_cast<uint16_t>(page << Bus::PAGE_SHIFT);
+        if (bus->getPageGeneration(first) == jitShadowGenerations[2 * page] &&
+            shadowBus.getPageGeneration(first) == jitShadowGenerations[2 * page + 1])
+        {
+            continue;
+        }
+        bool pageSame = true;
+        for (int offset = 0; offset < Bus::PAGE_SIZE; ++offset)
+        {
+            const uint16_t address = first + offset;
+            const uint8_t value = bus->Bus::read(address);
+            if (shadowBus.Bus::read(address) != value)
+            {
+                pageSame = false;
+                if (!repair)
+                    break;
+                shadowBus.Bus::write(address, value);
+            }
+        }
+        same = same && pageSame;
+        if (pageSame || repair)
+        {
+            jitShadowGenerations[2 * page] = bus->getPageGeneration(first);
+            jitShadowGenerations[2 * page + 1] = shadowBus.getPageGeneration(first);
+        }
+    }
+    return same;
+}
+
+void z80::flushJitCode()
+{
+    for (std::unique_ptr<TranslatedBlock> &block : blockCache)
+    {
+        if (block && !block->staticCode)
+        {
+            block->native = nullptr;
+        }
+    }
+    jitCodeUsed = 0;
+}
+
+// Compiles a valid block, returns false if it has to stay interpreted
+bool z80::compileBlock(TranslatedBlock &block)
+{
+#ifdef Z80_JIT_NATIVE
+    if (CpuBus::CHARGES_FETCHES || block.translations > JIT_MAX_TRANSLATIONS)
+        return false;
+    for (const DecodedInstruction &decoded : block.instructions)
+    {
+        if (isIOInstruction(decoded))
+            return false;
+    }
+
+    if (jitCode == nullptr)
+    {
+        void *code = mmap(nullptr, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (code == MAP_FAILED)
+        {
+            engine = ExecutionEngine::Block; // No executable memory, interpret
+            return false;
+        }
+        jitCode = static_cast<uint8_t *>(code);
+    }
+
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(this);
+    auto offset = [base](const void *member)
+    { return static_cast<int32_t>(static_cast<const uint8_t *>(member) - base); };
+    const int32_t pcDisp = offset(&PC);
+    const int32_t tstatesDisp = offset(&tstates);
+
+    // Generation counters of the one or two pages the block came from
+    const uint32_t *counters[2] = {bus->getPageGenerationPointer(block.start), nullptr};
+    if ((block.last >> 8) != (block.start >> 8))
+    {
+        counters[1] = bus->getPageGenerationPointer(block.last);
+    }
+
+    // Backward pass: the flags still to be read after each instruction. The
+    // end of the block and every handler call read all of them.
+    const size_t count = block.instructions.size();
+    std::vector<JitKind> kinds(count);
+    std::vector<uint8_t> liveAfter(count);
+    bool counts = false;
+    bool handlers = false;
+    uint8_t live = 0xFF;
+    for (size_t i = count; i-- > 0;)
+    {
+        const DecodedInstruction &decoded = block.instructions[i];
+        kinds[i] = classifyForJit(decoded, i + 1 == count);
+        counts = counts || kinds[i] == JitKind::Increment || kinds[i] == JitKind::Decrement ||
+                 kinds[i] == JitKind::StepPair;
+        handlers = handlers || kinds[i] == JitKind::Handler;
+        uint8_t uses, defines;
+        jitFlagEffects(kinds[i], decoded.opCode, uses, defines);
+        liveAfter[i] = live;
+        live = (live & ~defines) | uses;
+    }
+
+    X86Emitter x86;
+    JitRegisters regs(x86, offset(regs8));
+    x86.bytes({0x53, 0x48, 0x89, 0xFB}); // push rbx; mov rbx, rdi
+
+    // Where the block ends up when its last instruction jumps back to it
+    const DecodedInstruction &lastDecoded = block.instructions[count - 1];
+    const uint16_t lastPc = block.last + 1 - lastDecoded.length;
+    uint16_t target = lastPc + lastDecoded.length;
+    if (kinds[count - 1] == JitKind::Jump)
+        target = bus->Bus::read(lastPc + 1) | (bus->Bus::read(lastPc + 2) << 8);
+    else if (kinds[count - 1] == JitKind::RelativeJump || kinds[count - 1] == JitKind::ConditionalJump ||
+             kinds[count - 1] == JitKind::Countdown)
+        target += static_cast<int8_t>(bus->Bus::read(lastPc + 1));
+    const bool loops = target == block.start && kinds[count - 1] != JitKind::Handler &&
+                       kinds[count - 1] >= JitKind::Jump;
+    size_t loopStart = 0;
+    if (loops)
+    {
+        regs.holdAll();
+        loopStart = x86.code.size();
+    }
+
+    uint32_t pendingRefresh = 0;
+    uint32_t pendingCycles = 0;
+    auto flush = [&]()
+    {
+        if ((pendingRefresh & 0x7F) != 0)
+            x86.addRefresh(offset(&R), pendingRefresh & 0x7F);
+        if (pendingCycles != 0)
+            x86.addQwordImm(tstatesDisp, pendingCycles);
+        pendingRefresh = pendingCycles = 0;
+    };
+    auto leaveAt = [&](uint16_t pc)
+    {
+        regs.writeBack();
+        x86.storeWordImm(pcDisp, pc);
+        x86.leave(true);
+    };
+
+    // Flags of the 8-bit ALU operations into F when live says anything reads
+    // them, the operand in ecx and the carry in edi. The index into the two
+    // operand tables goes in eax as carry << 16 | A << 8 | operand.
+    auto operands = [&](bool carry)
+    {
+        if (carry)
+        {
+            x86.move(RAX, RDI);
+            x86.shift(4, RAX, 8); // shl eax, 8
+            x86.alu(0x09, RAX, R8);
+        }
+        else
+        {
+            x86.move(RAX, R8);
+        }
+        x86.shift(4, RAX, 8);
+        x86.alu(0x09, RAX, RCX);
+    };
+    auto alu = [&](uint8_t y, bool flagsLive)
+    {
+        regs.use(JitRegisters::A_SLOT);
+        const bool carryIn = y == 1 || y == 3;
+        if (carryIn)
+        {
+            regs.use(JitRegisters::F_SLOT);
+            x86.move(RDI, R9);
+            x86.aluImm(4, RDI, C_flag); // and edi, C
+        }
+        switch (y)
+        {
+        case 0: // ADD
+        case 1: // ADC
+        case 2: // SUB
+        case 3: // SBC
+        {
+            const bool add = y < 2;
+            if (flagsLive)
+            {
+                operands(carryIn);
+                x86.lookup(R9, (add ? addFlagsTable : subFlagsTable).data());
+            }
+            x86.alu(add ? 0x01 : 0x29, R8, RCX);
+            if (carryIn)
+                x86.alu(add ? 0x01 : 0x29, R8, RDI);
+            x86.aluImm(4, R8, 0xFF);
+            regs.changed(JitRegisters::A_SLOT);
+            break;
+        }
+        case 4: // AND
+        case 5: // XOR
+        case 6: // OR
+            x86.alu(y == 4 ? 0x21 : y == 5 ? 0x31 : 0x09, R8, RCX);
+            regs.changed(JitRegisters::A_SLOT);
+            if (flagsLive)
+            {
+                x86.move(RAX, R8);
+                x86.lookup(R9, szxypTable.data());
+                if (y == 4)
+                    x86.aluImm(1, R9, H_flag); // or r9d, H
+            }
+            break;
+        default: // CP
+            if (flagsLive)
+            {
+                operands(carryIn);
+                x86.lookup(R9, cpFlagsTable.data());
+            }
+            break;
+        }
+        if (flagsLive)
+            regs.changed(JitRegisters::F_SLOT);
+    };
+    // INC r and DEC r, the value in eax. Carry is kept.
+    auto step = [&](const ByteFlagTable &table, bool flagsLive)
+    {
+        if (!flagsLive)
+            return;
+        regs.use(JitRegisters::F_SLOT);
+        x86.aluImm(4, R9, C_flag);
+        x86.lookup(RCX, table.data());
+        x86.alu(0x09, R9, RCX);
+        regs.changed(JitRegisters::F_SLOT);
+    };
+
+    uint16_t pc = block.start;
+    bool ended = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const DecodedInstruction &decoded = block.instructions[i];
+        const JitKind kind = kinds[i];
+        const bool flagsLive = liveAfter[i] != 0;
+        const uint16_t next = pc + decoded.length;
+        const uint8_t op = decoded.opCode;
+        const uint8_t y = (op >> 3) & 7;
+        const int pair = (op >> 4) & 3;
+        pendingRefresh += decoded.refresh;
+        pendingCycles += decoded.cycles;
+
+        switch (kind)
+        {
+        case JitKind::Nop:
+            break;
+        case JitKind::LoadRegister:
+            regs.read(op & 7, RAX);
+            regs.write(y);
+            break;
+        case JitKind::LoadImmediate:
+            x86.moveImm(RAX, bus->Bus::read(pc + 1));
+            regs.write(y);
+            break;
+        case JitKind::LoadPair:
+        {
+            uint16_t value = bus->Bus::read(pc + 1) | (bus->Bus::read(pc + 2) << 8);
+            if (pair == 3)
+            {
+                x86.storeWordImm(offset(&SP), value);
+                break;
+            }
+            x86.moveImm(JitRegisters::host(JitRegisters::BC_SLOT + pair), value);
+            regs.changed(JitRegisters::BC_SLOT + pair);
+            break;
+        }
+        case JitKind::StepPair:
+        {
+            const bool increment = decoded.operation == &z80::INC_SS;
+            if (pair == 3)
+            {
+                increment ? x86.incWord(offset(&SP)) : x86.decWord(offset(&SP));
+                break;
+            }
+            regs.use(JitRegisters::BC_SLOT + pair);
+            x86.stepWord(increment ? 0 : 1, JitRegisters::host(JitRegisters::BC_SLOT + pair));
+            regs.changed(JitRegisters::BC_SLOT + pair);
+            break;
+        }
+        case JitKind::LoadSPHL:
+            regs.use(JitRegisters::HL_SLOT);
+            x86.storeRegister(RDX, offset(&SP), true);
+            break;
+        case JitKind::ExchangeDEHL:
+            regs.use(JitRegisters::DE_SLOT);
+            regs.use(JitRegisters::HL_SLOT);
+            x86.exchange(R11, RDX);
+            regs.changed(JitRegisters::DE_SLOT);
+            regs.changed(JitRegisters::HL_SLOT);
+            break;
+        case JitKind::ExchangeAll:
+        {
+            const uint16_t *alternates[3] = {&BC1, &DE1, &HL1};
+            for (int slot = JitRegisters::BC_SLOT; slot <= JitRegisters::HL_SLOT; ++slot)
+            {
+                const int32_t alternate = offset(alternates[slot - JitRegisters::BC_SLOT]);
+                regs.use(slot);
+                x86.loadZeroExtended(RAX, alternate, true);
+                x86.storeRegister(JitRegisters::host(slot), alternate, true);
+                x86.move(JitRegisters::host(slot), RAX);
+                regs.changed(slot);
+            }
+            break;
+        }
+        case JitKind::DisableInterrupts:
+            x86.storeByteImm(offset(&IFF1), 0);
+            x86.storeByteImm(offset(&IFF2), 0);
+            break;
+        case JitKind::Alu:
+            regs.read(op & 7, RCX);
+            alu(y, flagsLive);
+            break;
+        case JitKind::AluImmediate:
+            x86.moveImm(RCX, bus->Bus::read(pc + 1));
+            alu(y, flagsLive);
+            break;
+        case JitKind::Increment:
+        case JitKind::Decrement:
+        {
+            const bool increment = kind == JitKind::Increment;
+            regs.read(y, RAX);
+            step(increment ? incFlagsTable : decFlagsTable, flagsLive);
+            x86.aluImm(increment ? 0 : 5, RAX, 1); // add or sub eax, 1
+            regs.write(y);
+            break;
+        }
+        case JitKind::Jump:
+        case JitKind::RelativeJump:
+        case JitKind::ConditionalJump:
+        case JitKind::Countdown:
+        {
+            size_t notTaken = 0;
+            flush(); // Before the test, it changes the host flags
+            if (kind == JitKind::Countdown)
+            {
+                regs.read(0, RAX);
+                step(decFlagsTable, flagsLive);
+                x86.aluImm(5, RAX, 1);
+                regs.write(0);
+                x86.testByte(RAX, 0xFF);
+            }
+            else if (kind == JitKind::ConditionalJump)
+            {
+                regs.use(JitRegisters::F_SLOT);
+                x86.testByte(R9, y < 6 ? Z : C_flag);
+            }
+            if (kind == JitKind::Countdown || kind == JitKind::ConditionalJump)
+            {
+                // JR NZ and NC fall through when the flag is set, JR Z and C
+                // and DJNZ (on B) when it is clear
+                notTaken = x86.jump(kind == JitKind::ConditionalJump && (y & 1) == 0 ? NOT_EQUAL : EQUAL);
+                x86.addQwordImm(tstatesDisp, 5);
+            }
+            x86.storeWordImm(offset(&MPTR), target);
+
+            const JitRegisters::State branch = regs.state;
+            if (loops)
+            {
+                // Round again while the next iteration fits, as runBlocks()
+                // would run it, with the registers as they were at the top
+                regs.writeBack();
+                if (handlers)
+                {
+                    for (const uint32_t *counter : counters)
+                    {
+                        if (counter != nullptr)
+                            x86.exitUnlessGeneration(counter, *counter, pcDisp, target);
+                    }
+                }
+                size_t exits[3];
+                size_t exitCount = 0;
+                exits[exitCount++] = x86.jumpUnlessBefore(tstatesDisp, block.cyclesBeforeLast, offset(&runDeadline));
+                exits[exitCount++] = x86.jumpIfSet(offset(&pairProfiling));
+                if (!counts)
+                    exits[exitCount++] = x86.jumpIfSet(offset(&skipIdleLoops));
+                x86.incQword(offset(&blocksExecuted));
+                x86.incQword(offset(&jitBlocksRun));
+                regs.holdAll();
+                x86.jumpBack(loopStart);
+                for (size_t exit = 0; exit < exitCount; ++exit)
+                    x86.bind(exits[exit]);
+                x86.storeWordImm(pcDisp, target);
+                x86.leave(true);
+            }
+            else
+            {
+                leaveAt(target);
+            }
+            if (kind == JitKind::Countdown || kind == JitKind::ConditionalJump)
+            {
+                regs.state = branch;
+                x86.bind(notTaken);
+                leaveAt(next);
+            }
+            ended = true;
+            break;
+        }
+        default:
+            flush();
+            regs.writeBack();
+            x86.storeWordImm(pcDisp, pc + decoded.prefixLength);
+            x86.callHandler(&decoded);
+            regs.forget();
+            if (i + 1 == count)
+            {
+                x86.incWord(pcDisp); // The PC++ execute() does after every handler
+                x86.leave(true);
+                ended = true;
+            }
+            else
+            {
+                for (const uint32_t *counter : counters)
+                {
+                    if (counter != nullptr)
+                        x86.exitUnlessGeneration(counter, *counter, pcDisp, next);
+                }
+            }
+            break;
+        }
+        pc = next;
+    }
+
+    if (!ended)
+    {
+        flush();
+        leaveAt(pc);
+    }
+
+    if (jitCodeUsed + x86.code.size() > JIT_CODE_SIZE)
+    {
+        flushJitCode();
+    }
+
+    // Only writable while the code is copied in
+    if (mprotect(jitCode, JIT_CODE_SIZE, PROT_READ | PROT_WRITE) != 0)
+        return false;
+    uint8_t *entry = jitCode + jitCodeUsed;
+    std::memcpy(entry, x86.code.data(), x86.code.size());
+    jitCodeUsed += (x86.code.size() + 15) & ~size_t(15);
+    if (mprotect(jitCode, JIT_CODE_SIZE, PROT_READ | PROT_EXEC) != 0)
+    {
+        engine = ExecutionEngine::Block; // W^X not possible here, interpret
+        return false;
+    }
+
+    block.native = reinterpret_cast<bool (*)(z80 *)>(entry);
+    ++jitBlocksCompiled;
+    return true;
+#else
+    (void)block;
+    return false;
+#endif
+}
+#endif
+
+// Second execution engine. Instead of looking handlers up in the tables it
+// decodes the opcode structurally with the usual x/y/z/p/q fields:
+//
+//   x = bits 7-6, y = bits 5-3, z = bits 2-0, p = bits 5-4, q = bit 3
+//
+// All handlers live in this translation unit, so the compiler is free to
+// inline them into the switch. Behaviour, including the refresh register and
+// PC bookkeeping, is identical to executeTable(). Base T-states are taken from
+// the decode tables so the two engines always count the same cycles.
+void z80::executeSwitch(uint8_t opCode)
+{
+    switch (opCode)
+    {
+    case 0xCB:
+        IncrementRefreshRegister(2);
+        PC++;
+        opCode = bus->read(PC);
+        addBaseCycles(instructionTableCB[opCode].getCycles(), 2);
+        executeSwitchCB(opCode);
+        PC++;
+        return;
+    case 0xDD:
+    case 0xFD:
+    {
+        bool useIX = opCode == 0xDD;
+        PC++;
+        opCode = bus->read(PC);
+        if (opCode == 0xCB)
+        {
+            IncrementRefreshRegister(2);
+            opCode = bus->read(PC + 2); // the handler fetches d and the opcode itself
+            addBaseCycles(instructionTableDDCB[opCode].getCycles(), 2); // same timings as FDCB
+            useIX ? executeSwitchIndexCB<IX_INDEX>(opCode) : executeSwitchIndexCB<IY_INDEX>(opCode);
+            PC++;
+            return;
+        }
+        if (opCode == 0x64 || opCode == 0x6D || (useIX && opCode == 0x00))
+        {
+            IncrementRefreshRegister(1);
+        }
+        else
+        {
+            IncrementRefreshRegister(2);
+        }
+        // Base T-states go first like everywhere else, the LDIR and LDDR bulk
+        // path relies on tstates being up to date inside the handler
+        const Instruction &instruction = (useIX ? instructionTableDD : instructionTableFD)[opCode];
+        if (instruction.hasOperation())
+        {
+            addBaseCycles(instruction.getCycles(), 2);
+            useIX ? executeSwitchIndex<IX_INDEX>(opCode) : executeSwitchIndex<IY_INDEX>(opCode);
+            PC++;
+        }
+        else
+        {
+            tstates += 4;
+        }
+        return;
+    }
+    case 0xED:
+        IncrementRefreshRegister(2);
+        PC++;
+        opCode = bus->read(PC);
+        if (instructionTableED[opCode].hasOperation())
+        {
+            addBaseCycles(instructionTableED[opCode].getCycles(), 2);
+            executeSwitchED(opCode);
+            PC++;
+        }
+        else
+        {
+            tstates += 4;
+        }
+        return;
+    default:
+        break;
+    }
+
+    IncrementRefreshRegister(1);
+    addBaseCycles(instructionTable[opCode].getCycles(), 1);
+
+    uint8_t x = opCode >> 6;
+    uint8_t y = (opCode >> 3) & 0x07;
+    uint8_t z = opCode & 0x07;
+    uint8_t p = y >> 1;
+    uint8_t q = y & 0x01;
+
+    switch (x)
+    {
+    case 0:
+        switch (z)
+        {
+        case 0:
+            switch (y)
+            {
+            case 0: NOP(opCode); break;
+            case 1: EX_AF_AF1(opCode); break;
+            case 2: DJNZ_E(opCode); break;
+            case 3: JR_E(opCode); break;
+            case 4: JR_NZ_E(opCode); break;
+            case 5: JR_Z_E(opCode); break;
+            case 6: JR_NC_E(opCode); break;
+            default: JR_C_E(opCode); break;
+            }
+            break;
+        case 1:
+            q == 0 ? LD_DD_NN(opCode) : ADD_HL_SS(opCode);
+            break;
+        case 2:
+            switch (y)
+            {
+            case 0: LD_BC_A(opCode); break;
+            case 1: LD_A_BC(opCode); break;
+            case 2: LD_DE_A(opCode); break;
+            case 3: LD_A_DE(opCode); break;
+            case 4: LD_NN_HL(opCode); break;
+            case 5: LD_HL_NN(opCode); break;
+            case 6: LD_NN_A(opCode); break;
+            default: LD_A_NN(opCode); break;
+            }
+            break;
+        case 3:
+            q == 0 ? INC_SS(opCode) : DEC_SS(opCode);
+            break;
+        case 4:
+            y == 6 ? INC_HL(opCode) : INC_R(opCode);
+            break;
+        case 5:
+            y == 6 ? DEC_HL(opCode) : DEC_R(opCode);
+            break;
+        case 6:
+            y == 6 ? LD_HL_N(opCode) : LD_R_N(opCode);
+            break;
+        default:
+            switch (y)
+            {
+            case 0: RLCA(opCode); break;
+            case 1: RRCA(opCode); break;
+            case 2: RLA(opCode); break;
+            case 3: RRA(opCode); break;
+            case 4: DAA(opCode); break;
+            case 5: CPL(opCode); break;
+            case 6: SCF(opCode); break;
+            default: CCF(opCode); break;
+            }
+            break;
+        }
+        break;
+    case 1:
+        if (y == 6 && z == 6)
+        {
+            HALT(opCode);
+        }
+        else if (y == 6)
+        {
+            LD_HL_R(opCode);
+        }
+        else if (z == 6)
+        {
+            LD_R_HL(opCode);
+        }
+        else
+        {
+            LD_R_R(opCode);
+        }
+        break;
+    case 2:
+        if (z == 6)
+        {
+            switch (y)
+            {
+            case 0: ADD_A_HL(opCode); break;
+            case 1: ADC_A_HL(opCode); break;
+            case 2: SUB_A_HL(opCode); break;
+            case 3: SBC_A_HL(opCode); break;
+            case 4: AND_A_HL(opCode); break;
+            case 5: XOR_A_HL(opCode); break;
+            case 6: OR_A_HL(opCode); break;
+            default: CP_HL(opCode); break;
+            }
+        }
+        else
+        {
+            switch (y)
+            {
+            case 0: ADD_A_R(opCode); break;
+            case 1: ADC_A_s(opCode); break;
+            case 2: SUB_A_R(opCode); break;
+            case 3: SBC_A_S(opCode); break;
+            case 4: AND_A_R(opCode); break;
+            case 5: XOR_A_R(opCode); break;
+            case 6: OR_A_R(opCode); break;
+            default: CP_R(opCode); break;
+            }
+        }
+        break;
+    default:
+        switch (z)
+        {
+        case 0:
+            RET_CC(opCode);
+            break;
+        case 1:
+            if (q == 0)
+            {
+                POP_QQ(opCode);
+            }
+            else
+            {
+                switch (p)
+                {
+                case 0: RET(opCode); break;
+                case 1: EXX(opCode); break;
+                case 2: JP_HL(opCode); break;
+                default: LD_SP_HL(opCode); break;
+                }
+            }
+            break;
+        case 2:
+            JP_CC_NN(opCode);
+            break;
+        case 3:
+            switch (y)
+            {
+            case 0: JP_NN(opCode); break;
+            case 2: OUT_N_A(opCode); break;
+            case 3: IN_A_N(opCode); break;
+            case 4: EX_SP_HL(opCode); break;
+            case 5: EX_DE_HL(opCode); break;
+            case 6: DI(opCode); break;
+            default: EI(opCode); break; // y == 1 is the CB prefix, handled above
+            }
+            break;
+        case 4:
+            CALL_CC_NN(opCode);
+            break;
+        case 5:
+            q == 0 ? PUSH_QQ(opCode) : CALL_NN(opCode); // other q == 1 slots are prefixes
+            break;
+        case 6:
+            switch (y)
+            {
+            case 0: ADD_A_N(opCode); break;
+            case 1: ADC_A_N(opCode); break;
+            case 2: SUB_A_N(opCode); break;
+            case 3: SBC_A_N(opCode); break;
+            case 4: AND_A_N(opCode); break;
+            case 5: XOR_A_N(opCode); break;
+            case 6: OR_A_N(opCode); break;
+            default: CP_N(opCode); break;
+            }
+            break;
+        default:
+            RST_P(opCode);
+            break;
+        }
+        break;
+    }
+    PC++;
+}
+
+void z80::executeSwitchCB(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6;
+    uint8_t y = (opCode >> 3) & 0x07;
+    bool memory = (opCode & 0x07) == 6;
+
+    switch (x)
+    {
+    case 0:
+        switch (y)
+        {
+        case 0: memory ? RLC_HL(opCode) : RLC_R(opCode); break;
+        case 1: memory ? RRC_HL(opCode) : RRC_R(opCode); break;
+        case 2: memory ? RL_HL(opCode) : RL_R(opCode); break;
+        case 3: memory ? RR_HL(opCode) : RR_R(opCode); break;
+        case 4: memory ? SLA_HL(opCode) : SLA_R(opCode); break;
+        case 5: memory ? SRA_HL(opCode) : SRA_R(opCode); break;
+        case 6: memory ? SLS_HL(opCode) : SLS_R(opCode); break;
+        default: memory ? SRL_HL(opCode) : SRL_R(opCode); break;
+        }
+        break;
+    case 1:
+        memory ? BIT_B_HL(opCode) : BIT_B_R(opCode);
+        break;
+    case 2:
+        memory ? RES_B_HL(opCode) : RES_B_R(opCode);
+        break;
+    default:
+        memory ? SET_B_HL(opCode) : SET_B_R(opCode);
+        break;
+    }
+}
+
+template <uint8_t Index>
+void z80::executeSwitchIndexCB(uint8_t opCode)
+{
+    uint8_t x = opCode >> 6;
+    uint8_t y = (opCode >> 3) & 0x07;
+
+    switch (x)
+    {
+    case 0:
+        switch (y)
+        {
+        case 0: RLC_XY_D<Index>(opCode); break;
+        case 1: RRC_XY_D<Index>(opCode); break;
+        case 2: RL_XY_D<Index>(opCode); break;
+        case 3: RR_XY_D<Index>(opCode); break;
+        case 4: SLA_XY_D<Index>(opCode); break;
+        case 5: SRA_XY_D<Index>(opCode); break;
+        case 6: SLS_XY_D<Index>(opCode); break;
+        default: SRL_XY_D<Index>(opCode); break;
+        }
+        break;
+    case 1:
+        BIT_B_XY_D<Index>(opCode);
+        break;
+    case 2:
+        RES_B_XY_D<Index>(opCode);
+        break;
+    default:
+        SET_B_XY_D<Index>(opCode);
+        break;
+    }
+}
+
+// The DD and FD pages are irregular, so they switch on the whole opcode.
+// Returns false for opcodes that have no index register form.
+template <uint8_t Index>
+bool z80::executeSwitchIndex(uint8_t opCode)
+{
+    switch (opCode)
+    {
+    case 0x09:
+    case 0x19:
+    case 0x29:
+    case 0x39: ADD_XY_PP<Index>(opCode); break;
+    case 0x21: LD_XY_NN<Index>(opCode); break;
+    case 0x22: LD_NN_XY<Index>(opCode); break;
+    case 0x23: INC_XY<Index>(opCode); break;
+    case 0x24: INC_XYH<Index>(opCode); break;
+    case 0x25: DEC_XYH<Index>(opCode); break;
+    case 0x26: LD_XYH_N<Index>(opCode); break;
+    case 0x2A: LD_XY_NN2<Index>(opCode); break;
+    case 0x2B: DEC_XY<Index>(opCode); break;
+    case 0x2C: INC_XYL<Index>(opCode); break;
+    case 0x2D: DEC_XYL<Index>(opCode); break;
+    case 0x2E: LD_XYL_N<Index>(opCode); break;
+    case 0x34: INC_XY_D<Index>(opCode); break;
+    case 0x35: DEC_XY_D<Index>(opCode); break;
+    case 0x36: LD_XY_D_N<Index>(opCode); break;
+
+    case 0x44:
+    case 0x4C:
+    case 0x54:
+    case 0x5C:
+    case 0x7C: LD_R_XYH<Index>(opCode); break;
+    case 0x45:
+    case 0x4D:
+    case 0x55:
+    case 0x5D:
+    case 0x7D: LD_R_XYL<Index>(opCode); break;
+    case 0x46:
+    case 0x4E:
+    case 0x56:
+    case 0x5E:
+    case 0x66:
+    case 0x6E:
+    case 0x7E: LD_R_XY_D<Index>(opCode); break;
+    case 0x60:
+    case 0x61:
+    case 0x62:
+    case 0x63:
+    case 0x67: LD_XYH_R<Index>(opCode); break;
+    case 0x65: LD_XYH_XYL<Index>(opCode); break;
+    case 0x68:
+    case 0x69:
+    case 0x6A:
+    case 0x6B:
+    case 0x6F: LD_XYL_R<Index>(opCode); break;
+    case 0x6C: LD_XYL_XYH<Index>(opCode); break;
+    case 0x70:
+    case 0x71:
+    case 0x72:
+    case 0x73:
+    case 0x74:
+    case 0x75:
+    case 0x77: LD_XY_D_R<Index>(opCode); break;
+
+    case 0x84: ADD_A_XYH<Index>(opCode); break;
+    case 0x85: ADD_A_XYL<Index>(opCode); break;
+    case 0x86: ADD_A_XY_D<Index>(opCode); break;
+    case 0x8C: ADC_A_XYH<Index>(opCode); break;
+    case 0x8D: ADC_A_XYL<Index>(opCode); break;
+    case 0x8E: ADC_A_XY_D<Index>(opCode); break;
+    case 0x94: SUB_A_XYH<Index>(opCode); break;
+    case 0x95: SUB_A_XYL<Index>(opCode); break;
+    case 0x96: SUB_A_XY_D<Index>(opCode); break;
+    case 0x9C: SBC_A_XYH<Index>(opCode); break;
+    case 0x9D: SBC_A_XYL<Index>(opCode); break;
+    case 0x9E: SBC_A_XY_D<Index>(opCode); break;
+    case 0xA4: AND_A_XYH<Index>(opCode); break;
+    case 0xA5: AND_A_XYL<Index>(opCode); break;
+    case 0xA6: AND_A_XY_D<Index>(opCode); break;
+    case 0xAC: XOR_A_XYH<Index>(opCode); break;
+    case 0xAD: XOR_A_XYL<Index>(opCode); break;
+    case 0xAE: XOR_A_XY_D<Index>(opCode); break;
+    case 0xB4: OR_A_XYH<Index>(opCode); break;
+    case 0xB5: OR_A_XYL<Index>(opCode); break;
+    case 0xB6: OR_A_XY_D<Index>(opCode); break;
+    case 0xBC: CP_XYH<Index>(opCode); break;
+    case 0xBD: CP_XYL<Index>(opCode); break;
+    case 0xBE: CP_XY_D<Index>(opCode); break;
+
+    case 0xE1: POP_XY<Index>(opCode); break;
+    case 0xE3: EX_SP_XY<Index>(opCode); break;
+    case 0xE5: PUSH_XY<Index>(opCode); break;
+    case 0xE9: JP_XY<Index>(opCode); break;
+    case 0xF9: LD_SP_XY<Index>(opCode); break;
+    case 0xFD:
+        if (Index != IX_INDEX)
+        {
+            return false;
+        }
+        NOP(opCode);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+// Returns false for the ED opcodes that are not implemented
+bool z80::executeSwitchED(uint8_t opCode)
+{
+    if ((opCode >> 6) == 1)
+    {
+        uint8_t y = (opCode >> 3) & 0x07;
+        switch (opCode & 0x07)
+        {
+        case 0:
+            IN_R_C(opCode);
+            break;
+        case 1:
+            OUT_C_R(opCode);
+            break;
+        case 2:
+            (y & 1) ? ADC_HL_SS(opCode) : SBC_HL_SS(opCode);
+            break;
+        case 3:
+            (y & 1) ? LD_DD_nn(opCode) : LD_NN_DD(opCode);
+            break;
+        case 4:
+            NEG(opCode);
+            break;
+        case 5:
+            y == 1 ? RETI(opCode) : RETN(opCode);
+            break;
+        case 6:
+            switch (y & 3)
+            {
+            case 2: IM1(opCode); break;
+            case 3: IM2(opCode); break;
+            default: IM0(opCode); break;
+            }
+            break;
+        default:
+            switch (y)
+            {
+            case 0: LD_I_A(opCode); break;
+            case 1: LD_R_A(opCode); break;
+            case 2: LD_A_I(opCode); break;
+            case 3: LD_A_R(opCode); break;
+            case 4: RRD(opCode); break;
+            case 5: RLD(opCode); break;
+            default: return false; // ED 77 and ED 7F
+            }
+            break;
+        }
+        return true;
+    }
+
+    switch (opCode)
+    {
+    case 0xA0: LDI(opCode); break;
+    case 0xA1: CPI(opCode); break;
+    case 0xA2: INI(opCode); break;
+    case 0xA3: OUTI(opCode); break;
+    case 0xA8: LDD(opCode); break;
+    case 0xA9: CPD(opCode); break;
+    case 0xAA: IND(opCode); break;
+    case 0xAB: OUTD(opCode); break;
+    case 0xB0: LDIR(opCode); break;
+    case 0xB1: CPIR(opCode); break;
+    case 0xB2: INIR(opCode); break;
+    case 0xB3: OTIR(opCode); break;
+    case 0xB8: LDDR(opCode); break;
+    case 0xB9: CPDR(opCode); break;
+    case 0xBA: INDR(opCode); break;
+    case 0xBB: OTDR(opCode); break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+/*****************************************|
+ *                                        |
  *         8-Bit Load Group               |
  *                                        |
  *****************************************/
@@ -1847,6 +4273,12 @@ void z80::LD_R_R(uint8_t opCode)
     writeToRegister(destRegIndex, srcRegValue);
 }
 
+template <uint8_t Destination, uint8_t Source>
+void z80::LD_R_R(uint8_t opCode)
+{
+    regs8[writeRegisterOffset[Destination]] = regs8[readRegisterOffset[Source]];
+}
+
 void z80::LD_HL_R(uint8_t opCode)
 {
     uint8_t targetRegister = opCode & 0b00000111;
@@ -1869,64 +4301,33 @@ void z80::LD_R_HL(uint8_t opCode)
     writeToRegister(destinationRegister, value);
 }
 
-void z80::LD_R_IX_D(uint8_t opCode)
-{
-    uint8_t destinationRegister = (opCode & 0b00111000) >> 3;
-    int8_t displacement = fetchImmediate();       // Signed displacement
-    uint8_t value = bus->read(IX + displacement); // FIND A BETTER IMPLEMENTATION FOR IX; HL SO On
-    writeToRegister(destinationRegister, value);
-    MPTR = IX +displacement;
-}
-
-void z80::LD_R_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_R_XY_D(uint8_t opCode)
 {
     uint8_t destinationRegister = (opCode & 0b00111000) >> 3;
-    int8_t displacement = fetchImmediate(); // Signed displacement
-    uint8_t value = bus->read(IY + displacement);
+    uint8_t value = bus->read(indexedAddress<Index>());
     writeToRegister(destinationRegister, value);
-    MPTR = IY +displacement;
 }
 
-void z80::LD_IX_D_R(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XY_D_R(uint8_t opCode)
 {
-    uint8_t targetRegister = opCode & 0b00000111;
-    uint8_t value = readFromRegister(targetRegister);
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d; // FIND A BETTER IMPLEMENTATION FOR IX; HL SO On
-    bus->write(address, value);
-    MPTR = address;
+    uint8_t value = readFromRegister(opCode & 0b00000111);
+    bus->write(indexedAddress<Index>(), value);
 }
 
-void z80::LD_IY_D_R(uint8_t opCode)
-{
-    uint8_t targetRegister = opCode & 0b00000111;
-    uint8_t value = readFromRegister(targetRegister);
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    bus->write(address, value);
-    MPTR = address;
-}
 void z80::LD_HL_N(uint8_t opCode)
 {
     uint8_t value = fetchImmediate();
     bus->write(getHL(), value);
 }
 
-void z80::LD_IX_D_N(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t value = fetchImmediate();
-    uint16_t address = IX + d; // FIND A BETTER IMPLEMENTATION FOR IX; HL SO On
-    bus->write(address, value);
-    MPTR = address;
-}
-void z80::LD_IY_D_N(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XY_D_N(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
+    uint16_t address = indexedAddress<Index>();
     uint8_t value = fetchImmediate();
-    uint16_t address = IY + d; // FIND A BETTER IMPLEMENTATION FOR IX; HL SO On
     bus->write(address, value);
-    MPTR = address;
 }
 
 void z80::LD_A_BC(uint8_t opCode)
@@ -1992,6 +4393,7 @@ void z80::LD_A_I(uint8_t opCode)
 
 void z80::LD_A_R(uint8_t opCode)
 {
+    ++refreshReads;
     A = R;
     int8_t signedR = (int8_t)R;
     signedR < 0 ? setFlag(S) : clearFlag(S);
@@ -2014,139 +4416,55 @@ void z80::LD_R_A(uint8_t opCode)
 {
     R = A;
 }
-
-/*****************************************|
- *                                        |
- *         16-Bit Load Group              |
- *                                        |
- *****************************************/
-
-void z80::writeToRegisterPair(uint8_t reg, uint16_t value)
-{
-
-    switch (reg)
-    {
-    case 0:
-        B = (value & 0xFF00) >> 8;
-        C = (value & 0x00FF);
-        break;
-    case 1:
-        D = (value & 0xFF00) >> 8;
-        E = (value & 0x00FF);
-        break;
-    case 2:
-        H = (value & 0xFF00) >> 8;
-        L = (value & 0x00FF);
-        break;
-    case 3:
-        SP = value;
-        break;
-    default:
-        break;
-    }
-}
+
+/*****************************************|
+ *                                        |
+ *         16-Bit Load Group              |
+ *                                        |
+ *****************************************/
+
+void z80::writeToRegisterPair(uint8_t reg, uint16_t value)
+{
+    regs16[registerPairIndex[reg & 0x03]] = value;
+}
 void z80::setAF(uint16_t value)
 {
-    A = (value & 0xFF00) >> 8;
-    F = (value & 0x00FF);
+#ifdef Z80_LAZY_FLAGS
+    lazyOp = FlagOp::None;
+#endif
+    AF = value;
 }
 void z80::setBC(uint16_t value)
 {
-    B = (value & 0xFF00) >> 8;
-    C = (value & 0x00FF);
+    BC = value;
 }
 void z80::setDE(uint16_t value)
 {
-    D = (value & 0xFF00) >> 8;
-    E = (value & 0x00FF);
+    DE = value;
 }
 void z80::setHL(uint16_t value)
 {
-    H = (value & 0xFF00) >> 8;
-    L = (value & 0x00FF);
+    HL = value;
 }
 void z80::setAF1(uint16_t value)
 {
-    A1 = (value & 0xFF00) >> 8;
-    F1 = (value & 0x00FF);
+    AF1 = value;
 }
 void z80::setBC1(uint16_t value)
 {
-    B1 = (value & 0xFF00) >> 8;
-    C1 = (value & 0x00FF);
+    BC1 = value;
 }
 void z80::setDE1(uint16_t value)
 {
-    D1 = (value & 0xFF00) >> 8;
-    E1 = (value & 0x00FF);
+    DE1 = value;
 }
 void z80::setHL1(uint16_t value)
 {
-    H1 = (value & 0xFF00) >> 8;
-    L1 = (value & 0x00FF);
+    HL1 = value;
 }
 uint16_t z80::readFromRegisterPair(uint8_t reg)
 {
-
-    switch (reg)
-    {
-    case 0:
-        return getBC();
-        break;
-    case 1:
-        return getDE();
-        break;
-    case 2:
-        return getHL();
-        break;
-    case 3:
-        return SP;
-        break;
-    default:
-        return 0;
-    }
-}
-uint16_t z80::readFromRegisterPair2(uint8_t reg)
-{
-
-    switch (reg)
-    {
-    case 0:
-        return getBC();
-        break;
-    case 1:
-        return getDE();
-        break;
-    case 2:
-        return IX;
-        break;
-    case 3:
-        return SP;
-        break;
-    default:
-        return 0;
-    }
-}
-uint16_t z80::readFromRegisterPair3(uint8_t reg)
-{
-
-    switch (reg)
-    {
-    case 0:
-        return getBC();
-        break;
-    case 1:
-        return getDE();
-        break;
-    case 2:
-        return IY;
-        break;
-    case 3:
-        return SP;
-        break;
-    default:
-        return 0;
-    }
+    return regs16[registerPairIndex[reg & 0x03]];
 }
 
 void z80::LD_DD_NN(uint8_t opCode)
@@ -2159,141 +4477,59 @@ void z80::LD_DD_NN(uint8_t opCode)
 
     writeToRegisterPair(destination, value);
 }
-void z80::LD_IX_NN(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XY_NN(uint8_t opCode)
 {
     uint8_t loByte = fetchImmediate();
     uint8_t hiByte = fetchImmediate();
-    uint16_t value = (hiByte << 8) | loByte;
-    IX = value;
-}
-
-void z80::LD_IXl_N(uint8_t opCode)
-{
-    uint8_t n = fetchImmediate();
-    uint8_t hiByte = (IX >> 8);
-
-    uint16_t value = ((hiByte << 8) + n);
-    IX = value;
-}
-void z80::LD_IXH_N(uint8_t opCode)
-{
-    uint8_t n = fetchImmediate();
-    uint8_t loByte = (IX & 0x00FF);
-
-    uint16_t value = (n << 8) | loByte;
-    IX = value;
-}
-void z80::LD_IY_L_N(uint8_t opCode)
-{
-    uint8_t n = fetchImmediate();
-    uint8_t hiByte = (IY >> 8);
-
-    uint16_t value = ((hiByte << 8) + n);
-    IY = value;
-}
-void z80::LD_IY_H_N(uint8_t opCode)
-{
-    uint8_t n = fetchImmediate();
-    uint8_t loByte = (IY & 0x00FF);
-
-    uint16_t value = (n << 8) | loByte;
-    IY = value;
-}
-void z80::LD_IXH_IXL(uint8_t opCode)
-{
-    uint8_t loByte = (IX & 0x00FF);
-    IX = ((loByte << 8) + loByte);
-}
-void z80::LD_IYH_IYL(uint8_t opCode)
-{
-    uint8_t loByte = (IY & 0x00FF);
-    IY = ((loByte << 8) + loByte);
-}
-void z80::LD_IYL_IYH(uint8_t opCode)
-{
-    uint8_t hiByte = (IY >> 8);
-    IY = (hiByte << 8) + hiByte;
+    regs16[Index] = (hiByte << 8) | loByte;
 }
 
-void z80::LD_IXL_IXH(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYL_N(uint8_t opCode)
 {
-    uint8_t hiByte = (IX >> 8);
-    IX = (hiByte << 8) + hiByte;
+    regs8[2 * Index] = fetchImmediate();
 }
-
-void z80::LD_IXH_R(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYH_N(uint8_t opCode)
 {
-    uint8_t src = opCode & 0b00000111;
-    uint8_t n = readFromRegister(src);
-    uint8_t loByte = (IX & 0x00FF);
-
-    IX = ((n << 8) + loByte);
+    regs8[2 * Index + 1] = fetchImmediate();
 }
-
-void z80::LD_IXl_R(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYH_XYL(uint8_t opCode)
 {
-    uint8_t src = opCode & 0b00000111;
-    uint8_t n = readFromRegister(src);
-    uint8_t hiByte = (IX >> 8);
-
-    IX = ((hiByte << 8) + n);
+    regs8[2 * Index + 1] = regs8[2 * Index];
 }
-
-void z80::LD_IY_H_R(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYL_XYH(uint8_t opCode)
 {
-    uint8_t src = opCode & 0b00000111;
-    uint8_t n = readFromRegister(src);
-    uint8_t loByte = (IY & 0x00FF);
-
-    IY = ((n << 8) + loByte);
+    regs8[2 * Index] = regs8[2 * Index + 1];
 }
 
-void z80::LD_IY_L_R(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYH_R(uint8_t opCode)
 {
-    uint8_t src = opCode & 0b00000111;
-    uint8_t n = readFromRegister(src);
-    uint8_t hiByte = (IY >> 8);
-
-    IY = ((hiByte << 8) + n);
+    regs8[2 * Index + 1] = readFromRegister(opCode & 0b00000111);
 }
 
-void z80::LD_R_IXH(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XYL_R(uint8_t opCode)
 {
-    uint8_t dest = (opCode & 0b00111000) >> 3;
-    uint8_t hiByte = (IX >> 8);
-
-    writeToRegister(dest, hiByte);
+    regs8[2 * Index] = readFromRegister(opCode & 0b00000111);
 }
-void z80::LD_R_IXl(uint8_t opCode)
-{
-    uint8_t dest = (opCode & 0b00111000) >> 3;
-    uint8_t loByte = (IX & 0x00FF);
 
-    writeToRegister(dest, loByte);
-}
 
-void z80::LD_R_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_R_XYH(uint8_t opCode)
 {
-    uint8_t dest = (opCode & 0b00111000) >> 3;
-    uint8_t hiByte = (IY >> 8);
-
-    writeToRegister(dest, hiByte);
+    writeToRegister((opCode & 0b00111000) >> 3, regs8[2 * Index + 1]);
 }
-void z80::LD_R_IY_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_R_XYL(uint8_t opCode)
 {
-    uint8_t dest = (opCode & 0b00111000) >> 3;
-    uint8_t loByte = (IY & 0x00FF);
-
-    writeToRegister(dest, loByte);
+    writeToRegister((opCode & 0b00111000) >> 3, regs8[2 * Index]);
 }
 
-void z80::LD_IY_NN(uint8_t opCode)
-{
-    uint8_t loByte = fetchImmediate();
-    uint8_t hiByte = fetchImmediate();
-    uint16_t value = (hiByte << 8) | loByte;
-    IY = value;
-}
 // load HL (nn)
 void z80::LD_HL_NN(uint8_t opCode)
 {
@@ -2339,34 +4575,16 @@ void z80::LD_DD_nn(uint8_t opCode)
         break;
     }
 }
-void z80::LD_IX_NN2(uint8_t opCode)
-{
-    uint8_t loByte = fetchImmediate();
-    uint8_t hiByte = fetchImmediate();
-    uint16_t value = (hiByte << 8) | loByte;
-
-    uint16_t address = (hiByte << 8) | loByte;
-    uint16_t address2 = address + 1;
-    uint8_t value1 = bus->read(address);
-    uint8_t value2 = bus->read(address2);
-
-    IX = uint16_t(value2 << 8) | value1;
-
-    MPTR = (hiByte << 8) + loByte + 1;
-}
-void z80::LD_IY_NN2(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_XY_NN2(uint8_t opCode)
 {
     uint8_t loByte = fetchImmediate();
     uint8_t hiByte = fetchImmediate();
-    uint16_t value = (hiByte << 8) | loByte;
-
     uint16_t address = (hiByte << 8) | loByte;
-    uint16_t address2 = address + 1;
     uint8_t value1 = bus->read(address);
-    uint8_t value2 = bus->read(address2);
-    IY = uint16_t(value2 << 8) | value1;
-
-    MPTR = (hiByte << 8) + loByte + 1;
+    uint8_t value2 = bus->read(address + 1);
+    regs16[Index] = uint16_t(value2 << 8) | value1;
+    MPTR = address + 1;
 }
 void z80::LD_NN_HL(uint8_t opCode)
 {
@@ -2414,24 +4632,15 @@ void z80::LD_NN_DD(uint8_t opCode)
         break;
     }
 }
-void z80::LD_NN_IX(uint8_t opCode)
-{
-    uint8_t loByte = fetchImmediate();
-    uint8_t hiByte = fetchImmediate();
-    uint16_t address = (hiByte << 8) | loByte;
-    bus->write(address, IX & 0xFF);
-    bus->write(address + 1, (IX >> 8) & 0xFF);
-    MPTR = (hiByte << 8) + loByte + 1;
-
-}
-void z80::LD_NN_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_NN_XY(uint8_t opCode)
 {
     uint8_t loByte = fetchImmediate();
     uint8_t hiByte = fetchImmediate();
     uint16_t address = (hiByte << 8) | loByte;
-    bus->write(address, IY & 0xFF);
-    bus->write(address + 1, (IY >> 8) & 0xFF);
-     MPTR = (hiByte << 8) + loByte + 1;
+    bus->write(address, regs8[2 * Index]);
+    bus->write(address + 1, regs8[2 * Index + 1]);
+    MPTR = address + 1;
 }
 void z80::LD_SP_HL(uint8_t opCode)
 {
@@ -2440,13 +4649,10 @@ void z80::LD_SP_HL(uint8_t opCode)
     uint16_t value = (hiByte << 8) | loByte;
     SP = value;
 }
-void z80::LD_SP_IX(uint8_t opCode)
-{
-    SP = IX;
-}
-void z80::LD_SP_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::LD_SP_XY(uint8_t opCode)
 {
-    SP = IY;
+    SP = regs16[Index];
 }
 void z80::PUSH_QQ(uint8_t opCode)
 {
@@ -2475,30 +4681,20 @@ void z80::PUSH_QQ(uint8_t opCode)
         SP--;
         bus->write(SP, A);
         SP--;
-        bus->write(SP, F);
+        bus->write(SP, getF());
 
         break;
     default:
         break;
     }
 }
-void z80::PUSH_IX(uint8_t opCode)
-{
-    uint8_t hi = (IX >> 8) & 0xFF;
-    uint8_t lo = IX & 0xFF;
-    SP--;
-    bus->write(SP, hi);
-    SP--;
-    bus->write(SP, lo);
-}
-void z80::PUSH_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::PUSH_XY(uint8_t opCode)
 {
-    uint8_t hi = (IY >> 8) & 0xFF;
-    uint8_t lo = IY & 0xFF;
     SP--;
-    bus->write(SP, hi);
+    bus->write(SP, regs8[2 * Index + 1]);
     SP--;
-    bus->write(SP, lo);
+    bus->write(SP, regs8[2 * Index]);
 }
 void z80::POP_QQ(uint8_t opCode)
 {
@@ -2524,7 +4720,7 @@ void z80::POP_QQ(uint8_t opCode)
         SP++;
         break;
     case 3:
-        F = bus->read(SP);
+        setF(bus->read(SP));
         SP++;
         A = bus->read(SP);
         SP++;
@@ -2533,23 +4729,14 @@ void z80::POP_QQ(uint8_t opCode)
         break;
     }
 }
-void z80::POP_IX(uint8_t opCode)
-{
-    uint8_t lo = bus->read(SP);
-    SP++;
-    uint8_t hi = bus->read(SP);
-    SP++;
-    uint16_t value = (hi << 8) | lo;
-    IX = value;
-}
-void z80::POP_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::POP_XY(uint8_t opCode)
 {
     uint8_t lo = bus->read(SP);
     SP++;
     uint8_t hi = bus->read(SP);
     SP++;
-    uint16_t value = (hi << 8) | lo;
-    IY = value;
+    regs16[Index] = (hi << 8) | lo;
 }
 
 /*****************************************|
@@ -2561,95 +4748,48 @@ void z80::POP_IY(uint8_t opCode)
 
 void z80::EX_DE_HL(uint8_t opCode)
 {
-    uint16_t DE = getDE();
-    uint16_t HL = getHL();
-
-    H = (DE >> 8) & 0xFF;
-    L = DE & 0xFF;
-
-    D = (HL >> 8) & 0xFF;
-    E = HL & 0xFF;
+    std::swap(DE, HL);
 }
 void z80::EX_AF_AF1(uint8_t opCode)
 {
-    uint16_t AF = getAF();
-    uint16_t AF1 = getAF1();
-
-    A = ((AF1 & 0xFF00) >> 8);
-    F = (AF1 & 0x00FF);
-
-    A1 = ((AF & 0xFF00) >> 8);
-    F1 = (AF & 0x00FF);
+    resolveFlags();
+    std::swap(AF, AF1);
 }
 
 void z80::EXX(uint8_t opCode)
 {
-    uint16_t temp = getBC();
-
-    B = ((getBC1() & 0xFF00) >> 8);
-    C = (getBC1() & 0x00FF);
-
-    B1 = ((temp & 0xFF00) >> 8);
-    C1 = (temp & 0x00FF);
-
-    temp = getDE();
-
-    D = ((getDE1() & 0xFF00) >> 8);
-    E = (getDE1() & 0x00FF);
-
-    D1 = ((temp & 0xFF00) >> 8);
-    E1 = (temp & 0x00FF);
-
-    temp = getHL();
-
-    H = ((getHL1() & 0xFF00) >> 8);
-    L = (getHL1() & 0x00FF);
-
-    H1 = ((temp & 0xFF00) >> 8);
-    L1 = (temp & 0x00FF);
+    std::swap(BC, BC1);
+    std::swap(DE, DE1);
+    std::swap(HL, HL1);
 }
 
 void z80::EX_SP_HL(uint8_t opCode)
 {
-    uint8_t hi = (getHL() >> 8) & 0xFF;
-    uint8_t lo = getHL() & 0xFF;
+    uint8_t hi = H;
+    uint8_t lo = L;
 
     L = bus->read(SP);
     H = bus->read(SP + 1);
 
     bus->write(SP, lo);
     bus->write(SP + 1, hi);
-    MPTR = getHL();
+    MPTR = HL;
 }
 
-void z80::EX_SP_IX(uint8_t opCode)
-{
-    uint8_t hi = (IX >> 8) & 0xFF;
-    uint8_t lo = IX & 0xFF;
-
-    uint8_t hiByte = bus->read(SP + 1);
-    uint8_t loByte = bus->read(SP);
-
-    IX = (hiByte << 8) | loByte;
-
-    bus->write(SP, lo);
-    bus->write(SP + 1, hi);
-    MPTR = IX;
-}
-void z80::EX_SP_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::EX_SP_XY(uint8_t opCode)
 {
-    uint8_t hi = (IY >> 8) & 0xFF;
-    uint8_t lo = IY & 0xFF;
+    uint8_t hi = regs8[2 * Index + 1];
+    uint8_t lo = regs8[2 * Index];
 
     uint8_t hiByte = bus->read(SP + 1);
     uint8_t loByte = bus->read(SP);
 
-    IY = (hiByte << 8) | loByte;
+    regs16[Index] = (hiByte << 8) | loByte;
 
     bus->write(SP, lo);
     bus->write(SP + 1, hi);
-
-    MPTR = IY;
+    MPTR = regs16[Index];
 }
 
 void z80::LDI(uint8_t opCode)
@@ -2662,27 +4802,10 @@ void z80::LDI(uint8_t opCode)
 
     uint8_t temp1 = (data + A);
 
-    uint16_t temp;
-
-    temp = getHL();
-    temp++;
-    writeToRegisterPair(2, temp);
-
-    uint16_t DE_ = getDE();
-    DE_++;
-    uint8_t hi2 = (DE_ >> 8) & 0xFF;
-    uint8_t lo2 = DE_ & 0xFF;
-
-    D = hi2;
-    E = lo2;
-
-    uint16_t BC_ = getBC();
-    BC_--;
-    uint8_t hi = (BC_ >> 8) & 0xFF;
-    uint8_t lo = BC_ & 0xFF;
+    HL++;
+    DE++;
+    BC--;
 
-    B = hi;
-    C = lo;
 
     clearFlag(H_flag);
     getBC() != 0 ? setFlag(P) : clearFlag(P);
@@ -2704,29 +4827,11 @@ void z80::LDIR(uint8_t opCode)
 
     uint8_t temp = data + A;
 
-    uint16_t HL_ = getHL();
-    HL_++;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
+    HL++;
+    DE++;
 
-    uint16_t DE_ = getDE();
-    DE_++;
-    uint8_t hi2 = (DE_ >> 8) & 0xFF;
-    uint8_t lo2 = DE_ & 0xFF;
 
-    D = hi2;
-    E = lo2;
-
-    uint16_t BC_ = getBC();
-    BC_--;
-    uint8_t hi = (BC_ >> 8) & 0xFF;
-    uint8_t lo = BC_ & 0xFF;
-
-    B = hi;
-    C = lo;
+    BC--;
 
     clearFlag(H_flag);
     getBC() != 0 ? setFlag(P) : clearFlag(P);
@@ -2738,10 +4843,12 @@ void z80::LDIR(uint8_t opCode)
 
     if (getBC() != 0)
     {
+        tstates += 5;
         PC--;
         PC--;
 
         MPTR = PC + 2;
+        repeatBlockCopy(1);
     }
 }
 void z80::LDD(uint8_t opCode)
@@ -2753,31 +4860,13 @@ void z80::LDD(uint8_t opCode)
     bus->write(destAddress, data);
 
     uint8_t temp = (data + A);
-    uint16_t HL = getHL();
     HL--;
-    uint8_t hi1 = (HL >> 8) & 0xFF;
-    uint8_t lo1 = HL & 0xFF;
-
-    H = hi1;
-    L = lo1;
-
-    uint16_t DE = getDE();
     DE--;
-    uint8_t hi2 = (DE >> 8) & 0xFF;
-    uint8_t lo2 = DE & 0xFF;
 
-    D = hi2;
-    E = lo2;
 
-    uint16_t BC = getBC();
     BC--;
-    uint8_t hi = (BC >> 8) & 0xFF;
-    uint8_t lo = BC & 0xFF;
-
-    B = hi;
-    C = lo;
 
-    clearFlag(H);
+    clearFlag(H_flag);
     getBC() != 0 ? setFlag(P) : clearFlag(P);
     clearFlag(N);
 
@@ -2798,29 +4887,11 @@ void z80::LDDR(uint8_t opCode)
 
     uint8_t temp = (data + A);
 
-    uint16_t HL = getHL();
     HL--;
-    uint8_t hi1 = (HL >> 8) & 0xFF;
-    uint8_t lo1 = HL & 0xFF;
-
-    H = hi1;
-    L = lo1;
-
-    uint16_t DE = getDE();
     DE--;
-    uint8_t hi2 = (DE >> 8) & 0xFF;
-    uint8_t lo2 = DE & 0xFF;
 
-    D = hi2;
-    E = lo2;
 
-    uint16_t BC = getBC();
     BC--;
-    uint8_t hi = (BC >> 8) & 0xFF;
-    uint8_t lo = BC & 0xFF;
-
-    B = hi;
-    C = lo;
 
     clearFlag(H_flag);
     getBC() != 0 ? setFlag(P) : clearFlag(P);
@@ -2831,11 +4902,69 @@ void z80::LDDR(uint8_t opCode)
 
     if (getBC() != 0)
     {
+        tstates += 5;
         PC--;
         PC--;
         MPTR = PC + 2;
+        repeatBlockCopy(-1);
+    }
+}
+
+// Bulk path of LDIR and LDDR, called after an iteration that repeats. Runs the
+// following iterations in one go, as many as the runFor() call in progress
+// would still start before its deadline, with one memory copy. Each iteration
+// costs 21 T-states and two refreshes, except the one that brings BC to 0,
+// which costs 16 and moves PC on to the next instruction. F, like MEMPTR,
+// ends up as the last iteration leaves it. A copy that writes over the
+// instruction itself stops after that write, so the new bytes are fetched.
+void z80::repeatBlockCopy(int step)
+{
+    if (tstates >= runDeadline)
+        return;
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(BC, (runDeadline - tstates + 20) / 21));
+    count = std::min(count, iterationsBeforeSelfWrite(DE, step));
+    if (count == 0)
+        return;
+
+    bus->startAccesses(tstates + 8); // After the two opcode fetches
+    bus->copyMemory(HL, DE, count, step);
+    HL += step * static_cast<int>(count);
+    DE += step * static_cast<int>(count);
+    BC -= count;
+    IncrementRefreshRegister(2 * count);
+    tstates += 21 * count;
+    if (BC == 0)
+    {
+        tstates -= 5;
+        PC += 2;
+    }
+
+    uint8_t temp = bus->read(DE - step) + A;
+    clearFlag(H_flag);
+    BC != 0 ? setFlag(P) : clearFlag(P);
+    clearFlag(N);
+    ((temp & 0x02) > 0) ? setFlag(U) : clearFlag(U);
+    ((temp & 0x08) > 0) ? setFlag(X) : clearFlag(X);
+}
+
+// How many more iterations of a repeating block instruction, writing to
+// destination and one step further each time, the bulk paths may run: up to
+// and including the one that writes over the instruction's own bytes. 0 when
+// the iteration just run did, so the new bytes must be fetched next.
+uint32_t z80::iterationsBeforeSelfWrite(uint16_t destination, int step)
+{
+    uint32_t count = UINT32_MAX;
+    // PC is one before the ED prefix here
+    for (uint16_t opcodeByte : {uint16_t(PC + 1), uint16_t(PC + 2)})
+    {
+        // The iteration that writes it is the reachedAfter-th from now, the
+        // 65536th wrapping to 0 being the one just run
+        uint32_t reachedAfter = static_cast<uint16_t>((opcodeByte - destination + step) * step);
+        count = std::min(count, reachedAfter);
     }
+    return count;
 }
+
 void z80::CPI(uint8_t opCode)
 {
 
@@ -2847,21 +4976,9 @@ void z80::CPI(uint8_t opCode)
 
     uint8_t c = isFlagSet(C_flag);
 
-    uint16_t HL_ = getHL();
-    HL_++;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
-
-    uint16_t BC_ = getBC();
-    BC_--;
-    uint8_t hi = (BC_ >> 8) & 0xFF;
-    uint8_t lo = BC_ & 0xFF;
+    HL++;
+    BC--;
 
-    B = hi;
-    C = lo;
 
     CP_Flags(A, value);
 
@@ -2890,21 +5007,9 @@ void z80::CPIR(uint8_t opCode)
 
     int8_t temp = (A - value);
 
-    uint16_t HL_ = getHL();
-    HL_++;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
-
-    uint16_t BC_ = getBC();
-    BC_--;
-    uint8_t hi = (BC_ >> 8) & 0xFF;
-    uint8_t lo = BC_ & 0xFF;
+    HL++;
+    BC--;
 
-    B = hi;
-    C = lo;
 
     uint8_t c = isFlagSet(C_flag) ? 1 : 0;
 
@@ -2923,9 +5028,11 @@ void z80::CPIR(uint8_t opCode)
 
     if (getBC() != 0 && result != 0)
     {
+        tstates += 5;
         PC--;
         PC--;
         MPTR = PC + 2;
+        repeatBlockSearch(1);
     }
     else
     {
@@ -2941,21 +5048,9 @@ void z80::CPD(uint8_t opCode)
 
     int8_t temp = (A - value);
 
-    uint16_t HL_ = getHL();
-    HL_--;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
-
-    uint16_t BC_ = getBC();
-    BC_--;
-    uint8_t hi = (BC_ >> 8) & 0xFF;
-    uint8_t lo = BC_ & 0xFF;
+    HL--;
+    BC--;
 
-    B = hi;
-    C = lo;
 
     uint8_t c = isFlagSet(C_flag) ? 1 : 0;
 
@@ -2985,21 +5080,10 @@ void z80::CPDR(uint8_t opCode)
 
     uint8_t value = bus->read(address);
 
-    uint16_t HL = getHL();
     HL--;
-    uint8_t hi1 = (HL >> 8) & 0xFF;
-    uint8_t lo1 = HL & 0xFF;
-
-    uint16_t BC = getBC();
     BC--;
-    uint8_t hi = (BC >> 8) & 0xFF;
-    uint8_t lo = BC & 0xFF;
 
-    B = hi;
-    C = lo;
 
-    H = hi1;
-    L = lo1;
 
     uint8_t c = isFlagSet(C_flag) ? 1 : 0;
 
@@ -3018,15 +5102,40 @@ void z80::CPDR(uint8_t opCode)
 
     if (getBC() != 0 && result != 0)
     {
+        tstates += 5;
         PC--;
         PC--;
         MPTR = PC +2;
+        repeatBlockSearch(-1);
     }
     else{
         MPTR--;
     }
 }
 
+// Bulk path of CPIR and CPDR, called after an iteration that repeats. One
+// memory scan finds how many of the following iterations would repeat again
+// and start before the runFor() deadline, and those are skipped at 21 T-states
+// and two refreshes each. PC stays on the instruction, so the iteration after
+// them runs normally and leaves HL, BC, F and MEMPTR as stepping would.
+void z80::repeatBlockSearch(int step)
+{
+    if (tstates >= runDeadline)
+        return;
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(BC, (runDeadline - tstates + 20) / 21));
+
+    // An iteration stops the repeat when A - (HL) - H is 0: on a match, or on
+    // the byte one below A when that borrows from A's low nibble
+    uint8_t below = (A & 0x0F) == 0 ? static_cast<uint8_t>(A - 1) : A;
+    bus->startAccesses(tstates + 8);
+    uint32_t skipped = bus->findMemory(HL, count - 1, step, A, below);
+
+    HL += step * static_cast<int>(skipped);
+    BC -= skipped;
+    IncrementRefreshRegister(2 * skipped);
+    tstates += 21 * skipped;
+}
+
 /*****************************************|
  *                                        |
  *         8-Bit-Arithmetic Group         |
@@ -3034,125 +5143,58 @@ void z80::CPDR(uint8_t opCode)
  ========================================*/
 uint8_t z80::Add8_Bit(uint8_t a, uint8_t b)
 {
-    uint16_t fullSum = a + b;
-    uint8_t sum = fullSum & 0xFF;
-
-    clearFlag(N);
-
-    sum == 0 ? setFlag(Z) : clearFlag(Z);
-
-    (sum & 0x80) ? setFlag(S) : clearFlag(S);
-
-    ((a & 0x0F) + (b & 0x0F) > 0x0F) ? setFlag(H_flag) : clearFlag(H_flag);
-
-    (fullSum > 0xFF) ? setFlag(C_flag) : clearFlag(C_flag);
-
-    (((a ^ b) & 0x80) == 0 && ((a ^ sum) & 0x80) != 0) ? setFlag(P) : clearFlag(P);
-
-    ((sum & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((sum & 0x20) > 0) ? setFlag(U) : clearFlag(U);
-
+    uint8_t sum = a + b;
+    updateFlags(FlagOp::Add, a, b, sum);
     return sum;
 }
 uint8_t z80::Sub8_Bit(uint8_t a, uint8_t b)
 {
-    uint16_t fullSum = a - b;      // Adding the two 8-bit values as 16-bit.
-    uint8_t diff = fullSum & 0xFF; // Keep the lower 8 bits
-
-    setFlag(N); // Set the N flag for subtraction
-
-    // Z flag: Set if the result is 0, otherwise reset.
-    diff == 0 ? setFlag(Z) : clearFlag(Z);
-
-    // S flag: Set if the result is negative (MSB is 1), otherwise reset.
-    (diff & 0x80) > 0 ? setFlag(S) : clearFlag(S);
-
-    // H flag: Set if there was a borrow from bit 4 (half-carry), otherwise reset.
-    ((a & 0x0F) - (b & 0x0F) < 0x00) ? setFlag(H_flag) : clearFlag(H_flag);
-
-    // C flag: Set if there is a borrow
-    (a < b) ? setFlag(C_flag) : clearFlag(C_flag);
-
-    // P flag: Set if there is an overflow (signed overflow), otherwise reset.
-    (((a ^ b) & 0x80) != 0 && ((b ^ diff) & 0x80) == 0) ? setFlag(P) : clearFlag(P);
-
-    ((diff & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((diff & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    uint8_t diff = a - b;
+    updateFlags(FlagOp::Sub, a, b, diff);
+    return diff;
+}
 
-    return diff; // Return the 8-bit result of the subtraction.
+// ADD and SUB with the carry flag as carry/borrow in
+uint8_t z80::Adc8_Bit(uint8_t a, uint8_t b)
+{
+    uint8_t sum = a + b + (isFlagSet(C_flag) ? 1 : 0);
+    updateFlags(FlagOp::Adc, a, b, sum);
+    return sum;
+}
+uint8_t z80::Sbc8_Bit(uint8_t a, uint8_t b)
+{
+    uint8_t diff = a - b - (isFlagSet(C_flag) ? 1 : 0);
+    updateFlags(FlagOp::Sbc, a, b, diff);
+    return diff;
 }
 uint8_t z80::And8_Bit(uint8_t a, uint8_t b)
 {
-
     uint8_t result = a & b;
-
-    clearFlag(N);
-    clearFlag(C_flag);
-    setFlag(H_flag);
-    result == 0x00 ? setFlag(Z) : clearFlag(Z);
-    (result & 0x80) > 0 ? setFlag(S) : clearFlag(S);
-    isEvenParity(result) ? setFlag(P) : clearFlag(P);
-    ((result & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((result & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    updateFlags(FlagOp::And, a, b, result);
     return result;
 }
 uint8_t z80::Or8_Bit(uint8_t a, uint8_t b)
 {
-
     uint8_t result = a | b;
-
-    clearFlag(N);
-    clearFlag(C_flag);
-    clearFlag(H_flag);
-    result == 0x00 ? setFlag(Z) : clearFlag(Z);
-    (result & 0x80) > 0 ? setFlag(S) : clearFlag(S);
-    isEvenParity(result) ? setFlag(P) : clearFlag(P);
-
-    ((result & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((result & 0x20) > 0) ? setFlag(U) : clearFlag(U);
-
+    updateFlags(FlagOp::Or, a, b, result);
     return result;
 }
 uint8_t z80::Xor8_Bit(uint8_t a, uint8_t b)
-{
-
-    uint8_t result = a ^ b;
-
-    clearFlag(N);
-    clearFlag(C_flag);
-    clearFlag(H_flag);
-    result == 0x00 ? setFlag(Z) : clearFlag(Z);
-    (result & 0x80) > 0 ? setFlag(S) : clearFlag(S);
-    isEvenParity(result) ? setFlag(P) : clearFlag(P);
-
-    ((result & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((result & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+{
+    uint8_t result = a ^ b;
+    updateFlags(FlagOp::Xor, a, b, result);
     return result;
 }
 uint8_t z80::CP_Flags(uint8_t a, uint8_t b)
 {
     uint8_t result = a - b;
-    setFlag(N);
-    (b > A) ? setFlag(C_flag) : clearFlag(C_flag);
-    ((A & 0x0F) - (b & 0x0F) < 0x00) ? setFlag(H_flag) : clearFlag(H_flag);
-    result == 0x00 ? setFlag(Z) : clearFlag(Z);
-    result > 0x07F ? setFlag(S) : clearFlag(S);
-    (((A ^ b) & 0x80) != 0 && ((b ^ result) & 0x80) == 0) ? setFlag(P) : clearFlag(P);
-
-    ((b & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((b & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    updateFlags(FlagOp::Cp, a, b, result);
     return result;
 }
 
-bool z80::isEvenParity(uint8_t value)
+bool z80::isEvenParity(uint8_t value) const
 {
-    int count = 0;
-    while (value)
-    {
-        count += value & 1; // Increment count if the least significant bit is 1
-        value >>= 1;        // Right shift the value by 1 bit
-    }
-    return (count % 2) == 0;
+    return (szxypTable[value] & P) != 0;
 }
 
 void z80::ADD_A_R(uint8_t opCode)
@@ -3161,45 +5203,30 @@ void z80::ADD_A_R(uint8_t opCode)
     uint8_t srcValue = readFromRegister(src);
     A = Add8_Bit(A, srcValue);
 }
-void z80::ADD_A_IX_H(uint8_t opCode)
-{
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    A = Add8_Bit(A, n);
-}
-void z80::ADD_A_IX_L(uint8_t opCode)
-{
-    uint8_t n = (IX & 0x00FF);
-    A = Add8_Bit(A, n);
-}
-void z80::ADD_A_IY_H(uint8_t opCode)
-{
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    A = Add8_Bit(A, n);
-}
-void z80::ADD_A_IY_L(uint8_t opCode)
+template <uint8_t Source>
+void z80::ADD_A_R(uint8_t opCode)
 {
-    uint8_t n = (IY & 0x00FF);
-    A = Add8_Bit(A, n);
+    A = Add8_Bit(A, regs8[readRegisterOffset[Source]]);
 }
-void z80::SUB_A_IX_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADD_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    A = Sub8_Bit(A, n);
+    A = Add8_Bit(A, regs8[2 * Index + 1]);
 }
-void z80::SUB_A_IX_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADD_A_XYL(uint8_t opCode)
 {
-    uint8_t n = (IX & 0x00FF);
-    A = Sub8_Bit(A, n);
+    A = Add8_Bit(A, regs8[2 * Index]);
 }
-void z80::SUB_A_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::SUB_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    A = Sub8_Bit(A, n);
+    A = Sub8_Bit(A, regs8[2 * Index + 1]);
 }
-void z80::SUB_A_IY_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::SUB_A_XYL(uint8_t opCode)
 {
-    uint8_t n = (IY & 0x00FF);
-    A = Sub8_Bit(A, n);
+    A = Sub8_Bit(A, regs8[2 * Index]);
 }
 
 void z80::ADD_A_N(uint8_t opCode)
@@ -3212,113 +5239,55 @@ void z80::ADD_A_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     A = Add8_Bit(A, value);
 }
-void z80::ADD_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    A = Add8_Bit(A, value);
-    MPTR= IX+d;
-}
-void z80::ADD_A_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADD_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     A = Add8_Bit(A, value);
-     MPTR= IY+d;
 }
 void z80::ADC_A_s(uint8_t opCode)
 {
     uint8_t src = opCode & 0b00000111;
     uint8_t srcValue = readFromRegister(src);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    srcValue += carry;
-    A = Add8_Bit(A, srcValue);
+    A = Adc8_Bit(A, srcValue);
 }
 void z80::ADC_A_N(uint8_t opCode)
 {
     uint8_t value = fetchImmediate();
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Add8_Bit(A, value);
+    A = Adc8_Bit(A, value);
 }
 void z80::ADC_A_HL(uint8_t opCode)
 {
     uint8_t value = bus->read(getHL());
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Add8_Bit(A, value);
-}
-void z80::ADC_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Add8_Bit(A, value);
-    MPTR=IX+d;
+    A = Adc8_Bit(A, value);
 }
-void z80::ADC_A_IX_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADC_A_XY_D(uint8_t opCode)
 {
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Add8_Bit(A, n + carry);
+    uint8_t value = bus->read(indexedAddress<Index>());
+    A = Adc8_Bit(A, value);
 }
-void z80::ADC_A_IX_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADC_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IX & 0x00FF));
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Add8_Bit(A, n + carry);
+    A = Adc8_Bit(A, regs8[2 * Index + 1]);
 }
-void z80::ADC_A_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADC_A_XYL(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Add8_Bit(A, n + carry);
+    A = Adc8_Bit(A, regs8[2 * Index]);
 }
-void z80::ADC_A_IY_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::SBC_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0x00FF));
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Add8_Bit(A, n + carry);
+    A = Sbc8_Bit(A, regs8[2 * Index + 1]);
 }
-void z80::SBC_A_IX_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::SBC_A_XYL(uint8_t opCode)
 {
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Sub8_Bit(A, n + carry);
-}
-void z80::SBC_A_IX_L(uint8_t opCode)
-{
-    uint8_t n = ((IX & 0x00FF));
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Sub8_Bit(A, n + carry);
+    A = Sbc8_Bit(A, regs8[2 * Index]);
 }
 
-void z80::SBC_A_IY_H(uint8_t opCode)
-{
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Sub8_Bit(A, n + carry);
-}
-void z80::SBC_A_IY_L(uint8_t opCode)
-{
-    uint8_t n = ((IY & 0x00FF));
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    A = Sub8_Bit(A, n + carry);
-}
-void z80::ADC_A_IY_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Add8_Bit(A, value);
-    MPTR=IY+d;
-}
 void z80::SUB_A_R(uint8_t opCode)
 {
     uint8_t src = opCode & 0b00000111;
@@ -3335,63 +5304,33 @@ void z80::SUB_A_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     A = Sub8_Bit(A, value);
 }
-void z80::SUB_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    A = Sub8_Bit(A, value);
-    MPTR=IX+d;
-}
-void z80::SUB_A_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SUB_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     A = Sub8_Bit(A, value);
-    MPTR=IY+d;
 }
 void z80::SBC_A_S(uint8_t opCode)
 {
     uint8_t src = opCode & 0b00000111;
     uint8_t srcValue = readFromRegister(src);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    srcValue += carry;
-    A = Sub8_Bit(A, srcValue);
+    A = Sbc8_Bit(A, srcValue);
 }
 void z80::SBC_A_N(uint8_t opCode)
 {
     uint8_t value = fetchImmediate();
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Sub8_Bit(A, value);
+    A = Sbc8_Bit(A, value);
 }
 void z80::SBC_A_HL(uint8_t opCode)
 {
     uint8_t value = bus->read(getHL());
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Sub8_Bit(A, value);
-}
-void z80::SBC_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Sub8_Bit(A, value);
-    MPTR=IX+d;
+    A = Sbc8_Bit(A, value);
 }
-void z80::SBC_A_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SBC_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
-    uint8_t carry = isFlagSet(C_flag) ? 1 : 0;
-    value += carry;
-    A = Sub8_Bit(A, value);
-    MPTR=IY+d;
+    uint8_t value = bus->read(indexedAddress<Index>());
+    A = Sbc8_Bit(A, value);
 }
 void z80::AND_A_R(uint8_t opCode)
 {
@@ -3409,117 +5348,61 @@ void z80::AND_A_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     A = And8_Bit(A, value);
 }
-void z80::AND_A_IX_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::AND_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     A = And8_Bit(A, value);
-    MPTR=IX+d;
-}
-
-void z80::AND_A_IX_H(uint8_t opCode)
-{
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    A = And8_Bit(A, n);
-}
-void z80::AND_A_IY_H(uint8_t opCode)
-{
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    A = And8_Bit(A, n);
-}
-void z80::AND_A_IX_L(uint8_t opCode)
-{
-    uint8_t n = (IX & 0x00FF);
-    A = And8_Bit(A, n);
-}
-void z80::AND_A_IY_L(uint8_t opCode)
-{
-    uint8_t n = (IY & 0x00FF);
-    A = And8_Bit(A, n);
 }
 
-void z80::XOR_A_IX_H(uint8_t opCode)
-{
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    A = Xor8_Bit(A, n);
-}
-void z80::XOR_A_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::AND_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    A = Xor8_Bit(A, n);
+    A = And8_Bit(A, regs8[2 * Index + 1]);
 }
-void z80::OR_A_IX_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::AND_A_XYL(uint8_t opCode)
 {
-    uint8_t n = (IX & 0x00FF);
-    A = Or8_Bit(A, n);
+    A = And8_Bit(A, regs8[2 * Index]);
 }
 
-void z80::OR_A_IX_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::XOR_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    A = Or8_Bit(A, n);
+    A = Xor8_Bit(A, regs8[2 * Index + 1]);
 }
-
-void z80::OR_A_IY_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::OR_A_XYL(uint8_t opCode)
 {
-    uint8_t n = (IY & 0x00FF);
-    A = Or8_Bit(A, n);
+    A = Or8_Bit(A, regs8[2 * Index]);
 }
 
-void z80::OR_A_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::OR_A_XYH(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    A = Or8_Bit(A, n);
+    A = Or8_Bit(A, regs8[2 * Index + 1]);
 }
 
-void z80::CP_IX_H(uint8_t opCode)
-{
-    uint8_t n = ((IX & 0xFF00) >> 8);
-    uint8_t diff = A - n;
-    CP_Flags(A, n);
-}
 
-void z80::CP_IX_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::CP_XYH(uint8_t opCode)
 {
-    uint8_t n = (IX & 0x00FF);
-    uint8_t diff = A - n;
-    CP_Flags(A, n);
+    CP_Flags(A, regs8[2 * Index + 1]);
 }
 
-void z80::CP_A_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::CP_XYL(uint8_t opCode)
 {
-    uint8_t n = ((IY & 0xFF00) >> 8);
-    uint8_t diff = A - n;
-    CP_Flags(A, n);
+    CP_Flags(A, regs8[2 * Index]);
 }
 
-void z80::CP_A_IY_L(uint8_t opCode)
-{
-    uint8_t n = (IY & 0x00FF);
-    uint8_t diff = A - n;
-    CP_Flags(A, n);
-}
 
-void z80::XOR_A_IX_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::XOR_A_XYL(uint8_t opCode)
 {
-    uint8_t n = (IX & 0x00FF);
-    A = Xor8_Bit(A, n);
+    A = Xor8_Bit(A, regs8[2 * Index]);
 }
 
-void z80::XOR_A_IY_L(uint8_t opCode)
-{
-    uint8_t n = (IY & 0x00FF);
-    A = Xor8_Bit(A, n);
-}
-void z80::AND_A_IY_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
-    A = And8_Bit(A, value);
-    MPTR=IY+d;
-}
 void z80::OR_A_R(uint8_t opCode)
 {
     uint8_t src = opCode & 0b00000111;
@@ -3536,21 +5419,11 @@ void z80::OR_A_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     A = Or8_Bit(A, value);
 }
-void z80::OR_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    A = Or8_Bit(A, value);
-    MPTR=IX+d;
-}
-void z80::OR_A_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::OR_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     A = Or8_Bit(A, value);
-    MPTR=IY+d;
 }
 void z80::XOR_A_R(uint8_t opCode)
 {
@@ -3568,21 +5441,11 @@ void z80::XOR_A_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     A = Xor8_Bit(A, value);
 }
-void z80::XOR_A_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    A = Xor8_Bit(A, value);
-    MPTR=IX+d;
-}
-void z80::XOR_A_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::XOR_A_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     A = Xor8_Bit(A, value);
-    MPTR=IY+d;
 }
 void z80::CP_R(uint8_t opCode)
 {
@@ -3601,46 +5464,20 @@ void z80::CP_HL(uint8_t opCode)
     uint8_t value = bus->read(getHL());
     CP_Flags(A, value);
 }
-void z80::CP_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint16_t address = IX + d;
-    uint8_t value = bus->read(address);
-    CP_Flags(A, value);
-    MPTR=IX+d;
-}
-void z80::CP_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::CP_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint16_t address = IY + d;
-    uint8_t value = bus->read(address);
+    uint8_t value = bus->read(indexedAddress<Index>());
     CP_Flags(A, value);
-    MPTR=IY+d;
 }
 
 void z80::IncFlags(uint8_t value, uint8_t result)
 {
-
-    clearFlag(N);
-    (int8_t) result < 0 ? setFlag(S) : clearFlag(S);
-    result == 0 ? setFlag(Z) : clearFlag(Z);
-    value == 0x7F ? setFlag(P) : clearFlag(P);
-    ((value & 0x0F) + (0x01 & 0x0F) > 0x0F) ? setFlag(H_flag) : clearFlag(H_flag);
-
-    ((result & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((result & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    updateFlags(FlagOp::Inc, value, 1, result);
 }
 void z80::DecFlags(uint8_t value, uint8_t result)
 {
-
-    setFlag(N);
-    (int8_t) result < 0 ? setFlag(S) : clearFlag(S);
-    result == 0 ? setFlag(Z) : clearFlag(Z);
-    value == 0x80 ? setFlag(P) : clearFlag(P);
-    (value & 0x0F) < (0x01 & 0x0F) ? setFlag(H_flag) : clearFlag(H_flag);
-
-    ((result & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((result & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    updateFlags(FlagOp::Dec, value, 1, result);
 }
 
 void z80::INC_R(uint8_t opCode)
@@ -3652,6 +5489,14 @@ void z80::INC_R(uint8_t opCode)
     writeToRegister(src, result);
 }
 
+template <uint8_t Target>
+void z80::INC_R(uint8_t opCode)
+{
+    uint8_t value = regs8[readRegisterOffset[Target]];
+    IncFlags(value, value + 1);
+    regs8[writeRegisterOffset[Target]] = value + 1;
+}
+
 void z80::INC_HL(uint8_t opCode)
 {
     uint8_t target = bus->read(getHL());
@@ -3659,23 +5504,13 @@ void z80::INC_HL(uint8_t opCode)
     target++;
     bus->write(getHL(), target);
 }
-void z80::INC_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t target = bus->read(IX + d);
-    IncFlags(target, target + 1);
-    target++;
-    bus->write(IX + d, target);
-    MPTR = IX + d;
-}
-void z80::INC_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::INC_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t target = bus->read(IY + d);
+    uint16_t address = indexedAddress<Index>();
+    uint8_t target = bus->read(address);
     IncFlags(target, target + 1);
-    target++;
-    bus->write(IY + d, target);
-    MPTR = IY + d;
+    bus->write(address, target + 1);
 }
 void z80::DEC_R(uint8_t opCode)
 {
@@ -3688,27 +5523,17 @@ void z80::DEC_R(uint8_t opCode)
 void z80::DEC_HL(uint8_t opCode)
 {
     uint8_t target = bus->read(getHL());
-    target--;
-    bus->write(getHL(), target);
-    DecFlags(target, target);
-}
-void z80::DEC_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t target = bus->read(IX + d);
     DecFlags(target, target - 1);
     target--;
-    bus->write(IX + d, target);
-    MPTR = IX +d;
+    bus->write(getHL(), target);
 }
-void z80::DEC_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::DEC_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t target = bus->read(IY + d);
+    uint16_t address = indexedAddress<Index>();
+    uint8_t target = bus->read(address);
     DecFlags(target, target - 1);
-    target--;
-    bus->write(IY + d, target);
-    MPTR = IY+d;
+    bus->write(address, target - 1);
 }
 
 /*****************************************|
@@ -3761,12 +5586,7 @@ void z80::DAA(uint8_t opCode)
         A += isFlagSet(N) ? 0x9A : 0x66; // -0x66:0x66
         break;
     }
-    A == 0 ? setFlag(Z) : clearFlag(Z);
-    isEvenParity(A) ? setFlag(P) : clearFlag(P);
-    ((A & 0x80) > 0) ? setFlag(S) : clearFlag(S);
-
-    ((A & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((A & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(H_flag | N | C_flag, szxypTable[A]);
 }
 void z80::CPL(uint8_t opCode)
 {
@@ -3842,6 +5662,7 @@ void z80::EI(uint8_t opCode)
 {
     IFF2 = true;
     IFF1 = true;
+    eiEndedAt = tstates;
 }
 void z80::IM0(uint8_t opCode)
 {
@@ -4001,20 +5822,12 @@ void z80::SBC_HL_SS(uint8_t opCode)
 
     writeToRegisterPair(2, result);
 }
-void z80::ADD_IX_PP(uint8_t opCode)
+template <uint8_t Index>
+void z80::ADD_XY_PP(uint8_t opCode)
 {
     uint8_t src = (opCode & 0b00110000) >> 4;
-    uint16_t srcValue = readFromRegisterPair2(src); // this is for reading from IX and not HL
-    uint16_t sum = Add16_Bit(IX, srcValue);
-    IX = sum;
-}
-void z80::ADD_IY_RR(uint8_t opCode)
-{
-    uint8_t src = (opCode & 0b00110000) >> 4;
-    uint16_t srcValue = readFromRegisterPair3(src); // this is for reading from IX and not HL
-    MPTR = (IY + 1);
-    uint16_t sum = Add16_Bit(IY, srcValue);
-    IY = sum;
+    uint16_t srcValue = src == 2 ? regs16[Index] : regs16[registerPairIndex[src]]; // ADD IX, IX and ADD IY, IY
+    regs16[Index] = Add16_Bit(regs16[Index], srcValue);
 }
 void z80::INC_SS(uint8_t opCode)
 {
@@ -4026,49 +5839,24 @@ void z80::INC_SS(uint8_t opCode)
 
     writeToRegisterPair(src, sum);
 }
-void z80::INC_IX(uint8_t opCode)
-{
-    IX += 1;
-}
-void z80::INC_IXH(uint8_t opCode)
-{
-    uint8_t hiByte = (IX >> 8);
-    uint8_t loByte = IX & 0x00FF;
-    uint8_t incVal = (hiByte + 1);
-    IX = ((incVal << 8) + loByte);
-
-    IncFlags(hiByte, incVal);
-}
-void z80::INC_IXl(uint8_t opCode)
+template <uint8_t Index>
+void z80::INC_XY(uint8_t opCode)
 {
-    uint8_t hiByte = (IX >> 8);
-    uint8_t loByte = IX & 0x00FF;
-    uint8_t incVal = (loByte + 1);
-    IX = ((hiByte << 8) + incVal);
-
-    IncFlags(loByte, incVal);
-}
-void z80::INC_IY_H(uint8_t opCode)
-{
-    uint8_t hiByte = (IY >> 8);
-    uint8_t loByte = IY & 0x00FF;
-    uint8_t incVal = (hiByte + 1);
-    IY = ((incVal << 8) + loByte);
-
-    IncFlags(hiByte, incVal);
+    regs16[Index] += 1;
 }
-void z80::INC_IY_L(uint8_t opCode)
+template <uint8_t Index>
+void z80::INC_XYH(uint8_t opCode)
 {
-    uint8_t hiByte = (IY >> 8);
-    uint8_t loByte = IY & 0x00FF;
-    uint8_t incVal = (loByte + 1);
-    IY = ((hiByte << 8) + incVal);
-
-    IncFlags(loByte, incVal);
+    uint8_t value = regs8[2 * Index + 1];
+    IncFlags(value, value + 1);
+    regs8[2 * Index + 1] = value + 1;
 }
-void z80::INC_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::INC_XYL(uint8_t opCode)
 {
-    IY += 1;
+    uint8_t value = regs8[2 * Index];
+    IncFlags(value, value + 1);
+    regs8[2 * Index] = value + 1;
 }
 void z80::DEC_SS(uint8_t opCode)
 {
@@ -4077,51 +5865,25 @@ void z80::DEC_SS(uint8_t opCode)
     sum--;
     writeToRegisterPair(src, sum);
 }
-void z80::DEC_IX(uint8_t opCode)
-{
-    IX -= 1;
-}
-void z80::DEC_IXH(uint8_t opCode)
-{
-    uint8_t hiByte = (IX >> 8);
-    uint8_t loByte = IX & 0x00FF;
-    uint8_t incVal = (hiByte - 1);
-    IX = ((incVal << 8) + loByte);
-
-    DecFlags(hiByte, incVal);
-}
-
-void z80::DEC_IXl(uint8_t opCode)
+template <uint8_t Index>
+void z80::DEC_XY(uint8_t opCode)
 {
-    uint8_t hiByte = (IX >> 8);
-    uint8_t loByte = IX & 0x00FF;
-    uint8_t incVal = (loByte - 1);
-    IX = ((hiByte << 8) + incVal);
-
-    DecFlags(hiByte, incVal);
+    regs16[Index] -= 1;
 }
-void z80::DEC_IY_H(uint8_t opCode)
+template <uint8_t Index>
+void z80::DEC_XYH(uint8_t opCode)
 {
-    uint8_t hiByte = (IY >> 8);
-    uint8_t loByte = IY & 0x00FF;
-    uint8_t incVal = (hiByte - 1);
-    IY = ((incVal << 8) + loByte);
-
-    DecFlags(hiByte, incVal);
+    uint8_t value = regs8[2 * Index + 1];
+    DecFlags(value, value - 1);
+    regs8[2 * Index + 1] = value - 1;
 }
 
-void z80::DEC_IY_L(uint8_t opCode)
-{
-    uint8_t hiByte = (IY >> 8);
-    uint8_t loByte = IY & 0x00FF;
-    uint8_t incVal = (loByte - 1);
-    IY = ((hiByte << 8) + incVal);
-
-    DecFlags(hiByte, incVal);
-}
-void z80::DEC_IY(uint8_t opCode)
+template <uint8_t Index>
+void z80::DEC_XYL(uint8_t opCode)
 {
-    IY -= 1;
+    uint8_t value = regs8[2 * Index];
+    DecFlags(value, value - 1);
+    regs8[2 * Index] = value - 1;
 }
 
 /*****************************************|
@@ -4217,14 +5979,7 @@ void z80::RLC_R(uint8_t opCode)
 
 void z80::rotateFlags(uint8_t value)
 {
-    clearFlag(N);
-    clearFlag(H_flag);
-    value == 0 ? setFlag(Z) : clearFlag(Z);
-    value >= 0x80 ? setFlag(S) : clearFlag(S);
-    isEvenParity(value) ? setFlag(P) : clearFlag(P);
-
-    ((value & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((value & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(C_flag, szxypTable[value]); // N and H are cleared
 }
 void z80::RLC_HL(uint8_t opCode)
 {
@@ -4242,54 +5997,16 @@ void z80::RLC_HL(uint8_t opCode)
     rotateFlags(value);
 }
 // This instruction does undocumented stuff the whole thing is like 4 bytes and the d is the third
-void z80::RLC_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-
-    uint8_t c = 0;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-    if ((value & 0b10000000) > 0)
-    {
-        c = 1;
-    }
-
-    value = ((value << 1) + c);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IX + d, value);
-
-    c == 1 ? setFlag(C_flag) : clearFlag(C_flag);
-    rotateFlags(value);
-}
-void z80::RLC_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::RLC_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    MPTR=IY+d;
-
-    uint8_t c = 0;
-    uint8_t value = bus->read(IY + d);
-    if ((value & 0b10000000) > 0)
-    {
-        c = 1;
-    }
-    value = ((value << 1) + c);
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IY + d, value);
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
+    uint8_t newC = value & 0b10000000;
+    value = (value << 1) | (newC >> 7);
+    writeIndexedResult(address, opCode, value);
 
-    c == 1 ? setFlag(C_flag) : clearFlag(C_flag);
+    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
 
@@ -4323,52 +6040,19 @@ void z80::RL_HL(uint8_t opCode)
     newC > 1 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
-void z80::RL_IX_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::RL_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t currC = isFlagSet(C_flag);
     uint8_t newC = value & 0b10000000;
-
-    value = (value << 1) + currC;
-
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    value = (value << 1) | currC;
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
-void z80::RL_IY_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
-    uint8_t currC = isFlagSet(C_flag);
-    uint8_t newC = value & 0b10000000;
-
-    value = (value << 1) + currC;
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    newC > 1 ? setFlag(C_flag) : clearFlag(C_flag);
-    rotateFlags(value);
-}
 
 void z80::RRC_R(uint8_t opCode)
 {
@@ -4412,64 +6096,16 @@ void z80::RRC_HL(uint8_t opCode)
 
     rotateFlags(value);
 }
-void z80::RRC_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t c = 0;
-    if ((value & 0b00000001) > 0)
-    {
-        c = 1;
-    }
-
-    value = value >> 1;
-    if (c == 1)
-    {
-        value |= 0b10000000;
-    }
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    c == 1 ? setFlag(C_flag) : clearFlag(C_flag);
-
-    rotateFlags(value);
-}
-void z80::RRC_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::RRC_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = opCode & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
-    uint8_t c = 0;
-    if ((value & 0b00000001) > 0)
-    {
-        c = 1;
-    }
-
-    value = value >> 1;
-    if (c == 1)
-    {
-        value |= 0b10000000;
-    }
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    c == 1 ? setFlag(C_flag) : clearFlag(C_flag);
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
+    uint8_t newC = value & 0b00000001;
+    value = (value >> 1) | (newC << 7);
+    writeIndexedResult(address, opCode, value);
 
+    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
 
@@ -4488,32 +6124,9 @@ void z80::RR_R(uint8_t opCode)
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
-void z80::RR_HL(uint8_t opCode)
-{
-    uint8_t value = bus->read(getHL());
-
-    uint8_t currC = isFlagSet(C_flag);
-    uint8_t newC = value & 0b00000001;
-
-    value = (value >> 1);
-
-    if (currC == 1)
-    {
-        value |= 0b10000000;
-    }
-
-    bus->write(getHL(), value);
-
-    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
-    rotateFlags(value);
-}
-void z80::RR_IX_D(uint8_t opCode)
+void z80::RR_HL(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
+    uint8_t value = bus->read(getHL());
 
     uint8_t currC = isFlagSet(C_flag);
     uint8_t newC = value & 0b00000001;
@@ -4525,40 +6138,20 @@ void z80::RR_IX_D(uint8_t opCode)
         value |= 0b10000000;
     }
 
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    bus->write(getHL(), value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
 }
-void z80::RR_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::RR_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t currC = isFlagSet(C_flag);
     uint8_t newC = value & 0b00000001;
-
-    value = (value >> 1);
-
-    if (currC == 1)
-    {
-        value |= 0b10000000;
-    }
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    value = (value >> 1) | (currC << 7);
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     rotateFlags(value);
@@ -4593,102 +6186,28 @@ void z80::SLA_HL(uint8_t opCode)
 
 void z80::shiftFlags(uint8_t value)
 {
-    clearFlag(N);
-    clearFlag(H_flag);
-    value == 0 ? setFlag(Z) : clearFlag(Z);
-    value >= 0x80 ? setFlag(S) : clearFlag(S);
-    isEvenParity(value) ? setFlag(P) : clearFlag(P);
-
-    ((value & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((value & 0x20) > 0) ? setFlag(U) : clearFlag(U);
-}
-void z80::SLA_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t newC = value & 0b10000000;
-
-    value = value << 1;
-
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
-    shiftFlags(value);
-}
-void z80::SLS_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t newC = value & 0b10000000;
-
-    value = value << 1;
-    value |= 0b00000001;
-
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
-    shiftFlags(value);
+    replaceFlags(C_flag, szxypTable[value]);
 }
-
-void z80::SLS_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SLA_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t newC = value & 0b10000000;
-
     value = value << 1;
-    value |= 0b00000001;
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     shiftFlags(value);
 }
-void z80::SLA_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SLS_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t newC = value & 0b10000000;
-
-    value = value << 1;
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    value = (value << 1) | 0b00000001;
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     shiftFlags(value);
@@ -4759,56 +6278,14 @@ void z80::SRA_HL(uint8_t opCode)
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     shiftFlags(value);
 }
-void z80::SRA_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t newC = value & 0b00000001;
-    uint8_t bit7 = value & 0b10000000;
-    value = value >> 1;
-
-    if (bit7)
-    {
-        value += 0b10000000;
-    }
-
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
-    shiftFlags(value);
-}
-void z80::SRA_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SRA_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t newC = value & 0b00000001;
-    uint8_t bit7 = value & 0b10000000;
-    value = value >> 1;
-
-    if (bit7)
-    {
-        value += 0b10000000;
-    }
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    value = (value >> 1) | (value & 0b10000000);
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     shiftFlags(value);
@@ -4845,55 +6322,17 @@ void z80::SRL_HL(uint8_t opCode)
 
 void z80::shiftFlags2(uint8_t value)
 {
-    clearFlag(N);
-    clearFlag(H_flag);
-    value == 0 ? setFlag(Z) : clearFlag(Z);
-    clearFlag(S);
-    isEvenParity(value) ? setFlag(P) : clearFlag(P);
-
-    ((value & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((value & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(C_flag, szxypTable[value] & ~S);
 }
 
-void z80::SRL_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t newC = value & 0b00000001;
-
-    value = value >> 1;
-
-    bus->write(IX + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
-    shiftFlags2(value);
-}
-void z80::SRL_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SRL_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
+    uint8_t value = bus->read(address);
     uint8_t newC = value & 0b00000001;
     value = value >> 1;
-
-    bus->write(IY + d, value);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
+    writeIndexedResult(address, opCode, value);
 
     newC > 0 ? setFlag(C_flag) : clearFlag(C_flag);
     shiftFlags2(value);
@@ -4913,14 +6352,7 @@ void z80::RLD(uint8_t opCode)
 
     bus->write(getHL(), newValue);
 
-    clearFlag(N);
-    clearFlag(H_flag);
-    A == 0 ? setFlag(Z) : clearFlag(Z);
-    ((int8_t)A < 0) ? setFlag(S) : clearFlag(S);
-    isEvenParity(A) ? setFlag(P) : clearFlag(P);
-
-    ((A & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((A & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(C_flag, szxypTable[A]); // N and H are cleared
     MPTR = (getHL() + 1);
 }
 void z80::RRD(uint8_t opCode)
@@ -4937,14 +6369,7 @@ void z80::RRD(uint8_t opCode)
 
     bus->write(getHL(), newValue);
 
-    clearFlag(N);
-    clearFlag(H_flag);
-    A == 0 ? setFlag(Z) : clearFlag(Z);
-    ((int8_t)A < 0) ? setFlag(S) : clearFlag(S);
-    isEvenParity(A) ? setFlag(P) : clearFlag(P);
-
-    ((A & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((A & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(C_flag, szxypTable[A]); // N and H are cleared
     MPTR = (getHL() + 1);
 }
 /*****************************************|
@@ -4972,6 +6397,18 @@ void z80::BIT_B_R(uint8_t opCode)
     ((value & 0x0008) > 0) ? setFlag(X) : clearFlag(X);
     ((value & 0x0020) > 0) ? setFlag(U) : clearFlag(U);
 }
+template <uint8_t Bit, uint8_t Source>
+void z80::BIT_B_R(uint8_t opCode)
+{
+    uint8_t value = regs8[readRegisterOffset[Source]];
+    uint8_t result = value & (1 << Bit);
+    uint8_t flags = H_flag | (value & (X | U)) | (result == 0 ? Z | P : 0);
+    if (Bit == 7)
+    {
+        flags |= result; // S is bit 7 itself
+    }
+    replaceFlags(C_flag, flags); // N is cleared
+}
 void z80::BIT_B_HL(uint8_t opCode)
 {
     uint8_t value = bus->read(getHL());
@@ -4989,46 +6426,16 @@ void z80::BIT_B_HL(uint8_t opCode)
     ((MPTR & 0x0800) > 0) ? setFlag(X) : clearFlag(X);
     ((MPTR & 0x2000) > 0) ? setFlag(U) : clearFlag(U);
 }
-void z80::BIT_B_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t bit = fetchImmediate();
-    bit = (bit & 0b00111000) >> 3;
-    uint8_t value = bus->read(IX + d);
-
-    MPTR = (IX + d);
-
-    uint8_t result = value & (1 << bit);
-
-    clearFlag(N);
-    setFlag(H_flag);
-    result == 0 ? setFlag(Z) : clearFlag(Z);
-    bit == 7 && result != 0 ? setFlag(S) : clearFlag(S);
-    result == 0 ? setFlag(P) : clearFlag(P);
-
-    ((MPTR & 0x0800) > 0) ? setFlag(X) : clearFlag(X);
-    ((MPTR & 0x2000) > 0) ? setFlag(U) : clearFlag(U);
-}
-void z80::BIT_B_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::BIT_B_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-
+    uint8_t value = bus->read(indexedBitAddress<Index>());
     uint8_t bit = (opCode & 0b00111000) >> 3;
-
     uint8_t result = value & (1 << bit);
 
-    MPTR = (IY + d);
-
-    clearFlag(N);
-    setFlag(H_flag);
-    result == 0 ? setFlag(Z) : clearFlag(Z);
-    bit == 7 && result != 0 ? setFlag(S) : clearFlag(S);
-    result == 0 ? setFlag(P) : clearFlag(P);
-    ((MPTR & 0x0800) > 0) ? setFlag(X) : clearFlag(X);
-    ((MPTR & 0x2000) > 0) ? setFlag(U) : clearFlag(U);
+    // S only for bit 7, X and U come from the high byte of MEMPTR, N is cleared
+    uint8_t flags = H_flag | (result & S) | ((MPTR >> 8) & (X | U)) | (result == 0 ? Z | P : 0);
+    replaceFlags(C_flag, flags);
 }
 void z80::SET_B_R(uint8_t opCode)
 {
@@ -5041,6 +6448,11 @@ void z80::SET_B_R(uint8_t opCode)
 
     writeToRegister(src, value);
 }
+template <uint8_t Bit, uint8_t Target>
+void z80::SET_B_R(uint8_t opCode)
+{
+    regs8[writeRegisterOffset[Target]] = regs8[readRegisterOffset[Target]] | (1 << Bit);
+}
 void z80::SET_B_HL(uint8_t opCode)
 {
     uint8_t value = bus->read(getHL());
@@ -5050,39 +6462,13 @@ void z80::SET_B_HL(uint8_t opCode)
 
     bus->write(getHL(), value);
 }
-void z80::SET_B_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR = IX + d;
-    uint8_t bit = (opCode & 0b00111000) >> 3;
-    value |= (1 << bit);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IX + d, value);
-}
-void z80::SET_B_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::SET_B_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR = IY + d;
+    uint16_t address = indexedBitAddress<Index>();
     uint8_t bit = (opCode & 0b00111000) >> 3;
-    value |= (1 << bit);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IY + d, value);
+    uint8_t value = bus->read(address) | (1 << bit);
+    writeIndexedResult(address, opCode, value);
 }
 void z80::RES_B_R(uint8_t opCode)
 {
@@ -5094,6 +6480,11 @@ void z80::RES_B_R(uint8_t opCode)
 
     writeToRegister(src, value);
 }
+template <uint8_t Bit, uint8_t Target>
+void z80::RES_B_R(uint8_t opCode)
+{
+    regs8[writeRegisterOffset[Target]] = regs8[readRegisterOffset[Target]] & ~(1 << Bit);
+}
 void z80::RES_B_HL(uint8_t opCode)
 {
     uint8_t value = bus->read(getHL());
@@ -5103,41 +6494,13 @@ void z80::RES_B_HL(uint8_t opCode)
 
     bus->write(getHL(), value);
 }
-void z80::RES_B_IX_D(uint8_t opCode)
-{
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IX + d);
-    MPTR=IX+d;
-
-    uint8_t bit = (opCode & 0b00111000) >> 3;
-    value &= ~(1 << bit);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IX + d, value);
-}
-void z80::RES_B_IY_D(uint8_t opCode)
+template <uint8_t Index>
+void z80::RES_B_XY_D(uint8_t opCode)
 {
-    int8_t d = fetchImmediate();
-    uint8_t dest = fetchImmediate();
-    dest = dest & 0b00000111;
-    uint8_t value = bus->read(IY + d);
-    MPTR=IY+d;
-
+    uint16_t address = indexedBitAddress<Index>();
     uint8_t bit = (opCode & 0b00111000) >> 3;
-    value &= ~(1 << bit);
-
-    if (dest != 6)
-    {
-        writeToRegister(dest, value);
-    }
-
-    bus->write(IY + d, value);
+    uint8_t value = bus->read(address) & ~(1 << bit);
+    writeIndexedResult(address, opCode, value);
 }
 /*****************************************|
  *                                        |
@@ -5204,6 +6567,7 @@ void z80::JR_C_E(uint8_t opCode)
 
     if (isFlagSet(C_flag))
     {
+        tstates += 5;
         PC = PC + (uint16_t)e;
         MPTR = PC+1;
     }
@@ -5214,6 +6578,7 @@ void z80::JR_NC_E(uint8_t opCode)
 
     if (!isFlagSet(C_flag))
     {
+        tstates += 5;
         PC = PC + (uint16_t)e;
         MPTR = PC+1;
     }
@@ -5224,6 +6589,7 @@ void z80::JR_Z_E(uint8_t opCode)
 
     if (isFlagSet(Z))
     {
+        tstates += 5;
         PC = PC + (uint16_t)e;
         MPTR = PC+1;
     }
@@ -5234,6 +6600,7 @@ void z80::JR_NZ_E(uint8_t opCode)
 
     if (!isFlagSet(Z))
     {
+        tstates += 5;
         PC = (uint16_t)PC + e;
         MPTR = PC+1;
     }
@@ -5242,13 +6609,10 @@ void z80::JP_HL(uint8_t opCode)
 {
     PC = getHL() - 1;
 }
-void z80::JP_IX(uint8_t opCode)
+template <uint8_t Index>
+void z80::JP_XY(uint8_t opCode)
 {
-    PC = IX - 1;
-}
-void z80::JP_IY(uint8_t opCode)
-{
-    PC = IY - 1;
+    PC = regs16[Index] - 1;
 }
 
 void z80::DJNZ_E(uint8_t opCode)
@@ -5262,6 +6626,7 @@ void z80::DJNZ_E(uint8_t opCode)
 
     if (!isFlagSet(Z))
     {
+        tstates += 5;
         PC = PC + e;
         MPTR = PC+1;
     }
@@ -5316,6 +6681,7 @@ void z80::CALL_CC_NN(uint8_t opCode)
 
     if (evaluateCC(cc))
     {
+        tstates += 7;
         pushPC();
         PC = address - 1;
     }
@@ -5333,6 +6699,7 @@ void z80::RET_CC(uint8_t opCode)
 
     if (evaluateCC(cc))
     {
+        tstates += 6;
         popPC();
         MPTR = PC;
         PC--;
@@ -5410,14 +6777,7 @@ void z80::IN_R_C(uint8_t opCode)
     uint8_t dest = (opCode & 0b00111000) >> 3;
     writeToRegister(dest, n);
 
-    clearFlag(N);
-    clearFlag(H_flag);
-    isEvenParity(n) ? setFlag(P) : clearFlag(P);
-    n == 0 ? setFlag(Z) : clearFlag(Z);
-    n > 0x7F ? setFlag(S) : clearFlag(S);
-
-    ((n & 0x08) > 0) ? setFlag(X) : clearFlag(X);
-    ((n & 0x20) > 0) ? setFlag(U) : clearFlag(U);
+    replaceFlags(C_flag, szxypTable[n]); // N and H are cleared
 }
 void z80::INI(uint8_t opCode)
 {
@@ -5428,26 +6788,18 @@ void z80::INI(uint8_t opCode)
     uint16_t HLq = getHL();
     HLq++;
     writeToRegisterPair(2, HLq);
-    uint8_t val = B;
     B = B - 1;
-    uint8_t decVal = B;
-
-    DecFlags(val, decVal);
-
-    uint16_t k = n + ((C + 1) & 255);
-    k > 0xFF ? setFlag(H_flag) : clearFlag(H_flag);
-    k > 0xFF ? setFlag(C_flag) : clearFlag(C_flag);
 
-    uint16_t x = ((k & 7) ^ decVal);
-    isEvenParity(x) ? setFlag(P) : clearFlag(P);
-    ((n & 0x80) > 0) ? setFlag(N) : clearFlag(N);
+    blockIOFlags(n, n + ((C + 1) & 255));
 }
 void z80::INIR(uint8_t opCode)
 {
     INI(opCode);
     if (B != 0)
     {
+        tstates += 5;
         PC -= 2;
+        repeatBlockIO(true, 1);
     }
 }
 void z80::IND(uint8_t opCode)
@@ -5456,32 +6808,19 @@ void z80::IND(uint8_t opCode)
     bus->write(getHL(), value);
     MPTR = getBC() - 1;
 
-    uint16_t HL_ = getHL();
-    HL_--;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
+    HL--;
 
-    uint8_t val = B;
     B = B - 1;
-    uint8_t decVal = B;
-    DecFlags(val, B);
-    uint16_t k = value + ((C - 1) & 255);
-    k > 0xFF ? setFlag(H_flag) : clearFlag(H_flag);
-    k > 0xFF ? setFlag(C_flag) : clearFlag(C_flag);
-
-    uint16_t x = ((k & 7) ^ decVal);
-    isEvenParity(x) ? setFlag(P) : clearFlag(P);
-    ((value & 0x80) > 0) ? setFlag(N) : clearFlag(N);
+    blockIOFlags(value, value + ((C - 1) & 255));
 }
 void z80::INDR(uint8_t opCode)
 {
     IND(opCode);
     if (B != 0)
     {
+        tstates += 5;
         PC -= 2;
+        repeatBlockIO(true, -1);
     }
 }
 void z80::OUT_N_A(uint8_t opCode)
@@ -5506,26 +6845,11 @@ void z80::OUTI(uint8_t opCode)
     bus->writeIO(getBC(), value);
     
 
-    uint16_t HL_ = getHL();
-    HL_++;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
+    HL++;
 
-    uint8_t val = B;
     B = B - 1;
-    uint8_t decVal = B;
     MPTR = getBC() + 1;
-    DecFlags(val, B);
-    uint16_t k = value + L;
-    k > 0xFF ? setFlag(H_flag) : clearFlag(H_flag);
-    k > 0xFF ? setFlag(C_flag) : clearFlag(C_flag);
-
-    uint16_t x = ((k & 7) ^ decVal);
-    isEvenParity(x) ? setFlag(P) : clearFlag(P);
-    ((value & 0x80) > 0) ? setFlag(N) : clearFlag(N);
+    blockIOFlags(value, value + L);
 }
 void z80::OTIR(uint8_t opCode)
 {
@@ -5533,7 +6857,9 @@ void z80::OTIR(uint8_t opCode)
 
     if (B != 0)
     {
+        tstates += 5;
         PC -= 2;
+        repeatBlockIO(false, 1);
     }
 }
 void z80::OUTD(uint8_t opCode)
@@ -5542,32 +6868,109 @@ void z80::OUTD(uint8_t opCode)
     bus->writeIO(getBC(), value);
     
 
-    uint16_t HL_ = getHL();
-    HL_--;
-    uint8_t hi1 = (HL_ >> 8) & 0xFF;
-    uint8_t lo1 = HL_ & 0xFF;
-
-    H = hi1;
-    L = lo1;
+    HL--;
 
-    uint8_t val = B;
     B = B - 1;
-    uint8_t decVal = B;
     MPTR = getBC() - 1;
-    DecFlags(val, B);
-    uint16_t k = value + L;
+    blockIOFlags(value, value + L);
+}
+void z80::OTDR(uint8_t opCode)
+{
+    OUTD(opCode);
+    if (B != 0)
+    {
+        tstates += 5;
+        PC -= 2;
+        repeatBlockIO(false, -1);
+    }
+}
+
+// Flags of INI, IND, OUTI and OUTD once B has been decremented, value being
+// the byte moved and k the sum the undocumented H, C and P come from
+void z80::blockIOFlags(uint8_t value, uint16_t k)
+{
+    DecFlags(B + 1, B);
     k > 0xFF ? setFlag(H_flag) : clearFlag(H_flag);
     k > 0xFF ? setFlag(C_flag) : clearFlag(C_flag);
 
-    uint16_t x = ((k & 7) ^ decVal);
+    uint16_t x = ((k & 7) ^ B);
     isEvenParity(x) ? setFlag(P) : clearFlag(P);
     ((value & 0x80) > 0) ? setFlag(N) : clearFlag(N);
 }
-void z80::OTDR(uint8_t opCode)
+
+// Bulk path of INIR, INDR, OTIR and OTDR, called after an iteration that
+// repeats. The bytes of the following iterations that the runFor() call in
+// progress would still start go through the port in one Bus call, each with
+// the T-state its iteration would move it at. Iterations cost 21 T-states and
+// two refreshes, except the one that brings B to 0, which costs 16 and moves
+// PC on. F and MEMPTR end up as the last iteration leaves them. INIR and INDR
+// stop after writing over the instruction itself, so the new bytes are fetched.
+void z80::repeatBlockIO(bool input, int step)
 {
-    OUTD(opCode);
-    if (B != 0)
+    if (tstates >= runDeadline)
+        return;
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(B, (runDeadline - tstates + 20) / 21));
+
+    if (input)
     {
-        PC -= 2;
+        count = std::min(count, iterationsBeforeSelfWrite(HL, step));
+        if (count == 0)
+            return;
+    }
+
+    // Only the ports that go the same way as the first move at once. Past
+    // them the handler carries on an iteration at a time, so a device that
+    // handles some of the ports still sees each byte at its own T-state.
+    uint16_t port = getBC();
+    count = bus->ioBlockLength(port, count, !input);
+    if (count == 0)
+        return;
+
+    // The handler of each iteration runs once its 16 base T-states are counted
+    uint8_t data[256] = {};
+    uint64_t timestamps[256] = {};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        timestamps[i] = tstates + 21 * i + 16;
+    }
+
+    if (input)
+    {
+        bus->readIOBlock(port, data, count, timestamps);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            bus->write(HL + step * static_cast<int>(i), data[i]);
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            data[i] = bus->read(HL + step * static_cast<int>(i));
+        }
+        bus->writeIOBlock(port, data, count, timestamps);
+    }
+
+    HL += step * static_cast<int>(count);
+    B -= count;
+    IncrementRefreshRegister(2 * count);
+    tstates += 21 * count;
+    if (B == 0)
+    {
+        tstates -= 5;
+        PC += 2;
+    }
+
+    // INIR and INDR address MEMPTR from B before the last decrement, OTIR and OTDR after it
+    uint8_t value = data[count - 1];
+    if (input)
+    {
+        MPTR = static_cast<uint16_t>(((B + 1) << 8) | C) + step;
+        blockIOFlags(value, value + ((C + step) & 255));
+    }
+    else
+    {
+        MPTR = getBC() + step;
+        blockIOFlags(value, value + L);
     }
 }
\ No newline at end of file
@@ -3,11 +3,15 @@
 #define MAIN_H
 
 #include <cstdint>
-#include <map>
 #include <functional>
 #include <iomanip>
-#include "Bus.hpp"
-class Instruction;
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "BusPolicies.hpp"
+#include "Instruction.hpp"
 
 enum class InterruptMode
 {
@@ -16,6 +20,119 @@ enum class InterruptMode
   Mode2  // Interrupt Mode 2
 };
 
+// How execute() decodes opcodes. Table looks handlers up in the static decode
+// tables, Switch decodes the opcode bits in a switch so handlers can be inlined.
+// Predecoded keeps the decoded prefix chain of every address in a cache and
+// only decodes again after the memory page has been written. Block works like
+// Predecoded for execute(), while runFor() runs whole translated basic blocks.
+// Jit is Block plus native code for hot blocks when built with Z80_JIT.
+enum class ExecutionEngine
+{
+  Table,
+  Switch,
+  Predecoded,
+  Block,
+  Jit
+};
+
+// Z80_JIT builds the x86-64 recompiler. It needs mmap, so native code is only
+// generated on x86-64 Linux; anywhere else the Jit engine runs plain blocks.
+#if defined(Z80_JIT) && defined(__x86_64__) && defined(__linux__)
+#define Z80_JIT_NATIVE
+#endif
+
+#ifndef Z80_DEFAULT_ENGINE
+#define Z80_DEFAULT_ENGINE Table
+#endif
+
+// The bus z80 runs over, Bus unless the build picks one of BusPolicies.hpp
+// with Z80_BUS. Memory accesses call it directly, so each build of the core
+// has its bus inlined.
+#ifndef Z80_BUS
+#define Z80_BUS Bus
+#endif
+using CpuBus = Z80_BUS;
+
+// An instruction decoded at one address, as cached by the Predecoded engine.
+// Operands are still fetched by the handler, so only the prefixes and the
+// opcode have to stay unchanged for the entry to be valid.
+struct DecodedInstruction
+{
+  Operation operation = nullptr; // null when a prefix runs as a NOP
+  uint32_t generation = 0;       // page generation(s) the entry was decoded at
+  uint8_t leadByte = 0;          // first byte at the address
+  uint8_t opCode = 0;            // byte the handler is called with
+  uint8_t prefixLength = 0;      // bytes PC moves before the handler runs
+  uint8_t refresh = 0;           // R increment
+  uint8_t cycles = 0;
+  uint8_t length = 0;            // bytes in the whole instruction
+  uint8_t prefixFetches = 0;     // opcode reads after the first, see chargeFetches()
+  bool endsBlock = false;        // branch, RST, RET, HALT or repeating block op
+  // Index into z80::fusedPairs when this and the next instruction of a block
+  // run as one superinstruction, 0 when they do not
+  uint8_t fusion = 0;
+};
+
+// Straight-line code up to the next instruction that can leave it, as run by
+// the Block engine. Blocks are decoded from at most two adjacent pages.
+struct TranslatedBlock
+{
+  std::vector<DecodedInstruction> instructions;
+  uint16_t start = 0;
+  uint16_t last = 0;             // last byte the block was decoded from
+  uint32_t generation = 0;       // page generation(s) the block was decoded at
+  uint32_t cycles = 0;           // base T-states of the whole block
+  uint32_t cyclesBeforeLast = 0; // T-states until the last instruction starts
+  // The last blocks execution continued with, checked before blockCache
+  TranslatedBlock *successors[2] = {nullptr, nullptr};
+  // Native code of the block, returns false if it stopped early
+  bool (*native)(z80 *cpu) = nullptr;
+  bool staticCode = false;  // native comes from a StaticTranslation, not the JIT
+  uint32_t executions = 0;  // runs since the last translation
+  uint32_t translations = 0;
+  bool countdown = false;   // NOPs and a DJNZ, a delay loop when it branches to itself
+};
+
+// One block of a ROM translated ahead of time by romTranslator. It covers the
+// same bytes as the TranslatedBlock that starts at the same address.
+struct StaticBlock
+{
+  uint16_t start;
+  uint16_t last;
+  bool (*run)(z80 *cpu); // returns false if it stopped early
+};
+
+// C++ generated from a fixed ROM image, see romTranslator/romTranslator.cpp.
+// The checksum is FNV-1a over the first size bytes of the image.
+struct StaticTranslation
+{
+  const char *name;
+  uint32_t size;
+  uint64_t checksum;
+  const StaticBlock *blocks;
+  size_t blockCount;
+};
+
+// 8-bit ALU operations whose flags are built by z80::computeFlags()
+enum class FlagOp : uint8_t
+{
+  None,
+  Add,
+  Adc,
+  Sub,
+  Sbc,
+  Cp,
+  And,
+  Or,
+  Xor,
+  Inc,
+  Dec
+};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The z80 register file assumes a little-endian host"
+#endif
+
 class z80
 {
 
@@ -29,43 +146,173 @@ public:
   static const int Z = 1 << 6;      // Zero flag
   static const int S = 1 << 7;
 
-  InterruptMode interruptMode = InterruptMode::Mode0;
-
-  uint8_t A, B, C, D, E, H, L, F;
-  uint8_t A1, B1, C1, D1, E1, H1, L1, F1;
-  uint8_t I, R;
-  uint16_t IX, IY;
-  uint16_t SP, PC;
+  static constexpr int TSTATES_PER_FRAME = 69888; // 48K Spectrum, 50 Hz
+  static constexpr int TSTATES_PER_LINE = 224;
+  static constexpr int INT_LENGTH = 32; // T-states the ULA holds INT for
+
+  // Register file. Every pair is a 16-bit lane and the 8-bit registers are
+  // views into it, so getHL() is a plain load and EXX swaps three words. The
+  // 3-bit register field of an opcode indexes regs8 through the offset tables
+  // below, where (HL) reads as 0 and writes to a sink byte. Together with
+  // tstates it fills the first cache line of the object.
+  union alignas(64)
+  {
+    uint16_t regs16[16];
+    uint8_t regs8[32];
+    struct
+    {
+      uint16_t BC, DE, HL, SP, AF, PC, IX, IY;
+      uint16_t BC1, DE1, HL1, AF1;
+      uint16_t MPTR;
+    };
+    struct
+    {
+      uint8_t C, B, E, D, L, H, SPl, SPh, F, A;
+      uint8_t PCl, PCh, IXl, IXh, IYl, IYh;
+      uint8_t C1, B1, E1, D1, L1, H1, F1, A1;
+      uint8_t MPTRl, MPTRh, I, R;
+      uint8_t zeroSlot, sinkSlot;
+    };
+  };
+
+  // T-states executed since reset
+  uint64_t tstates;
+  // T-states the last runFor() call ran past its budget
+  uint64_t overshoot;
+  // tstates when an EI last finished. INT is not taken straight after EI,
+  // only once the instruction that follows it has run.
+  uint64_t eiEndedAt;
+  // Deadline of the runFor() call in progress, or of the next bus event if
+  // that is sooner, 0 outside of one. LDIR and LDDR run as many iterations at
+  // once as the call would still start.
+  uint64_t runDeadline = 0;
+
+  // regs8 offsets of B, C, D, E, H, L, (HL), A
+  static constexpr uint8_t readRegisterOffset[8] = {1, 0, 3, 2, 5, 4, 28, 9};
+  static constexpr uint8_t writeRegisterOffset[8] = {1, 0, 3, 2, 5, 4, 29, 9};
+  // regs16 indexes of BC, DE, HL, SP
+  static constexpr uint8_t registerPairIndex[4] = {0, 1, 2, 3};
+  // regs16 indexes of IX and IY. The DD and FD handlers are templates over
+  // one of these, so both prefixes share one implementation and the DD, FD,
+  // DDCB and FDCB tables are built from it. The high and low halves of the
+  // index register are regs8[2 * Index + 1] and regs8[2 * Index].
+  static constexpr uint8_t IX_INDEX = 6;
+  static constexpr uint8_t IY_INDEX = 7;
 
-  uint16_t MPTR;
+  InterruptMode interruptMode = InterruptMode::Mode0;
+  ExecutionEngine engine = ExecutionEngine::Z80_DEFAULT_ENGINE;
 
   bool IFF2;
   bool IFF1;
   bool halted;
 
-  std::map<uint8_t, Instruction> instructionTable;
-  std::map<uint8_t, Instruction> instructionTableDD;
-  std::map<uint8_t, Instruction> instructionTableDDCB;
-  std::map<uint8_t, Instruction> instructionTableFD;
-  std::map<uint8_t, Instruction> instructionTableFDCB;
-  std::map<uint8_t, Instruction> instructionTableED;
-  std::map<uint8_t, Instruction> instructionTableCB;
+  // One flat 256 entry table per prefix, indexed directly by the opcode byte.
+  // The tables are built at compile time and shared by all instances.
+  static const InstructionTable instructionTable;
+  static const InstructionTable instructionTableDD;
+  static const InstructionTable instructionTableDDCB;
+  static const InstructionTable instructionTableFD;
+  static const InstructionTable instructionTableFDCB;
+  static const InstructionTable instructionTableED;
+  static const InstructionTable instructionTableCB;
+
+  // Predecode cache indexed by PC, allocated on first use
+  std::vector<DecodedInstruction> decodeCache;
+  uint64_t decodeCacheHits;
+  uint64_t decodeCacheMisses;
+
+  // Translated blocks indexed by their start address, for the Block engine
+  static constexpr size_t MAX_BLOCK_LENGTH = 64;
+  std::vector<std::unique_ptr<TranslatedBlock>> blockCache;
+  uint64_t blocksExecuted;
+  uint64_t blocksTranslated;
+  uint64_t blocksChained;
+
+  // Superinstructions. translateBlock() marks frequent pairs of adjacent
+  // instructions, which the Block engine then runs through one fused handler
+  // whenever the whole block fits in the T-state budget.
+  bool fuseInstructions = true;
+  uint64_t fusedPairsRun;
+
+  // Pair profiling. Every pair of adjacent instructions in the blocks the
+  // Block engine runs is counted, and topPairs() reports the most frequent
+  // ones as "mnemonic; mnemonic", the candidates for fusion.
+  void enablePairProfile();
+  std::vector<std::pair<std::string, uint64_t>> topPairs(size_t count) const;
+
+  // Ahead of time translated ROM code. The Block and Jit engines run a static
+  // block in place of the interpreted one while the ROM pages it came from
+  // still hold the bytes they held when the translation was attached.
+  // Returns false, and attaches nothing, if memory does not hold the image
+  // the translation was generated from. reset() detaches it again.
+  bool attachStaticTranslation(const StaticTranslation &translation);
+  // Called by the generated code after anything that may have written memory,
+  // so it is kept inline
+  bool staticCodeIntact(uint16_t first, uint16_t last) const
+  {
+    return *staticCounters[first >> 8] == staticGenerations[first >> 8] &&
+           *staticCounters[last >> 8] == staticGenerations[last >> 8];
+  }
+  uint64_t staticBlocksRun;
+
+  // Idle loop skipping. When the Block engine comes back to a block with
+  // every register, memory and the ports as they were last time, and LD A,R
+  // has not run in between, the same loop will run again and again until the
+  // runFor() deadline, since nothing outside the CPU changes before then. Its
+  // remaining iterations are then credited at once, T-states and R included.
+  // DJNZ loops over NOPs are counted down the same way. idleLoops holds the
+  // T-states skipped so far by the lowest block address of each loop. Not
+  // done on a bus that adds waits, where iterations differ in length.
+  bool skipIdleLoops = true;
+  std::unordered_map<uint16_t, uint64_t> idleLoops;
+  // LD A,R executions, the one way a loop can see R
+  uint64_t refreshReads;
+
+#ifdef Z80_JIT
+  // A block is compiled once it has run this often. Blocks that had to be
+  // translated again this often are self-modifying and stay interpreted.
+  static constexpr uint32_t JIT_THRESHOLD = 16;
+  static constexpr uint32_t JIT_MAX_TRANSLATIONS = 4;
+  static constexpr size_t JIT_CODE_SIZE = 4 << 20;
+  // Lowered by test suites so that code run only once is compiled too
+  uint32_t jitThreshold = JIT_THRESHOLD;
+
+  uint8_t *jitCode = nullptr; // mmap'ed, writable only while compiling
+  size_t jitCodeUsed = 0;
+  uint64_t jitBlocksCompiled = 0;
+  uint64_t jitBlocksRun = 0;
+
+  // Differential mode. A second CPU on its own bus runs every block again on
+  // the Table engine, and the registers and memory of both are compared after
+  // each block. Memory is compared page by page where either bus wrote since
+  // the last block. The shadow bus must start out with the same contents.
+  void enableJitDifferential(CpuBus *shadowBus);
+  std::unique_ptr<z80> jitShadow;
+  uint64_t jitMismatches = 0;
+  // Called on every mismatch with the shadow CPU, before the shadow is set
+  // back to the state of this one
+  std::function<void(const z80 &shadow)> onJitMismatch;
+#endif
 
-  Bus *bus;
+  CpuBus *bus = nullptr;
 
   z80();
+#ifdef Z80_JIT
+  ~z80();
+#endif
   // Initialize registers and flags
-  void reset(Bus *bus);
+  void reset(CpuBus *bus);
 
   // Read and Write functions
   uint8_t readFromRegister(uint8_t regIndex);
   uint16_t readFromRegisterPair(uint8_t regIndex);
-  uint16_t readFromRegisterPair2(uint8_t regIndex);
-  uint16_t readFromRegisterPair3(uint8_t regIndex);
   void writeToRegister(uint8_t regIndex, uint8_t value);
   void writeToRegisterPair(uint8_t reg, uint16_t value);
 
   void IncrementRefreshRegister(int steps);
+  // Puts an instruction's base T-states on the clock ahead of its handler
+  void addBaseCycles(uint32_t cycles, int fetches);
+  void chargeFetches(const DecodedInstruction &decoded, bool opcodeRead);
 
   // Flag manipulation functions
   void setFlag(uint8_t flagMask);
@@ -73,26 +320,121 @@ public:
   void toggleFlag(uint8_t flagMask);
   bool isFlagSet(uint8_t flagMask) const;
 
-  // Instruction helpers
-  void initializeInstructionTable();
+  // With Z80_LAZY_FLAGS the ALU helpers only record their operands and F is
+  // built the first time a flag is read. F is always up to date after
+  // runFor() and runFrame(). Anyone reading F directly after execute() or
+  // run() should use getF() or call resolveFlags() first.
+  void resolveFlags();
+  uint8_t getF();
+  void setF(uint8_t value);
 
   // Execution of instructions
   void execute(uint8_t opCode);
+  void executeTable(uint8_t opCode);
+  void executeSwitch(uint8_t opCode);
+  void executePredecoded(uint8_t opCode);
+  void runBlocks(uint64_t deadline);
   void run(uint8_t opCode);
+  uint64_t runFor(uint64_t budget);
+  uint64_t runFrame();
   void handleInterrupt(InterruptMode interruptMode);
+  // Runs the bus events that are due and samples INT after them
+  void runDueEvents();
+  void sampleInterrupt();
+  // Id of the frame interrupt event runFrame() scheduled on the bus, -1 until
+  // then, and the frame length it repeats at
+  int frameEvent = -1;
+  uint32_t frameEventLength = 0;
+
+private:
+  friend class RomTranslator;
+
+  // A pair of handlers that runs as one superinstruction
+  struct FusedPair
+  {
+    Operation first;
+    Operation second;
+    bool (z80::*run)(const DecodedInstruction *pair);
+  };
+  static const FusedPair fusedPairs[];
+  template <Operation First, Operation Second, bool FirstWrites>
+  bool runFused(const DecodedInstruction *pair);
+  void fuseBlock(TranslatedBlock &block);
+  // Blocks a loop may run before the snapshot moves on to a later block
+  static constexpr uint32_t IDLE_LOOP_BLOCKS = 64;
+  // State at the block an idle loop would start from, see skipIdleLoops
+  struct IdleSnapshot
+  {
+    const TranslatedBlock *head = nullptr;
+    uint32_t blocksSince = IDLE_LOOP_BLOCKS; // blocks run since head, none taken yet
+    uint16_t lowest;          // lowest block address since head, which names the loop
+    uint64_t tstates;
+    uint16_t registers[13];   // BC to MPTR
+    uint8_t I, R;
+    bool IFF1, IFF2;
+    InterruptMode interruptMode;
+    uint64_t memoryChanges;
+    uint64_t portSideEffects;
+    uint64_t refreshReads;
+  };
+  static bool isCountdown(const TranslatedBlock &block);
+  void takeIdleSnapshot(IdleSnapshot &idle, const TranslatedBlock &head);
+  void checkIdleLoop(IdleSnapshot &idle, const TranslatedBlock &block, uint64_t deadline);
+
+  bool pairProfiling = false;
+  std::unordered_map<uint32_t, uint64_t> pairCounts; // by instructionKey() pair
+  uint16_t instructionKey(const DecodedInstruction &decoded) const;
+  const Instruction &instructionForKey(uint16_t key) const;
+
+  std::vector<const StaticBlock *> staticBlocks; // indexed by start address
+  std::vector<uint32_t> staticGenerations;       // page generations at attach
+  std::vector<const uint32_t *> staticCounters;  // and where they are counted
+
+  void decodeInstruction(uint16_t address, DecodedInstruction &decoded);
+  uint32_t decodeGeneration(uint16_t address);
+  TranslatedBlock &findBlock(uint16_t address);
+#ifdef Z80_JIT
+  bool compileBlock(TranslatedBlock &block);
+  void flushJitCode();
+  void syncJitShadow();
+  bool compareJitShadowMemory(bool repair);
+  // Page generations of this bus and the shadow's at the last comparison
+  std::vector<uint32_t> jitShadowGenerations;
+#endif
+  void translateBlock(uint16_t address, TranslatedBlock &block);
+  uint32_t blockGeneration(const TranslatedBlock &block);
+  void skipHalted(uint64_t until);
+  void repeatBlockCopy(int step);
+  void repeatBlockSearch(int step);
+  void repeatBlockIO(bool input, int step);
+  uint32_t iterationsBeforeSelfWrite(uint16_t destination, int step);
+  void executeSwitchCB(uint8_t opCode);
+  template <uint8_t Index>
+  void executeSwitchIndexCB(uint8_t opCode);
+  template <uint8_t Index>
+  bool executeSwitchIndex(uint8_t opCode);
+  bool executeSwitchED(uint8_t opCode);
+
+public:
 
   // Instruction implementations
   void LD_R_R(uint8_t opCode);
+  // The decode tables hold one instantiation of the templated handlers per
+  // opcode, with the register fields (0-7 for B, C, D, E, H, L, (HL), A) and
+  // the bit number as template arguments, so each one is a couple of moves.
+  // The plain forms decode the fields at runtime and serve executeSwitch().
+  template <uint8_t Destination, uint8_t Source>
+  void LD_R_R(uint8_t opCode);
   void LD_R_N(uint8_t opCode);
   void LD_R_HL(uint8_t opCode);
-  void LD_R_IX_D(uint8_t opCode);
-  void LD_R_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_R_XY_D(uint8_t opCode);
   void LD_HL_R(uint8_t opCode);
-  void LD_IX_D_R(uint8_t opCode);
-  void LD_IY_D_R(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XY_D_R(uint8_t opCode);
   void LD_HL_N(uint8_t opCode);
-  void LD_IX_D_N(uint8_t opCode);
-  void LD_IY_D_N(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XY_D_N(uint8_t opCode);
   void LD_A_BC(uint8_t opCode);
   void LD_A_DE(uint8_t opCode);
   void LD_A_NN(uint8_t opCode);
@@ -104,107 +446,110 @@ public:
   void LD_R_A(uint8_t opCode);
   void LD_BC_A(uint8_t opCode);
 
-  void LD_R_IXH(uint8_t opCode);
-  void LD_IXH_R(uint8_t opCode);
-  void LD_R_IXl(uint8_t opCode);
-  void LD_IXH_IXL(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_R_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYH_R(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_R_XYL(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYH_XYL(uint8_t opCode);
 
-  void LD_IXl_R(uint8_t opCode);
-  void LD_R_IXh(uint8_t opCode);
-  void LD_IXL_IXH(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYL_R(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYL_XYH(uint8_t opCode);
 
-  void ADD_A_IX_H(uint8_t opCode);
-  void ADD_A_IX_L(uint8_t opCode);
+  template <uint8_t Index>
+  void ADD_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void ADD_A_XYL(uint8_t opCode);
 
-  void SUB_A_IX_H(uint8_t opCode);
-  void SUB_A_IX_L(uint8_t opCode);
+  template <uint8_t Index>
+  void SUB_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void SUB_A_XYL(uint8_t opCode);
 
-  void SUB_A_IY_H(uint8_t opCode);
-  void SUB_A_IY_L(uint8_t opCode);
 
-  void SBC_A_IX_H(uint8_t opCode);
-  void SBC_A_IX_L(uint8_t opCode);
+  template <uint8_t Index>
+  void SBC_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void SBC_A_XYL(uint8_t opCode);
 
-  void SBC_A_IY_H(uint8_t opCode);
-  void SBC_A_IY_L(uint8_t opCode);
 
-  void ADC_A_IX_H(uint8_t opCode);
-  void ADC_A_IX_L(uint8_t opCode);
+  template <uint8_t Index>
+  void ADC_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void ADC_A_XYL(uint8_t opCode);
 
-  void ADC_A_IY_H(uint8_t opCode);
-  void ADC_A_IY_L(uint8_t opCode);
 
-  void AND_A_IX_H(uint8_t opCode);
-  void AND_A_IX_L(uint8_t opCode);
-  void XOR_A_IX_H(uint8_t opCode);
-  void XOR_A_IX_L(uint8_t opCode);
-  void OR_A_IX_H(uint8_t opCode);
-  void OR_A_IX_L(uint8_t opCode);
+  template <uint8_t Index>
+  void AND_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void AND_A_XYL(uint8_t opCode);
+  template <uint8_t Index>
+  void XOR_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void XOR_A_XYL(uint8_t opCode);
+  template <uint8_t Index>
+  void OR_A_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void OR_A_XYL(uint8_t opCode);
 
-  void AND_A_IY_H(uint8_t opCode);
-  void AND_A_IY_L(uint8_t opCode);
-  void XOR_A_IY_H(uint8_t opCode);
-  void XOR_A_IY_L(uint8_t opCode);
-  void OR_A_IY_H(uint8_t opCode);
-  void OR_A_IY_L(uint8_t opCode);
 
-  void CP_IX_H(uint8_t opCode);
-  void CP_IX_L(uint8_t opCode);
-  void SLS_IX_D(uint8_t opCode);
+  template <uint8_t Index>
+  void CP_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void CP_XYL(uint8_t opCode);
+  template <uint8_t Index>
+  void SLS_XY_D(uint8_t opCode);
 
-  void CP_A_IY_H(uint8_t opCode);
-  void CP_A_IY_L(uint8_t opCode);
-  void SLS_IY_D(uint8_t opCode);
 
-  void INC_IY_H(uint8_t opCode);
-  void INC_IY_L(uint8_t opCode);
+  template <uint8_t Index>
+  void INC_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void INC_XYL(uint8_t opCode);
 
-  void DEC_IY_H(uint8_t opCode);
-  void DEC_IY_L(uint8_t opCode);
+  template <uint8_t Index>
+  void DEC_XYH(uint8_t opCode);
+  template <uint8_t Index>
+  void DEC_XYL(uint8_t opCode);
 
-  void LD_IY_H_N(uint8_t opCode);
-  void LD_IY_L_N(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYH_N(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XYL_N(uint8_t opCode);
 
-  void LD_R_IY_H(uint8_t opCode);
-  void LD_R_IY_L(uint8_t opCode);
 
-  void LD_IY_H_R(uint8_t opCode);
-  void LD_IY_L_R(uint8_t opCode);
 
-  void LD_IYH_IYL(uint8_t opCode);
-  void LD_IYL_IYH(uint8_t opCode);
 
-  void ADD_A_IY_L(uint8_t opCode);
-  void ADD_A_IY_H(uint8_t opCode);
 
   void LD_DD_NN(uint8_t opCode);
-  void LD_IX_NN(uint8_t opCode);
-  void LD_IXH_N(uint8_t opCode);
-  void LD_IXl_N(uint8_t opCode);
-  void LD_IY_NN(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XY_NN(uint8_t opCode);
   void LD_HL_NN(uint8_t opCode);
   void LD_DD_nn(uint8_t opCode);
-  void LD_IX_NN2(uint8_t opCode);
-  void LD_IY_NN2(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_XY_NN2(uint8_t opCode);
   void LD_NN_HL(uint8_t opCode);
   void LD_NN_DD(uint8_t opCode);
-  void LD_NN_IX(uint8_t opCode);
-  void LD_NN_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_NN_XY(uint8_t opCode);
   void LD_SP_HL(uint8_t opCode);
-  void LD_SP_IX(uint8_t opCode);
-  void LD_SP_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void LD_SP_XY(uint8_t opCode);
   void PUSH_QQ(uint8_t opCode);
-  void PUSH_IX(uint8_t opCode);
-  void PUSH_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void PUSH_XY(uint8_t opCode);
   void POP_QQ(uint8_t opCode);
-  void POP_IX(uint8_t opCode);
-  void POP_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void POP_XY(uint8_t opCode);
 
   void EX_DE_HL(uint8_t opCode);
   void EX_AF_AF1(uint8_t opCode);
   void EX_SP_HL(uint8_t opCode);
-  void EX_SP_IX(uint8_t opCode);
-  void EX_SP_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void EX_SP_XY(uint8_t opCode);
   void LDI(uint8_t opCode);
   void EXX(uint8_t opCode);
   void LDIR(uint8_t opCode);
@@ -215,63 +560,67 @@ public:
   void CPD(uint8_t opCode);
   void CPDR(uint8_t opCode);
 
+  void ADD_A_R(uint8_t opCode);
+  template <uint8_t Source>
   void ADD_A_R(uint8_t opCode);
   void ADD_A_N(uint8_t opCode);
   void ADD_A_HL(uint8_t opCode);
-  void ADD_A_IX_D(uint8_t opCode);
-  void ADD_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void ADD_A_XY_D(uint8_t opCode);
   void ADC_A_s(uint8_t opCode);
   void ADC_A_N(uint8_t opCode);
   void ADC_A_HL(uint8_t opCode);
-  void ADC_A_IX_D(uint8_t opCode);
-  void ADC_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void ADC_A_XY_D(uint8_t opCode);
   void SUB_S(uint8_t opCode);
   void SUB_A_N(uint8_t opCode);
   void SUB_A_HL(uint8_t opCode);
-  void SUB_A_IX_D(uint8_t opCode);
-  void SUB_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SUB_A_XY_D(uint8_t opCode);
   void SUB_A_S(uint8_t opCode);
   void SUB_A_R(uint8_t opCode);
   void SBC_A_S(uint8_t opCode);
   void SBC_A_N(uint8_t opCode);
   void SBC_A_HL(uint8_t opCode);
-  void SBC_A_IX_D(uint8_t opCode);
-  void SBC_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SBC_A_XY_D(uint8_t opCode);
   void AND_S(uint8_t opCode);
   void OR_S(uint8_t opCode);
   void XOR_S(uint8_t opCode);
   void CP_S(uint8_t opCode);
   void INC_R(uint8_t opCode);
+  template <uint8_t Target>
+  void INC_R(uint8_t opCode);
   void INC_HL(uint8_t opCode);
-  void INC_IX_D(uint8_t opCode);
-  void INC_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void INC_XY_D(uint8_t opCode);
   void DEC_M(uint8_t opCode);
   void AND_A_R(uint8_t opCode);
   void AND_A_N(uint8_t opCode);
   void AND_A_HL(uint8_t opCode);
-  void AND_A_IX_D(uint8_t opCode);
-  void AND_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void AND_A_XY_D(uint8_t opCode);
   void OR_A_R(uint8_t opCode);
   void OR_A_N(uint8_t opCode);
   void OR_A_HL(uint8_t opCode);
-  void OR_A_IX_D(uint8_t opCode);
-  void OR_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void OR_A_XY_D(uint8_t opCode);
   void XOR_A_R(uint8_t opCode);
   void XOR_A_N(uint8_t opCode);
   void XOR_A_HL(uint8_t opCode);
-  void XOR_A_IX_D(uint8_t opCode);
-  void XOR_A_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void XOR_A_XY_D(uint8_t opCode);
 
   void CP_R(uint8_t opCode);
   void CP_N(uint8_t opCode);
   void CP_HL(uint8_t opCode);
-  void CP_IX_D(uint8_t opCode);
-  void CP_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void CP_XY_D(uint8_t opCode);
 
   void DEC_R(uint8_t opCode);
   void DEC_HL(uint8_t opCode);
-  void DEC_IX_D(uint8_t opCode);
-  void DEC_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void DEC_XY_D(uint8_t opCode);
 
   void DAA(uint8_t opCode);
   void CPL(uint8_t opCode);
@@ -289,20 +638,14 @@ public:
   void ADD_HL_SS(uint8_t opCode);
   void ADC_HL_SS(uint8_t opCode);
   void SBC_HL_SS(uint8_t opCode);
-  void ADD_IX_PP(uint8_t opCode);
-  void ADD_IY_RR(uint8_t opCode);
+  template <uint8_t Index>
+  void ADD_XY_PP(uint8_t opCode);
   void INC_SS(uint8_t opCode);
-  void INC_IX(uint8_t opCode);
-  void INC_IXH(uint8_t opCode);
-  void INC_IXl(uint8_t opCode);
-  void DEC_IXH(uint8_t opCode);
-  void DEC_IXl(uint8_t opCode);
-  void INC_IY(uint8_t opCode);
-  void INC_IYH(uint8_t opCode);
-  void DEC_IYH(uint8_t opCode);
+  template <uint8_t Index>
+  void INC_XY(uint8_t opCode);
   void DEC_SS(uint8_t opCode);
-  void DEC_IX(uint8_t opCode);
-  void DEC_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void DEC_XY(uint8_t opCode);
 
   void RLCA(uint8_t opCode);
   void RLA(uint8_t opCode);
@@ -310,49 +653,55 @@ public:
   void RRA(uint8_t opCode);
   void RLC_R(uint8_t opCode);
   void RLC_HL(uint8_t opCode);
-  void RLC_IX_D(uint8_t opCode);
-  void RLC_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void RLC_XY_D(uint8_t opCode);
   void RL_R(uint8_t opCode);
   void RL_HL(uint8_t opCode);
-  void RL_IX_D(uint8_t opCode);
-  void RL_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void RL_XY_D(uint8_t opCode);
   void RRC_R(uint8_t opCode);
   void RRC_HL(uint8_t opCode);
-  void RRC_IX_D(uint8_t opCode);
-  void RRC_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void RRC_XY_D(uint8_t opCode);
   void RR_R(uint8_t opCode);
   void RR_HL(uint8_t opCode);
-  void RR_IX_D(uint8_t opCode);
-  void RR_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void RR_XY_D(uint8_t opCode);
   void SLA_R(uint8_t opCode);
   void SLA_HL(uint8_t opCode);
-  void SLA_IX_D(uint8_t opCode);
-  void SLA_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SLA_XY_D(uint8_t opCode);
   void SRA_R(uint8_t opCode);
   void SLS_R(uint8_t opCode);
   void SLS_HL(uint8_t opCode);
   void SRA_HL(uint8_t opCode);
-  void SRA_IX_D(uint8_t opCode);
-  void SRA_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SRA_XY_D(uint8_t opCode);
   void SRL_R(uint8_t opCode);
   void SRL_HL(uint8_t opCode);
-  void SRL_IX_D(uint8_t opCode);
-  void SRL_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SRL_XY_D(uint8_t opCode);
   void RLD(uint8_t opCode);
   void RRD(uint8_t opCode);
 
+  void BIT_B_R(uint8_t opCode);
+  template <uint8_t Bit, uint8_t Source>
   void BIT_B_R(uint8_t opCode);
   void BIT_B_HL(uint8_t opCode);
-  void BIT_B_IX_D(uint8_t opCode);
-  void BIT_B_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void BIT_B_XY_D(uint8_t opCode);
+  void SET_B_R(uint8_t opCode);
+  template <uint8_t Bit, uint8_t Target>
   void SET_B_R(uint8_t opCode);
   void SET_B_HL(uint8_t opCode);
-  void SET_B_IX_D(uint8_t opCode);
-  void SET_B_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void SET_B_XY_D(uint8_t opCode);
+  void RES_B_R(uint8_t opCode);
+  template <uint8_t Bit, uint8_t Target>
   void RES_B_R(uint8_t opCode);
   void RES_B_HL(uint8_t opCode);
-  void RES_B_IX_D(uint8_t opCode);
-  void RES_B_IY_D(uint8_t opCode);
+  template <uint8_t Index>
+  void RES_B_XY_D(uint8_t opCode);
 
   void JP_NN(uint8_t opCode);
   void JP_CC_NN(uint8_t opCode);
@@ -362,8 +711,8 @@ public:
   void JR_Z_E(uint8_t opCode);
   void JR_NZ_E(uint8_t opCode);
   void JP_HL(uint8_t opCode);
-  void JP_IX(uint8_t opCode);
-  void JP_IY(uint8_t opCode);
+  template <uint8_t Index>
+  void JP_XY(uint8_t opCode);
   void DJNZ_E(uint8_t opCode);
 
   void CALL_NN(uint8_t opCode);
@@ -390,6 +739,11 @@ public:
   // Helper to fetch immediate data
   uint8_t fetchImmediate();
   uint8_t fetchHL();
+  template <uint8_t Index>
+  uint16_t indexedAddress();
+  template <uint8_t Index>
+  uint16_t indexedBitAddress();
+  void writeIndexedResult(uint16_t address, uint8_t opCode, uint8_t value);
   uint8_t fetchIX();
   uint16_t getBC();
   uint16_t getDE();
@@ -412,12 +766,15 @@ public:
 
   uint8_t Add8_Bit(uint8_t a, uint8_t b);
   uint8_t Sub8_Bit(uint8_t a, uint8_t b);
+  uint8_t Adc8_Bit(uint8_t a, uint8_t b);
+  uint8_t Sbc8_Bit(uint8_t a, uint8_t b);
   uint8_t And8_Bit(uint8_t a, uint8_t b);
   uint8_t Or8_Bit(uint8_t a, uint8_t b);
   uint8_t Xor8_Bit(uint8_t a, uint8_t b);
   uint8_t CP_Flags(uint8_t a, uint8_t b);
   void IncFlags(uint8_t value, uint8_t result);
   void DecFlags(uint8_t value, uint8_t result);
+  void blockIOFlags(uint8_t value, uint16_t k);
   void rotateFlags(uint8_t value);
   void shiftFlags(uint8_t value);
   void shiftFlags2(uint8_t value);
@@ -429,8 +786,18 @@ public:
   uint16_t Sub16_Bit(uint16_t a, uint16_t b);
   uint16_t getPageZeroAddress(uint8_t value);
 
-  bool isEvenParity(uint8_t result);
+  bool isEvenParity(uint8_t result) const;
   bool evaluateCC(uint8_t result);
+
+  void updateFlags(FlagOp op, uint8_t a, uint8_t b, uint8_t result);
+  uint8_t computeFlags(FlagOp op, uint8_t a, uint8_t b, uint8_t result) const;
+  void replaceFlags(uint8_t keepMask, uint8_t flags);
+
+#ifdef Z80_LAZY_FLAGS
+  // Last ALU operation whose flags have not been written to F yet
+  FlagOp lazyOp;
+  uint8_t lazyA, lazyB, lazyResult;
+#endif
 };
 
 #endif
@@ -0,0 +1,409 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+
+// Ahead of time translation of a fixed ROM image, like 48.rom, into C++.
+//
+// Code is found by recursive descent from the reset, RST and NMI vectors,
+// following jumps, calls and fall through. Targets that are only known at run
+// time, like the jump tables of the calculator, can be found by booting the
+// ROM for a number of frames first and starting from every block that ran.
+//
+// Every block is cut exactly like z80::translateBlock() cuts it, so at run
+// time the generated function stands in for the TranslatedBlock starting at
+// the same address (see z80::attachStaticTranslation()). Register moves and
+// jumps become plain C++ on the z80 register file, everything else calls its
+// handler through the decode tables. Blocks that the generated code does not
+// cover, and anything in RAM, keep running on the interpreter.
+//
+// Usage: romTranslator <rom path> <output.cpp> [name] [trace frames]
+
+namespace
+{
+const char *const registerNames[8] = {"B", "C", "D", "E", "H", "L", nullptr, "A"};
+const char *const registerPairNames[4] = {"BC", "DE", "HL", "SP"};
+
+std::string hex(unsigned value, int digits)
+{
+    char text[8];
+    std::snprintf(text, sizeof(text), "%0*X", digits, value);
+    return std::string("0x") + text;
+}
+}
+
+class RomTranslator
+{
+public:
+    RomTranslator(const std::string &romPath) : memory(0x10000), bus(memory)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            bus.KeyMatrix[i] = 0xFF; // No keys pressed
+        }
+        romSize = static_cast<uint32_t>(bus.readAllBytes(romPath).size());
+        if (romSize == 0 || romSize > 0x10000)
+        {
+            throw std::runtime_error("Unsupported ROM size: " + romPath);
+        }
+        bus.loadROM(romPath);
+        cpu.reset(&bus);
+    }
+
+    // Every block reachable from address
+    void discover(uint16_t address)
+    {
+        std::vector<uint16_t> pending = {address};
+        while (!pending.empty())
+        {
+            uint16_t start = pending.back();
+            pending.pop_back();
+            if (start >= romSize || blocks.count(start) != 0)
+                continue;
+
+            TranslatedBlock &block = blocks[start];
+            cpu.translateBlock(start, block);
+            if (block.last >= romSize)
+            {
+                // Runs on into RAM, leave it to the interpreter
+                blocks.erase(start);
+                continue;
+            }
+            for (uint16_t next : successors(block))
+            {
+                pending.push_back(next);
+            }
+        }
+    }
+
+    // Boots the ROM for frames frames and discovers from every block that ran
+    void trace(uint64_t frames)
+    {
+        Memory traceMemory(0x10000);
+        Bus traceBus(traceMemory);
+        for (int i = 0; i < 8; ++i)
+        {
+            traceBus.KeyMatrix[i] = 0xFF;
+        }
+        for (uint32_t address = 0; address < romSize; ++address)
+        {
+            traceBus.write(address, bus.read(address));
+        }
+
+        z80 traceCpu;
+        traceCpu.reset(&traceBus);
+        traceCpu.engine = ExecutionEngine::Block;
+        for (uint64_t i = 0; i < frames; ++i)
+        {
+            traceCpu.runFrame();
+        }
+
+        for (uint32_t address = 0; address < romSize && address < traceCpu.blockCache.size(); ++address)
+        {
+            if (traceCpu.blockCache[address])
+            {
+                discover(address);
+            }
+        }
+    }
+
+    void write(std::ostream &out, const std::string &name)
+    {
+        uint64_t checksum = 1469598103934665603ull;
+        for (uint32_t address = 0; address < romSize; ++address)
+        {
+            checksum ^= bus.read(address);
+            checksum *= 1099511628211ull;
+        }
+
+        out << "// Generated by romTranslator, do not edit.\n"
+            << "// " << blocks.size() << " blocks of a " << romSize << " byte ROM.\n"
+            << "#include <utility>\n"
+            << "#include \"main.hpp\"\n\n"
+            << "namespace\n{\n";
+        for (const auto &entry : blocks)
+        {
+            emitBlock(out, entry.second);
+        }
+        out << "}\n\n";
+
+        out << "static const StaticBlock " << name << "Blocks[] = {\n";
+        for (const auto &entry : blocks)
+        {
+            out << "    {" << hex(entry.second.start, 4) << ", " << hex(entry.second.last, 4)
+                << ", block" << hex(entry.second.start, 4).substr(2) << "},\n";
+        }
+        out << "};\n\n";
+
+        char checksumText[24];
+        std::snprintf(checksumText, sizeof(checksumText), "0x%016llXull", static_cast<unsigned long long>(checksum));
+        out << "extern const StaticTranslation " << name << "Translation;\n"
+            << "const StaticTranslation " << name << "Translation = {\"" << name << "\", " << romSize << ", "
+            << checksumText << ", " << name << "Blocks, " << blocks.size() << "};\n";
+    }
+
+    size_t blockCount() const { return blocks.size(); }
+
+private:
+    Memory memory;
+    Bus bus;
+    z80 cpu;
+    uint32_t romSize;
+    std::map<uint16_t, TranslatedBlock> blocks;
+
+    uint16_t word(uint16_t address)
+    {
+        return bus.read(address) | (bus.read(address + 1) << 8);
+    }
+
+    // Address of the last instruction of a block
+    uint16_t lastInstruction(const TranslatedBlock &block)
+    {
+        uint16_t pc = block.start;
+        for (size_t i = 0; i + 1 < block.instructions.size(); ++i)
+        {
+            pc += block.instructions[i].length;
+        }
+        return pc;
+    }
+
+    // Where execution can go after the block, as far as the code shows
+    std::vector<uint16_t> successors(const TranslatedBlock &block)
+    {
+        const DecodedInstruction &decoded = block.instructions.back();
+        const uint16_t pc = lastInstruction(block);
+        const uint16_t next = pc + decoded.length;
+        const uint8_t op = decoded.opCode;
+        if (!decoded.endsBlock || decoded.operation == nullptr)
+            return {next};
+
+        if (decoded.prefixLength == 0)
+        {
+            const uint8_t x = op >> 6, y = (op >> 3) & 7, z = op & 7;
+            if (op == 0xC3)
+                return {word(pc + 1)};
+            if (op == 0x18)
+                return {static_cast<uint16_t>(next + static_cast<int8_t>(bus.read(pc + 1)))};
+            if (op == 0x10 || (x == 0 && z == 0 && y >= 4))
+                return {static_cast<uint16_t>(next + static_cast<int8_t>(bus.read(pc + 1))), next};
+            if (op == 0xCD || (x == 3 && (z == 2 || z == 4)))
+                return {word(pc + 1), next};
+            if (x == 3 && z == 7)
+                return {static_cast<uint16_t>(y * 8), next};
+            if (op == 0xC9 || op == 0xE9)
+                return {};
+            return {next};
+        }
+
+        if (decoded.leadByte == 0xED)
+        {
+            if ((op >> 6) == 1 && (op & 7) == 5)
+                return {}; // RETN and RETI
+            if ((op >> 6) == 2)
+                return {pc, next}; // Repeats from its own address
+        }
+        if (decoded.leadByte != 0xED && op == 0xE9)
+            return {}; // JP (IX) and JP (IY)
+        return {next};
+    }
+
+    // The decode table entry the handler was taken from, for the mnemonic
+    std::string tableFor(const DecodedInstruction &decoded, uint16_t pc)
+    {
+        if (decoded.prefixLength == 0)
+            return "instructionTable";
+        if (decoded.leadByte == 0xED)
+            return "instructionTableED";
+        if (decoded.leadByte == 0xCB)
+            return "instructionTableCB";
+        std::string index = decoded.leadByte == 0xDD ? "DD" : "FD";
+        return "instructionTable" + index + (bus.read(pc + 1) == 0xCB ? "CB" : "");
+    }
+
+    void emitBlock(std::ostream &out, const TranslatedBlock &block)
+    {
+        out << "// " << hex(block.start, 4) << "-" << hex(block.last, 4) << "\n"
+            << "bool block" << hex(block.start, 4).substr(2) << "(z80 *cpu)\n{\n";
+
+        uint32_t pendingRefresh = 0;
+        uint32_t pendingCycles = 0;
+        bool pcWritten = false;
+        auto flush = [&]()
+        {
+            if ((pendingRefresh & 0x7F) != 0)
+            {
+                out << "    cpu->R = (cpu->R & 0x80) | ((cpu->R + " << (pendingRefresh & 0x7F) << ") & 0x7F);\n";
+            }
+            if (pendingCycles != 0)
+            {
+                out << "    cpu->tstates += " << pendingCycles << ";\n";
+            }
+            pendingRefresh = pendingCycles = 0;
+        };
+
+        uint16_t pc = block.start;
+        for (size_t i = 0; i < block.instructions.size(); ++i)
+        {
+            const DecodedInstruction &decoded = block.instructions[i];
+            const bool last = i + 1 == block.instructions.size();
+            const bool plain = decoded.prefixLength == 0;
+            const uint16_t next = pc + decoded.length;
+            const Operation operation = decoded.operation;
+            const uint8_t op = decoded.opCode;
+            const uint8_t source = op & 7, destination = (op >> 3) & 7, pair = (op >> 4) & 3;
+            pendingRefresh += decoded.refresh;
+            pendingCycles += decoded.cycles;
+
+            if (operation != nullptr)
+            {
+                const std::string table = tableFor(decoded, pc);
+                const Instruction *instruction = table == "instructionTable"     ? &z80::instructionTable[op]
+                                                 : table == "instructionTableED" ? &z80::instructionTableED[op]
+                                                 : table == "instructionTableCB" ? &z80::instructionTableCB[op]
+                                                 : table == "instructionTableDD" ? &z80::instructionTableDD[op]
+                                                 : table == "instructionTableFD" ? &z80::instructionTableFD[op]
+                                                 : table == "instructionTableDDCB"
+                                                     ? &z80::instructionTableDDCB[op]
+                                                     : &z80::instructionTableFDCB[op];
+                out << "    // " << hex(pc, 4) << " " << instruction->getMnemonic() << "\n";
+            }
+
+            if (operation == nullptr || (plain && operation == &z80::NOP))
+            {
+                // A NOP, or a prefix that runs as one
+            }
+            else if (plain && (op & 0xC0) == 0x40 && source != 6 && destination != 6) // LD r, r'
+            {
+                out << "    cpu->" << registerNames[destination] << " = cpu->" << registerNames[source] << ";\n";
+            }
+            else if (plain && operation == &z80::LD_R_N && destination != 6)
+            {
+                out << "    cpu->" << registerNames[destination] << " = " << hex(bus.read(pc + 1), 2) << ";\n";
+            }
+            else if (plain && operation == &z80::LD_DD_NN)
+            {
+                out << "    cpu->" << registerPairNames[pair] << " = " << hex(word(pc + 1), 4) << ";\n";
+            }
+            else if (plain && operation == &z80::INC_SS)
+            {
+                out << "    ++cpu->" << registerPairNames[pair] << ";\n";
+            }
+            else if (plain && operation == &z80::DEC_SS)
+            {
+                out << "    --cpu->" << registerPairNames[pair] << ";\n";
+            }
+            else if (plain && operation == &z80::LD_SP_HL)
+            {
+                out << "    cpu->SP = cpu->HL;\n";
+            }
+            else if (plain && operation == &z80::EX_DE_HL)
+            {
+                out << "    std::swap(cpu->DE, cpu->HL);\n";
+            }
+            else if (plain && operation == &z80::EXX)
+            {
+                out << "    std::swap(cpu->BC, cpu->BC1);\n"
+                    << "    std::swap(cpu->DE, cpu->DE1);\n"
+                    << "    std::swap(cpu->HL, cpu->HL1);\n";
+            }
+            else if (plain && operation == &z80::DI)
+            {
+                out << "    cpu->IFF1 = cpu->IFF2 = false;\n";
+            }
+            else if (plain && last && (operation == &z80::JP_NN || operation == &z80::JR_E))
+            {
+                uint16_t target = operation == &z80::JP_NN ? word(pc + 1)
+                                                           : next + static_cast<int8_t>(bus.read(pc + 1));
+                flush();
+                out << "    cpu->PC = cpu->MPTR = " << hex(target, 4) << ";\n";
+                pcWritten = true;
+            }
+            else if (plain && last && (operation == &z80::JR_NZ_E || operation == &z80::JR_Z_E ||
+                                       operation == &z80::JR_NC_E || operation == &z80::JR_C_E))
+            {
+                uint16_t target = next + static_cast<int8_t>(bus.read(pc + 1));
+                const char *flag = (operation == &z80::JR_NZ_E || operation == &z80::JR_Z_E) ? "z80::Z" : "z80::C_flag";
+                bool taken = operation == &z80::JR_Z_E || operation == &z80::JR_C_E;
+                flush();
+                out << "    if (" << (taken ? "" : "!") << "cpu->isFlagSet(" << flag << "))\n"
+                    << "    {\n"
+                    << "        cpu->tstates += 5;\n"
+                    << "        cpu->PC = cpu->MPTR = " << hex(target, 4) << ";\n"
+                    << "    }\n"
+                    << "    else\n"
+                    << "    {\n"
+                    << "        cpu->PC = " << hex(next, 4) << ";\n"
+                    << "    }\n";
+                pcWritten = true;
+            }
+            else
+            {
+                flush();
+                out << "    cpu->PC = " << hex(uint16_t(pc + decoded.prefixLength), 4) << ";\n"
+                    << "    (cpu->*z80::" << tableFor(decoded, pc) << "[" << hex(op, 2) << "].getOperation())("
+                    << hex(op, 2) << ");\n";
+                if (last)
+                {
+                    out << "    cpu->PC++;\n";
+                    pcWritten = true;
+                }
+                else
+                {
+                    out << "    if (!cpu->staticCodeIntact(" << hex(block.start, 4) << ", " << hex(block.last, 4)
+                        << "))\n"
+                        << "    {\n"
+                        << "        cpu->PC = " << hex(next, 4) << ";\n"
+                        << "        return false;\n"
+                        << "    }\n";
+                }
+            }
+            pc = next;
+        }
+
+        flush();
+        if (!pcWritten)
+        {
+            out << "    cpu->PC = " << hex(pc, 4) << ";\n";
+        }
+        out << "    return true;\n}\n\n";
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: romTranslator <rom path> <output.cpp> [name] [trace frames]" << std::endl;
+        return 1;
+    }
+    std::string name = argc > 3 ? argv[3] : "rom";
+    uint64_t frames = argc > 4 ? std::stoull(argv[4]) : 0;
+
+    RomTranslator translator(argv[1]);
+    translator.discover(0x0000);
+    for (uint16_t vector = 0x08; vector <= 0x38; vector += 8)
+    {
+        translator.discover(vector);
+    }
+    translator.discover(0x0066);
+    translator.trace(frames);
+
+    std::ostringstream source;
+    translator.write(source, name);
+    std::ofstream out(argv[2]);
+    if (!out)
+    {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    out << source.str();
+    std::cout << "romTranslator: " << translator.blockCount() << " blocks written to " << argv[2] << std::endl;
+    return 0;
+}
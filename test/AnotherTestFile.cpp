@@ -3,6 +3,7 @@
 #include "../Bus.cpp"
 #include "../Memory.cpp"
 #include "../Instruction.cpp"
+#include "Step.hpp"
 
 class GeneralPurposeGroupTest : public ::testing::Test
 {
@@ -27,9 +28,9 @@ TEST_F(GeneralPurposeGroupTest, DAA)
     // Write and execute the DAA instruction
     bus.write(cpu.PC, 0x80);
     bus.write(cpu.PC + 1, 0x27); // Opcode for DAA
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.A, 0x3C);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0x42); // After DAA, A should hold the correct BCD result (42)
 
@@ -48,7 +49,7 @@ TEST_F(GeneralPurposeGroupTest, DAASubtractionNegativeResult)
     cpu.B = 0x27; // Set B register to 27 in BCD (0010 0111)
     // SUB A, B (A = A - B)
     bus.write(cpu.PC, 0x90); // Opcode for SUB B
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.A, 0xEE); // After subtraction, binary result is EE (-18 in signed form)
     // Write and execute the DAA instruction
     bus.write(cpu.PC + 1, 0x27); // Opcode for DAA
@@ -74,7 +75,7 @@ TEST_F(GeneralPurposeGroupTest, CPL)
     cpu.A = 0xB4; // Set Accumulator to 0xB4 (1011 0100 in binary)
     // Write and execute the CPL instruction
     bus.write(cpu.PC, 0x2F); // Opcode for CPL
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0x4B); // After CPL, A should contain the inverted value (0100 1011)
 
@@ -93,7 +94,7 @@ TEST_F(GeneralPurposeGroupTest, NEG)
     bus.write(cpu.PC + 1, 0x44); // Opcode for NEG
 
     // Execute the NEG instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     cpu.execute(bus.read(cpu.PC + 1));
 
     // Verify the result in the accumulator
@@ -111,7 +112,7 @@ TEST_F(GeneralPurposeGroupTest, NEG)
     cpu.A = 0x80;
     bus.write(cpu.PC, 0xED); // Prefix for extended opcodes
     bus.write(cpu.PC + 1, 0x44);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     cpu.execute(bus.read(cpu.PC + 1));
     ASSERT_EQ(cpu.A, 0x80);                  // Two's complement of 0x80 is itself
     ASSERT_TRUE(cpu.isFlagSet(z80::P));      // P/V flag set because A was 0x80
@@ -124,7 +125,7 @@ TEST_F(GeneralPurposeGroupTest, NEG)
     cpu.A = 0x00;
     bus.write(cpu.PC, 0xED); // Prefix for extended opcodes
     bus.write(cpu.PC + 1, 0x44);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     cpu.execute(bus.read(cpu.PC + 1));
     ASSERT_EQ(cpu.A, 0x00);                   // 0 - 0 = 0
     ASSERT_FALSE(cpu.isFlagSet(z80::S));      // Result is not negative
@@ -141,7 +142,7 @@ TEST_F(GeneralPurposeGroupTest, CCF)
 
     // Set up the bus to execute the CCF instruction (opcode 0x3F)
     bus.write(cpu.PC, 0x3F);       // Opcode for CCF
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the Carry flag is inverted (CY was 1, now should be 0)
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag)); // CY should be reset (CY = 0)
@@ -150,7 +151,7 @@ TEST_F(GeneralPurposeGroupTest, CCF)
     // If CY was 0 initially, we should verify that CY is set
     cpu.clearFlag(z80::C_flag);    // Now set Carry flag to 0
     bus.write(cpu.PC, 0x3F);       // Execute CCF instruction again
-    cpu.execute(bus.read(cpu.PC)); // Invert the Carry flag
+    step(cpu); // Invert the Carry flag
 
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag)); // CY should be set (CY = 1)
 }
@@ -161,7 +162,7 @@ TEST_F(GeneralPurposeGroupTest, SCF)
 
     // Set up the bus to execute the CCF instruction (opcode 0x3F)
     bus.write(cpu.PC, 0x37);       // Opcode for CCF
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the Carry flag is inverted (CY was 1, now should be 0)
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));  // CY should be reset (CY = 0)
@@ -173,7 +174,7 @@ TEST_F(GeneralPurposeGroupTest, IM0)
 
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, 0x46);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.interruptMode, InterruptMode::Mode0);
 }
@@ -182,7 +183,7 @@ TEST_F(GeneralPurposeGroupTest, IM1)
 
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, 0x56);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.interruptMode, InterruptMode::Mode1);
 }
@@ -191,7 +192,7 @@ TEST_F(GeneralPurposeGroupTest, IM2)
 
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, 0x5E);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.interruptMode, InterruptMode::Mode2);
 }
@@ -200,7 +201,7 @@ TEST_F(GeneralPurposeGroupTest, NOP)
 
     bus.write(cpu.PC, 0x00);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0xff);
 }
@@ -217,7 +218,7 @@ TEST_F(GeneralPurposeGroupTest, LoadROMTest)
     {
         uint8_t opCode = bus.read(cpu.PC);
         uint16_t PCbefore = cpu.PC;
-        cpu.execute(bus.read(cpu.PC));
+        step(cpu);
     }
     bool videoMemoryPopulated = false;
     if (bus.read(0x3ff0) == 0x3c)
@@ -270,7 +271,7 @@ TEST_F(SixteenBitArithmetictest, ADD_HL_SS)
     memory.write(cpu.PC, 0x19); // Opcode for ADD HL, DE
 
     // Execute the ADD HL, DE instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the result in HL
     ASSERT_EQ(cpu.getHL(), 0x5353); // Expected result = 0x4242 + 0x1111 = 0x5353
@@ -295,7 +296,7 @@ TEST_F(SixteenBitArithmetictest, ADD_HL_SS2)
     memory.write(cpu.PC, 0x19); // Opcode for ADD HL, DE
 
     // Execute the ADD HL, DE instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the result in HL
     ASSERT_EQ(cpu.getHL(), 0x0E00); // Expected result = 0x4242 + 0x1111 = 0x5353
@@ -319,7 +320,7 @@ TEST_F(SixteenBitArithmetictest, ADD_HL_SS3)
     memory.write(cpu.PC, 0x19); // Opcode for ADD HL, DE
 
     // Execute the ADD HL, DE instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the result in HL
     ASSERT_EQ(cpu.getHL(), 0x1000); // Expected result = 0x4242 + 0x1111 = 0x5353
@@ -350,7 +351,7 @@ TEST_F(SixteenBitArithmetictest, ADC_HL_SP_WithCarry)
     uint16_t initialSP = cpu.SP;
 
     // Execute the ADC HL, SP instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the results
     ASSERT_EQ(cpu.getHL(), 0x0E01); // HL should contain 0x10101 (F0FF + 0101 + 1)
@@ -389,7 +390,7 @@ TEST_F(SixteenBitArithmetictest, ADC_HL_SP_WithCarry2)
     uint16_t initialHL = cpu.getHL();
     uint16_t initialSP = cpu.SP;
     // Execute the ADC HL, SP instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
     // Verify the results
     ASSERT_EQ(cpu.getHL(), 0x0001); // HL should contain 0x10101 (F0FF + 0101 + 1)
 
@@ -413,7 +414,7 @@ TEST_F(SixteenBitArithmetictest, SBC_HL_SP_WithCarry)
     uint16_t initialSP = cpu.SP;
 
     // Execute the ADC HL, SP instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the results
     ASSERT_EQ(cpu.getHL(), 0x8887);
@@ -448,7 +449,7 @@ TEST_F(SixteenBitArithmetictest, ADD_IX_PP)
     memory.write(cpu.PC + 1, 0x09);
 
     // Execute the ADD HL, DE instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the result in HL
     ASSERT_EQ(cpu.IX, 0x1000); // Expected result = 0x4242 + 0x1111 = 0x5353
@@ -470,7 +471,7 @@ TEST_F(SixteenBitArithmetictest, ADD_IY_RR)
     bus.write(cpu.PC + 1, 0x09);
 
     // Execute the ADD HL, DE instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result in HL
     ASSERT_EQ(cpu.IY, 0x0002); // Expected result = 0x4242 + 0x1111 = 0x5353
@@ -515,7 +516,7 @@ TEST_F(SixteenBitArithmetictest, INC_IX)
     uint16_t initialHL = cpu.IX;
     bus.write(cpu.PC, 0xDD);
     bus.write(cpu.PC + 1, 0x23);
-    cpu.execute(bus.read(cpu.PC)); // The opcode for INC HL is 0x34
+    step(cpu); // The opcode for INC HL is 0x34
 
     ASSERT_EQ(cpu.IX, initialHL + 1);
 }
@@ -528,7 +529,7 @@ TEST_F(SixteenBitArithmetictest, INC_IY)
 
     bus.write(cpu.PC, 0xFD);
     bus.write(cpu.PC + 1, 0x23);
-    cpu.execute(bus.read(cpu.PC)); // The opcode for INC HL is 0x34
+    step(cpu); // The opcode for INC HL is 0x34
 
     ASSERT_EQ(cpu.IY, initialHL + 1);
 }
@@ -564,7 +565,7 @@ TEST_F(SixteenBitArithmetictest, DEC_IX)
     uint16_t initialHL = cpu.IX;
     bus.write(cpu.PC, 0xDD);
     bus.write(cpu.PC + 1, 0x2B);
-    cpu.execute(bus.read(cpu.PC)); // The opcode for INC HL is 0x34
+    step(cpu); // The opcode for INC HL is 0x34
 
     ASSERT_EQ(cpu.IX, initialHL - 1);
 }
@@ -577,7 +578,7 @@ TEST_F(SixteenBitArithmetictest, DEC_IY)
 
     bus.write(cpu.PC, 0xFD);
     bus.write(cpu.PC + 1, 0x2B);
-    cpu.execute(bus.read(cpu.PC)); // The opcode for INC HL is 0x34
+    step(cpu); // The opcode for INC HL is 0x34
 
     ASSERT_EQ(cpu.IY, initialHL - 1);
 }
@@ -605,7 +606,7 @@ TEST_F(RotateAndShiftGroup, RLCA)
     bus.write(cpu.PC, 0x07); // RLCA opcode
 
     // Execute the RLCA instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b00010001); // Bit 7 is moved to bit 0, other bits shifted left
@@ -623,7 +624,7 @@ TEST_F(RotateAndShiftGroup, RLA)
     cpu.A = 0b01110110;
     bus.write(cpu.PC, 0x17); // RLA opcode
     // Execute the RLCA instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b11101101);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -635,7 +636,7 @@ TEST_F(RotateAndShiftGroup, RRCA)
     cpu.A = 0b00010001;
     bus.write(cpu.PC, 0x0F); // RLA opcode
     // Execute the RLCA instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b10001000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -648,7 +649,7 @@ TEST_F(RotateAndShiftGroup, RRA)
     cpu.clearFlag(z80::C_flag);
     bus.write(cpu.PC, 0x1F); // RLA opcode
     // Execute the RLCA instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b01110000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -662,7 +663,7 @@ TEST_F(RotateAndShiftGroup, RLC_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x01);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.C, 0b00010001);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -681,7 +682,7 @@ TEST_F(RotateAndShiftGroup, RLC_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x06);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b00010001);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -703,7 +704,7 @@ TEST_F(RotateAndShiftGroup, RLC_IX_D)
     bus.write(cpu.PC + 2, 0x10);
     bus.write(cpu.PC + 3, 0x01);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(address), 0b00010001);
     ASSERT_EQ(cpu.C, 0b00010001);
@@ -725,7 +726,7 @@ TEST_F(RotateAndShiftGroup, RLC_IY_D)
     bus.write(cpu.PC + 2, 0x10);
     bus.write(cpu.PC + 3, 0x07);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(address), 0b00010001);
     ASSERT_EQ(cpu.A, 0b00010001);
@@ -741,7 +742,7 @@ TEST_F(RotateAndShiftGroup, RL_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x10);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.B, 0b00011110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -758,7 +759,7 @@ TEST_F(RotateAndShiftGroup, RL_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x16);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b00011110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -777,7 +778,7 @@ TEST_F(RotateAndShiftGroup, RL_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x16);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IX + d), 0b00011110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -797,7 +798,7 @@ TEST_F(RotateAndShiftGroup, RL_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x12);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IY + d), 0b00011110);
     ASSERT_EQ(cpu.D, 0b00011110);
@@ -814,7 +815,7 @@ TEST_F(RotateAndShiftGroup, RRC_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x0F);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0b10001000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -833,7 +834,7 @@ TEST_F(RotateAndShiftGroup, RRC_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x0E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.getHL()), 0b10011000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -854,7 +855,7 @@ TEST_F(RotateAndShiftGroup, RRC_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x0E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IX + d), 0b10011000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -875,7 +876,7 @@ TEST_F(RotateAndShiftGroup, RRC_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x08);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IY + d), 0b10011000);
     ASSERT_EQ(cpu.B, 0b10011000);
@@ -893,7 +894,7 @@ TEST_F(RotateAndShiftGroup, RR_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x1F);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b01101110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -912,7 +913,7 @@ TEST_F(RotateAndShiftGroup, RR_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x1E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b11101110);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -933,7 +934,7 @@ TEST_F(RotateAndShiftGroup, RR_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x1E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IX + d), 0b01101110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag)); // toDo Might not be right
@@ -952,7 +953,7 @@ TEST_F(RotateAndShiftGroup, RR_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x1E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IY + d), 0b01101110);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag)); // toDo Might not be right
@@ -968,7 +969,7 @@ TEST_F(RotateAndShiftGroup, SLA_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x25);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.L, 0b01100010);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -987,7 +988,7 @@ TEST_F(RotateAndShiftGroup, SLA_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x26);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b10110010);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1009,7 +1010,7 @@ TEST_F(RotateAndShiftGroup, SLA_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x26);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IX + d), 0b10110010);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1031,7 +1032,7 @@ TEST_F(RotateAndShiftGroup, SLA_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x26);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IY + d), 0b10110010);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1049,7 +1050,7 @@ TEST_F(RotateAndShiftGroup, SRA_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x2F);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.A, 0b11011100);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1068,7 +1069,7 @@ TEST_F(RotateAndShiftGroup, SRA_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x2E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b11011100);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1090,7 +1091,7 @@ TEST_F(RotateAndShiftGroup, SRA_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x2E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IX + d), 0b11011100);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1112,7 +1113,7 @@ TEST_F(RotateAndShiftGroup, SRA_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x2E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IY + d), 0b11011100);
     ASSERT_FALSE(cpu.isFlagSet(z80::C_flag));
@@ -1129,7 +1130,7 @@ TEST_F(RotateAndShiftGroup, SRL_R)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x3A);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(cpu.D, 0b01011000);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -1148,7 +1149,7 @@ TEST_F(RotateAndShiftGroup, SRL_HL)
     bus.write(cpu.PC, 0xCB);
     bus.write(cpu.PC + 1, 0x3E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b00101100);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -1171,7 +1172,7 @@ TEST_F(RotateAndShiftGroup, SRL_IX_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x3E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IX + d), 0b00101100);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -1193,7 +1194,7 @@ TEST_F(RotateAndShiftGroup, SRL_IY_D)
     bus.write(cpu.PC + 2, d);
     bus.write(cpu.PC + 3, 0x3E);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.IY + d), 0b00101100);
     ASSERT_TRUE(cpu.isFlagSet(z80::C_flag));
@@ -1214,7 +1215,7 @@ TEST_F(RotateAndShiftGroup, RLD)
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, 0x6F);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b00011010);
     ASSERT_EQ(cpu.A, 0b01110011);
@@ -1236,7 +1237,7 @@ TEST_F(RotateAndShiftGroup, RRD)
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, 0x67);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that A was rotated left circularly
     ASSERT_EQ(bus.read(cpu.getHL()), 0b01000010);
     ASSERT_EQ(cpu.A, 0b10000000);
@@ -1268,7 +1269,7 @@ TEST_F(BitGroup, BIT_b_r)
     bus.write(cpu.PC, 0xCB);     // First byte of BIT instruction
     bus.write(cpu.PC + 1, 0x50); // Second byte: BIT 2, B
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that Z flag is reset because bit 2 is 1
     ASSERT_FALSE(cpu.isFlagSet(z80::Z));
@@ -1280,7 +1281,7 @@ TEST_F(BitGroup, BIT_b_r)
     bus.write(cpu.PC, 0xCB);     // First byte of BIT instruction
     bus.write(cpu.PC + 1, 0x50); // Second byte: BIT 2, B
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that Z flag is set because bit 2 is 0
     ASSERT_TRUE(cpu.isFlagSet(z80::Z));
@@ -1299,7 +1300,7 @@ TEST_F(BitGroup, BIT_b_HL)
     bus.write(cpu.PC, 0xCB);       // First byte of BIT instruction
     bus.write(cpu.PC + 1, 0x66);   // Second byte: BIT 4, (HL)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_FALSE(cpu.isFlagSet(z80::Z));     // Z flag should be reset because bit 4 is 1
@@ -1311,7 +1312,7 @@ TEST_F(BitGroup, BIT_b_HL)
     bus.write(cpu.PC, 0xCB);       // First byte of BIT instruction
     bus.write(cpu.PC + 1, 0x66);   // Second byte: BIT 4, (HL)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_TRUE(cpu.isFlagSet(z80::Z));      // Z flag should be set because bit 4 is 0
@@ -1333,7 +1334,7 @@ TEST_F(BitGroup, BIT_b_IX_plus_d)
     bus.write(cpu.PC + 2, displacement);          // Displacement
     bus.write(cpu.PC + 3, 0x76);                  // BIT 6, (IX + d) - 0x76 encodes BIT 6
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_FALSE(cpu.isFlagSet(z80::Z));     // Z flag reset because bit 6 is 1
@@ -1347,7 +1348,7 @@ TEST_F(BitGroup, BIT_b_IX_plus_d)
     bus.write(cpu.PC + 2, displacement);          // Displacement
     bus.write(cpu.PC + 3, 0x76);                  // BIT 6, (IX + d) - 0x76 encodes BIT 6
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_TRUE(cpu.isFlagSet(z80::Z));      // Z flag set because bit 6 is 0
@@ -1368,7 +1369,7 @@ TEST_F(BitGroup, BIT_b_IY_plus_d)
     bus.write(cpu.PC + 2, displacement);          // Displacement
     bus.write(cpu.PC + 3, 0x76);                  // BIT 6, (IX + d) - 0x76 encodes BIT 6
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_FALSE(cpu.isFlagSet(z80::Z));     // Z flag reset because bit 6 is 1
@@ -1382,7 +1383,7 @@ TEST_F(BitGroup, BIT_b_IY_plus_d)
     bus.write(cpu.PC + 2, displacement);          // Displacement
     bus.write(cpu.PC + 3, 0x76);                  // BIT 6, (IX + d) - 0x76 encodes BIT 6
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify flags
     ASSERT_TRUE(cpu.isFlagSet(z80::Z));      // Z flag set because bit 6 is 0
@@ -1396,7 +1397,7 @@ TEST_F(BitGroup, SET_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xE7); // 0xE7 = SET 4, A (b=4, r=A)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(cpu.A, 0b00010000); // Bit 4 should now be set to 1
@@ -1406,7 +1407,7 @@ TEST_F(BitGroup, SET_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xF8); // 0xF8 = SET 7, B (b=7, r=B)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(cpu.B, 0b11111111); // Bit 7 should now be set to 1
@@ -1416,7 +1417,7 @@ TEST_F(BitGroup, SET_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xC2); // 0xC2 = SET 0, D (b=0, r=D)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(cpu.D, 0b11111111); // Bit 0 should now be set to 1
@@ -1432,7 +1433,7 @@ TEST_F(BitGroup, SET_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xE6); // 0xE6 = SET 4, (HL) (b=4)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(hlAddress), 0b00010000); // Bit 4 should now be set to 1
@@ -1443,7 +1444,7 @@ TEST_F(BitGroup, SET_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xFE); // 0xFE = SET 7, (HL) (b=7)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(hlAddress), 0b11111111); // Bit 7 should now be set to 1
@@ -1454,7 +1455,7 @@ TEST_F(BitGroup, SET_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for BIT, SET, and RES instructions
     bus.write(cpu.PC + 1, 0xC6); // 0xC6 = SET 0, (HL) (b=0)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(hlAddress), 0b11111111); // Bit 0 should now be set to 1
@@ -1472,7 +1473,7 @@ TEST_F(BitGroup, SET_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xC6);         // 0xC6 = SET 0, (IX+d) (b=0)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b11111111); // Bit 0 should now be set to 1
@@ -1487,7 +1488,7 @@ TEST_F(BitGroup, SET_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xE6);         // 0xE6 = SET 4, (IX+d) (b=4)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b00010000); // Bit 4 should now be set to 1
@@ -1502,7 +1503,7 @@ TEST_F(BitGroup, SET_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xFE);         // 0xFE = SET 7, (IX+d) (b=7)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b11111111); // Bit 7 should now be set to 1
@@ -1520,7 +1521,7 @@ TEST_F(BitGroup, SET_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xC6);         // 0xC6 = SET 0, (IX+d) (b=0)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b11111111); // Bit 0 should now be set to 1
@@ -1535,7 +1536,7 @@ TEST_F(BitGroup, SET_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xE6);         // 0xE6 = SET 4, (IX+d) (b=4)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b00010000); // Bit 4 should now be set to 1
@@ -1550,7 +1551,7 @@ TEST_F(BitGroup, SET_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement value
     bus.write(cpu.PC + 3, 0xFE);         // 0xFE = SET 7, (IX+d) (b=7)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the result
     ASSERT_EQ(bus.read(targetAddress), 0b11111111); // Bit 7 should now be set to 1
@@ -1563,7 +1564,7 @@ TEST_F(BitGroup, RES_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0x82); // 0x82 = RES 0, D (b = 0, r = D)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 0 in D is cleared
     ASSERT_EQ(cpu.D, 0b11111110); // Only bit 0 should be cleared
@@ -1574,7 +1575,7 @@ TEST_F(BitGroup, RES_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0x98); // 0x98 = RES 3, B (b = 3, r = B)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 3 in B is cleared
     ASSERT_EQ(cpu.B, 0b11110111); // Bit 3 remains cleared, unchanged result
@@ -1585,7 +1586,7 @@ TEST_F(BitGroup, RES_b_r)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0xBF); // 0xBF = RES 7, A (b = 7, r = A)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 7 in A is cleared
     ASSERT_EQ(cpu.A, 0b00000000); // All bits should now be cleared
@@ -1600,7 +1601,7 @@ TEST_F(BitGroup, RES_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0x86); // 0x86 = RES 0, (HL) (b = 0, memory at HL)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 0 in memory at HL is cleared
     ASSERT_EQ(bus.read(0x2000), 0b11111110);
@@ -1611,7 +1612,7 @@ TEST_F(BitGroup, RES_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0xA6); // 0xA6 = RES 4, (HL) (b = 4, memory at HL)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 4 in memory at HL is cleared
     ASSERT_EQ(bus.read(0x2000), 0b11101111);
@@ -1622,7 +1623,7 @@ TEST_F(BitGroup, RES_b_HL)
     bus.write(cpu.PC, 0xCB);     // Prefix for bit operations
     bus.write(cpu.PC + 1, 0xBE); // 0xBE = RES 7, (HL) (b = 7, memory at HL)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 7 in memory at HL is cleared
     ASSERT_EQ(bus.read(0x2000), 0b00000000);
@@ -1639,7 +1640,7 @@ TEST_F(BitGroup, RES_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0x86);         // 0x86 = RES 0, (IX+d) (b = 0)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 0 at IX + 3 is cleared
     ASSERT_EQ(bus.read(cpu.IX + displacement), 0b11111110);
@@ -1653,7 +1654,7 @@ TEST_F(BitGroup, RES_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0xA6);         // 0xA6 = RES 4, (IX+d) (b = 4)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 4 at IX + 5 is cleared
     ASSERT_EQ(bus.read(cpu.IX + displacement), 0b11101111);
@@ -1667,7 +1668,7 @@ TEST_F(BitGroup, RES_b_IX_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0xBE);         // 0xBE = RES 7, (IX+d) (b = 7)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 7 at IX - 2 is cleared
     ASSERT_EQ(bus.read(cpu.IX + displacement), 0b00000000);
@@ -1684,7 +1685,7 @@ TEST_F(BitGroup, RES_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0x86);         // 0x86 = RES 0, (IY+d) (b = 0)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 0 at IY + 3 is cleared
     ASSERT_EQ(bus.read(cpu.IY + displacement), 0b11111110);
@@ -1698,7 +1699,7 @@ TEST_F(BitGroup, RES_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0xA6);         // 0xA6 = RES 4, (IY+d) (b = 4)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 4 at IY + 5 is cleared
     ASSERT_EQ(bus.read(cpu.IY + displacement), 0b11101111);
@@ -1712,7 +1713,7 @@ TEST_F(BitGroup, RES_b_IY_d)
     bus.write(cpu.PC + 2, displacement); // Displacement
     bus.write(cpu.PC + 3, 0xBE);         // 0xBE = RES 7, (IY+d) (b = 7)
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that bit 7 at IY - 2 is cleared
     ASSERT_EQ(bus.read(cpu.IY + displacement), 0b00000000);
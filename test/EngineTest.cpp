@@ -0,0 +1,858 @@
+#include <gtest/gtest.h>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+#include "../IODevice.cpp"
+#include <random>
+
+// A CPU on the engine under test, and a reference CPU on the Table engine
+// over its own 64K that the tests run the same code on and compare against
+class EngineTest : public ::testing::Test
+{
+protected:
+    Memory memory;
+    CpuBus bus;
+    z80 cpu;
+    Memory referenceMemory;
+    CpuBus referenceBus;
+    z80 reference;
+    uint64_t referenceDeadline = 0;
+
+    EngineTest() : memory(0x10000), bus(memory), cpu(), referenceMemory(0x10000), referenceBus(referenceMemory), reference()
+    {
+        cpu.reset(&bus);
+        reference.reset(&referenceBus);
+        reference.engine = ExecutionEngine::Table;
+    }
+
+    // Writes a byte to both machines
+    void poke(uint16_t address, uint8_t value)
+    {
+        bus.write(address, value);
+        referenceBus.write(address, value);
+    }
+
+    // Writes the program to both machines and points both PCs at it
+    template <size_t N>
+    void loadProgram(uint16_t address, const uint8_t (&program)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            poke(address + i, program[i]);
+        }
+        cpu.PC = reference.PC = address;
+    }
+
+    // Steps the reference until it has run as long as the budgets given so
+    // far, as runFor() would. Outside runFor() LDIR, CPIR, OTIR and the like
+    // run one iteration per instruction, so this is the plain interpreter.
+    void runReference(uint64_t budget)
+    {
+        referenceDeadline += budget;
+        while (reference.tstates < referenceDeadline)
+        {
+            reference.run(referenceBus.read(reference.PC));
+        }
+    }
+
+    void expectSameState()
+    {
+        EXPECT_EQ(cpu.PC, reference.PC);
+        EXPECT_EQ(cpu.SP, reference.SP);
+        EXPECT_EQ(cpu.getAF(), reference.getAF());
+        EXPECT_EQ(cpu.getBC(), reference.getBC());
+        EXPECT_EQ(cpu.getDE(), reference.getDE());
+        EXPECT_EQ(cpu.getHL(), reference.getHL());
+        EXPECT_EQ(cpu.IX, reference.IX);
+        EXPECT_EQ(cpu.IY, reference.IY);
+        EXPECT_EQ(cpu.MPTR, reference.MPTR);
+        EXPECT_EQ(cpu.R, reference.R);
+        EXPECT_EQ(cpu.IFF1, reference.IFF1);
+        EXPECT_EQ(cpu.halted, reference.halted);
+        EXPECT_EQ(cpu.tstates, reference.tstates);
+    }
+
+    void expectSameMemory(int first, int last)
+    {
+        for (int address = first; address <= last; ++address)
+        {
+            ASSERT_EQ(bus.read(address), referenceBus.read(address)) << "at " << address;
+        }
+    }
+};
+
+TEST_F(EngineTest, RunForCarriesOvershoot)
+{
+    // Memory is all NOPs, 4 T-states each
+
+    // 10 T-states can only be covered by finishing the third NOP
+    ASSERT_EQ(cpu.runFor(10), 12);
+    ASSERT_EQ(cpu.PC, 0x0003);
+
+    // The 2 T-states of overshoot are taken off the next budget
+    ASSERT_EQ(cpu.runFor(10), 8);
+    ASSERT_EQ(cpu.PC, 0x0005);
+    ASSERT_EQ(cpu.tstates, 20);
+}
+
+TEST_F(EngineTest, RunFrameTakesInterruptOnEntry)
+{
+    cpu.PC = 0x8000; // Out of reach of the NOPs run during the frame
+    cpu.SP = 0xFFF0;
+    bus.write(cpu.PC, 0x76); // HALT
+    cpu.execute(bus.read(cpu.PC));
+    ASSERT_TRUE(cpu.halted);
+
+    cpu.interruptMode = InterruptMode::Mode1;
+    cpu.IFF1 = cpu.IFF2 = true;
+
+    uint64_t executed = cpu.runFrame();
+
+    ASSERT_GE(executed, z80::TSTATES_PER_FRAME);
+    ASSERT_FALSE(cpu.halted);
+    ASSERT_FALSE(bus.interrupt);
+
+    // Return address is the instruction after HALT
+    ASSERT_EQ(cpu.SP, 0xFFEE);
+    ASSERT_EQ(bus.read(0xFFEE), 0x01);
+    ASSERT_EQ(bus.read(0xFFEF), 0x80);
+
+    // The rest of the frame ran through the NOPs after 0x0038
+    ASSERT_GT(cpu.PC, 0x0038);
+}
+
+TEST(SchedulerTest, RunsEventsInTStateOrder)
+{
+    Scheduler scheduler;
+    std::vector<int> order;
+    scheduler.schedule(30, [&](uint64_t)
+                       { order.push_back(3); });
+    scheduler.schedule(10, [&](uint64_t)
+                       { order.push_back(1); });
+    scheduler.schedule(30, [&](uint64_t)
+                       { order.push_back(4); }); // after the first one due at 30
+    int periodic = scheduler.scheduleEvery(20, 20, [&](uint64_t when)
+                                           { order.push_back(static_cast<int>(when)); });
+    int cancelled = scheduler.schedule(25, [&](uint64_t)
+                                       { order.push_back(-1); });
+    scheduler.cancel(cancelled);
+
+    ASSERT_EQ(scheduler.next(), 10);
+    scheduler.runDue(45);
+    ASSERT_EQ(order, std::vector<int>({1, 20, 3, 4, 40}));
+
+    scheduler.cancel(periodic);
+    ASSERT_EQ(scheduler.next(), Scheduler::NEVER);
+}
+
+TEST_F(EngineTest, RunForStopsAtScheduledInterrupt)
+{
+    cpu.PC = 0x8000;
+    cpu.SP = 0xFFF0;
+    bus.write(cpu.PC, 0x76); // HALT
+    cpu.interruptMode = InterruptMode::Mode1;
+    cpu.IFF1 = cpu.IFF2 = true;
+
+    uint64_t raisedAt = 0;
+    bus.scheduler.schedule(1000, [&](uint64_t)
+                           {
+        raisedAt = cpu.tstates;
+        bus.interrupt = true; });
+    bus.scheduler.schedule(1000 + z80::INT_LENGTH, [&](uint64_t)
+                           { bus.interrupt = false; });
+
+    cpu.runFor(5000);
+
+    // The halted CPU only ran up to the event, and took the interrupt there
+    ASSERT_EQ(raisedAt, 1000);
+    ASSERT_FALSE(cpu.halted);
+    ASSERT_FALSE(bus.interrupt);
+    ASSERT_EQ(cpu.SP, 0xFFEE);
+    ASSERT_EQ(bus.read(0xFFEE), 0x01);
+    ASSERT_EQ(bus.read(0xFFEF), 0x80);
+    ASSERT_GT(cpu.PC, 0x0038);
+}
+
+TEST_F(EngineTest, InterruptHeldAcrossEIIsTaken)
+{
+    // INT goes up at 100 T-states with interrupts off and the EI comes 8
+    // T-states later, well inside the window
+    for (int i = 0; i < 26; ++i)
+    {
+        bus.write(0x8000 + i, 0x00); // NOP
+    }
+    bus.write(0x801A, 0xFB); // EI
+    bus.write(0x801B, 0x00); // NOP
+    bus.write(0x801C, 0x76); // HALT
+    cpu.PC = 0x8000;
+    cpu.SP = 0xFFF0;
+    cpu.interruptMode = InterruptMode::Mode1;
+
+    bus.scheduler.schedule(100, [&](uint64_t)
+                           { bus.interrupt = true; });
+    bus.scheduler.schedule(100 + z80::INT_LENGTH, [&](uint64_t)
+                           { bus.interrupt = false; });
+
+    cpu.runFor(1000);
+
+    // Taken after the instruction that follows EI, not straight after it
+    ASSERT_FALSE(cpu.halted);
+    ASSERT_FALSE(cpu.IFF1);
+    ASSERT_EQ(cpu.SP, 0xFFEE);
+    ASSERT_EQ(bus.read(0xFFEE), 0x1C);
+    ASSERT_EQ(bus.read(0xFFEF), 0x80);
+    ASSERT_GT(cpu.PC, 0x0038);
+}
+
+TEST_F(EngineTest, RunFrameKeepsFramesOnTheEmulatedClock)
+{
+    cpu.runFrame();
+    ASSERT_FALSE(bus.interrupt);
+
+    // A shorter run in between does not move the frames that follow: the
+    // third one starts inside the next runFrame() and the fourth is due next
+    cpu.runFor(1000);
+    cpu.runFrame();
+    ASSERT_FALSE(bus.interrupt);
+    ASSERT_GE(cpu.tstates, 2 * z80::TSTATES_PER_FRAME + 1000);
+    ASSERT_EQ(bus.scheduler.next(), 3 * z80::TSTATES_PER_FRAME);
+}
+
+TEST_F(EngineTest, PredecodedSeesSelfModifyingCode)
+{
+    cpu.engine = ExecutionEngine::Predecoded;
+
+    bus.write(0x8000, 0x3C); // INC A
+    bus.write(0x8001, 0x32); // LD (0x8000), A
+    bus.write(0x8002, 0x00);
+    bus.write(0x8003, 0x80);
+
+    cpu.A = 0x00;
+    cpu.PC = 0x8000;
+    cpu.execute(bus.read(cpu.PC));
+    ASSERT_EQ(cpu.A, 0x01);
+    ASSERT_EQ(cpu.decodeCacheMisses, 1);
+
+    // Running the same address again comes from the cache
+    cpu.PC = 0x8000;
+    cpu.execute(bus.read(cpu.PC));
+    ASSERT_EQ(cpu.A, 0x02);
+    ASSERT_EQ(cpu.decodeCacheHits, 1);
+
+    // Overwrite the INC A with 0x04, INC B
+    cpu.A = 0x04;
+    cpu.execute(bus.read(cpu.PC));
+    ASSERT_EQ(bus.read(0x8000), 0x04);
+
+    cpu.B = 0x10;
+    cpu.PC = 0x8000;
+    cpu.execute(bus.read(cpu.PC));
+    ASSERT_EQ(cpu.B, 0x11);
+    ASSERT_EQ(cpu.A, 0x04);
+    ASSERT_EQ(cpu.PC, 0x8001);
+}
+
+TEST_F(EngineTest, EnginesSeeCodePatchedThroughMemory)
+{
+    const ExecutionEngine engines[] = {ExecutionEngine::Table, ExecutionEngine::Switch,
+                                       ExecutionEngine::Predecoded, ExecutionEngine::Block,
+                                       ExecutionEngine::Jit};
+    for (ExecutionEngine engine : engines)
+    {
+        Memory storage(0x10000);
+        CpuBus patchedBus(storage);
+        z80 patched;
+        patched.reset(&patchedBus);
+        patched.engine = engine;
+        const uint8_t program[] = {
+            0x3E, 0x01,                   // LD A, 1
+            0x18, 0xFC,                   // JR back
+            0xDD, 0x21, 0x01, 0x00, 0x18, // LD IX, 1; JR back
+            0xFA,
+        };
+        for (size_t i = 0; i < sizeof(program); ++i)
+        {
+            storage.write(0x8000 + i, program[i]);
+        }
+
+        patched.PC = 0x8000;
+        patched.runFor(2000);
+        ASSERT_EQ(patched.A, 0x01);
+        patched.A = 0x00;
+        storage.write(0x8000, 0x06); // LD B, 1
+        patched.runFor(2000);
+        EXPECT_EQ(patched.A, 0x00) << "engine " << static_cast<int>(engine);
+        EXPECT_EQ(patched.B, 0x01) << "engine " << static_cast<int>(engine);
+
+        // A byte after a prefix, LD IX, 1 becomes LD IXH, 1 and a NOP
+        patched.PC = 0x8004;
+        patched.runFor(2000);
+        ASSERT_EQ(patched.IX, 0x0001);
+        patched.IX = 0x0000;
+        storage.write(0x8005, 0x26);
+        patched.runFor(2000);
+        EXPECT_EQ(patched.IX, 0x0100) << "engine " << static_cast<int>(engine);
+    }
+}
+
+TEST_F(EngineTest, BlockSeesCodeWrittenInsideTheBlock)
+{
+    const uint8_t program[] = {
+        0x3E, 0x04,       // LD A, 0x04
+        0x32, 0x06, 0x80, // LD (0x8006), A
+        0x00,             // NOP
+        0x00,             // NOP, becomes INC B
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+
+    cpu.engine = ExecutionEngine::Block;
+    cpu.runFor(1000);
+    runReference(1000);
+
+    ASSERT_EQ(cpu.B, 0x01);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.PC, 0x8007);
+    ASSERT_GT(cpu.blocksTranslated, 1);
+    expectSameState();
+}
+
+TEST_F(EngineTest, JitMatchesInterpreterOnLoop)
+{
+    // With Z80_JIT the loop body runs as native code after JIT_THRESHOLD
+    // iterations, without it as a translated block
+    const uint8_t program[] = {
+        0x06, 0x00,       // LD B, 0
+        0x21, 0x00, 0x90, // LD HL, 0x9000
+        0x78,             // LD A, B
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0xEB,             // EX DE, HL
+        0xEB,             // EX DE, HL
+        0x10, 0xF9,       // DJNZ -7
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+
+    cpu.engine = ExecutionEngine::Jit;
+    cpu.runFor(20000);
+    runReference(20000);
+
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.getHL(), 0x9100);
+    expectSameState();
+    expectSameMemory(0x9000, 0x90FF);
+}
+
+#ifdef Z80_JIT
+TEST_F(EngineTest, JitDifferentialComparesMemory)
+{
+    if (CpuBus::CHARGES_FETCHES)
+        GTEST_SKIP() << "Nothing is compiled on a bus that charges fetches";
+    const uint8_t program[] = {
+        0x21, 0x00, 0x90, // LD HL, 0x9000
+        0x06, 0x40,       // LD B, 0x40
+        0x7E,             // loop: LD A, (HL)
+        0x3C,             // INC A
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0x10, 0xFA,       // DJNZ loop
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+
+    std::vector<uint16_t> mismatches;
+    cpu.engine = ExecutionEngine::Jit;
+    cpu.jitThreshold = 1;
+    cpu.enableJitDifferential(&referenceBus);
+    cpu.onJitMismatch = [&](const z80 &shadow)
+    { mismatches.push_back(shadow.PC); };
+
+    cpu.runFor(1000);
+    ASSERT_GT(cpu.jitBlocksRun, 0);
+    ASSERT_EQ(cpu.jitMismatches, 0);
+
+    // A byte only this bus holds is reported once, then copied to the shadow
+    bus.write(0x9010, 0x55);
+    cpu.runFor(3000);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.jitMismatches, 1);
+    ASSERT_EQ(mismatches.size(), 1);
+    ASSERT_EQ(referenceBus.read(0x9010), bus.read(0x9010));
+}
+
+TEST_F(EngineTest, JitRegistersAndFlagsMatchInterpreter)
+{
+    if (CpuBus::CHARGES_FETCHES)
+        GTEST_SKIP() << "Nothing is compiled on a bus that charges fetches";
+    // Native ALU, INC/DEC and register moves with live and dead flags, a
+    // handler in between and loops that run inside the compiled block. The
+    // odd budgets stop the loops at every point of their iterations.
+    const uint8_t program[] = {
+        0x31, 0x00, 0xA0, // LD SP, 0xA000
+        0x01, 0x05, 0x10, // LD BC, 0x1005
+        0x11, 0x34, 0x12, // LD DE, 0x1234
+        0x21, 0x00, 0x90, // LD HL, 0x9000
+        0xAF,             // XOR A
+        0x80,             // inner: ADD A, B
+        0xCE, 0x35,       // ADC A, 0x35
+        0x99,             // SBC A, C
+        0xD6, 0x07,       // SUB 7
+        0xA3,             // AND E
+        0xB4,             // OR H
+        0xEE, 0x5A,       // XOR 0x5A
+        0xBD,             // CP L
+        0x14,             // INC D
+        0x1D,             // DEC E
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0x33,             // INC SP
+        0x1B,             // DEC DE
+        0xD9,             // EXX
+        0x0C,             // INC C
+        0x81,             // ADD A, C
+        0xD9,             // EXX
+        0xEB,             // EX DE, HL
+        0x62,             // LD H, D
+        0xEB,             // EX DE, HL
+        0x10, 0xE6,       // DJNZ inner
+        0x0D,             // DEC C
+        0x20, 0xE3,       // JR NZ, inner
+        0x3E, 0x20,       // LD A, 0x20
+        0x1C,             // countdown: INC E
+        0x3D,             // DEC A
+        0x20, 0xFC,       // JR NZ, countdown
+        0xC6, 0x30,       // carry: ADD A, 0x30
+        0x30, 0xFC,       // JR NC, carry
+        0xF9,             // LD SP, HL
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+
+    cpu.engine = ExecutionEngine::Jit;
+    cpu.jitThreshold = 2;
+    for (int i = 0; i < 400 && !cpu.halted; ++i)
+    {
+        cpu.runFor(997);
+        runReference(997);
+        expectSameState();
+    }
+
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_GT(cpu.jitBlocksCompiled, 0);
+    expectSameMemory(0x9000, 0x94FF);
+}
+#endif
+
+namespace
+{
+// What romTranslator emits for LD A, 5; LD B, A; HALT at 0x0000
+bool staticLoadAndHalt(z80 *cpu)
+{
+    cpu->R = (cpu->R & 0x80) | ((cpu->R + 3) & 0x7F);
+    cpu->tstates += 15;
+    cpu->A = 0x05;
+    cpu->B = cpu->A;
+    cpu->PC = 0x0003;
+    (cpu->*z80::instructionTable[0x76].getOperation())(0x76);
+    cpu->PC++;
+    return true;
+}
+}
+
+TEST_F(EngineTest, StaticTranslationRunsUntilRomIsWritten)
+{
+    if (CpuBus::ADDS_WAITS)
+        GTEST_SKIP() << "Blocks run an instruction at a time on a bus that adds waits";
+    const uint8_t rom[] = {0x3E, 0x05, 0x47, 0x76}; // LD A, 5; LD B, A; HALT
+    uint64_t checksum = 1469598103934665603ull;
+    for (int address = 0; address < 0x100; ++address)
+    {
+        uint8_t value = address < 4 ? rom[address] : 0x00;
+        bus.write(address, value);
+        checksum ^= value;
+        checksum *= 1099511628211ull;
+    }
+    const StaticBlock blocks[] = {{0x0000, 0x0003, staticLoadAndHalt}};
+    const StaticTranslation translation = {"test", 0x100, checksum, blocks, 1};
+    const StaticTranslation otherRom = {"other", 0x100, checksum + 1, blocks, 1};
+
+    cpu.engine = ExecutionEngine::Block;
+    ASSERT_FALSE(cpu.attachStaticTranslation(otherRom));
+    ASSERT_TRUE(cpu.attachStaticTranslation(translation));
+
+    cpu.runFor(15);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.A, 0x05);
+    ASSERT_EQ(cpu.B, 0x05);
+    ASSERT_EQ(cpu.tstates, 15);
+    ASSERT_EQ(cpu.staticBlocksRun, 1);
+
+    // Once the ROM page is written the interpreter runs the new bytes
+    bus.write(0x0001, 0x07);
+    cpu.halted = false;
+    cpu.PC = 0x0000;
+    cpu.runFor(15);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.B, 0x07);
+    ASSERT_EQ(cpu.staticBlocksRun, 1);
+}
+
+TEST_F(EngineTest, FusedPairsMatchInterpreter)
+{
+    if (CpuBus::ADDS_WAITS)
+        GTEST_SKIP() << "Blocks run an instruction at a time on a bus that adds waits";
+    const uint8_t program[] = {
+        0x21, 0x06, 0x80, // LD HL, 0x8006
+        0x3E, 0x3C,       // LD A, 0x3C
+        0x77,             // LD (HL), A, turns the INC HL below into INC A
+        0x23,             // INC HL
+        0x06, 0x10,       // LD B, 16
+        0x7E,             // loop: LD A, (HL)
+        0x23,             // INC HL
+        0x10, 0xFC,       // DJNZ loop
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+
+    cpu.engine = ExecutionEngine::Block;
+    cpu.runFor(2000);
+    runReference(2000);
+
+    ASSERT_GT(cpu.fusedPairsRun, 0);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(bus.read(0x8006), 0x3C);
+    expectSameState();
+}
+
+TEST_F(EngineTest, BlockCopyMatchesSteppedExecution)
+{
+    const uint8_t program[] = {
+        0x21, 0x00, 0x90, // LD HL, 0x9000
+        0x11, 0x01, 0x90, // LD DE, 0x9001
+        0x01, 0x00, 0x03, // LD BC, 0x0300
+        0xED, 0xB0,       // LDIR, fills 0x9000-0x9300 with (0x9000)
+        0x21, 0xFF, 0x92, // LD HL, 0x92FF
+        0x11, 0xFF, 0xA2, // LD DE, 0xA2FF
+        0x01, 0x00, 0x01, // LD BC, 0x0100
+        0xED, 0xB8,       // LDDR
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+    poke(0x9000, 0xAA);
+
+    // A budget that runs out in the middle of the LDIR, then one that runs to the HALT
+    for (uint64_t budget : {1000, 40000})
+    {
+        cpu.runFor(budget);
+        runReference(budget);
+        expectSameState();
+        expectSameMemory(0x9000, 0xA2FF);
+    }
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(bus.read(0xA2FF), 0xAA);
+}
+
+TEST_F(EngineTest, BlockSearchMatchesSteppedExecution)
+{
+    const uint8_t program[] = {
+        0x21, 0x00, 0x90, // LD HL, 0x9000
+        0x01, 0x00, 0x04, // LD BC, 0x0400
+        0x3E, 0x58,       // LD A, 'X'
+        0xED, 0xB1,       // CPIR, stops on the X at 0x9345
+        0x21, 0xFF, 0x93, // LD HL, 0x93FF
+        0x01, 0x00, 0x04, // LD BC, 0x0400
+        0x3E, 0x40,       // LD A, 0x40
+        0xED, 0xB9,       // CPDR, stops on the 0x3F below A at 0x9123
+        0x76,             // HALT
+    };
+    loadProgram(0x8000, program);
+    for (int address = 0x9000; address < 0x9400; ++address)
+    {
+        poke(address, address == 0x9345 ? 0x58 : address == 0x9123 ? 0x3F : 0x20);
+    }
+
+    // A budget that runs out in the middle of the CPIR, then one that runs to the HALT
+    for (uint64_t budget : {1000, 40000})
+    {
+        cpu.runFor(budget);
+        runReference(budget);
+        expectSameState();
+    }
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.getHL(), 0x9122);
+}
+
+namespace
+{
+// Sector style device on port 0x5F, high bytes lowest to highest, that records
+// every port it sees with the T-state it saw it at, and how many block calls
+// it took. Reads return 0, 1, 2 and so on.
+class RecordingDevice : public IODevice
+{
+public:
+    z80 *cpu = nullptr;
+    int lowest = 0x00;
+    int highest = 0xFF;
+    int blockCalls = 0;
+    uint8_t nextValue = 0;
+    std::vector<int> ports;
+    std::vector<uint8_t> written;
+    std::vector<uint64_t> times;
+
+    bool handlesAddress(int address) override { return (address & 0xFF) == 0x5F && (address >> 8) >= lowest && (address >> 8) <= highest; }
+    uint8_t read(int address) override
+    {
+        ports.push_back(address);
+        times.push_back(cpu->tstates);
+        return nextValue++;
+    }
+    void write(int address, uint8_t value) override
+    {
+        ports.push_back(address);
+        written.push_back(value);
+        times.push_back(cpu->tstates);
+    }
+    void readBlock(int address, uint8_t *data, int count, const uint64_t *timestamps) override
+    {
+        ++blockCalls;
+        for (int i = 0; i < count; ++i)
+        {
+            ports.push_back((address - (i << 8)) & 0xFFFF);
+            data[i] = nextValue++;
+        }
+        times.insert(times.end(), timestamps, timestamps + count);
+    }
+    void writeBlock(int address, const uint8_t *data, int count, const uint64_t *timestamps) override
+    {
+        ++blockCalls;
+        for (int i = 0; i < count; ++i)
+        {
+            ports.push_back((address - (i << 8)) & 0xFFFF);
+        }
+        written.insert(written.end(), data, data + count);
+        times.insert(times.end(), timestamps, timestamps + count);
+    }
+};
+}
+
+// INIR, INDR, OTIR and OTDR on the engine under test, whose bulk path hands
+// whole runs of ports to a device, against the reference one at a time
+class BlockIOTest : public EngineTest
+{
+protected:
+    RecordingDevice device, referenceDevice;
+
+    BlockIOTest()
+    {
+        device.cpu = &cpu;
+        referenceDevice.cpu = &reference;
+        bus.attachIODevice(&device);
+        referenceBus.attachIODevice(&referenceDevice);
+        for (int i = 0; i < 0x100; ++i)
+        {
+            poke(0x9000 + i, i * 3);
+        }
+    }
+
+    // Runs the repeated instruction with HL and BC set up until the HALT after it
+    void runBlockIO(uint8_t opCode, uint16_t hl, uint16_t bc)
+    {
+        const uint8_t program[] = {
+            0x21, uint8_t(hl), uint8_t(hl >> 8), // LD HL, hl
+            0x01, uint8_t(bc), uint8_t(bc >> 8), // LD BC, bc
+            0xED, opCode,
+            0x76, // HALT
+        };
+        loadProgram(0x8000, program);
+
+        cpu.runFor(10000);
+        runReference(10000);
+
+        ASSERT_TRUE(cpu.halted);
+        ASSERT_EQ(device.ports, referenceDevice.ports);
+        ASSERT_EQ(device.written, referenceDevice.written);
+        ASSERT_EQ(device.times, referenceDevice.times);
+        expectSameState();
+        expectSameMemory(0x8F00, 0x91FF);
+    }
+};
+
+// The first byte of each moves through the handler, the rest in one call
+
+TEST_F(BlockIOTest, InirMatchesSteppedExecution)
+{
+    runBlockIO(0xB2, 0x9000, 0x805F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(bus.read(0x907F), 0x7F);
+}
+
+TEST_F(BlockIOTest, IndrMatchesSteppedExecution)
+{
+    runBlockIO(0xBA, 0x90FF, 0x405F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(bus.read(0x90C0), 0x3F);
+}
+
+TEST_F(BlockIOTest, OtirMatchesSteppedExecution)
+{
+    runBlockIO(0xB3, 0x9000, 0x805F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(device.written.size(), 0x80);
+}
+
+TEST_F(BlockIOTest, OtdrMatchesSteppedExecution)
+{
+    runBlockIO(0xBB, 0x90FF, 0x405F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(device.written.size(), 0x40);
+}
+
+// Ports 0x405F and up are the device's, the ones below plain ports. Only the
+// device's go to it in one call, the others never do.
+TEST_F(BlockIOTest, OutputRunsStopWhereTheDeviceDoes)
+{
+    device.lowest = referenceDevice.lowest = 0x40;
+    runBlockIO(0xB3, 0x9000, 0x805F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(device.written.size(), 0x41);
+    ASSERT_EQ(bus.ioPorts[0x5F], referenceBus.ioPorts[0x5F]);
+}
+
+TEST_F(BlockIOTest, InputRunsStopWhereTheDeviceDoes)
+{
+    device.lowest = referenceDevice.lowest = 0x40;
+    runBlockIO(0xB2, 0x9000, 0xC05F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(device.ports.front(), 0xC05F);
+    ASSERT_EQ(device.ports.back(), 0x405F);
+}
+
+// Now 0x405F and down: the plain ports go first, the device takes the first
+// of its own through the handler and the rest in one call
+TEST_F(BlockIOTest, OutputRunsStartWhereTheDeviceDoes)
+{
+    device.highest = referenceDevice.highest = 0x40;
+    runBlockIO(0xBB, 0x90FF, 0x805F);
+    ASSERT_EQ(device.blockCalls, 1);
+    ASSERT_EQ(device.ports.front(), 0x405F);
+    ASSERT_EQ(device.written.size(), 0x40);
+}
+
+TEST_F(EngineTest, HaltedCpuSkipsToTheDeadline)
+{
+    // HALT with interrupts disabled, so only the deadline ends the wait
+    const uint8_t program[] = {0x76};
+    loadProgram(0x8000, program);
+
+    cpu.runFor(z80::TSTATES_PER_FRAME);
+    runReference(z80::TSTATES_PER_FRAME);
+
+    // Every NOP the halted CPU runs refreshes memory once
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.PC, 0x8000);
+    ASSERT_EQ(cpu.R, (z80::TSTATES_PER_FRAME / 4) & 0x7F);
+    expectSameState();
+}
+
+TEST_F(EngineTest, IdleLoopsMatchInterpreter)
+{
+    if (CpuBus::ADDS_WAITS)
+        GTEST_SKIP() << "Blocks run an instruction at a time on a bus that adds waits";
+    const uint8_t program[] = {
+        0x31, 0x00, 0xF0, // LD SP, 0xF000
+        0xCD, 0x10, 0x80, // wait: CALL poll
+        0x28, 0xFB,       // JR Z, wait
+        0x06, 0x00,       // LD B, 0
+        0x10, 0xFE,       // DJNZ $, 256 times
+        0x76,             // HALT
+        0x00, 0x00, 0x00,
+        0xE5,             // poll: PUSH HL
+        0x3A, 0x00, 0x90, // LD A, (0x9000)
+        0xA7,             // AND A
+        0xE1,             // POP HL
+        0xC9,             // RET
+    };
+    loadProgram(0x8000, program);
+    cpu.engine = ExecutionEngine::Block;
+
+    // Two frames of polling, then the flag is set and the DJNZ loop ends in the HALT
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        if (frame == 2)
+        {
+            poke(0x9000, 1);
+        }
+        cpu.runFor(z80::TSTATES_PER_FRAME);
+        runReference(z80::TSTATES_PER_FRAME);
+        expectSameState();
+    }
+
+    // The loop is reported by its lowest address
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_GT(cpu.idleLoops[0x8003], z80::TSTATES_PER_FRAME);
+    ASSERT_GT(cpu.idleLoops[0x800A], 0);
+}
+
+// Random code in the contended 16K, run in slices on every engine and on the
+// Table engine. Built over ContendedBus the engines have to put the same
+// waits on the clock whether or not they have the code decoded already.
+TEST(EngineEquivalenceTest, RandomCodeMatchesTable)
+{
+    const ExecutionEngine engines[] = {ExecutionEngine::Switch, ExecutionEngine::Predecoded,
+                                       ExecutionEngine::Block, ExecutionEngine::Jit};
+    for (uint32_t seed = 0; seed < 40; ++seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> code(0x4000);
+        for (uint8_t &byte : code)
+        {
+            byte = static_cast<uint8_t>(random());
+        }
+        const uint16_t start = 0x4000 + random() % 0x4000;
+
+        struct Machine
+        {
+            Memory memory{0x10000};
+            CpuBus bus{memory};
+            z80 cpu;
+        };
+        auto boot = [&](Machine &machine, ExecutionEngine engine)
+        {
+            for (int i = 0; i < 0x4000; ++i)
+            {
+                machine.memory.write(0x4000 + i, code[i]);
+            }
+            machine.cpu.reset(&machine.bus);
+            machine.cpu.engine = engine;
+            machine.cpu.PC = start;
+            machine.cpu.SP = 0xFF00;
+        };
+
+        Machine reference;
+        boot(reference, ExecutionEngine::Table);
+        std::vector<std::unique_ptr<Machine>> machines;
+        for (ExecutionEngine engine : engines)
+        {
+            machines.emplace_back(new Machine());
+            boot(*machines.back(), engine);
+        }
+
+        for (int slice = 0; slice < 40; ++slice)
+        {
+            reference.cpu.runFor(3000);
+            for (size_t i = 0; i < machines.size(); ++i)
+            {
+                z80 &cpu = machines[i]->cpu;
+                cpu.runFor(3000);
+                ASSERT_EQ(cpu.tstates, reference.cpu.tstates)
+                    << "seed " << seed << " slice " << slice << " engine " << static_cast<int>(engines[i]);
+                ASSERT_EQ(cpu.PC, reference.cpu.PC) << "seed " << seed << " slice " << slice;
+                ASSERT_EQ(cpu.getAF(), reference.cpu.getAF()) << "seed " << seed << " slice " << slice;
+                ASSERT_EQ(cpu.getHL(), reference.cpu.getHL()) << "seed " << seed << " slice " << slice;
+                ASSERT_EQ(cpu.R, reference.cpu.R) << "seed " << seed << " slice " << slice;
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include "../Bus.cpp"
 #include "../Memory.cpp"
 #include "../Instruction.cpp"
+#include "Step.hpp"
 
 class EightBitLoadTest : public ::testing::Test
 {
@@ -24,7 +25,7 @@ TEST_F(EightBitLoadTest, LD_R_R)
 
     // "LD B, C"
     bus.write(cpu.PC, 0x41); // Opcode for LD B, C
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     cpu.PC++;
 
     ASSERT_EQ(cpu.B, 0x56); // B should now contain the value from C (0x56)
@@ -32,7 +33,7 @@ TEST_F(EightBitLoadTest, LD_R_R)
 
     // "LD C, B"
     bus.write(cpu.PC, 0x49); // Opcode for LD C, B
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     cpu.PC++;
 
     ASSERT_EQ(cpu.B, 0x56); // B should still contain its value (0x56)
@@ -52,7 +53,7 @@ TEST_F(EightBitLoadTest, LD_R_N)
     uint8_t immediateB = 0x56;         // Immediate value to load into register C
     bus.write(cpu.PC, opcodeB);        // Write opcode to memory at current PC
     bus.write(cpu.PC + 1, immediateB); // Write immediate value to memory at next byte
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.C, 0x56);
 }
@@ -64,7 +65,7 @@ TEST_F(EightBitLoadTest, LD_R_HL)
     uint8_t valueInMemory = 0x42;
     bus.write(0x2000, valueInMemory);
     bus.write(cpu.PC, opCode);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     uint8_t opCodeB = 0x6E;
     cpu.H = 0x10;
@@ -72,7 +73,7 @@ TEST_F(EightBitLoadTest, LD_R_HL)
     uint8_t valueInMemoryB = 0x40;
     bus.write(0x1000, valueInMemoryB);
     bus.write(cpu.PC, opCodeB);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0x42);
     ASSERT_EQ(cpu.L, 0x40);
@@ -86,7 +87,7 @@ TEST_F(EightBitLoadTest, LD_HL_R)
     cpu.H = 0x11;
     cpu.L = 0x23;
     bus.write(cpu.PC, opCode);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(bus.read(0x1123), 0x40);
 }
 
@@ -103,7 +104,7 @@ TEST_F(EightBitLoadTest, LD_R_IX_D)
     bus.write(cpu.PC + 2, displacement);
     bus.write(0x3000 + displacement, 0x50);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.B, 0x50);
 }
@@ -121,7 +122,7 @@ TEST_F(EightBitLoadTest, LD_R_IY_D)
     bus.write(cpu.PC + 2, displacement);
     bus.write(0x3000 + displacement, 0x50);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.B, 0x50);
 }
@@ -136,7 +137,7 @@ TEST_F(EightBitLoadTest, LD_IX_D_R)
     bus.write(cpu.PC, opCode);
     bus.write(cpu.PC + 1, instruction);
     bus.write(cpu.PC + 2, displacement);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(bus.read(0x2000 + displacement), 0x40);
 }
 
@@ -150,7 +151,7 @@ TEST_F(EightBitLoadTest, LD_IY_D_R)
     bus.write(cpu.PC, opCode);
     bus.write(cpu.PC + 1, instruction);
     bus.write(cpu.PC + 2, displacement);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(bus.read(0x2000 + displacement), 0x40);
 
     ASSERT_EQ(cpu.PC, 3);
@@ -170,7 +171,7 @@ TEST_F(EightBitLoadTest, LD_HL_n)
     bus.write(cpu.PC + 1, immediateValue); // Write immediate value (n)
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the value was written to the correct memory address
     ASSERT_EQ(bus.read(hlAddress), immediateValue);
@@ -192,7 +193,7 @@ TEST_F(EightBitLoadTest, LD_IX_D_n)
     bus.write(cpu.PC + 2, displacement);   // Write the displacement byte to memory
     bus.write(cpu.PC + 3, immediateValue); // Write the immediate value (n) to memory
 
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the value was written to the correct memory address
     ASSERT_EQ(bus.read(0x219A + displacement), immediateValue);
@@ -213,7 +214,7 @@ TEST_F(EightBitLoadTest, LD_IY_D_n)
     bus.write(cpu.PC + 2, displacement);   // Write the displacement byte to memory
     bus.write(cpu.PC + 3, immediateValue); // Write the immediate value (n) to memory
 
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the value was written to the correct memory address
     ASSERT_EQ(bus.read(0x219A + displacement), immediateValue);
@@ -232,7 +233,7 @@ TEST_F(EightBitLoadTest, LD_A_BC)
     bus.write(bcAddress, memoryValue); // Write value 0x12 to memory location 0x4747
 
     bus.write(cpu.PC, opCode);     // Write the opcode to memory
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the value from memory (0x12) was loaded into the accumulator (A)
     ASSERT_EQ(cpu.A, memoryValue);
@@ -248,7 +249,7 @@ TEST_F(EightBitLoadTest, LD_A_DE)
     bus.write(bcAddress, memoryValue); // Write value 0x12 to memory location 0x4747
 
     bus.write(cpu.PC, opCode);     // Write the opcode to memory
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction
+    step(cpu); // Execute the instruction
 
     // Verify that the value from memory (0x12) was loaded into the accumulator (A)
     ASSERT_EQ(cpu.A, memoryValue);
@@ -271,7 +272,7 @@ TEST_F(EightBitLoadTest, LD_A_nn)
     bus.write(cpu.PC + 2, 0x88); // High byte of the address
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that A contains the value from memory at address 0x8832
     ASSERT_EQ(cpu.A, memoryValue); // A should be 0x04
@@ -294,7 +295,7 @@ TEST_F(EightBitLoadTest, LD_DE_A)
     bus.write(cpu.PC, opCode);
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the memory at address 0x1128 contains the value from A (0xA0)
     ASSERT_EQ(bus.read(address), valueInA); // Memory at DE address should contain 0xA0
@@ -316,7 +317,7 @@ TEST_F(EightBitLoadTest, LD_BC_A)
     bus.write(cpu.PC, opCode);
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the memory at address 0x1128 contains the value from A (0xA0)
     ASSERT_EQ(bus.read(address), valueInA); // Memory at DE address should contain 0xA0
@@ -339,7 +340,7 @@ TEST_F(EightBitLoadTest, LD_nn_A)
     bus.write(cpu.PC + 2, 0x31); // High byte of the address
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the memory at address 0x3141 contains the value from A (0xD7)
     ASSERT_EQ(bus.read(address), valueInA); // Memory at address nn should contain 0xD7
@@ -387,7 +388,7 @@ TEST_F(EightBitLoadTest, testLD_A_R)
     bus.write(cpu.PC, 0xED);
     bus.write(cpu.PC + 1, opCode);
     // Act
-    cpu.execute(bus.read(cpu.PC)); // Example opcode for the LD A, I instruction
+    step(cpu); // Example opcode for the LD A, I instruction
 
     // Assert
     ASSERT_EQ(cpu.A, cpu.R);                        // Check A is loaded with I
@@ -410,7 +411,7 @@ TEST_F(EightBitLoadTest, LD_I_A)
     uint8_t immediateB = 0x47;         // Immediate value to load into register C
     bus.write(cpu.PC, opcodeB);        // Write opcode to memory at current PC
     bus.write(cpu.PC + 1, immediateB); // Write immediate value to memory at next byte
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.I, cpu.A);
 }
@@ -421,7 +422,7 @@ TEST_F(EightBitLoadTest, LD_R_A)
     uint8_t immediateB = 0x4F;         // Immediate value to load into register C
     bus.write(cpu.PC, opcodeB);        // Write opcode to memory at current PC
     bus.write(cpu.PC + 1, immediateB); // Write immediate value to memory at next byte
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.R, cpu.A);
 }
@@ -446,7 +447,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_nn)
     bus.write(cpu.PC, 0x01);        // Opcode for LD HL, nn
     bus.write(cpu.PC + 1, nn_low);  // Low byte of nn
     bus.write(cpu.PC + 2, nn_high); // High byte of nn
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.getBC(), 0x5000); // HL should now be 5000h
 
     uint8_t nn_low1 = 0x01; // Low byte of nn (5000h)
@@ -454,7 +455,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_nn)
     bus.write(cpu.PC, 0x11);        // Opcode for LD HL, nn
     bus.write(cpu.PC + 1, nn_low1); // Low byte of nn
     bus.write(cpu.PC + 2, nn_high1);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.getDE(), 0x5001);
 
     uint8_t nn_low2 = 0x02; // Low byte of nn (5000h)
@@ -462,7 +463,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_nn)
     bus.write(cpu.PC, 0x21);        // Opcode for LD HL, nn
     bus.write(cpu.PC + 1, nn_low2); // Low byte of nn
     bus.write(cpu.PC + 2, nn_high2);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.getHL(), 0x5002);
 
     uint8_t nn_low3 = 0x03; // Low byte of nn (5000h)
@@ -470,7 +471,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_nn)
     bus.write(cpu.PC, 0x31);        // Opcode for LD HL, nn
     bus.write(cpu.PC + 1, nn_low3); // Low byte of nn
     bus.write(cpu.PC + 2, nn_high3);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.SP, 0x5003);
 }
 TEST_F(SixteenBitLoadTest, LD_IX_nn)
@@ -483,7 +484,7 @@ TEST_F(SixteenBitLoadTest, LD_IX_nn)
     bus.write(cpu.PC + 1, 0x21);    // Opcode for LD HL, nn
     bus.write(cpu.PC + 2, nn_low);  // Low byte of nn
     bus.write(cpu.PC + 3, nn_high); // High byte of nn
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.IX, 0x5000); // HL should now be 5000h
 }
 TEST_F(SixteenBitLoadTest, LD_IY_nn)
@@ -495,7 +496,7 @@ TEST_F(SixteenBitLoadTest, LD_IY_nn)
     bus.write(cpu.PC + 1, 0x21);    // Opcode for LD HL, nn
     bus.write(cpu.PC + 2, nn_low);  // Low byte of nn
     bus.write(cpu.PC + 3, nn_high); // High byte of nn
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     ASSERT_EQ(cpu.IY, 0x5000); // HL should now be 5000h
 }
 TEST_F(SixteenBitLoadTest, LD_HL_NN)
@@ -514,7 +515,7 @@ TEST_F(SixteenBitLoadTest, LD_HL_NN)
     bus.write(cpu.PC + 2, (nn >> 8) & 0xFF); // High byte of nn
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
 
     // Check that HL is loaded correctly
     ASSERT_EQ(cpu.H, highByte);     // H should now contain the value at memory[nn+1]
@@ -538,7 +539,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_NN2)
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High byte of nn
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
 
     // Check that HL is loaded correctly
     ASSERT_EQ(cpu.H, highByte);     // H should now contain the value at memory[nn+1]
@@ -560,7 +561,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_NN2)
     bus.write(cpu.PC + 3, (nn1 >> 8) & 0xFF); // High byte of nn
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
 
     // Check that HL is loaded correctly
     ASSERT_EQ(cpu.B, highByte1); // H should now contain the value at memory[nn+1]
@@ -582,7 +583,7 @@ TEST_F(SixteenBitLoadTest, LD_DD_NN2)
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High byte of nn
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
 
     // Check that HL is loaded correctly
 
@@ -603,7 +604,7 @@ TEST_F(SixteenBitLoadTest, LD_IX_NN2)
     bus.write(cpu.PC + 2, nn & 0xFF);        // Low byte of nn
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High byte of nn
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
     ASSERT_EQ(cpu.IX, 0xA137);     // HL should combine to form 0xA137
 }
 TEST_F(SixteenBitLoadTest, LD_IY_NN2)
@@ -621,7 +622,7 @@ TEST_F(SixteenBitLoadTest, LD_IY_NN2)
     bus.write(cpu.PC + 2, nn & 0xFF);        // Low byte of nn
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High byte of nn
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC)); // Execute the instruction at PC
+    step(cpu); // Execute the instruction at PC
     ASSERT_EQ(cpu.IY, 0xA137);     // HL should combine to form 0xA137
 }
 TEST_F(SixteenBitLoadTest, LD_NN_HL)
@@ -636,7 +637,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_HL)
     bus.write(cpu.PC + 1, 0x29);
     bus.write(cpu.PC + 2, 0xB2);
     // Execute the LD (nn), HL instruction
-    cpu.execute(bus.read(cpu.PC)); // 0x22 is the opcode for LD (nn), HL
+    step(cpu); // 0x22 is the opcode for LD (nn), HL
 
     // Assert that memory at address nn contains L and at nn + 1 contains H
     ASSERT_EQ(memory.read(address), L);     // Memory[nn] should contain L (0x3A)
@@ -656,7 +657,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_DD)
     bus.write(cpu.PC + 2, 0x29);
     bus.write(cpu.PC + 3, 0xB2);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(memory.read(address), cpu.C); // Memory[nn] should contain L (0x3A)
     ASSERT_EQ(memory.read(address + 1), cpu.B);
@@ -671,7 +672,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_DD)
     bus.write(cpu.PC + 2, 0x20);
     bus.write(cpu.PC + 3, 0xB2);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(memory.read(address3), cpu.E); // Memory[nn] should contain L (0x3A)
     ASSERT_EQ(memory.read(address3 + 1), cpu.D);
@@ -685,7 +686,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_DD)
     bus.write(cpu.PC + 2, 0x29);
     bus.write(cpu.PC + 3, 0xB2);
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(memory.read(address2), lo2); // Memory[nn] should contain L (0x3A)
     ASSERT_EQ(memory.read(address2 + 1), hi2);
@@ -703,7 +704,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_IX)
     bus.write(cpu.PC + 2, nn & 0xFF);        // Low-order byte of nn
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High-order byte of nn
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(nn), 0x30);     // Low byte of IX
     ASSERT_EQ(bus.read(nn + 1), 0x5A); // High byte of IX
@@ -721,7 +722,7 @@ TEST_F(SixteenBitLoadTest, LD_NN_IY)
     bus.write(cpu.PC + 2, nn & 0xFF);        // Low-order byte of nn
     bus.write(cpu.PC + 3, (nn >> 8) & 0xFF); // High-order byte of nn
 
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(nn), 0x30);     // Low byte of IX
     ASSERT_EQ(bus.read(nn + 1), 0x5A); // High byte of IX
@@ -733,7 +734,7 @@ TEST_F(SixteenBitLoadTest, LD_SP_HL)
     cpu.L = 0x24; // Set low byte of HL
 
     bus.write(cpu.PC, 0xF9); // Opcode for LD SP, HL
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.SP, 0x4424); // SP should now match the value of HL
 }
@@ -743,7 +744,7 @@ TEST_F(SixteenBitLoadTest, LD_SP_IX)
     cpu.IX = 0x2224;         // Set low byte of HL
     bus.write(cpu.PC, 0xDD); // Opcode for LD SP, HL
     bus.write(cpu.PC + 1, 0xF9);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.SP, cpu.IX); // SP should now match the value of IX
 }
@@ -753,7 +754,7 @@ TEST_F(SixteenBitLoadTest, LD_SP_IY)
     cpu.IY = 0x2224;         // Set low byte of HL
     bus.write(cpu.PC, 0xFD); // Opcode for LD SP, HL
     bus.write(cpu.PC + 1, 0xF9);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.SP, 0x2224); // SP should now match the value of IX
 }
@@ -767,7 +768,7 @@ TEST_F(SixteenBitLoadTest, PUSHQQ)
     // Write the opcode for PUSH HL to memory
     bus.write(cpu.PC, 0xF5); // Opcode for PUSH HL
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that the SP was decremented twice
     ASSERT_EQ(cpu.SP, 0x1FFE);
     // Verify that the stack contains the correct values
@@ -787,7 +788,7 @@ TEST_F(SixteenBitLoadTest, PUSHIX)
     bus.write(cpu.PC, 0xDD);
     bus.write(cpu.PC + 1, 0xE5); // Opcode for PUSH HL
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that the SP was decremented twice
     ASSERT_EQ(cpu.SP, 0x1FFE);
     // Verify that the stack contains the correct values
@@ -804,7 +805,7 @@ TEST_F(SixteenBitLoadTest, PUSHIY)
     bus.write(cpu.PC, 0xFD);
     bus.write(cpu.PC + 1, 0xE5); // Opcode for PUSH HL
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
     // Verify that the SP was decremented twice
     ASSERT_EQ(cpu.SP, 0x1FFE);
     // Verify that the stack contains the correct values
@@ -865,7 +866,7 @@ TEST_F(SixteenBitLoadTest, POP_IX)
     bus.write(cpu.PC + 1, opcode);
 
     // Execute POP instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Check IX register values
     ASSERT_EQ(cpu.IX, 0x3355); // IX should contain the combined value 0x3355
@@ -888,7 +889,7 @@ TEST_F(SixteenBitLoadTest, POP_IY)
     bus.write(cpu.PC + 1, opcode);
 
     // Execute POP instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Check IX register values
     ASSERT_EQ(cpu.IY, 0x3355); // IX should contain the combined value 0x3355
@@ -1026,7 +1027,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, EX_SP_IX)
 
     bus.write(cpu.PC, 0xDD); // Memory[SP] = 0x90 (low byte)
     bus.write(cpu.PC + 1, 0xE3);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify IX contains the memory values
     ASSERT_EQ(cpu.IX, 0x4890);
@@ -1052,7 +1053,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, EX_SP_IY)
 
     bus.write(cpu.PC, 0xFD); // Memory[SP] = 0x90 (low byte)
     bus.write(cpu.PC + 1, 0xE3);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.IY, 0x4890);
 
@@ -1084,7 +1085,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, LDI)
     memory.write(cpu.PC + 1, 0xA0); // Second byte of LDI opcode
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC)); // Execute ED
+    step(cpu); // Execute ED
 
     // Verify results
     ASSERT_EQ(cpu.getHL(), 0xd098); // HL incremented
@@ -1141,7 +1142,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, LDIR)
 
     do
     {
-        cpu.execute(memory.read(cpu.PC));
+        step(cpu);
 
     } while (cpu.PC < 2);
 
@@ -1192,7 +1193,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, LDD)
     memory.write(cpu.PC + 1, 0xA8); // Second byte of LDD opcode
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results
     ASSERT_EQ(cpu.getHL(), initialHL - 1); // HL decremented
@@ -1239,7 +1240,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, LDDR)
     uint8_t count = 0;
     while (cpu.getBC() != 0)
     {
-        cpu.execute(memory.read(cpu.PC));
+        step(cpu);
         count++;
     }
 
@@ -1281,7 +1282,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, CPI)
     memory.write(cpu.PC + 1, 0xA1); // Second byte of CPI opcode
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results
     ASSERT_EQ(cpu.getHL(), HL + 1);   // HL incremented by 1
@@ -1325,7 +1326,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, CPIR)
     // Execute the CPIR instruction
     while (count < 3)
     {
-        cpu.execute(memory.read(cpu.PC));
+        step(cpu);
         count++;
         if (cpu.getBC() == 0)
         {
@@ -1371,7 +1372,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, CPD)
     memory.write(cpu.PC + 1, 0xA9); // Second byte of CPD opcode
     int count = 0;
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results after execution
     ASSERT_EQ(cpu.getHL(), HL - 1); // HL decrements until match
@@ -1417,7 +1418,7 @@ TEST_F(ExchangeBlockTransferandSearchGroupTest, CPDR)
     // Execute the CPDR instruction
     while (count < 3)
     {
-        cpu.execute(memory.read(cpu.PC));
+        step(cpu);
         count++;
         if (cpu.getBC() == 0)
         {
@@ -1469,7 +1470,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_R)
     memory.write(cpu.PC, 0x80); // OpCode for ADD A, B
 
     // Execute the ADD A, B instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results after execution
     ASSERT_EQ(cpu.A, expectedResult); // Accumulator contains the sum
@@ -1498,7 +1499,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_n)
     memory.write(cpu.PC + 1, operand); // Write the operand n (0x33) to memory
 
     // Execute the ADD A, n instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the result after the instruction is executed
     ASSERT_EQ(cpu.A, 0x23 + operand); // A should be updated with 0x56 (23h + 33h = 56h)
@@ -1517,7 +1518,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_n)
 
     memory.write(cpu.PC, 0xC6);
     memory.write(cpu.PC + 1, operand); // Update operand in memory
-    cpu.execute(memory.read(cpu.PC));  // Execute the instruction
+    step(cpu);  // Execute the instruction
 
     // Verify the result after the overflow
     ASSERT_EQ(cpu.A, 0); // A should be 0x8F (overflowed value)
@@ -1544,7 +1545,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_HL)
     memory.write(cpu.PC, 0x86); // Opcode for ADD A, (HL)
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify the results
     ASSERT_EQ(cpu.A, 0xA8);         // A should contain the result 0xA8
@@ -1580,7 +1581,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_IX_d)
     memory.write(cpu.PC + 2, displacement); // Displacement d = 0x05
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results
     ASSERT_EQ(cpu.A, 0x33);    // 0x11 + 0x22 = 0x33
@@ -1611,7 +1612,7 @@ TEST_F(EightBitArithmeticGroupTest, ADD_A_IY_d)
     memory.write(cpu.PC + 2, displacement); // Displacement d = 0x05
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify results
     ASSERT_EQ(cpu.A, 0xA2);    // 0x11 + 0x22 = 0x33
@@ -1638,7 +1639,7 @@ TEST_F(EightBitArithmeticGroupTest, ADC_A_s)
 
     memory.write(cpu.PC, 0x88); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1668,7 +1669,7 @@ TEST_F(EightBitArithmeticGroupTest, ADC_A_N)
     memory.write(cpu.PC, opCode);
     memory.write(cpu.PC + 1, immediateValue);
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
     // Verify accumulator result
     ASSERT_EQ(cpu.A, 0x36);
 
@@ -1730,7 +1731,7 @@ TEST_F(EightBitArithmeticGroupTest, ADC_A_IX_D)
     memory.write(cpu.PC, 0xDD);
     memory.write(cpu.PC + 1, 0x8E);
     memory.write(cpu.PC + 2, displacement);
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1767,7 +1768,7 @@ TEST_F(EightBitArithmeticGroupTest, ADC_A_IY_D)
     memory.write(cpu.PC, 0xFD);
     memory.write(cpu.PC + 1, 0x8E);
     memory.write(cpu.PC + 2, displacement);
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1795,7 +1796,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_S)
 
     memory.write(cpu.PC, opCode); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1819,7 +1820,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_S_Overflow)
 
     memory.write(cpu.PC, opCode); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1844,7 +1845,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_N)
     memory.write(cpu.PC, opCode);
     memory.write(cpu.PC + 1, 0x80); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1870,7 +1871,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_HL)
     memory.write(cpu.PC, opCode);
     memory.write(cpu.getHL(), 0x80); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1899,7 +1900,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_IX_D)
     memory.write(cpu.PC + 2, 0x05);
     memory.write(cpu.IX + d, 0x80); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1928,7 +1929,7 @@ TEST_F(EightBitArithmeticGroupTest, SUB_A_IY_D)
     memory.write(cpu.PC + 2, 0x05);
     memory.write(cpu.IY + d, 0x80); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1953,7 +1954,7 @@ TEST_F(EightBitArithmeticGroupTest, SBC_A_S)
 
     memory.write(cpu.PC, opCode); // First byte of the instruction prefix
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -1980,7 +1981,7 @@ TEST_F(EightBitArithmeticGroupTest, SBC_A_HL)
     memory.write(cpu.PC, opCode);
     memory.write(cpu.getHL(), 0x15);
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2010,7 +2011,7 @@ TEST_F(EightBitArithmeticGroupTest, SBC_A_IX_D)
     memory.write(cpu.PC + 2, d);
     memory.write(cpu.IX + d, 0x15);
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2040,7 +2041,7 @@ TEST_F(EightBitArithmeticGroupTest, SBC_A_IY_D)
     memory.write(cpu.PC + 2, d);
     memory.write(cpu.IY + d, 0x15);
 
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2091,7 +2092,7 @@ TEST_F(EightBitArithmeticGroupTest, AND_A_N)
     memory.write(cpu.PC + 1, immediateValue);
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2120,7 +2121,7 @@ TEST_F(EightBitArithmeticGroupTest, AND_A_HL)
     memory.write(cpu.PC, opCode);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2154,7 +2155,7 @@ TEST_F(EightBitArithmeticGroupTest, AND_A_IX_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2184,7 +2185,7 @@ TEST_F(EightBitArithmeticGroupTest, AND_A_IY_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2235,7 +2236,7 @@ TEST_F(EightBitArithmeticGroupTest, OR_A_N)
     memory.write(cpu.PC + 1, immediateValue);
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2264,7 +2265,7 @@ TEST_F(EightBitArithmeticGroupTest, OR_A_HL)
     memory.write(cpu.PC, opCode);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2294,7 +2295,7 @@ TEST_F(EightBitArithmeticGroupTest, OR_A_IX_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2324,7 +2325,7 @@ TEST_F(EightBitArithmeticGroupTest, OR_A_IY_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2374,7 +2375,7 @@ TEST_F(EightBitArithmeticGroupTest, XOR_A_N)
     memory.write(cpu.PC + 1, immediateValue);
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2403,7 +2404,7 @@ TEST_F(EightBitArithmeticGroupTest, XOR_A_HL)
     memory.write(cpu.PC, opCode);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2433,7 +2434,7 @@ TEST_F(EightBitArithmeticGroupTest, XOR_A_IX_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2463,7 +2464,7 @@ TEST_F(EightBitArithmeticGroupTest, XOR_A_IY_D)
     memory.write(cpu.PC + 2, 0x05);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify accumulator result
     ASSERT_EQ(cpu.A, expectedResult);
@@ -2523,7 +2524,7 @@ TEST_F(EightBitArithmeticGroupTest, CP_N)
     memory.write(cpu.PC + 1, immediateValue);
 
     // Execute the instruction
-    cpu.execute(memory.read(cpu.PC));
+    step(cpu);
 
     // Verify that the accumulator remains unchanged
     ASSERT_EQ(cpu.A, 0x81);
@@ -2573,7 +2574,7 @@ TEST_F(EightBitArithmeticGroupTest, INC_R)
     cpu.A = 0x06;
     uint8_t opCode = 0x3C;
     memory.write(cpu.PC, opCode);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.A, 0x06 + 1);
 
@@ -2592,7 +2593,7 @@ TEST_F(EightBitArithmeticGroupTest, INC_HL)
     uint8_t opCode = 0x34;
     memory.write(cpu.PC, opCode);
     memory.write(cpu.getHL(), 0x06);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.getHL()), 0x06 + 1);
 
@@ -2612,7 +2613,7 @@ TEST_F(EightBitArithmeticGroupTest, INC_IX_D)
     memory.write(cpu.PC + 1, opCode);
     bus.write(cpu.PC + 2, d);
     memory.write(cpu.IX + d, 0x06);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IX + d), 0x06 + 1);
 
@@ -2632,7 +2633,7 @@ TEST_F(EightBitArithmeticGroupTest, INC_IY_D)
     memory.write(cpu.PC + 1, opCode);
     bus.write(cpu.PC + 2, d);
     memory.write(cpu.IY + d, 0x06);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IY + d), 0x06 + 1);
 
@@ -2648,7 +2649,7 @@ TEST_F(EightBitArithmeticGroupTest, DEC_R)
     cpu.B = 0x80;
     uint8_t opCode = 0x05;
     memory.write(cpu.PC, opCode);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.B, 0x80 - 1);
 
@@ -2667,7 +2668,7 @@ TEST_F(EightBitArithmeticGroupTest, DEC_HL)
     uint8_t opCode = 0x35;
     memory.write(cpu.PC, opCode);
     memory.write(cpu.getHL(), 0x0A);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.getHL()), 0x09);
 
@@ -2687,7 +2688,7 @@ TEST_F(EightBitArithmeticGroupTest, DEC_IX_D)
     memory.write(cpu.PC + 1, opCode);
     bus.write(cpu.PC + 2, d);
     memory.write(cpu.IX + d, 0x06);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IX + d), 0x06 - 1);
 
@@ -2707,7 +2708,7 @@ TEST_F(EightBitArithmeticGroupTest, DEC_IY_D)
     memory.write(cpu.PC + 1, opCode);
     bus.write(cpu.PC + 2, d);
     memory.write(cpu.IY + d, 0x06);
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(bus.read(cpu.IY + d), 0x06 - 1);
 
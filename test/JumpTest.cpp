@@ -3,6 +3,7 @@
 #include "../Bus.cpp"
 #include "../Memory.cpp"
 #include "../Instruction.cpp"
+#include "Step.hpp"
 
 class JumpGroup : public ::testing::Test
 {
@@ -31,7 +32,7 @@ TEST_F(JumpGroup, JP_NN)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP nn instruction (opcode 0xC3 for JP nn)
-    cpu.execute(bus.read(cpu.PC)); // The first byte is the opcode
+    step(cpu); // The first byte is the opcode
 
     // Verify that the PC is now set to 0x1234
     ASSERT_EQ(cpu.PC, 0x1234);
@@ -52,7 +53,7 @@ TEST_F(JumpGroup, JP_CC_TRUE)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP C, nn instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is now set to 0x1234 since the condition is true
     ASSERT_EQ(cpu.PC, targetAddress);
@@ -71,7 +72,7 @@ TEST_F(JumpGroup, JP_CC_TRUE)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP C, nn instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is now set to 0x1234 since the condition is true
     ASSERT_EQ(cpu.PC, targetAddress);
@@ -93,7 +94,7 @@ TEST_F(JumpGroup, JP_CC_FALSE)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP C, nn instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC increments to the next instruction (0x1003) since the condition is false
     ASSERT_EQ(cpu.PC, 0x1003);
@@ -112,7 +113,7 @@ TEST_F(JumpGroup, JP_CC_FALSE)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP C, nn instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC increments to the next instruction (0x1003) since the condition is false
     ASSERT_EQ(cpu.PC, 0x1003);
@@ -131,7 +132,7 @@ TEST_F(JumpGroup, JP_CC_FALSE)
     bus.write(cpu.PC + 2, 0x12); // High byte of address 0x1234
 
     // Execute the JP C, nn instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC increments to the next instruction (0x1003) since the condition is false
     ASSERT_EQ(cpu.PC, 0x1003);
@@ -150,7 +151,7 @@ TEST_F(JumpGroup, JR_e)
     bus.write(cpu.PC + 1, displacement); // Displacement value
 
     // Execute the JR e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // 0x0482 (PC after opcode+operand) + 5
     ASSERT_EQ(cpu.PC, 0x0485);
@@ -172,7 +173,7 @@ TEST_F(JumpGroup, JR_C_e)
     cpu.setFlag(z80::C_flag);
 
     // Execute the JR C, e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated correctly (jump taken)
     uint16_t expectedPC = 0x0482 + displacement; // 0x0482 (PC after opcode+operand) - 4
@@ -195,7 +196,7 @@ TEST_F(JumpGroup, JR_C_e_NoJump)
     cpu.clearFlag(z80::C_flag);
 
     // Execute the JR C, e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is incremented by 2 (jump not taken)
     uint16_t expectedPC = 0x0482; // No jump, PC = PC + 2
@@ -217,7 +218,7 @@ TEST_F(JumpGroup, JR_NC_e)
     cpu.clearFlag(z80::C_flag);
 
     // Execute the JR C, e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated correctly (jump taken)
     uint16_t expectedPC = 0x0482 + displacement; // 0x0482 (PC after opcode+operand) - 4
@@ -239,7 +240,7 @@ TEST_F(JumpGroup, JR_Z_e)
     cpu.setFlag(z80::Z);
 
     // Execute the JR C, e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated correctly (jump taken)
     uint16_t expectedPC = 0x0482 + displacement; // 0x0482 (PC after opcode+operand) - 4
@@ -261,7 +262,7 @@ TEST_F(JumpGroup, JR_NZ_e)
     cpu.clearFlag(z80::Z);
 
     // Execute the JR C, e instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated correctly (jump taken)
     uint16_t expectedPC = 0x0482 + displacement; // 0x0482 (PC after opcode+operand) - 4
@@ -282,7 +283,7 @@ TEST_F(JumpGroup, JP_HL)
     bus.write(cpu.PC, 0xE9); // Opcode for JP (HL)
 
     // Execute the JP (HL) instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated to the contents of HL
     ASSERT_EQ(cpu.PC, targetAddress);
@@ -301,7 +302,7 @@ TEST_F(JumpGroup, JP_IX)
     bus.write(cpu.PC + 1, 0xE9); // Opcode for JP (IX)
 
     // Execute the JP (IX) instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated to the contents of IX
     ASSERT_EQ(cpu.PC, targetAddress);
@@ -320,7 +321,7 @@ TEST_F(JumpGroup, JP_IY)
     bus.write(cpu.PC + 1, 0xE9); // Opcode for JP (IY)
 
     // Execute the JP (IY) instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that the PC is updated to the contents of IY
     ASSERT_EQ(cpu.PC, targetAddress);
@@ -340,7 +341,7 @@ TEST_F(JumpGroup, DJNZ_e)
     // Execute the instruction
     for (int i = 0; i < 10; i++)
     {
-        cpu.execute(bus.read(cpu.PC));
+        step(cpu);
     }
 
     // Verify that PC is updated to PC + e (0x1000 - 2 = 0x0FFE) since B != 0
@@ -360,7 +361,7 @@ TEST_F(JumpGroup, DJNZ_NoJumpWhenBIsZero)
     bus.write(cpu.PC + 1, 0xFE); // Displacement -2 (two's complement)
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that B is decremented to 0
     ASSERT_EQ(cpu.B, 0);
@@ -381,7 +382,7 @@ TEST_F(JumpGroup, CALL_nn)
     bus.write(cpu.PC + 2, 0x21); // High byte of address 0x2135
 
     // Execute the CALL instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the stack pointer (SP) has been updated correctly
     ASSERT_EQ(cpu.SP, 0x1FFE); // SP should have been decremented by 2
@@ -409,7 +410,7 @@ TEST_F(JumpGroup, CALL_CC_NN)
     bus.write(cpu.PC + 2, 0x9c); // High byte of address 0x2135
 
     // Execute the CALL instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     ASSERT_EQ(cpu.getAF(), 0x004e);
     // Verify the stack pointer (SP) has been updated correctly
@@ -431,7 +432,7 @@ TEST_F(JumpGroup, CALL_CC_NN_notzero)
     cpu.clearFlag(z80::Z);
 
     // Execute the CALL instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the stack pointer (SP) has been updated correctly
     ASSERT_EQ(cpu.PC, 0x0083); // SP should have been decremented by 2
@@ -452,7 +453,7 @@ TEST_F(JumpGroup, RET)
     bus.write(cpu.PC, 0xC9); // Opcode for RET
 
     // Execute the RET instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the Stack Pointer (SP) has been incremented correctly
     ASSERT_EQ(cpu.SP, 0x2000); // SP should have been incremented by 2
@@ -475,7 +476,7 @@ TEST_F(JumpGroup, RET_cc)
     bus.write(cpu.PC, 0xD8);
 
     // Execute the RET M instruction (condition "M" checks if the S flag is set)
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the Stack Pointer (SP) has been incremented correctly
     ASSERT_EQ(cpu.SP, 0x2000); // SP should have been incremented by 2
@@ -487,7 +488,7 @@ TEST_F(JumpGroup, RET_cc)
     cpu.clearFlag(z80::S); // Clear the S flag
     cpu.SP = 0x2000;       // Reset SP
     cpu.PC = 0x1234;       // Reset PC
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify that SP and PC remain unchanged when the condition is false
     ASSERT_EQ(cpu.SP, 0x2000); // SP should remain the same
@@ -522,7 +523,7 @@ TEST_F(InputOutputGroupTest, IN_A_n)
     bus.write(cpu.PC + 1, port); // Port number
 
     // Execute the instruction
-    cpu.execute(bus.read(cpu.PC));
+    step(cpu);
 
     // Verify the accumulator contains the value read from the port
     ASSERT_EQ(cpu.A, portValue);
@@ -0,0 +1,376 @@
+#include <gtest/gtest.h>
+#include "../main.cpp"
+#include "../Bus.cpp"
+#include "../Memory.cpp"
+#include "../Instruction.cpp"
+#include "../IODevice.cpp"
+#include <tuple>
+
+class MemoryMapTest : public ::testing::Test
+{
+protected:
+    Memory memory;
+    Bus bus;
+    z80 cpu;
+
+    MemoryMapTest() : memory(0x10000), bus(memory), cpu()
+    {
+        cpu.reset(&bus);
+    }
+};
+
+TEST_F(MemoryMapTest, RomPagesDropWrites)
+{
+    const uint8_t program[] = {
+        0x3E, 0x55,       // LD A, 0x55
+        0x32, 0x00, 0x10, // LD (0x1000), A
+        0x21, 0x00, 0x80, // LD HL, 0x8000
+        0x11, 0xFE, 0x3F, // LD DE, 0x3FFE
+        0x01, 0x04, 0x00, // LDIR 4 bytes, across the end of the ROM
+        0xED, 0xB0,
+        0x76,             // HALT
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+    {
+        bus.write(0x8000 + i, program[i]);
+    }
+    bus.write(0x3FFE, 0xAA); // ROM contents, while the page is still RAM
+    bus.mapMemory(0x0000, 0x4000, 0x0000, false);
+
+    cpu.engine = ExecutionEngine::Block;
+    cpu.PC = 0x8000;
+    cpu.runFor(200);
+
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(bus.read(0x1000), 0x00);
+    ASSERT_EQ(bus.read(0x3FFE), 0xAA);
+    ASSERT_EQ(bus.read(0x3FFF), 0x00);
+    ASSERT_EQ(bus.read(0x4000), 0x32); // RAM from here on
+    ASSERT_EQ(bus.read(0x4001), 0x00);
+}
+
+namespace
+{
+// Memory mapped device that reads back the low byte of the address
+class MappedDevice : public IODevice
+{
+public:
+    std::vector<std::pair<int, uint8_t>> written;
+
+    bool handlesAddress(int) override { return false; }
+    uint8_t read(int address) override { return address & 0xFF; }
+    void write(int address, uint8_t value) override { written.push_back({address, value}); }
+};
+}
+
+TEST_F(MemoryMapTest, FlaggedPagesTakeTheSlowPath)
+{
+    MappedDevice device;
+    bus.setPageFlags(0xD000, 0x100, Bus::PAGE_IO, true, &device);
+    bus.setPageFlags(0xC000, 0x100, Bus::PAGE_WATCH, true);
+    std::vector<std::tuple<uint16_t, uint8_t, bool>> watched;
+    bus.watcher = [&](uint16_t address, uint8_t value, bool write)
+    { watched.push_back({address, value, write}); };
+
+    bus.write(0xC010, 0x12);
+    ASSERT_EQ(bus.read(0xC010), 0x12);
+    ASSERT_EQ(watched, (std::vector<std::tuple<uint16_t, uint8_t, bool>>{{0xC010, 0x12, true}, {0xC010, 0x12, false}}));
+
+    bus.write(0xD020, 0x34);
+    ASSERT_EQ(bus.read(0xD042), 0x42);
+    ASSERT_EQ(device.written, (std::vector<std::pair<int, uint8_t>>{{0xD020, 0x34}}));
+
+    // Once the flags are cleared the pages are plain RAM again
+    bus.setPageFlags(0xC000, 0x2000, Bus::PAGE_IO | Bus::PAGE_WATCH, false);
+    bus.write(0xD020, 0x56);
+    ASSERT_EQ(bus.read(0xD020), 0x56);
+    ASSERT_EQ(bus.read(0xC010), 0x12);
+    ASSERT_EQ(watched.size(), 2);
+}
+
+class BankedMemoryTest : public ::testing::Test
+{
+protected:
+    Memory memory;
+    Bus bus;
+    z80 cpu;
+
+    BankedMemoryTest() : memory(Bus::BANKED_MEMORY_SIZE), bus(memory), cpu()
+    {
+        bus.setModel(MachineModel::Spectrum128K);
+        cpu.reset(&bus);
+    }
+};
+
+TEST_F(BankedMemoryTest, PortSelectsTheBankAtC000)
+{
+    bus.write(0xC000, 0x11); // Bank 0
+    bus.writeIO(0x7FFD, 1);
+    ASSERT_EQ(bus.read(0xC000), 0x00);
+    bus.write(0xC000, 0x22);
+    ASSERT_EQ(memory.getMemoryPointer()[Bus::BANK_OFFSETS[1]], 0x22);
+
+    bus.writeIO(0x7FFD, 0);
+    ASSERT_EQ(bus.read(0xC000), 0x11);
+
+    // 0xFFFD is the sound chip, A15 set keeps it off the paging port
+    bus.writeIO(0xFFFD, 1);
+    ASSERT_EQ(bus.read(0xC000), 0x11);
+}
+
+TEST_F(BankedMemoryTest, StorageIsAddressedPastTheFirst64K)
+{
+    memory.write(Bus::BANK_OFFSETS[7] + 5, 0x77);
+    ASSERT_EQ(memory.read(Bus::BANK_OFFSETS[7] + 5), 0x77);
+    ASSERT_EQ(memory.read(0x0005), 0x00); // Not wrapped onto the ROM
+    bus.writeIO(0x7FFD, 7);
+    ASSERT_EQ(bus.read(0xC005), 0x77);
+}
+
+TEST_F(BankedMemoryTest, BankMappedTwiceSharesItsBytes)
+{
+    bus.writeIO(0x7FFD, 5);
+    bus.write(0xC123, 0x77);
+    ASSERT_EQ(bus.read(0x4123), 0x77);
+    bus.write(0x4124, 0x88);
+    ASSERT_EQ(bus.read(0xC124), 0x88);
+
+    uint32_t generation = bus.getPageGeneration(0x4100);
+    bus.write(0xC100, 0x99);
+    ASSERT_GT(bus.getPageGeneration(0x4100), generation);
+}
+
+TEST_F(BankedMemoryTest, ScreenFollowsBit3)
+{
+    bus.write(0x4000, 0x55);
+    ASSERT_EQ(bus.getScreen()[0], 0x55);
+
+    bus.writeIO(0x7FFD, 7);
+    bus.write(0xC000, 0xAA);
+    ASSERT_EQ(bus.getScreen()[0], 0x55);
+
+    bus.writeIO(0x7FFD, 7 | 0x08);
+    ASSERT_EQ(bus.getScreen()[0], 0xAA);
+}
+
+TEST_F(BankedMemoryTest, LockBitFreezesPaging)
+{
+    bus.writeIO(0x7FFD, 3 | 0x20);
+    bus.write(0xC000, 0x33);
+    bus.writeIO(0x7FFD, 0);
+    ASSERT_EQ(bus.read(0xC000), 0x33);
+    ASSERT_EQ(memory.getMemoryPointer()[Bus::BANK_OFFSETS[3]], 0x33);
+
+    // Until the model is set up again, as on reset
+    bus.setModel(MachineModel::Spectrum128K);
+    ASSERT_EQ(bus.read(0xC000), 0x00);
+}
+
+TEST_F(BankedMemoryTest, SwitchedBankRunsItsOwnCode)
+{
+    for (int bank = 0; bank < 2; ++bank)
+    {
+        bus.writeIO(0x7FFD, bank);
+        bus.write(0xC000, 0x3E); // LD A, bank + 1
+        bus.write(0xC001, bank + 1);
+        bus.write(0xC002, 0x76); // HALT
+    }
+
+    cpu.engine = ExecutionEngine::Block;
+    cpu.PC = 0xC000;
+    cpu.runFor(20);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.A, 2);
+
+    // Same addresses, other bank: the block built from bank 1 must not run
+    bus.writeIO(0x7FFD, 0);
+    cpu.halted = false;
+    cpu.PC = 0xC000;
+    cpu.runFor(20);
+    ASSERT_TRUE(cpu.halted);
+    ASSERT_EQ(cpu.A, 1);
+}
+
+TEST_F(BankedMemoryTest, FramesFollowTheModel)
+{
+    // Memory is all NOPs, which fill the frame exactly
+    cpu.runFrame();
+    ASSERT_EQ(cpu.tstates, 70908);
+    ASSERT_EQ(bus.scheduler.next(), 70908);
+
+    // Back on the 48K the next frames are the shorter ones
+    bus.setModel(MachineModel::Spectrum48K);
+    cpu.runFrame();
+    ASSERT_EQ(cpu.tstates, 70908 + z80::TSTATES_PER_FRAME);
+    ASSERT_EQ(bus.scheduler.next(), 70908 + z80::TSTATES_PER_FRAME);
+}
+
+TEST_F(BankedMemoryTest, Plus2ASpecialPagingPutsRamAtZero)
+{
+    bus.setModel(MachineModel::SpectrumPlus2A);
+    bus.write(0x0000, 0x44);
+    ASSERT_EQ(bus.read(0x0000), 0x00); // ROM 0
+
+    bus.writeIO(0x1FFD, 1); // Banks 0, 1, 2, 3
+    bus.write(0x0000, 0x44);
+    ASSERT_EQ(bus.read(0x0000), 0x44);
+    ASSERT_EQ(memory.getMemoryPointer()[Bus::BANK_OFFSETS[0]], 0x44);
+
+    bus.writeIO(0x1FFD, 0x04); // Normal paging, ROM 2
+    ASSERT_EQ(bus.read(0x0000), memory.getMemoryPointer()[Bus::ROM_OFFSETS[2]]);
+    bus.write(0x0000, 0x66);
+    ASSERT_EQ(memory.getMemoryPointer()[Bus::ROM_OFFSETS[2]], 0x00);
+}
+
+TEST(BusPolicyTest, FlatBusIsPlainRam)
+{
+    Memory memory(0x10000);
+    FlatBus bus(memory);
+
+    uint32_t generation = bus.getPageGeneration(0x0012);
+    bus.write(0x0012, 0x34);
+    ASSERT_EQ(bus.read(0x0012), 0x34);
+    ASSERT_EQ(memory.read(0x0012), 0x34);
+    ASSERT_GT(bus.getPageGeneration(0x0012), generation);
+    ASSERT_EQ(bus.getMemoryChanges(), 1);
+
+    bus.write(0x0012, 0x34); // Same value, nothing changed
+    ASSERT_EQ(bus.getMemoryChanges(), 1);
+}
+
+TEST(BusPolicyTest, ContendedBusDelaysScreenAccesses)
+{
+    Memory memory(0x10000);
+    ContendedBus bus(memory);
+    uint64_t tstates = 14335 + 7; // The instruction's T-states are on the clock
+    bus.attachClock(&tstates);
+    bus.startAccesses(14335); // First T-state the ULA fetches the screen
+
+    bus.read(0x8000); // Uncontended bank
+    ASSERT_EQ(tstates, 14335 + 7);
+    bus.startAccesses(14335);
+    bus.read(0x4000);
+    ASSERT_EQ(tstates, 14335 + 7 + 6);
+    bus.write(0x5800, 0x38); // 3 T-states and the wait on, the next wait is 5
+    ASSERT_EQ(tstates, 14335 + 7 + 11);
+    ASSERT_EQ(bus.getContention(), 11);
+
+    bus.startAccesses(14335 + 130); // Border, the ULA is not fetching
+    bus.read(0x4000);
+    bus.startAccesses(100); // Top border
+    bus.read(0x4000);
+    ASSERT_EQ(bus.getContention(), 11);
+}
+
+TEST(BusPolicyTest, ContendedBusSpacesRepeatedCopies)
+{
+    Memory memory(0x10000);
+    ContendedBus bus(memory);
+    uint64_t tstates = 0;
+    bus.attachClock(&tstates);
+
+    // Each byte is an LDIR iteration of its own. The first read waits 6, so
+    // the second comes 21 + 6 T-states later and waits 3.
+    bus.startAccesses(14335);
+    bus.copyMemory(0x4000, 0x8000, 2, 1);
+    ASSERT_EQ(bus.getContention(), 6 + 3);
+}
+
+TEST(BusPolicyTest, ContendedBusFollowsThePagedBank)
+{
+    Memory memory(Bus::BANKED_MEMORY_SIZE);
+    ContendedBus bus(memory);
+    bus.setModel(MachineModel::Spectrum128K);
+    uint64_t tstates = 14361;
+    bus.attachClock(&tstates);
+
+    bus.read(0xC000); // Bank 0
+    ASSERT_EQ(tstates, 14361);
+    bus.writeIO(0x7FFD, 1);
+    bus.startAccesses(14361);
+    bus.read(0xC000);
+    ASSERT_EQ(tstates, 14361 + 6);
+}
+
+TEST(BusPolicyTest, InstrumentedBusCountsAccesses)
+{
+    Memory memory(0x10000);
+    InstrumentedBus bus(memory);
+
+    bus.write(0x8000, 1);
+    bus.read(0x8000);
+    bus.read(0x80FF);
+    bus.copyMemory(0x8000, 0x9000, 4, 1);
+    bus.writeIO(0x00FE, 7);
+    bus.readIO(0xFEFE);
+
+    ASSERT_EQ(bus.reads[0x80], 6);
+    ASSERT_EQ(bus.writes[0x80], 1);
+    ASSERT_EQ(bus.writes[0x90], 4);
+    ASSERT_EQ(bus.ioReads, 1);
+    ASSERT_EQ(bus.ioWrites, 1);
+    ASSERT_EQ(bus.read(0x9000), 1);
+
+    bus.clearCounts();
+    ASSERT_EQ(bus.reads[0x90], 0);
+}
+
+namespace
+{
+// A ROM file of count bytes, each its offset folded to a byte plus salt
+std::string writeRomFile(const std::string &name, int count, uint8_t salt)
+{
+    std::ofstream file(name, std::ios::binary);
+    for (int i = 0; i < count; ++i)
+    {
+        file.put(static_cast<char>((i ^ (i >> 8)) + salt));
+    }
+    return name;
+}
+}
+
+TEST(RomLoadingTest, MachinesShareOneRomFile)
+{
+    std::string rom = writeRomFile("sharedRom.tmp", 0x4000, 0);
+    Memory firstMemory(0x10000), secondMemory(0x10000);
+    Bus first(firstMemory), second(secondMemory);
+    first.write(0x0100, 0xAA);
+    uint32_t generation = first.getPageGeneration(0x0100);
+
+    first.loadROM(rom);
+    second.loadROM(rom);
+    std::remove(rom.c_str()); // The mappings outlive the name
+
+    ASSERT_GT(first.getPageGeneration(0x0100), generation);
+    ASSERT_EQ(first.read(0x0100), 0x01);
+    ASSERT_EQ(first.read(0x3FFF), 0xC0);
+    ASSERT_EQ(second.read(0x1234), 0x26);
+
+    // Writing the ROM through the bus is dropped
+    first.write(0x0010, 0x99);
+    ASSERT_EQ(first.read(0x0010), 0x10);
+    ASSERT_EQ(second.read(0x0010), 0x10);
+
+    // Loading over the mapping only changes that machine's copy
+    const uint8_t patch = 0x99;
+    firstMemory.load(0x0010, &patch, 1);
+    ASSERT_EQ(first.read(0x0010), 0x99);
+    ASSERT_EQ(second.read(0x0010), 0x10);
+    ASSERT_EQ(first.read(0x4000), 0x00); // RAM is left alone
+}
+
+TEST(RomLoadingTest, BankedModelsMapEachRom)
+{
+    std::string rom = writeRomFile("bankedRom.tmp", 0x8000, 0x80);
+    Memory memory(Bus::BANKED_MEMORY_SIZE);
+    Bus bus(memory);
+    bus.setModel(MachineModel::Spectrum128K);
+    bus.loadROM(rom);
+    std::remove(rom.c_str());
+
+    ASSERT_EQ(bus.read(0x0001), 0x81);
+    bus.writeIO(0x7FFD, 0x10); // ROM 1
+    ASSERT_EQ(bus.read(0x0001), 0xC1); // Offset 0x4001 in the file
+    ASSERT_EQ(bus.read(0x0002), 0xC2);
+    ASSERT_EQ(memory.getMemoryPointer()[Bus::ROM_OFFSETS[1] + 0x7F], 0xBF);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_STEP_H
+#define TEST_STEP_H
+
+// Runs the instruction at PC on the engine the suite was built for. The Block
+// and Jit engines only run code through runFor(), so there it is given a
+// budget of one T-state, which ends after the first instruction; when that is
+// all there is to its block, the translated (or, for Jit, compiled) block runs.
+inline void step(z80 &cpu)
+{
+    if (cpu.engine == ExecutionEngine::Block || cpu.engine == ExecutionEngine::Jit)
+    {
+#ifdef Z80_JIT
+        cpu.jitThreshold = 1;
+#endif
+        cpu.overshoot = 0;
+        cpu.runFor(1);
+    }
+    else
+    {
+        cpu.execute(cpu.bus->read(cpu.PC));
+    }
+}
+
+#endif